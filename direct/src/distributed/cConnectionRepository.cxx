@@ -537,7 +537,9 @@ send_message_bundle(unsigned int channel, unsigned int sender_channel) {
     // add each bundled message
     BundledMsgVector::const_iterator bmi;
     for (bmi = _bundle_msgs.begin(); bmi != _bundle_msgs.end(); bmi++) {
-      dg.add_string(*bmi);
+      // This is the same encoding as add_string().
+      dg.add_uint16((*bmi).get_length());
+      dg.append_data((*bmi).get_data(), (*bmi).get_length());
     }
 
     send_datagram(dg);
@@ -569,7 +571,7 @@ bundle_msg(const Datagram &dg) {
   ReMutexHolder holder(_lock);
 
   nassertv(is_bundling_messages());
-  _bundle_msgs.push_back(dg.get_message());
+  _bundle_msgs.push_back(dg);
 }
 
 ////////////////////////////////////////////////////////////////////
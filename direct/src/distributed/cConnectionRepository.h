@@ -26,6 +26,7 @@
 #include "clockObject.h"
 #include "reMutex.h"
 #include "reMutexHolder.h"
+#include "pvector.h"
 
 #ifdef HAVE_NET
 #include "queuedConnectionManager.h"
@@ -227,7 +228,9 @@ private:
 
   bool _want_message_bundling;
   unsigned int _bundling_msgs;
-  typedef std::vector< string > BundledMsgVector;
+  // The bundled datagrams share their buffers with the originals, so
+  // each message is copied only once, into the bundle itself.
+  typedef pvector<Datagram> BundledMsgVector;
   BundledMsgVector _bundle_msgs;
 
   static PStatCollector _update_pcollector;
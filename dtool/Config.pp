@@ -213,6 +213,14 @@
 // must be supplied to all executables in a given runtime session.
 #define PRC_EXECUTABLE_ARGS_ENVVAR PRC_EXECUTABLE_ARGS
 
+// Processes that start often may ask config to cache the parsed
+// contents of the prc files it reads, in a single file that is
+// consulted (and refreshed, if any prc file has changed) the next
+// time.  This names the environment variable that gives the
+// filename of that cache; if the variable is unset or empty, no
+// cache is used.
+#define PRC_CACHE_ENVVAR PANDA_PRC_CACHE
+
 // You can implement signed prc files, if you require this advanced
 // feature.  This allows certain config variables to be set only by a
 // prc file that has been provided by a trusted source.  To do this,
@@ -456,6 +464,12 @@
 // Normally, if you build NATIVE_NET, you will also build NET.
 #defer HAVE_NET $[WANT_NATIVE_NET]
 
+// Do you want the net package to use epoll() rather than select() to
+// wait for activity on its sockets?  This is only available on Linux,
+// and lifts the FD_SETSIZE limit on the number of connections a
+// single ConnectionReader can monitor.
+#defer HAVE_EPOLL $[and $[HAVE_NET],$[IS_LINUX]]
+
 // Do you want to build the egg loader?  Usually there's no reason to
 // avoid building this, unless you really want to make a low-footprint
 // build (such as, for instance, for the iPhone).
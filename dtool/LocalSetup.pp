@@ -491,6 +491,9 @@ $[cdefine USE_PANDAFILESTREAM]
 /* Define if we want to compile the net code.  */
 $[cdefine HAVE_NET]
 
+/* Define if the net code should use epoll() instead of select().  */
+$[cdefine HAVE_EPOLL]
+
 /* Define if we want to compile the egg code.  */
 $[cdefine HAVE_EGG]
 
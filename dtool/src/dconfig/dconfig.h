@@ -24,6 +24,7 @@
 #include "configVariableDouble.h"
 #include "configVariableList.h"
 #include "configFlags.h"
+#include "startupTrace.h"
 
 ////////////////////////////////////////////////////////////////////
 //       Class : DConfig
@@ -68,13 +69,21 @@ PUBLISHED:
 #define ConfigureDef(name) \
   class StaticInitializer_ ## name { \
   public: \
-    StaticInitializer_ ## name(); \
+    StaticInitializer_ ## name() { \
+      StartupTrace::Scope trace(#name); \
+      init(); \
+    } \
+    void init(); \
   }; \
   static StaticInitializer_ ## name name;
 #define DToolConfigureDef(name) \
   class StaticInitializer_ ## name { \
   public: \
-    StaticInitializer_ ## name(); \
+    StaticInitializer_ ## name() { \
+      StartupTrace::Scope trace(#name); \
+      init(); \
+    } \
+    void init(); \
   }; \
   static StaticInitializer_ ## name name;
 
@@ -86,11 +95,12 @@ PUBLISHED:
 
 // This one defines a block of code that will be executed at static
 // init time.  It must always be defined (in the C file), even if no
-// code is to be executed.
+// code is to be executed.  The time spent in each block is recorded
+// in the StartupTrace.
 
 #define ConfigureFn(name) \
-  StaticInitializer_ ## name::StaticInitializer_ ## name()
+  void StaticInitializer_ ## name::init()
 #define DToolConfigureFn(name) \
-  StaticInitializer_ ## name::StaticInitializer_ ## name()
+  void StaticInitializer_ ## name::init()
 
 #endif /* __CONFIG_H__ */
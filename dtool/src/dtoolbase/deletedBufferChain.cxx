@@ -15,6 +15,16 @@
 #include "deletedBufferChain.h"
 #include "memoryHook.h"
 
+#ifdef USE_DELETED_CHAIN_CACHE
+DeletedBufferChain *DeletedBufferChain::_cached_chains[DeletedBufferChain::max_cached_chains];
+TVOLATILE AtomicAdjust::Integer DeletedBufferChain::_num_cached_chains = 0;
+DeletedBufferChain::ThreadCache *DeletedBufferChain::_thread_caches = NULL;
+pthread_key_t DeletedBufferChain::_cache_key;
+pthread_once_t DeletedBufferChain::_cache_once = PTHREAD_ONCE_INIT;
+pthread_mutex_t DeletedBufferChain::_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+bool DeletedBufferChain::_cache_key_valid = false;
+#endif  // USE_DELETED_CHAIN_CACHE
+
 ////////////////////////////////////////////////////////////////////
 //     Function: DeletedBufferChain::Constructor
 //       Access: Protected
@@ -36,6 +46,23 @@ DeletedBufferChain(size_t buffer_size) {
   // reasons.
   _buffer_size = max(_buffer_size, sizeof(ObjectNode));
   _alloc_size = max(_alloc_size, sizeof(ObjectNode));
+
+#ifdef USE_DELETED_CHAIN_CACHE
+  // Each thread keeps up to about 8K worth of free buffers for this
+  // chain, but never fewer than a handful.
+  _magazine_size = (int)max((size_t)4, min((size_t)64, (size_t)8192 / _alloc_size));
+
+  pthread_mutex_lock(&_cache_lock);
+  int n = AtomicAdjust::get(_num_cached_chains);
+  if (n < (int)max_cached_chains) {
+    _index = n;
+    _cached_chains[n] = this;
+    AtomicAdjust::set(_num_cached_chains, n + 1);
+  } else {
+    _index = -1;
+  }
+  pthread_mutex_unlock(&_cache_lock);
+#endif  // USE_DELETED_CHAIN_CACHE
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -51,14 +78,36 @@ allocate(size_t size, TypeHandle type_handle) {
   //TAU_PROFILE("void *DeletedBufferChain::allocate(size_t, TypeHandle)", " ", TAU_USER);
   assert(size <= _buffer_size);
 
-  ObjectNode *obj;
+  ObjectNode *obj = NULL;
 
-  _lock.acquire();
-  if (_deleted_chain != (ObjectNode *)NULL) {
-    obj = _deleted_chain;
-    _deleted_chain = _deleted_chain->_next;
+#ifdef USE_DELETED_CHAIN_CACHE
+  if (_index >= 0) {
+    ThreadCache *cache = get_thread_cache();
+    Magazine &mag = cache->_magazines[_index];
+    if (mag._head != (ObjectNode *)NULL) {
+      ++cache->_hits;
+    } else {
+      ++cache->_misses;
+      refill_magazine(mag);
+    }
+    if (mag._head != (ObjectNode *)NULL) {
+      obj = mag._head;
+      mag._head = obj->_next;
+      --mag._count;
+    }
+
+  } else
+#endif  // USE_DELETED_CHAIN_CACHE
+  {
+    _lock.acquire();
+    if (_deleted_chain != (ObjectNode *)NULL) {
+      obj = _deleted_chain;
+      _deleted_chain = _deleted_chain->_next;
+    }
     _lock.release();
+  }
 
+  if (obj != (ObjectNode *)NULL) {
 #ifdef USE_DELETEDCHAINFLAG
     assert(obj->_flag == (AtomicAdjust::Integer)DCF_deleted);
     obj->_flag = DCF_alive;
@@ -73,7 +122,6 @@ allocate(size_t size, TypeHandle type_handle) {
 
     return ptr;
   }
-  _lock.release();
 
   // If we get here, the deleted_chain is empty; we have to allocate a
   // new object from the system pool.
@@ -128,6 +176,24 @@ deallocate(void *ptr, TypeHandle type_handle) {
   assert(orig_flag == (AtomicAdjust::Integer)DCF_alive);
 #endif  // USE_DELETEDCHAINFLAG
 
+#ifdef USE_DELETED_CHAIN_CACHE
+  if (_index >= 0) {
+    ThreadCache *cache = get_thread_cache();
+    Magazine &mag = cache->_magazines[_index];
+    obj->_next = mag._head;
+    mag._head = obj;
+    ++mag._count;
+    if (mag._count <= _magazine_size) {
+      ++cache->_hits;
+    } else {
+      // The magazine is full; return half of it to the shared chain.
+      ++cache->_misses;
+      flush_magazine(mag, _magazine_size / 2);
+    }
+    return;
+  }
+#endif  // USE_DELETED_CHAIN_CACHE
+
   _lock.acquire();
 
   obj->_next = _deleted_chain;
@@ -139,3 +205,234 @@ deallocate(void *ptr, TypeHandle type_handle) {
   PANDA_FREE_SINGLE(ptr);
 #endif  // USE_DELETED_CHAIN
 }
+
+////////////////////////////////////////////////////////////////////
+//     Function: DeletedBufferChain::get_num_thread_caches
+//       Access: Public, Static
+//  Description: Returns the number of per-thread buffer caches that
+//               have been created so far.  A cache slot is recycled
+//               when its thread exits, so this is the maximum number
+//               of threads that have simultaneously used a
+//               DeletedBufferChain.  This is always 0 if the
+//               per-thread caches are not compiled in.
+////////////////////////////////////////////////////////////////////
+int DeletedBufferChain::
+get_num_thread_caches() {
+#ifdef USE_DELETED_CHAIN_CACHE
+  int count = 0;
+  pthread_mutex_lock(&_cache_lock);
+  for (ThreadCache *cache = _thread_caches; 
+       cache != (ThreadCache *)NULL; 
+       cache = cache->_next) {
+    ++count;
+  }
+  pthread_mutex_unlock(&_cache_lock);
+  return count;
+#else
+  return 0;
+#endif  // USE_DELETED_CHAIN_CACHE
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: DeletedBufferChain::get_thread_cache_hits
+//       Access: Public, Static
+//  Description: Returns the number of allocations and deallocations
+//               through the nth thread cache that were satisfied
+//               without touching the shared chain.
+////////////////////////////////////////////////////////////////////
+size_t DeletedBufferChain::
+get_thread_cache_hits(int n) {
+#ifdef USE_DELETED_CHAIN_CACHE
+  ThreadCache *cache = find_thread_cache(n);
+  if (cache != (ThreadCache *)NULL) {
+    return cache->_hits;
+  }
+#endif  // USE_DELETED_CHAIN_CACHE
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: DeletedBufferChain::get_thread_cache_misses
+//       Access: Public, Static
+//  Description: Returns the number of allocations and deallocations
+//               through the nth thread cache that had to lock the
+//               shared chain to refill or drain a magazine.
+////////////////////////////////////////////////////////////////////
+size_t DeletedBufferChain::
+get_thread_cache_misses(int n) {
+#ifdef USE_DELETED_CHAIN_CACHE
+  ThreadCache *cache = find_thread_cache(n);
+  if (cache != (ThreadCache *)NULL) {
+    return cache->_misses;
+  }
+#endif  // USE_DELETED_CHAIN_CACHE
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: DeletedBufferChain::is_thread_cache_active
+//       Access: Public, Static
+//  Description: Returns true if the nth thread cache currently
+//               belongs to a running thread, or false if its thread
+//               has exited and the slot is waiting to be reused.
+////////////////////////////////////////////////////////////////////
+bool DeletedBufferChain::
+is_thread_cache_active(int n) {
+#ifdef USE_DELETED_CHAIN_CACHE
+  ThreadCache *cache = find_thread_cache(n);
+  if (cache != (ThreadCache *)NULL) {
+    return cache->_active;
+  }
+#endif  // USE_DELETED_CHAIN_CACHE
+  return false;
+}
+
+#ifdef USE_DELETED_CHAIN_CACHE
+////////////////////////////////////////////////////////////////////
+//     Function: DeletedBufferChain::make_thread_cache
+//       Access: Private, Static
+//  Description: Assigns a ThreadCache to the current thread, reusing
+//               one left behind by an exited thread if possible.
+////////////////////////////////////////////////////////////////////
+DeletedBufferChain::ThreadCache *DeletedBufferChain::
+make_thread_cache() {
+  pthread_once(&_cache_once, &st_init_thread_cache);
+
+  ThreadCache *cache = (ThreadCache *)pthread_getspecific(_cache_key);
+  if (cache != (ThreadCache *)NULL) {
+    return cache;
+  }
+
+  pthread_mutex_lock(&_cache_lock);
+  for (cache = _thread_caches; 
+       cache != (ThreadCache *)NULL && cache->_active; 
+       cache = cache->_next) {
+  }
+  if (cache == (ThreadCache *)NULL) {
+    // These are never freed, just like the buffers themselves.
+    cache = (ThreadCache *)NeverFreeMemory::alloc(sizeof(ThreadCache));
+    memset(cache, 0, sizeof(ThreadCache));
+    cache->_next = _thread_caches;
+    _thread_caches = cache;
+  }
+  cache->_active = true;
+  pthread_mutex_unlock(&_cache_lock);
+
+  pthread_setspecific(_cache_key, cache);
+  return cache;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: DeletedBufferChain::st_init_thread_cache
+//       Access: Private, Static
+//  Description: Called once, to create the thread-specific key.
+////////////////////////////////////////////////////////////////////
+void DeletedBufferChain::
+st_init_thread_cache() {
+  pthread_key_create(&_cache_key, &st_thread_exit);
+  _cache_key_valid = true;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: DeletedBufferChain::st_thread_exit
+//       Access: Private, Static
+//  Description: Called by pthreads when a thread that owns a
+//               ThreadCache exits.  Returns all of the cached buffers
+//               to their shared chains and releases the cache for
+//               reuse by a future thread.
+////////////////////////////////////////////////////////////////////
+void DeletedBufferChain::
+st_thread_exit(void *data) {
+  ThreadCache *cache = (ThreadCache *)data;
+  int num_chains = AtomicAdjust::get(_num_cached_chains);
+  for (int i = 0; i < num_chains; ++i) {
+    if (cache->_magazines[i]._head != (ObjectNode *)NULL) {
+      _cached_chains[i]->flush_magazine(cache->_magazines[i], 0);
+    }
+  }
+
+  pthread_mutex_lock(&_cache_lock);
+  cache->_active = false;
+  pthread_mutex_unlock(&_cache_lock);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: DeletedBufferChain::find_thread_cache
+//       Access: Private, Static
+//  Description: Returns the nth ThreadCache in the list, or NULL if n
+//               is out of range.
+////////////////////////////////////////////////////////////////////
+DeletedBufferChain::ThreadCache *DeletedBufferChain::
+find_thread_cache(int n) {
+  pthread_mutex_lock(&_cache_lock);
+  ThreadCache *cache = _thread_caches;
+  while (cache != (ThreadCache *)NULL && n > 0) {
+    cache = cache->_next;
+    --n;
+  }
+  pthread_mutex_unlock(&_cache_lock);
+  return cache;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: DeletedBufferChain::refill_magazine
+//       Access: Private
+//  Description: Moves up to half a magazine's worth of buffers from
+//               the shared chain into the indicated (empty) magazine,
+//               with a single acquisition of the lock.
+////////////////////////////////////////////////////////////////////
+void DeletedBufferChain::
+refill_magazine(Magazine &mag) {
+  int want = max(_magazine_size / 2, 1);
+
+  _lock.acquire();
+  while (want > 0 && _deleted_chain != (ObjectNode *)NULL) {
+    ObjectNode *obj = _deleted_chain;
+    _deleted_chain = obj->_next;
+    obj->_next = mag._head;
+    mag._head = obj;
+    ++mag._count;
+    --want;
+  }
+  _lock.release();
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: DeletedBufferChain::flush_magazine
+//       Access: Private
+//  Description: Returns all but keep buffers from the indicated
+//               magazine to the shared chain.
+////////////////////////////////////////////////////////////////////
+void DeletedBufferChain::
+flush_magazine(Magazine &mag, int keep) {
+  if (mag._count <= keep) {
+    return;
+  }
+
+  // Walk past the buffers we keep, outside the lock; the remainder
+  // is spliced onto the shared chain in one step.
+  ObjectNode *first;
+  if (keep == 0) {
+    first = mag._head;
+    mag._head = NULL;
+  } else {
+    ObjectNode *last_kept = mag._head;
+    for (int i = 1; i < keep; ++i) {
+      last_kept = last_kept->_next;
+    }
+    first = last_kept->_next;
+    last_kept->_next = NULL;
+  }
+  mag._count = keep;
+
+  ObjectNode *last = first;
+  while (last->_next != (ObjectNode *)NULL) {
+    last = last->_next;
+  }
+
+  _lock.acquire();
+  last->_next = _deleted_chain;
+  _deleted_chain = first;
+  _lock.release();
+}
+#endif  // USE_DELETED_CHAIN_CACHE
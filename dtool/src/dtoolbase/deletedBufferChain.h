@@ -38,6 +38,16 @@
 #define USE_DELETEDCHAINFLAG 1
 #endif // NDEBUG
 
+#if defined(USE_DELETED_CHAIN) && defined(THREAD_POSIX_IMPL)
+// When we have real posix threads, each thread keeps a small
+// "magazine" of free buffers for each chain, so that most allocations
+// and deallocations never need to touch the shared mutex.  The
+// magazines are refilled from (and returned to) the shared chain in
+// batches.
+#define USE_DELETED_CHAIN_CACHE 1
+#include <pthread.h>
+#endif
+
 #ifdef USE_DELETEDCHAINFLAG
 enum DeletedChainFlag {
   DCF_deleted = 0xfeedba0f,
@@ -61,6 +71,10 @@ enum DeletedChainFlag {
 //
 //               Use MemoryHook to get a new DeletedBufferChain of a
 //               particular size.
+//
+//               When USE_DELETED_CHAIN_CACHE is defined, each thread
+//               also caches a handful of free buffers per chain, to
+//               reduce contention on the chain's mutex.
 ////////////////////////////////////////////////////////////////////
 class EXPCL_DTOOL DeletedBufferChain {
 protected:
@@ -73,6 +87,11 @@ public:
   INLINE bool validate(void *ptr);
   INLINE size_t get_buffer_size() const;
 
+  static int get_num_thread_caches();
+  static size_t get_thread_cache_hits(int n);
+  static size_t get_thread_cache_misses(int n);
+  static bool is_thread_cache_active(int n);
+
 private:
   class ObjectNode {
   public:
@@ -101,6 +120,52 @@ private:
   size_t _buffer_size;
   size_t _alloc_size;
 
+#ifdef USE_DELETED_CHAIN_CACHE
+  // A per-thread stack of free buffers belonging to one chain.
+  class Magazine {
+  public:
+    ObjectNode *_head;
+    int _count;
+  };
+
+  // The maximum number of distinct chains that may have per-thread
+  // magazines.  Chains created beyond this go straight to the shared
+  // list.
+  enum { max_cached_chains = 128 };
+
+  // One of these is allocated for each thread that touches a cached
+  // chain.  When the thread exits, its ThreadCache is flushed and
+  // made available to the next new thread.
+  class ThreadCache {
+  public:
+    Magazine _magazines[max_cached_chains];
+    size_t _hits;
+    size_t _misses;
+    bool _active;
+    ThreadCache *_next;
+  };
+
+  INLINE static ThreadCache *get_thread_cache();
+  static ThreadCache *make_thread_cache();
+  static void st_init_thread_cache();
+  static void st_thread_exit(void *data);
+  static ThreadCache *find_thread_cache(int n);
+
+  void refill_magazine(Magazine &mag);
+  void flush_magazine(Magazine &mag, int keep);
+
+  int _index;
+  int _magazine_size;
+
+  static DeletedBufferChain *_cached_chains[max_cached_chains];
+  static TVOLATILE AtomicAdjust::Integer _num_cached_chains;
+  static ThreadCache *_thread_caches;
+  static pthread_key_t _cache_key;
+  static pthread_once_t _cache_once;
+  static bool _cache_key_valid;
+  static pthread_mutex_t _cache_lock;
+#endif  // USE_DELETED_CHAIN_CACHE
+
   friend class MemoryHook;
 };
 
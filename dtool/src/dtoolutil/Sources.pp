@@ -24,6 +24,7 @@
     panda_getopt.h panda_getopt_long.h panda_getopt_impl.h \
     pfstream.h pfstream.I pfstreamBuf.h \
     preprocess_argv.h \
+    startupTrace.h \
     stringDecoder.h stringDecoder.I \
     textEncoder.h textEncoder.I \
     unicodeLatinMap.h \
@@ -43,6 +44,7 @@
     panda_getopt_impl.cxx \
     pfstreamBuf.cxx pfstream.cxx \
     preprocess_argv.cxx \
+    startupTrace.cxx \
     stringDecoder.cxx \
     textEncoder.cxx \
     unicodeLatinMap.cxx \
@@ -63,6 +65,7 @@
     panda_getopt.h panda_getopt_long.h panda_getopt_impl.h \
     pfstream.h pfstream.I pfstreamBuf.h \
     preprocess_argv.h \
+    startupTrace.h \
     stringDecoder.h stringDecoder.I \
     textEncoder.h textEncoder.I \
     unicodeLatinMap.h \
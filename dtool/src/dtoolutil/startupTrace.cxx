@@ -0,0 +1,266 @@
+// Filename: startupTrace.cxx
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#include "startupTrace.h"
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#undef WIN32_LEAN_AND_MEAN
+#else
+#include <sys/time.h>
+#endif
+
+#include <iomanip>
+
+// These are plain pointers and PODs, so that they are valid before
+// any static constructors have run.
+StartupTrace::Entries *StartupTrace::_entries = NULL;
+int StartupTrace::_depth = 0;
+int StartupTrace::_generation = 0;
+MutexImpl *StartupTrace::_lock = NULL;
+
+////////////////////////////////////////////////////////////////////
+//     Function: StartupTrace::get_num_entries
+//       Access: Published, Static
+//  Description: Returns the number of steps that have been recorded.
+////////////////////////////////////////////////////////////////////
+int StartupTrace::
+get_num_entries() {
+  init_lock();
+  _lock->acquire();
+  int num_entries = (_entries == (Entries *)NULL) ? 0 : (int)_entries->size();
+  _lock->release();
+  return num_entries;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: StartupTrace::get_entry_name
+//       Access: Published, Static
+//  Description: Returns the name of the nth recorded step.  For a
+//               static-init block, this is the name given to
+//               ConfigureFn(), e.g. "config_pgraph".
+////////////////////////////////////////////////////////////////////
+string StartupTrace::
+get_entry_name(int n) {
+  init_lock();
+  _lock->acquire();
+  assert(_entries != (Entries *)NULL && n >= 0 && n < (int)_entries->size());
+  string name = (*_entries)[n]._name;
+  _lock->release();
+  return name;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: StartupTrace::get_entry_depth
+//       Access: Published, Static
+//  Description: Returns the number of other steps that were in
+//               progress when the nth step began.
+////////////////////////////////////////////////////////////////////
+int StartupTrace::
+get_entry_depth(int n) {
+  init_lock();
+  _lock->acquire();
+  assert(_entries != (Entries *)NULL && n >= 0 && n < (int)_entries->size());
+  int depth = (*_entries)[n]._depth;
+  _lock->release();
+  return depth;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: StartupTrace::get_entry_time
+//       Access: Published, Static
+//  Description: Returns the elapsed time in seconds of the nth step,
+//               including any steps nested within it.  This is 0 if
+//               the step has not yet finished.
+////////////////////////////////////////////////////////////////////
+double StartupTrace::
+get_entry_time(int n) {
+  init_lock();
+  _lock->acquire();
+  assert(_entries != (Entries *)NULL && n >= 0 && n < (int)_entries->size());
+  double time = (*_entries)[n]._time;
+  _lock->release();
+  return time;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: StartupTrace::get_total_time
+//       Access: Published, Static
+//  Description: Returns the total elapsed time in seconds of all of
+//               the outermost steps.
+////////////////////////////////////////////////////////////////////
+double StartupTrace::
+get_total_time() {
+  init_lock();
+  _lock->acquire();
+  double total = 0.0;
+  if (_entries != (Entries *)NULL) {
+    Entries::const_iterator ei;
+    for (ei = _entries->begin(); ei != _entries->end(); ++ei) {
+      if ((*ei)._depth == 0) {
+        total += (*ei)._time;
+      }
+    }
+  }
+  _lock->release();
+  return total;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: StartupTrace::reset
+//       Access: Published, Static
+//  Description: Discards all of the recorded steps.  Steps that are
+//               still in progress are not recorded when they finish.
+//               This is called when the prc files are reloaded, so
+//               that the trace describes only the most recent load.
+////////////////////////////////////////////////////////////////////
+void StartupTrace::
+reset() {
+  init_lock();
+  _lock->acquire();
+  if (_entries != (Entries *)NULL) {
+    _entries->clear();
+  }
+  ++_generation;
+  _lock->release();
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: StartupTrace::write
+//       Access: Published, Static
+//  Description: Writes each recorded step with its elapsed time in
+//               milliseconds, one per line, in the order the steps
+//               were begun.
+////////////////////////////////////////////////////////////////////
+void StartupTrace::
+write(ostream &out) {
+  // Copy the entries out first, so that we don't hold the lock while
+  // writing to the stream.
+  init_lock();
+  _lock->acquire();
+  Entries entries;
+  if (_entries != (Entries *)NULL) {
+    entries = *_entries;
+  }
+  _lock->release();
+
+  double total = 0.0;
+  Entries::const_iterator ei;
+  for (ei = entries.begin(); ei != entries.end(); ++ei) {
+    const Entry &entry = (*ei);
+    out << setw(10) << fixed << setprecision(3) << entry._time * 1000.0
+        << " ms  ";
+    for (int d = 0; d < entry._depth; ++d) {
+      out << "  ";
+    }
+    out << entry._name << "\n";
+    if (entry._depth == 0) {
+      total += entry._time;
+    }
+  }
+  out << setw(10) << fixed << setprecision(3) << total * 1000.0
+      << " ms  total\n";
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: StartupTrace::list
+//       Access: Published, Static
+//  Description: Writes the recorded steps to standard error.  See
+//               write().
+////////////////////////////////////////////////////////////////////
+void StartupTrace::
+list() {
+  write(cerr);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: StartupTrace::get_real_time
+//       Access: Public, Static
+//  Description: Returns a wall-clock time in seconds, from an
+//               arbitrary starting point.  This is a minimal
+//               substitute for TrueClock, which is not available
+//               this low in the tree.
+////////////////////////////////////////////////////////////////////
+double StartupTrace::
+get_real_time() {
+#ifdef WIN32
+  LARGE_INTEGER count, frequency;
+  QueryPerformanceCounter(&count);
+  QueryPerformanceFrequency(&frequency);
+  return (double)count.QuadPart / (double)frequency.QuadPart;
+#else
+  struct timeval tv;
+  gettimeofday(&tv, (struct timezone *)NULL);
+  return (double)tv.tv_sec + (double)tv.tv_usec / 1000000.0;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: StartupTrace::init_lock
+//       Access: Private, Static
+//  Description: Ensures the lock pointer has been allocated.  The
+//               first call happens during static init, before any
+//               threads have been spawned.
+////////////////////////////////////////////////////////////////////
+void StartupTrace::
+init_lock() {
+  if (_lock == (MutexImpl *)NULL) {
+    _lock = new MutexImpl;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: StartupTrace::Scope::Constructor
+//       Access: Public
+//  Description: Begins a new step.  The name must be a string
+//               literal, or otherwise remain valid for the life of
+//               the process.
+////////////////////////////////////////////////////////////////////
+StartupTrace::Scope::
+Scope(const char *name) {
+  init_lock();
+  _lock->acquire();
+  if (_entries == (Entries *)NULL) {
+    _entries = new Entries;
+  }
+  Entry entry;
+  entry._name = name;
+  entry._depth = _depth;
+  entry._time = 0.0;
+  _index = _entries->size();
+  _generation = StartupTrace::_generation;
+  _entries->push_back(entry);
+  ++_depth;
+  _lock->release();
+
+  _start = get_real_time();
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: StartupTrace::Scope::Destructor
+//       Access: Public
+//  Description: Ends the step, and records its elapsed time, unless
+//               the trace has been reset in the meantime.
+////////////////////////////////////////////////////////////////////
+StartupTrace::Scope::
+~Scope() {
+  double elapsed = get_real_time() - _start;
+  _lock->acquire();
+  if (_generation == StartupTrace::_generation) {
+    (*_entries)[_index]._time = elapsed;
+  }
+  --_depth;
+  _lock->release();
+}
@@ -0,0 +1,86 @@
+// Filename: startupTrace.h
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include "dtoolbase.h"
+#include "mutexImpl.h"
+
+#include <vector>
+
+////////////////////////////////////////////////////////////////////
+//       Class : StartupTrace
+// Description : Records the wall-clock time spent in each of the
+//               static-init blocks (ConfigureFn) and in a handful of
+//               other expensive startup steps, such as loading the
+//               prc files.  The entries are recorded unconditionally,
+//               since there are only a few dozen of them, and may be
+//               written out on demand with write().
+//
+//               Entries are kept in the order they were begun, with
+//               a nesting depth, so that a step begun within another
+//               step is listed indented beneath it.  Each time is
+//               inclusive of the nested steps.  The depth is shared
+//               by all threads, so steps recorded from several
+//               threads at once may be indented unexpectedly, but
+//               the list itself is protected by a lock.
+////////////////////////////////////////////////////////////////////
+class EXPCL_DTOOL StartupTrace {
+PUBLISHED:
+  static int get_num_entries();
+  static string get_entry_name(int n);
+  static int get_entry_depth(int n);
+  static double get_entry_time(int n);
+  MAKE_SEQ(get_entry_names, get_num_entries, get_entry_name);
+
+  static double get_total_time();
+
+  static void reset();
+
+  static void write(ostream &out);
+  static void list();
+
+public:
+  static double get_real_time();
+
+  class EXPCL_DTOOL Scope {
+  public:
+    Scope(const char *name);
+    ~Scope();
+
+  private:
+    size_t _index;
+    int _generation;
+    double _start;
+  };
+
+private:
+  class Entry {
+  public:
+    const char *_name;
+    int _depth;
+    double _time;
+  };
+  typedef vector<Entry> Entries;
+
+  static void init_lock();
+
+  static Entries *_entries;
+  static int _depth;
+  static int _generation;
+  static MutexImpl *_lock;
+};
+
+#endif
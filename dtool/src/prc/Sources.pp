@@ -15,6 +15,7 @@
     configFlags.I configFlags.h \
     configPage.I configPage.h \
     configPageManager.I configPageManager.h \
+    configSnapshot.I configSnapshot.h \
     configVariable.I configVariable.h \
     configVariableBase.I configVariableBase.h \
     configVariableBool.I configVariableBool.h \
@@ -50,6 +51,7 @@
     configFlags.cxx \
     configPage.cxx \
     configPageManager.cxx \
+    configSnapshot.cxx \
     configVariable.cxx \
     configVariableBase.cxx \
     configVariableBool.cxx \
@@ -79,6 +81,7 @@
     configFlags.I configFlags.h \
     configPage.I configPage.h \
     configPageManager.I configPageManager.h \
+    configSnapshot.I configSnapshot.h \
     configVariable.I configVariable.h \
     configVariableBase.I configVariableBase.h \
     configVariableBool.I configVariableBool.h \
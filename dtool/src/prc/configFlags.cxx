@@ -15,6 +15,21 @@
 #include "configFlags.h"
 
 TVOLATILE AtomicAdjust::Integer ConfigFlags::_global_modified;
+bool ConfigFlags::_tracking_reads = false;
+
+////////////////////////////////////////////////////////////////////
+//     Function: ConfigFlags::set_tracking_reads
+//       Access: Protected, Static
+//  Description: Enables or disables the counting of ConfigVariable
+//               reads.  All of the caches are invalidated, so that
+//               variables that were cached before the change pick up
+//               the new mode on their next read.
+////////////////////////////////////////////////////////////////////
+void ConfigFlags::
+set_tracking_reads(bool flag) {
+  _tracking_reads = flag;
+  invalidate_cache();
+}
 
 ////////////////////////////////////////////////////////////////////
 //     Function: ConfigFlags::Type output operator
@@ -66,8 +66,14 @@ protected:
   INLINE static AtomicAdjust::Integer initial_invalid_cache();
   INLINE static void invalidate_cache();
 
+  INLINE static bool is_tracking_reads();
+  static void set_tracking_reads(bool flag);
+
 private:
   static TVOLATILE AtomicAdjust::Integer _global_modified;
+  static bool _tracking_reads;
+
+  friend class ConfigVariableManager;
 };
 
 ostream &operator << (ostream &out, ConfigFlags::ValueType type);
@@ -24,6 +24,7 @@
 #include "pandaSystem.h"
 #include "textEncoder.h"
 #include "stringDecoder.h"
+#include "startupTrace.h"
 
 // This file is generated by ppremake.
 #include "prc_parameters.h"
@@ -38,6 +39,12 @@
 #include <algorithm>
 #include <ctype.h>
 
+#ifdef WIN32
+#include <process.h>  // for _getpid()
+#else
+#include <unistd.h>   // for getpid()
+#endif
+
 ConfigPageManager *ConfigPageManager::_global_ptr = NULL;
 
 ////////////////////////////////////////////////////////////////////
@@ -92,6 +99,13 @@ reload_implicit_pages() {
     return;
   }
   _currently_loading = true;
+  if (_loaded_implicit) {
+    // This is a reload, not the first load at startup; discard the
+    // startup steps already recorded, so the trace doesn't keep
+    // growing.
+    StartupTrace::reset();
+  }
+  StartupTrace::Scope trace("reload_implicit_pages");
 
   // First, remove all the previously-loaded pages.
   Pages::iterator pi;
@@ -308,6 +322,23 @@ reload_implicit_pages() {
     }
   }
 
+  // If PRC_CACHE_ENVVAR names a cache file, we can take the contents
+  // of the unchanged files from there, rather than reading and
+  // parsing each one.
+  Filename cache_filename;
+  PrcCache prc_cache, new_prc_cache;
+  bool cache_changed = false;
+  string prc_cache_envvar = PRC_CACHE_ENVVAR;
+  if (!prc_cache_envvar.empty()) {
+    string cache_name = ExecutionEnvironment::get_environment_variable(prc_cache_envvar);
+    if (!cache_name.empty()) {
+      cache_filename = Filename::from_os_specific(cache_name);
+      if (!read_prc_cache(cache_filename, prc_cache)) {
+        cache_changed = true;
+      }
+    }
+  }
+
   // Now we have a list of filenames in order from most important to
   // least important.  Walk through the list in reverse order to load
   // their contents, because we want the first file in the list (the
@@ -360,7 +391,7 @@ reload_implicit_pages() {
     } else if ((file._file_flags & FF_read) != 0) {
       // Just read the file.
       filename.set_text();
-      
+
       pifstream in;
       if (!filename.open_read(in)) {
         prc_cat.error()
@@ -370,12 +401,39 @@ reload_implicit_pages() {
         ++i;
         _implicit_pages.push_back(page);
         _pages_sorted = false;
-        
-        page->read_prc(in);
+
+        if (cache_filename.empty()) {
+          page->read_prc(in);
+
+        } else {
+          // Read the whole file first, so that its contents can be
+          // checked against the cache.  Only the parsing is skipped
+          // when the cache matches.
+          ostringstream contents_strm;
+          contents_strm << in.rdbuf();
+          string contents = contents_strm.str();
+          PN_uint64 hash = hash_prc_contents(contents);
+
+          if (!load_cached_page(filename, contents.size(), hash, prc_cache,
+                                new_prc_cache, page)) {
+            istringstream contents_in(contents);
+            page->read_prc(contents_in);
+
+            if (record_cached_page(filename, contents.size(), hash, page,
+                                   new_prc_cache)) {
+              cache_changed = true;
+            }
+          }
+        }
       }
     }
   }
 
+  if (!cache_filename.empty() &&
+      (cache_changed || new_prc_cache.size() != prc_cache.size())) {
+    write_prc_cache(cache_filename, new_prc_cache);
+  }
+
   if (!_loaded_implicit) {
     config_initialized();
     _loaded_implicit = true;
@@ -651,6 +709,241 @@ scan_up_from(Filename &result, const Filename &dir,
   return scan_up_from(result, parent, suffix);
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: ConfigPageManager::load_cached_page
+//       Access: Private, Static
+//  Description: If the cache contains an entry for the indicated prc
+//               file, and the size and hash of the file's contents
+//               still match the entry, fills the page with the cached
+//               declarations, copies the entry to new_cache, and
+//               returns true.  Otherwise, returns false, and the file
+//               should be parsed normally.
+//
+//               The contents are compared rather than the
+//               modification time, which has only one-second
+//               resolution on many filesystems and so can't tell
+//               apart two same-sized edits within the same second.
+////////////////////////////////////////////////////////////////////
+bool ConfigPageManager::
+load_cached_page(const Filename &filename, size_t size, PN_uint64 hash,
+                 const PrcCache &cache, PrcCache &new_cache,
+                 ConfigPage *page) {
+  PrcCache::const_iterator ci = cache.find(filename.get_fullpath());
+  if (ci == cache.end()) {
+    return false;
+  }
+  const CachedPage &cached = (*ci).second;
+  if (cached._size != size || cached._hash != hash) {
+    return false;
+  }
+
+  CachedPage::Declarations::const_iterator di;
+  for (di = cached._declarations.begin();
+       di != cached._declarations.end();
+       ++di) {
+    page->make_declaration((*di).first, (*di).second);
+  }
+
+  new_cache[(*ci).first] = cached;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: ConfigPageManager::record_cached_page
+//       Access: Private, Static
+//  Description: Adds the declarations of a freshly-read page to the
+//               cache, so that they may be used by the next process
+//               that starts up.  Signed pages are not cached, since
+//               the cache file is not itself signed and the trust
+//               level could not be verified.  Returns true if the
+//               page was added, or false if it was skipped.
+////////////////////////////////////////////////////////////////////
+bool ConfigPageManager::
+record_cached_page(const Filename &filename, size_t size, PN_uint64 hash,
+                   const ConfigPage *page, PrcCache &cache) {
+  if (page->get_trust_level() != 0 || !page->get_signature().empty()) {
+    return false;
+  }
+
+  CachedPage &cached = cache[filename.get_fullpath()];
+  cached._size = size;
+  cached._hash = hash;
+  cached._declarations.clear();
+
+  int num_declarations = page->get_num_declarations();
+  cached._declarations.reserve(num_declarations);
+  for (int i = 0; i < num_declarations; ++i) {
+    cached._declarations.push_back
+      (pair<string, string>(page->get_variable_name(i),
+                            page->get_string_value(i)));
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: ConfigPageManager::read_prc_cache
+//       Access: Private, Static
+//  Description: Reads the prc cache file written by a previous
+//               process into the indicated map.  Returns true on
+//               success, or false if the file does not exist or is
+//               not a valid cache file (in which case the map is left
+//               empty).
+//
+//               The file is a simple text file: a "page" line with
+//               the size, content hash, number of declarations, and
+//               name of each prc file, followed by a "d" line for each of
+//               its declarations, and finally an "end" line with the
+//               number of pages.  A file that was cut short is
+//               rejected.
+////////////////////////////////////////////////////////////////////
+bool ConfigPageManager::
+read_prc_cache(const Filename &cache_filename, PrcCache &cache) {
+  Filename filename = cache_filename;
+  filename.set_text();
+
+  pifstream in;
+  if (!filename.open_read(in)) {
+    return false;
+  }
+
+  string line;
+  if (!getline(in, line) || line != "prc-cache 3") {
+    return false;
+  }
+
+  CachedPage *cached = NULL;
+  size_t expected_declarations = 0;
+  while (getline(in, line)) {
+    if (line.substr(0, 5) == "page ") {
+      // page <size> <hash> <num_declarations> <filename>
+      if (cached != (CachedPage *)NULL &&
+          cached->_declarations.size() != expected_declarations) {
+        break;
+      }
+      size_t p = line.find(' ', 5);
+      size_t q = (p == string::npos) ? p : line.find(' ', p + 1);
+      size_t r = (q == string::npos) ? q : line.find(' ', q + 1);
+      if (r == string::npos) {
+        break;
+      }
+      cached = &cache[line.substr(r + 1)];
+      cached->_size = (size_t)atol(line.substr(5, p - 5).c_str());
+      cached->_hash = 0;
+      istringstream hash_strm(line.substr(p + 1, q - p - 1));
+      hash_strm >> hex >> cached->_hash;
+      expected_declarations = (size_t)atol(line.substr(q + 1, r - q - 1).c_str());
+      cached->_declarations.clear();
+      cached->_declarations.reserve(expected_declarations);
+
+    } else if (line.substr(0, 2) == "d " && cached != (CachedPage *)NULL) {
+      // d <variable> <value>
+      size_t p = line.find(' ', 2);
+      if (p == string::npos) {
+        cached->_declarations.push_back
+          (pair<string, string>(line.substr(2), string()));
+      } else {
+        cached->_declarations.push_back
+          (pair<string, string>(line.substr(2, p - 2), line.substr(p + 1)));
+      }
+
+    } else if (line.substr(0, 4) == "end ") {
+      // end <num_pages>
+      if ((cached == (CachedPage *)NULL ||
+           cached->_declarations.size() == expected_declarations) &&
+          (size_t)atol(line.substr(4).c_str()) == cache.size()) {
+        return true;
+      }
+      break;
+
+    } else {
+      break;
+    }
+  }
+
+  // Either the file is malformed, or we reached the end of it without
+  // seeing the "end" line, so it was truncated.
+  prc_cat.warning()
+    << "Ignoring invalid prc cache " << filename << "\n";
+  cache.clear();
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: ConfigPageManager::write_prc_cache
+//       Access: Private, Static
+//  Description: Rewrites the prc cache file with the indicated
+//               contents.  The file is written under a temporary name
+//               first and then renamed into place, so that another
+//               process starting at the same time never sees a
+//               partially-written cache.  The temporary name
+//               includes the process id, so that processes starting
+//               together don't write into the same temporary file.
+////////////////////////////////////////////////////////////////////
+void ConfigPageManager::
+write_prc_cache(const Filename &cache_filename, const PrcCache &cache) {
+#ifdef WIN32
+  int pid = _getpid();
+#else
+  int pid = getpid();
+#endif
+
+  // Put the temporary file in the same directory as the cache, so
+  // that it can be renamed into place.
+  string dirname = cache_filename.get_dirname();
+  if (dirname.empty()) {
+    dirname = ".";
+  }
+  ostringstream prefix;
+  prefix << cache_filename.get_basename() << "." << pid << ".";
+  Filename temp_filename = Filename::temporary(dirname, prefix.str(), ".tmp");
+  temp_filename.set_text();
+
+  pofstream out;
+  if (!temp_filename.open_write(out)) {
+    prc_cat.warning()
+      << "Unable to write " << temp_filename << "\n";
+    return;
+  }
+
+  out << "prc-cache 3\n";
+  PrcCache::const_iterator ci;
+  for (ci = cache.begin(); ci != cache.end(); ++ci) {
+    const CachedPage &cached = (*ci).second;
+    out << "page " << cached._size << " " << hex << cached._hash << dec
+        << " " << cached._declarations.size() << " " << (*ci).first << "\n";
+
+    CachedPage::Declarations::const_iterator di;
+    for (di = cached._declarations.begin();
+         di != cached._declarations.end();
+         ++di) {
+      out << "d " << (*di).first << " " << (*di).second << "\n";
+    }
+  }
+  out << "end " << cache.size() << "\n";
+  out.close();
+
+  if (out.fail() || !temp_filename.rename_to(cache_filename)) {
+    temp_filename.unlink();
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: ConfigPageManager::hash_prc_contents
+//       Access: Private, Static
+//  Description: Returns a 64-bit FNV-1a hash of the contents of a prc
+//               file, for recognizing an unchanged file in the prc
+//               cache.
+////////////////////////////////////////////////////////////////////
+PN_uint64 ConfigPageManager::
+hash_prc_contents(const string &contents) {
+  PN_uint64 hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < contents.size(); ++i) {
+    hash ^= (unsigned char)contents[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: ConfigPageManager::config_initialized
 //       Access: Private
@@ -22,6 +22,7 @@
 #include "pnotify.h"
 
 #include <vector>
+#include <map>
 
 class ConfigPage;
 
@@ -79,6 +80,26 @@ private:
 
   void config_initialized();
 
+  class CachedPage {
+  public:
+    size_t _size;
+    PN_uint64 _hash;
+    typedef vector<pair<string, string> > Declarations;
+    Declarations _declarations;
+  };
+  typedef map<string, CachedPage> PrcCache;
+
+  static bool load_cached_page(const Filename &filename, size_t size,
+                               PN_uint64 hash, const PrcCache &cache,
+                               PrcCache &new_cache, ConfigPage *page);
+  static bool record_cached_page(const Filename &filename, size_t size,
+                                 PN_uint64 hash, const ConfigPage *page,
+                                 PrcCache &cache);
+  static bool read_prc_cache(const Filename &cache_filename, PrcCache &cache);
+  static void write_prc_cache(const Filename &cache_filename,
+                              const PrcCache &cache);
+  static PN_uint64 hash_prc_contents(const string &contents);
+
   typedef vector<ConfigPage *> Pages;
   Pages _implicit_pages;
   Pages _explicit_pages;
@@ -0,0 +1,112 @@
+// Filename: configSnapshot.cxx
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#include "configSnapshot.h"
+
+ConfigSnapshot *ConfigSnapshot::_first = NULL;
+AtomicAdjust::Integer ConfigSnapshot::_local_modified = -1;
+bool ConfigSnapshot::_frozen = false;
+
+////////////////////////////////////////////////////////////////////
+//     Function: ConfigSnapshot::Constructor
+//       Access: Protected
+//  Description: Adds the snapshot to the global list, so that it
+//               will be updated by refresh_all().
+////////////////////////////////////////////////////////////////////
+ConfigSnapshot::
+ConfigSnapshot() :
+  _prev(NULL),
+  _next(_first)
+{
+  if (_first != (ConfigSnapshot *)NULL) {
+    _first->_prev = this;
+  }
+  _first = this;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: ConfigSnapshot::Destructor
+//       Access: Protected, Virtual
+//  Description: Removes the snapshot from the global list.
+////////////////////////////////////////////////////////////////////
+ConfigSnapshot::
+~ConfigSnapshot() {
+  if (_prev != (ConfigSnapshot *)NULL) {
+    _prev->_next = _next;
+  } else {
+    _first = _next;
+  }
+  if (_next != (ConfigSnapshot *)NULL) {
+    _next->_prev = _prev;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: ConfigSnapshot::set_frozen
+//       Access: Published, Static
+//  Description: Freezes or thaws all of the ConfigSnapshots.  While
+//               they are frozen, a snapshot holds the value its
+//               ConfigVariable had at the last check_all() or
+//               refresh_all(), and reading it costs no more than
+//               reading a member variable.  While they are thawed
+//               (the default), a snapshot reads its ConfigVariable
+//               each time, so changes take effect immediately.
+//
+//               Only freeze the snapshots if the configuration does
+//               not change at runtime, or if it is acceptable for a
+//               change not to take effect until the next frame.
+////////////////////////////////////////////////////////////////////
+void ConfigSnapshot::
+set_frozen(bool frozen) {
+  if (frozen && !_frozen) {
+    refresh_all();
+  }
+  _frozen = frozen;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: ConfigSnapshot::refresh_all
+//       Access: Published, Static
+//  Description: Unconditionally copies the current value of every
+//               ConfigVariable into its ConfigSnapshot.  Normally
+//               you would call check_all() instead, which only does
+//               this when something has changed.
+////////////////////////////////////////////////////////////////////
+void ConfigSnapshot::
+refresh_all() {
+  mark_cache_valid(_local_modified);
+
+  for (ConfigSnapshot *snapshot = _first;
+       snapshot != (ConfigSnapshot *)NULL;
+       snapshot = snapshot->_next) {
+    snapshot->do_refresh();
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: ConfigSnapshot::get_num_snapshots
+//       Access: Published, Static
+//  Description: Returns the number of ConfigSnapshots currently in
+//               existence.
+////////////////////////////////////////////////////////////////////
+int ConfigSnapshot::
+get_num_snapshots() {
+  int count = 0;
+  for (ConfigSnapshot *snapshot = _first;
+       snapshot != (ConfigSnapshot *)NULL;
+       snapshot = snapshot->_next) {
+    ++count;
+  }
+  return count;
+}
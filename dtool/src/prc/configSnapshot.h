@@ -0,0 +1,104 @@
+// Filename: configSnapshot.h
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#ifndef CONFIGSNAPSHOT_H
+#define CONFIGSNAPSHOT_H
+
+#include "dtoolbase.h"
+#include "configFlags.h"
+#include "configVariableBool.h"
+#include "configVariableInt.h"
+#include "configVariableDouble.h"
+
+////////////////////////////////////////////////////////////////////
+//       Class : ConfigSnapshot
+// Description : This is the base class of a plain copy of the value
+//               of a ConfigVariable, for variables that are
+//               consulted so often (for instance, once per node
+//               during the cull traversal, or once per compose
+//               operation) that even the cached lookup in
+//               ConfigVariable::get_value() shows up in profiles.
+//
+//               By default, reading a ConfigSnapshot simply reads
+//               the ConfigVariable, so a change to the variable takes
+//               effect immediately, as usual.  An application whose
+//               configuration does not change while it runs may call
+//               set_frozen(true); from then on, reading a snapshot is
+//               just a load of a member variable, and does not
+//               consult the global modified counter.  The price is
+//               that a change to the underlying ConfigVariable
+//               (either by loading a new prc file or by a local
+//               assignment) is not noticed until the next call to
+//               check_all(), which the GraphicsEngine makes once at
+//               the start of each frame.
+//
+//               A ConfigSnapshot must be constructed after the
+//               ConfigVariable it copies; typically it is defined
+//               immediately after it in the same config_*.cxx file.
+////////////////////////////////////////////////////////////////////
+class EXPCL_DTOOLCONFIG ConfigSnapshot : public ConfigFlags {
+protected:
+  ConfigSnapshot();
+  virtual ~ConfigSnapshot();
+
+PUBLISHED:
+  static void set_frozen(bool frozen);
+  INLINE static bool is_frozen();
+
+  INLINE static void check_all();
+  static void refresh_all();
+  static int get_num_snapshots();
+
+protected:
+  virtual void do_refresh()=0;
+
+private:
+  ConfigSnapshot *_prev;
+  ConfigSnapshot *_next;
+
+  static ConfigSnapshot *_first;
+  static AtomicAdjust::Integer _local_modified;
+
+protected:
+  static bool _frozen;
+};
+
+////////////////////////////////////////////////////////////////////
+//       Class : ConfigSnapshotValue
+// Description : A ConfigSnapshot of one particular typed
+//               ConfigVariable.  Use one of the typedefs below.
+////////////////////////////////////////////////////////////////////
+template<class VarType, class Type>
+class ConfigSnapshotValue : public ConfigSnapshot {
+public:
+  INLINE ConfigSnapshotValue(const VarType &var);
+
+  INLINE operator Type () const;
+  INLINE Type get_value() const;
+
+protected:
+  virtual void do_refresh();
+
+private:
+  const VarType &_var;
+  Type _value;
+};
+
+typedef ConfigSnapshotValue<ConfigVariableBool, bool> ConfigSnapshotBool;
+typedef ConfigSnapshotValue<ConfigVariableInt, int> ConfigSnapshotInt;
+typedef ConfigSnapshotValue<ConfigVariableDouble, double> ConfigSnapshotDouble;
+
+#include "configSnapshot.I"
+
+#endif
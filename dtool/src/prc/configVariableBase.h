@@ -70,6 +70,7 @@ PUBLISHED:
   INLINE void write(ostream &out) const;
 
 protected:
+  INLINE void record_read() const;
   void record_unconstructed() const;
   bool was_unconstructed() const;
 
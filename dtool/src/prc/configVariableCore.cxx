@@ -40,7 +40,8 @@ ConfigVariableCore(const string &name) :
   _default_value(NULL),
   _local_value(NULL),
   _declarations_sorted(true),
-  _value_queried(false)
+  _value_queried(false),
+  _num_reads(0)
 {
 #if defined(PRC_INC_TRUST_LEVEL) && PRC_INC_TRUST_LEVEL != 0
   _flags = (_flags & ~F_trust_level_mask) | ((_flags & F_trust_level_mask) + PRC_INC_TRUST_LEVEL);
@@ -64,7 +65,8 @@ ConfigVariableCore(const ConfigVariableCore &templ, const string &name) :
   _default_value(NULL),
   _local_value(NULL),
   _declarations_sorted(false),
-  _value_queried(false)
+  _value_queried(false),
+  _num_reads(0)
 {
   if (templ._default_value != (ConfigDeclaration *)NULL) {
     set_default_value(templ._default_value->get_string_value());
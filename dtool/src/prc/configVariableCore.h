@@ -80,9 +80,14 @@ PUBLISHED:
   INLINE const ConfigDeclaration *get_unique_reference(int n) const;
   MAKE_SEQ(get_unique_references, get_num_unique_references, get_unique_reference);
 
+  INLINE int get_num_reads() const;
+
   void output(ostream &out) const;
   void write(ostream &out) const;
 
+public:
+  INLINE void record_read();
+
 private:
   void add_declaration(ConfigDeclaration *decl);
   void remove_declaration(ConfigDeclaration *decl);
@@ -106,6 +111,7 @@ private:
   Declarations _unique_declarations;
   bool _declarations_sorted;
   bool _value_queried;
+  TVOLATILE AtomicAdjust::Integer _num_reads;
 
   friend class ConfigDeclaration;
   friend class ConfigVariableManager;
@@ -18,6 +18,8 @@
 #include "configPage.h"
 #include "config_prc.h"
 
+#include <algorithm>
+
 ConfigVariableManager *ConfigVariableManager::_global_ptr = NULL;
 
 ////////////////////////////////////////////////////////////////////
@@ -334,6 +336,83 @@ list_dynamic_variables() const {
   }
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: ConfigVariableManager::reset_read_counts
+//       Access: Published
+//  Description: Resets the read count of every variable to zero.
+//               Typically this is called at the start of a
+//               measurement interval, after set_track_reads(true).
+////////////////////////////////////////////////////////////////////
+void ConfigVariableManager::
+reset_read_counts() {
+  Variables::iterator vi;
+  for (vi = _variables.begin(); vi != _variables.end(); ++vi) {
+    AtomicAdjust::set((*vi)->_num_reads, 0);
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: ConfigVariableManager::CompareReads::operator ()
+//       Access: Public
+//  Description: Sorts variables in descending order by number of
+//               reads.
+////////////////////////////////////////////////////////////////////
+bool ConfigVariableManager::CompareReads::
+operator () (const ConfigVariableCore *a, const ConfigVariableCore *b) const {
+  return a->get_num_reads() > b->get_num_reads();
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: ConfigVariableManager::write_read_counts
+//       Access: Published
+//  Description: Writes the max_variables most frequently-read
+//               variables, in descending order, along with the
+//               number of reads per frame, given that num_frames
+//               frames have elapsed since reset_read_counts() was
+//               last called.  If max_variables is negative, all
+//               variables that have been read at all are listed.
+//
+//               This only reports useful numbers while
+//               set_track_reads() is in effect.
+////////////////////////////////////////////////////////////////////
+void ConfigVariableManager::
+write_read_counts(ostream &out, int num_frames, int max_variables) const {
+  Variables sorted;
+  Variables::const_iterator vi;
+  for (vi = _variables.begin(); vi != _variables.end(); ++vi) {
+    if ((*vi)->get_num_reads() != 0) {
+      sorted.push_back(*vi);
+    }
+  }
+  sort(sorted.begin(), sorted.end(), CompareReads());
+
+  if (max_variables >= 0 && (int)sorted.size() > max_variables) {
+    sorted.erase(sorted.begin() + max_variables, sorted.end());
+  }
+  if (num_frames < 1) {
+    num_frames = 1;
+  }
+
+  for (vi = sorted.begin(); vi != sorted.end(); ++vi) {
+    const ConfigVariableCore *variable = (*vi);
+    int num_reads = variable->get_num_reads();
+    out << variable->get_name() << " "
+        << (double)num_reads / (double)num_frames << " reads/frame ("
+        << num_reads << " total)\n";
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: ConfigVariableManager::list_read_counts
+//       Access: Published
+//  Description: Writes the most frequently-read variables to nout.
+//               See write_read_counts().
+////////////////////////////////////////////////////////////////////
+void ConfigVariableManager::
+list_read_counts(int num_frames, int max_variables) const {
+  write_read_counts(nout, num_frames, max_variables);
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: ConfigVariableManager::get_global_ptr
 //       Access: Published
@@ -60,12 +60,25 @@ PUBLISHED:
   void list_variables() const;
   void list_dynamic_variables() const;
 
+  INLINE void set_track_reads(bool flag);
+  INLINE bool get_track_reads() const;
+  void reset_read_counts();
+  void write_read_counts(ostream &out, int num_frames = 1,
+                         int max_variables = 20) const;
+  void list_read_counts(int num_frames = 1, int max_variables = 20) const;
+
   static ConfigVariableManager *get_global_ptr();
 
 private:
   void list_variable(const ConfigVariableCore *variable,
                      bool include_descriptions) const;
 
+  class CompareReads {
+  public:
+    bool operator () (const ConfigVariableCore *a,
+                      const ConfigVariableCore *b) const;
+  };
+
   // We have to avoid pmap and pvector, due to the very low-level
   // nature of this stuff.
   typedef vector<ConfigVariableCore *> Variables;
@@ -4,6 +4,7 @@
 #include "configFlags.cxx"
 #include "configPage.cxx"
 #include "configPageManager.cxx"
+#include "configSnapshot.cxx"
 #include "configVariable.cxx"
 #include "configVariableBase.cxx"
 #include "configVariableBool.cxx"
@@ -53,6 +53,10 @@ $[cdefine PRC_ENCRYPTION_KEY]
    executables found that match one of the above patterns. */
 # define PRC_EXECUTABLE_ARGS_ENVVAR "$[PRC_EXECUTABLE_ARGS_ENVVAR]"
 
+/* The environment variable that names a file in which to cache the
+   parsed contents of the prc files, to speed up process startup. */
+# define PRC_CACHE_ENVVAR "$[PRC_CACHE_ENVVAR]"
+
 /* Define if we want to enable the "trust_level" feature of prc config
    variables.  This requires OpenSSL and PRC_PUBLIC_KEYS_FILENAME,
    above. */
@@ -209,8 +209,9 @@ xform(const LMatrix4 &mat) {
     verts.reserve(_points.size());
     Points::const_iterator pi;
     for (pi = _points.begin(); pi != _points.end(); ++pi) {
-      verts.push_back(to_3d((*pi)._p, to_3d_mat) * mat);
+      verts.push_back(to_3d((*pi)._p, to_3d_mat));
     }
+    mat.xform_points(&verts[0], &verts[0], verts.size());
 
     const LPoint3 *verts_begin = &verts[0];
     const LPoint3 *verts_end = verts_begin + verts.size();
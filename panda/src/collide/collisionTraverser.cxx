@@ -35,6 +35,7 @@
 #include "lodNode.h"
 #include "nodePath.h"
 #include "pStatTimer.h"
+#include "configSnapshot.h"
 #include "indent.h"
 
 #include <algorithm>
@@ -277,6 +278,7 @@ clear_colliders() {
 void CollisionTraverser::
 traverse(const NodePath &root) {
   PStatTimer timer(_this_pcollector);
+  ConfigSnapshot::check_all();
 
   #ifdef DO_COLLISION_RECORDING
   if (has_recorder()) {
@@ -60,7 +60,7 @@ private:
     PN_stdfloat _dist;
   };
 
-  typedef pvector<ObjectData> Objects;
+  typedef vector<ObjectData, FrameArenaAllocator<ObjectData> > Objects;
   Objects _objects;
 
 public:
@@ -62,7 +62,7 @@ private:
     int _draw_order;
   };
 
-  typedef pvector<ObjectData> Objects;
+  typedef vector<ObjectData, FrameArenaAllocator<ObjectData> > Objects;
   Objects _objects;
 
 public:
@@ -63,7 +63,7 @@ private:
     CullableObject *_object;
   };
 
-  typedef pvector<ObjectData> Objects;
+  typedef vector<ObjectData, FrameArenaAllocator<ObjectData> > Objects;
   Objects _objects;
 
 public:
@@ -45,7 +45,7 @@ protected:
   virtual void fill_result_graph(ResultGraphBuilder &builder);
 
 private:
-  typedef pvector<CullableObject *> Objects;
+  typedef vector<CullableObject *, FrameArenaAllocator<CullableObject *> > Objects;
   Objects _objects;
 
 public:
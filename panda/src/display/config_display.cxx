@@ -67,6 +67,17 @@ ConfigVariableString threading_model
           "a 3-stage pipeline.  See GraphicsEngine::set_threading_model(). "
           "EXPERIMENTAL and incomplete, do not use this!"));
 
+ConfigVariableInt cull_threads
+("cull-threads", 0,
+ PRC_DESC("The number of helper threads the GraphicsEngine may use to cull "
+          "several DisplayRegions at once, for instance the faces of a "
+          "cube map or the cascades of a shadow map.  DisplayRegions that "
+          "share a camera are still culled only once.  Each DisplayRegion is "
+          "drawn as soon as its own cull is finished.  "
+          "This has no effect unless Panda was compiled with "
+          "THREADED_PIPELINE.  Set this to 0 to cull all DisplayRegions "
+          "serially in the cull thread."));
+
 ConfigVariableBool allow_nonpipeline_threads
 ("allow-nonpipeline-threads", false,
  PRC_DESC("This variable should only be set true for debugging or development "
@@ -38,6 +38,7 @@ extern EXPCL_PANDA_DISPLAY ConfigVariableBool pstats_unused_states;
 
 extern EXPCL_PANDA_DISPLAY ConfigVariableString threading_model;
 extern EXPCL_PANDA_DISPLAY ConfigVariableBool allow_nonpipeline_threads;
+extern EXPCL_PANDA_DISPLAY ConfigVariableInt cull_threads;
 extern EXPCL_PANDA_DISPLAY ConfigVariableBool auto_flip;
 extern EXPCL_PANDA_DISPLAY ConfigVariableBool sync_flip;
 extern EXPCL_PANDA_DISPLAY ConfigVariableBool yield_timeslice;
@@ -37,6 +37,7 @@ DisplayRegion(GraphicsOutput *window, const LVecBase4 &dimensions) :
   _window(window),
   _incomplete_render(true),
   _texture_reload_priority(0),
+  _cull_cache_valid(false),
   _cull_region_pcollector("Cull:Invalid"),
   _draw_region_pcollector("Draw:Invalid")
 {
@@ -57,6 +58,7 @@ DisplayRegion(GraphicsOutput *window, const LVecBase4 &dimensions) :
 DisplayRegion::
 DisplayRegion(const DisplayRegion &copy) : 
   _window(NULL),
+  _cull_cache_valid(false),
   _cull_region_pcollector("Cull:Invalid"),
   _draw_region_pcollector("Draw:Invalid")
 {
@@ -806,6 +808,55 @@ set_active_index(int index) {
 #endif  // DO_PSTATS
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: DisplayRegion::check_cull_cache
+//       Access: Public
+//  Description: Called in the cull thread before culling this
+//               DisplayRegion.  Returns true if the cull cache is
+//               enabled and the CullResult saved from the previous
+//               frame is still valid for the indicated scene, in
+//               which case it may simply be drawn again.  Otherwise,
+//               returns false, and the caller should perform the
+//               cull and then call save_cull_cache().
+////////////////////////////////////////////////////////////////////
+bool DisplayRegion::
+check_cull_cache(SceneSetup *scene_setup, GraphicsStateGuardian *gsg,
+                 Thread *current_thread) {
+  UpdateSeq cache_seq;
+  {
+    CDReader cdata(_cycler, current_thread);
+    if (!cdata->_cull_cache) {
+      _cull_cache_valid = false;
+      return false;
+    }
+    cache_seq = cdata->_cull_cache_seq;
+  }
+
+  _cull_cache_next_key.set(scene_setup, gsg, cache_seq, current_thread);
+  return _cull_cache_valid && _cull_cache_next_key == _cull_cache_key;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: DisplayRegion::save_cull_cache
+//       Access: Public
+//  Description: Called in the cull thread after culling this
+//               DisplayRegion, following a call to
+//               check_cull_cache() that returned false.  If
+//               cacheable is true, the new CullResult may be reused
+//               in subsequent frames as long as nothing changes.
+////////////////////////////////////////////////////////////////////
+void DisplayRegion::
+save_cull_cache(bool cacheable) {
+  CDReader cdata(_cycler);
+  if (cacheable && cdata->_cull_cache) {
+    _cull_cache_key = _cull_cache_next_key;
+    _cull_cache_valid = true;
+  } else {
+    _cull_cache_valid = false;
+  }
+  _cull_cache_next_key = CullCacheKey();
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: DisplayRegion::do_cull
 //       Access: Protected, Virtual
@@ -832,7 +883,8 @@ CData() :
   _sort(0),
   _stereo_channel(Lens::SC_mono),
   _tex_view_offset(0),
-  _target_tex_page(-1)
+  _target_tex_page(-1),
+  _cull_cache(false)
 {
   _regions.push_back(Region());
 }
@@ -852,7 +904,9 @@ CData(const DisplayRegion::CData &copy) :
   _sort(copy._sort),
   _stereo_channel(copy._stereo_channel),
   _tex_view_offset(copy._tex_view_offset),
-  _target_tex_page(copy._target_tex_page)
+  _target_tex_page(copy._target_tex_page),
+  _cull_cache(copy._cull_cache),
+  _cull_cache_seq(copy._cull_cache_seq)
 {
 }
 
@@ -887,3 +941,78 @@ GraphicsPipe *DisplayRegionPipelineReader::
 get_pipe() const {
   return (_object->_window != (GraphicsOutput *)NULL) ? _object->_window->get_pipe() : NULL;
 }
+
+////////////////////////////////////////////////////////////////////
+//     Function: DisplayRegion::CullCacheKey::Constructor
+//       Access: Public
+//  Description: 
+////////////////////////////////////////////////////////////////////
+DisplayRegion::CullCacheKey::
+CullCacheKey() :
+  _gsg(NULL),
+  _scene_root(NULL),
+  _camera(NULL),
+  _viewport_width(0),
+  _viewport_height(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: DisplayRegion::CullCacheKey::set
+//       Access: Public
+//  Description: Records everything about the indicated scene that
+//               would affect the result of culling it.
+////////////////////////////////////////////////////////////////////
+void DisplayRegion::CullCacheKey::
+set(SceneSetup *scene_setup, GraphicsStateGuardian *gsg,
+    UpdateSeq cache_seq, Thread *current_thread) {
+  const NodePath &scene_root = scene_setup->get_scene_root();
+  _gsg = gsg;
+  _scene_root = scene_root.node();
+
+  // Any change at or below the scene root marks its bounding volume
+  // stale, so the bounds sequence tells us whether the scene changed.
+  _scene_root->get_bounds(_scene_seq, current_thread);
+
+  _camera_transform = scene_setup->get_camera_transform();
+  if (scene_setup->get_cull_center() != scene_setup->get_camera_path()) {
+    _cull_center_transform = 
+      scene_setup->get_cull_center().get_transform(scene_root, current_thread);
+  } else {
+    _cull_center_transform = NULL;
+  }
+  _initial_state = scene_setup->get_initial_state();
+  _lens = scene_setup->get_lens();
+  _lens_seq = _lens->get_last_change();
+  // Node tags are covered by the bounds sequence above; the tag
+  // states that they select are covered here.
+  _camera = scene_setup->get_camera_node();
+  _camera_mask = _camera->get_camera_mask();
+  _tag_state_seq = _camera->get_tag_state_seq();
+  _viewport_width = scene_setup->get_viewport_width();
+  _viewport_height = scene_setup->get_viewport_height();
+  _cache_seq = cache_seq;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: DisplayRegion::CullCacheKey::operator ==
+//       Access: Public
+//  Description: 
+////////////////////////////////////////////////////////////////////
+bool DisplayRegion::CullCacheKey::
+operator == (const CullCacheKey &other) const {
+  return (_gsg == other._gsg &&
+          _scene_root == other._scene_root &&
+          _scene_seq == other._scene_seq &&
+          _camera_transform == other._camera_transform &&
+          _cull_center_transform == other._cull_center_transform &&
+          _initial_state == other._initial_state &&
+          _lens == other._lens &&
+          _lens_seq == other._lens_seq &&
+          _camera_mask == other._camera_mask &&
+          _camera == other._camera &&
+          _tag_state_seq == other._tag_state_seq &&
+          _viewport_width == other._viewport_width &&
+          _viewport_height == other._viewport_height &&
+          _cache_seq == other._cache_seq);
+}
@@ -38,6 +38,9 @@
 #include "cullTraverser.h"
 #include "callbackObject.h"
 #include "luse.h"
+#include "updateSeq.h"
+#include "transformState.h"
+#include "renderState.h"
 
 class GraphicsOutput;
 class GraphicsPipe;
@@ -124,6 +127,10 @@ PUBLISHED:
   INLINE void clear_cull_callback();
   INLINE CallbackObject *get_cull_callback() const;
 
+  INLINE void set_cull_cache(bool cull_cache);
+  INLINE bool get_cull_cache() const;
+  INLINE void invalidate_cull_cache();
+
   INLINE void set_draw_callback(CallbackObject *object);
   INLINE void clear_draw_callback();
   INLINE CallbackObject *get_draw_callback() const;
@@ -162,6 +169,10 @@ public:
   INLINE CullResult *get_cull_result(Thread *current_thread) const;
   INLINE SceneSetup *get_scene_setup(Thread *current_thread) const;
 
+  bool check_cull_cache(SceneSetup *scene_setup, GraphicsStateGuardian *gsg,
+                        Thread *current_thread);
+  void save_cull_cache(bool cacheable);
+
   INLINE PStatCollector &get_cull_region_pcollector();
   INLINE PStatCollector &get_draw_region_pcollector();
 
@@ -196,6 +207,36 @@ protected:
   // Ditto for the cull traverser.
   PT(CullTraverser) _trav;
 
+private:
+  // The parameters of the last cull traversal, used to decide whether
+  // its CullResult may be drawn again; see set_cull_cache().  These
+  // are only touched by the thread that culls this DisplayRegion.
+  class CullCacheKey {
+  public:
+    CullCacheKey();
+    void set(SceneSetup *scene_setup, GraphicsStateGuardian *gsg,
+             UpdateSeq cache_seq, Thread *current_thread);
+    bool operator == (const CullCacheKey &other) const;
+
+    GraphicsStateGuardian *_gsg;
+    PandaNode *_scene_root;
+    UpdateSeq _scene_seq;
+    CPT(TransformState) _camera_transform;
+    CPT(TransformState) _cull_center_transform;
+    CPT(RenderState) _initial_state;
+    CPT(Lens) _lens;
+    UpdateSeq _lens_seq;
+    DrawMask _camera_mask;
+    const Camera *_camera;
+    UpdateSeq _tag_state_seq;
+    int _viewport_width;
+    int _viewport_height;
+    UpdateSeq _cache_seq;
+  };
+  CullCacheKey _cull_cache_key;
+  CullCacheKey _cull_cache_next_key;
+  bool _cull_cache_valid;
+
 private:
   // This is the data that is associated with the DisplayRegion that
   // needs to be cycled every frame, but represents the parameters as
@@ -226,6 +267,9 @@ private:
 
     PT(CallbackObject) _cull_callback;
     PT(CallbackObject) _draw_callback;
+
+    bool _cull_cache;
+    UpdateSeq _cull_cache_seq;
   };
 
   PipelineCycler<CData> _cycler;
@@ -17,6 +17,7 @@
 #include "parasiteBuffer.h"
 #include "config_gobj.h"
 #include "config_display.h"
+#include "configSnapshot.h"
 #include "pipeline.h"
 #include "drawCullHandler.h"
 #include "binCullHandler.h"
@@ -117,6 +118,17 @@ PStatCollector GraphicsEngine::_occlusion_passed_pcollector("Occlusion results:V
 PStatCollector GraphicsEngine::_occlusion_failed_pcollector("Occlusion results:Occluded");
 PStatCollector GraphicsEngine::_occlusion_tests_pcollector("Occlusion tests");
 
+#ifdef DO_PSTATS
+// The state passed through Pipeline::iterate_cycle_times() to
+// pstats_time_cycler_type().
+class CycleTimeData {
+public:
+  GraphicsEngine *_self;
+  Thread *_thread;
+  double _as_of;
+};
+#endif  // DO_PSTATS
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GraphicsEngine::Constructor
 //       Access: Published
@@ -130,7 +142,10 @@ GraphicsEngine(Pipeline *pipeline) :
   _pipeline(pipeline),
   _app("app"),
   _lock("GraphicsEngine::_lock"),
-  _loaded_textures_lock("GraphicsEngine::_loaded_textures_lock")
+  _loaded_textures_lock("GraphicsEngine::_loaded_textures_lock"),
+  _cull_jobs_lock("GraphicsEngine::_cull_jobs_lock"),
+  _cull_jobs_cvar(_cull_jobs_lock),
+  _cull_done_cvar(_cull_jobs_lock)
 {
   if (_pipeline == (Pipeline *)NULL) {
     _pipeline = Pipeline::get_render_pipeline();
@@ -151,6 +166,9 @@ GraphicsEngine(Pipeline *pipeline) :
 
   _singular_warning_last_frame = false;
   _singular_warning_this_frame = false;
+
+  _cull_threads_started = false;
+  _cull_threads_terminate = false;
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -680,6 +698,10 @@ render_frame() {
   BamCache *cache = BamCache::get_global_ptr();
   cache->consider_flush_index();
 
+  // Likewise, if the ConfigSnapshots consulted by the traversals are
+  // frozen, pick up any config changes made since the last frame.
+  ConfigSnapshot::check_all();
+
   // Anything that happens outside of GraphicsEngine::render_frame()
   // is deemed to be App.
 #ifdef DO_PSTATS
@@ -812,7 +834,26 @@ render_frame() {
 #ifdef THREADED_PIPELINE
     {
       PStatTimer timer(_cycle_pcollector, current_thread);
+#ifdef DO_PSTATS
+      // While PStats is listening, have the pipeline time each type
+      // of cycler, so we can break down App:Cycle by type.
+      bool time_cycle = PStatClient::is_connected();
+      if (time_cycle != _pipeline->get_time_cycle()) {
+        _pipeline->set_time_cycle(time_cycle);
+      }
+      CycleTimeData ctd;
+      ctd._self = this;
+      ctd._thread = current_thread;
+      ctd._as_of = time_cycle ? PStatClient::get_global_pstats()->get_real_time() : 0.0;
+#endif  // DO_PSTATS
+
       _pipeline->cycle();
+
+#ifdef DO_PSTATS
+      if (time_cycle) {
+        _pipeline->iterate_cycle_times(pstats_time_cycler_type, &ctd);
+      }
+#endif  // DO_PSTATS
     }
 #endif  // THREADED_PIPELINE
     
@@ -1433,9 +1474,16 @@ cull_and_draw_together(GraphicsOutput *win, DisplayRegion *dr,
 //               RenderThread objects during the frame rendering.  It
 //               collects the geometry into bins in preparation for
 //               drawing.
+//
+//               When the cull threads are in use, this only queues
+//               the work in the indicated batch and returns; the
+//               caller must then call wait_cull_region() before
+//               drawing each DisplayRegion, and finish_cull_batch()
+//               before the frame is over.
 ////////////////////////////////////////////////////////////////////
 void GraphicsEngine::
-cull_to_bins(const GraphicsEngine::Windows &wlist, Thread *current_thread) {
+cull_to_bins(const GraphicsEngine::Windows &wlist, CullBatch &batch,
+             Thread *current_thread) {
   PStatTimer timer(_cull_pcollector, current_thread);
 
   _singular_warning_last_frame = _singular_warning_this_frame;
@@ -1446,48 +1494,97 @@ cull_to_bins(const GraphicsEngine::Windows &wlist, Thread *current_thread) {
   typedef pmap<NodePath, DisplayRegion *> AlreadyCulled;
   AlreadyCulled already_culled;
 
+  // Each DisplayRegion with a camera of its own needs to be culled.
+  // These are independent of each other, so they may be handed out to
+  // the cull threads.
+  typedef pvector<CullJob> Regions;
+  Regions regions;
+
   Windows::const_iterator wi;
   for (wi = wlist.begin(); wi != wlist.end(); ++wi) {
     GraphicsOutput *win = (*wi);
     if (win->is_active() && win->get_gsg()->is_active()) {
-      PStatTimer timer(win->get_cull_window_pcollector(), current_thread);
       int num_display_regions = win->get_num_active_display_regions();
       for (int i = 0; i < num_display_regions; ++i) {
         DisplayRegion *dr = win->get_active_display_region(i);
         if (dr != (DisplayRegion *)NULL) {
-          DisplayRegionPipelineReader *dr_reader = 
-            new DisplayRegionPipelineReader(dr, current_thread);
-          NodePath camera = dr_reader->get_camera();
+          NodePath camera = dr->get_camera(current_thread);
           AlreadyCulled::iterator aci = already_culled.insert(AlreadyCulled::value_type(camera, (DisplayRegion *)NULL)).first;
           if ((*aci).second == NULL) {
             // We have not used this camera already in this thread.
             // Perform the cull operation.
-            delete dr_reader;
-            dr_reader = NULL;
             (*aci).second = dr;
-            cull_to_bins(win, dr, current_thread);
-            
+            CullJob job;
+            job._win = win;
+            job._dr = dr;
+            job._batch = &batch;
+            regions.push_back(job);
+
           } else {
             // We have already culled a scene using this camera in
             // this thread, and now we're being asked to cull another
             // scene using the same camera.  (Maybe this represents
             // two different DisplayRegions for the left and right
             // channels of a stereo image.)  Of course, the cull
-            // result will be the same, so just use the result from
-            // the other DisplayRegion.
-            DisplayRegion *other_dr = (*aci).second;
-            dr->set_cull_result(other_dr->get_cull_result(current_thread),
-                                setup_scene(win->get_gsg(), dr_reader),
-                                current_thread);
-          }
-        
-          if (dr_reader != (DisplayRegionPipelineReader *)NULL) {
-            delete dr_reader;
+            // result will be the same, so we will just use the result
+            // from the other DisplayRegion, once it is ready.
+            SharedCull shared;
+            shared._win = win;
+            shared._dr = dr;
+            shared._source = (*aci).second;
+            batch._shared_culls.push_back(shared);
           }
         }
       }
     }
   }
+
+  batch._pipeline_stage = current_thread->get_pipeline_stage();
+
+  // Without a threaded pipeline the scene graph's cyclers have no
+  // locking at all, so the cull threads can only be used when it is
+  // compiled in.
+#ifdef THREADED_PIPELINE
+  batch._threaded = (cull_threads > 0 && regions.size() > 1);
+#endif
+
+  Regions::const_iterator ri;
+  if (!batch._threaded) {
+    // Cull everything serially, in this thread.
+    for (ri = regions.begin(); ri != regions.end(); ++ri) {
+      run_cull_region((*ri)._win, (*ri)._dr, current_thread);
+    }
+
+    CullBatch::SharedCulls::const_iterator si;
+    for (si = batch._shared_culls.begin(); si != batch._shared_culls.end(); ++si) {
+      apply_shared_cull(*si, current_thread);
+    }
+    batch._shared_culls.clear();
+    return;
+  }
+
+  start_cull_threads();
+
+  // Hand the jobs to the cull threads.  A cull callback may call back
+  // into user code that doesn't expect to be run in some other
+  // thread, so a DisplayRegion with one is culled here.
+  Regions local_jobs;
+  _cull_jobs_lock.acquire();
+  for (ri = regions.begin(); ri != regions.end(); ++ri) {
+    if ((*ri)._dr->get_cull_callback() != (CallbackObject *)NULL) {
+      local_jobs.push_back(*ri);
+    } else {
+      _cull_jobs.push_back(*ri);
+      batch._pending.insert((*ri)._dr);
+      ++batch._num_pending;
+    }
+  }
+  _cull_jobs_cvar.notify_all();
+  _cull_jobs_lock.release();
+
+  for (ri = local_jobs.begin(); ri != local_jobs.end(); ++ri) {
+    run_cull_region((*ri)._win, (*ri)._dr, current_thread);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -1510,17 +1607,31 @@ cull_to_bins(GraphicsOutput *win, DisplayRegion *dr, Thread *current_thread) {
     DisplayRegionPipelineReader dr_reader(dr, current_thread);
     scene_setup = setup_scene(gsg, &dr_reader);
     cull_result = dr->get_cull_result(current_thread);
+  }
 
-    if (cull_result != (CullResult *)NULL) {
-      cull_result = cull_result->make_next();
+  if (cull_result != (CullResult *)NULL &&
+      scene_setup != (SceneSetup *)NULL &&
+      dr->check_cull_cache(scene_setup, gsg, current_thread)) {
+    // Nothing has changed since last frame, so last frame's cull
+    // result is still good.  Draw it again.
+    dr->set_cull_result(cull_result, scene_setup, current_thread);
+    return;
+  }
 
-    } else {
-      // This DisplayRegion has no cull results; draw it.
-      cull_result = new CullResult(gsg, dr->get_draw_region_pcollector());
-    }
+  if (cull_result != (CullResult *)NULL) {
+    cull_result = cull_result->make_next();
+
+  } else {
+    // This DisplayRegion has no cull results; draw it.
+    cull_result = new CullResult(gsg, dr->get_draw_region_pcollector());
   }
 
   if (scene_setup != (SceneSetup *)NULL) {
+    // Everything generated by this traversal dies with cull_result,
+    // so it can all come from cull_result's arena.
+    FrameArena *prev_arena = current_thread->get_frame_arena();
+    current_thread->set_frame_arena(cull_result->get_frame_arena());
+
     BinCullHandler cull_handler(cull_result);
     CallbackObject *cbobj = dr->get_cull_callback();
     if (cbobj != (CallbackObject *)NULL) {
@@ -1528,21 +1639,228 @@ cull_to_bins(GraphicsOutput *win, DisplayRegion *dr, Thread *current_thread) {
       DisplayRegionCullCallbackData cbdata(&cull_handler, scene_setup);
       cbobj->do_callback(&cbdata);
 
-      // The callback has taken care of the culling.
+      // The callback has taken care of the culling.  We can't know
+      // what it depends on, so its result can't be cached.
+      dr->save_cull_cache(false);
 
     } else {
       // Perform the cull normally.
       dr->do_cull(&cull_handler, scene_setup, gsg, current_thread);
+      dr->save_cull_cache(dr->get_cull_traverser()->get_num_cull_callbacks() == 0);
     }
 
-    PStatTimer timer(_cull_sort_pcollector, current_thread);
-    cull_result->finish_cull(scene_setup, current_thread);
+    {
+      PStatTimer timer(_cull_sort_pcollector, current_thread);
+      cull_result->finish_cull(scene_setup, current_thread);
+    }
+
+    current_thread->set_frame_arena(prev_arena);
   }
   
   // Save the results for next frame.
   dr->set_cull_result(cull_result, scene_setup, current_thread);
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: GraphicsEngine::run_cull_region
+//       Access: Private
+//  Description: Culls one DisplayRegion, charging the time to its
+//               window's cull collector.
+////////////////////////////////////////////////////////////////////
+void GraphicsEngine::
+run_cull_region(GraphicsOutput *win, DisplayRegion *dr,
+                Thread *current_thread) {
+  PStatTimer timer(win->get_cull_window_pcollector(), current_thread);
+  cull_to_bins(win, dr, current_thread);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GraphicsEngine::run_queued_cull_job
+//       Access: Private
+//  Description: Takes the job for the indicated DisplayRegion of the
+//               indicated batch off the queue, if no cull thread has
+//               started it yet, and runs it in the current thread.
+//               If dr is NULL, any job of the batch will do.  Returns
+//               true if a job was run, false if there was none to
+//               take.
+//
+//               Assumes _cull_jobs_lock is held; it is released while
+//               the job runs.
+////////////////////////////////////////////////////////////////////
+bool GraphicsEngine::
+run_queued_cull_job(CullBatch &batch, DisplayRegion *dr,
+                    Thread *current_thread) {
+  CullJobs::iterator ji;
+  for (ji = _cull_jobs.begin(); ji != _cull_jobs.end(); ++ji) {
+    if ((*ji)._batch == &batch &&
+        (dr == (DisplayRegion *)NULL || (*ji)._dr == dr)) {
+      CullJob job = (*ji);
+      _cull_jobs.erase(ji);
+      _cull_jobs_lock.release();
+      run_cull_region(job._win, job._dr, current_thread);
+      _cull_jobs_lock.acquire();
+      finish_cull_job(job);
+      return true;
+    }
+  }
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GraphicsEngine::finish_cull_job
+//       Access: Private
+//  Description: Records that the indicated job has finished, and
+//               wakes up anyone waiting for it.  Assumes
+//               _cull_jobs_lock is held.
+////////////////////////////////////////////////////////////////////
+void GraphicsEngine::
+finish_cull_job(const CullJob &job) {
+  job._batch->_pending.erase(job._dr);
+  --(job._batch->_num_pending);
+  _cull_done_cvar.notify_all();
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GraphicsEngine::apply_shared_cull
+//       Access: Private
+//  Description: Gives a DisplayRegion the cull result of the earlier
+//               DisplayRegion that uses the same camera.  That
+//               DisplayRegion must already have been culled.
+////////////////////////////////////////////////////////////////////
+void GraphicsEngine::
+apply_shared_cull(const SharedCull &shared, Thread *current_thread) {
+  DisplayRegionPipelineReader dr_reader(shared._dr, current_thread);
+  shared._dr->set_cull_result(shared._source->get_cull_result(current_thread),
+                              setup_scene(shared._win->get_gsg(), &dr_reader),
+                              current_thread);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GraphicsEngine::wait_cull_region
+//       Access: Private
+//  Description: Called before drawing a DisplayRegion, to ensure that
+//               its cull, if it was queued in the indicated batch, is
+//               finished.  If no cull thread has started it yet, it
+//               is culled in the current thread.
+////////////////////////////////////////////////////////////////////
+void GraphicsEngine::
+wait_cull_region(CullBatch &batch, DisplayRegion *dr,
+                 Thread *current_thread) {
+  if (!batch._threaded) {
+    // Everything was culled up front.
+    return;
+  }
+
+  _cull_jobs_lock.acquire();
+  while (batch._pending.count(dr) != 0) {
+    if (!run_queued_cull_job(batch, dr, current_thread)) {
+      // A cull thread is working on it.
+      PStatTimer timer(_wait_pcollector, current_thread);
+      _cull_done_cvar.wait();
+    }
+  }
+  _cull_jobs_lock.release();
+
+  CullBatch::SharedCulls::iterator si;
+  for (si = batch._shared_culls.begin(); si != batch._shared_culls.end(); ++si) {
+    if ((*si)._dr == dr) {
+      SharedCull shared = (*si);
+      batch._shared_culls.erase(si);
+      wait_cull_region(batch, shared._source, current_thread);
+      apply_shared_cull(shared, current_thread);
+      break;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GraphicsEngine::finish_cull_batch
+//       Access: Private
+//  Description: Waits for all of the culls queued in the indicated
+//               batch to finish, helping to run them in the meantime.
+//               This must be called before the batch is destroyed.
+////////////////////////////////////////////////////////////////////
+void GraphicsEngine::
+finish_cull_batch(CullBatch &batch, Thread *current_thread) {
+  if (!batch._threaded) {
+    return;
+  }
+
+  _cull_jobs_lock.acquire();
+  while (batch._num_pending != 0) {
+    if (!run_queued_cull_job(batch, NULL, current_thread)) {
+      PStatTimer timer(_wait_pcollector, current_thread);
+      _cull_done_cvar.wait();
+    }
+  }
+  _cull_jobs_lock.release();
+
+  CullBatch::SharedCulls::const_iterator si;
+  for (si = batch._shared_culls.begin(); si != batch._shared_culls.end(); ++si) {
+    apply_shared_cull(*si, current_thread);
+  }
+  batch._shared_culls.clear();
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GraphicsEngine::start_cull_threads
+//       Access: Private
+//  Description: Spawns the pool of cull threads, as specified by
+//               cull-threads, if they have not already been spawned.
+//               If threads cannot be started, cull_to_bins() will
+//               simply run all of its jobs itself.
+////////////////////////////////////////////////////////////////////
+void GraphicsEngine::
+start_cull_threads() {
+  MutexHolder holder(_cull_jobs_lock);
+  if (_cull_threads_started) {
+    return;
+  }
+  _cull_threads_started = true;
+  _cull_threads_terminate = false;
+
+  for (int i = 0; i < cull_threads; ++i) {
+    ostringstream strm;
+    strm << "cull-" << i;
+    PT(CullThread) thread = new CullThread(strm.str(), this);
+    if (!thread->start(TP_normal, true)) {
+      display_cat.warning()
+        << "Unable to start " << thread->get_name() << "\n";
+      break;
+    }
+    _cull_threads.push_back(thread);
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GraphicsEngine::stop_cull_threads
+//       Access: Private
+//  Description: Signals the cull threads to terminate and waits for
+//               them to finish.  It is assumed that no thread is
+//               within cull_to_bins() at the time.
+////////////////////////////////////////////////////////////////////
+void GraphicsEngine::
+stop_cull_threads() {
+  {
+    MutexHolder holder(_cull_jobs_lock);
+    if (!_cull_threads_started) {
+      return;
+    }
+    nassertv(_cull_jobs.empty());
+    _cull_threads_terminate = true;
+    _cull_jobs_cvar.notify_all();
+  }
+
+  CullThreads::iterator ti;
+  for (ti = _cull_threads.begin(); ti != _cull_threads.end(); ++ti) {
+    (*ti)->join();
+  }
+  _cull_threads.clear();
+
+  MutexHolder holder(_cull_jobs_lock);
+  _cull_threads_started = false;
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GraphicsEngine::draw_bins
 //       Access: Private
@@ -1550,10 +1868,13 @@ cull_to_bins(GraphicsOutput *win, DisplayRegion *dr, Thread *current_thread) {
 //               RenderThread objects during the frame rendering.  It
 //               issues the graphics commands to draw the objects that
 //               have been collected into bins by a previous call to
-//               cull_to_bins().
+//               cull_to_bins().  If some of those culls are still
+//               running in the cull threads, each DisplayRegion is
+//               drawn as soon as its own cull is finished.
 ////////////////////////////////////////////////////////////////////
 void GraphicsEngine::
-draw_bins(const GraphicsEngine::Windows &wlist, Thread *current_thread) {
+draw_bins(const GraphicsEngine::Windows &wlist, CullBatch &batch,
+          Thread *current_thread) {
   nassertv(wlist.verify_list());
 
   size_t wlist_size = wlist.size();
@@ -1583,6 +1904,7 @@ draw_bins(const GraphicsEngine::Windows &wlist, Thread *current_thread) {
         for (int i = 0; i < num_display_regions; ++i) {
           DisplayRegion *dr = win->get_active_display_region(i);
           if (dr != (DisplayRegion *)NULL) {
+            wait_cull_region(batch, dr, current_thread);
             draw_bins(win, dr, current_thread);
           }
         }
@@ -2346,6 +2668,9 @@ terminate_threads(Thread *current_thread) {
   }
   
   _threads.clear();
+
+  // Now that nothing is culling, the cull threads can go too.
+  stop_cull_threads();
 }
 
 
@@ -2389,6 +2714,31 @@ pstats_count_dirty_cycler_type(TypeHandle type, int count, void *data) {
 }
 #endif // DO_PSTATS
 
+#ifdef DO_PSTATS
+////////////////////////////////////////////////////////////////////
+//     Function: GraphicsEngine::pstats_time_cycler_type
+//       Access: Private, Static
+//  Description: A callback function for
+//               Pipeline::iterate_cycle_times() to report the time
+//               spent cycling each cycler type to PStats, as a
+//               sequence of child intervals of App:Cycle.
+////////////////////////////////////////////////////////////////////
+void GraphicsEngine::
+pstats_time_cycler_type(TypeHandle type, int count, double elapsed, void *data) {
+  CycleTimeData *ctd = (CycleTimeData *)data;
+  GraphicsEngine *self = ctd->_self;
+  CyclerTypeCounters::iterator ci = self->_cycle_cycler_types.find(type);
+  if (ci == self->_cycle_cycler_types.end()) {
+    PStatCollector collector(_cycle_pcollector, type.get_name());
+    ci = self->_cycle_cycler_types.insert(CyclerTypeCounters::value_type(type, collector)).first;
+  }
+  PStatThread thread(ctd->_thread);
+  (*ci).second.start(thread, ctd->_as_of);
+  ctd->_as_of += elapsed;
+  (*ci).second.stop(thread, ctd->_as_of);
+}
+#endif // DO_PSTATS
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GraphicsEngine::get_invert_polygon_state
 //       Access: Protected, Static
@@ -2572,9 +2922,11 @@ do_frame(GraphicsEngine *engine, Thread *current_thread) {
   PStatTimer timer(engine->_do_frame_pcollector, current_thread);
   LightReMutexHolder holder(_wl_lock);
 
-  engine->cull_to_bins(_cull, current_thread);
+  CullBatch batch;
+  engine->cull_to_bins(_cull, batch, current_thread);
   engine->cull_and_draw_together(_cdraw, current_thread);
-  engine->draw_bins(_draw, current_thread);
+  engine->draw_bins(_draw, batch, current_thread);
+  engine->finish_cull_batch(batch, current_thread);
   engine->process_events(_window, current_thread);
 
   // If any GSG's on the list have no more outstanding pointers, clean
@@ -2801,3 +3153,65 @@ thread_main() {
     }
   }
 }
+
+////////////////////////////////////////////////////////////////////
+//     Function: GraphicsEngine::CullBatch::Constructor
+//       Access: Public
+//  Description:
+////////////////////////////////////////////////////////////////////
+GraphicsEngine::CullBatch::
+CullBatch() :
+  _pipeline_stage(0),
+  _threaded(false),
+  _num_pending(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GraphicsEngine::CullThread::Constructor
+//       Access: Public
+//  Description: 
+////////////////////////////////////////////////////////////////////
+GraphicsEngine::CullThread::
+CullThread(const string &name, GraphicsEngine *engine) : 
+  Thread(name, "Main"),
+  _engine(engine)
+{
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GraphicsEngine::CullThread::thread_main
+//       Access: Public, Virtual
+//  Description: The main loop for a cull thread.  The thread waits
+//               for CullJobs to be queued by cull_to_bins(), and
+//               runs them in the pipeline stage of the thread that
+//               queued them.
+////////////////////////////////////////////////////////////////////
+void GraphicsEngine::CullThread::
+thread_main() {
+  Thread *current_thread = Thread::get_current_thread();
+  GraphicsEngine *engine = _engine;
+
+  MutexHolder holder(engine->_cull_jobs_lock);
+  while (true) {
+    while (engine->_cull_jobs.empty() && !engine->_cull_threads_terminate) {
+      PStatTimer timer(_wait_pcollector, current_thread);
+      engine->_cull_jobs_cvar.wait();
+    }
+    if (engine->_cull_threads_terminate) {
+      return;
+    }
+
+    CullJob job = engine->_cull_jobs.front();
+    engine->_cull_jobs.pop_front();
+    engine->_cull_jobs_lock.release();
+
+    if (get_pipeline_stage() != job._batch->_pipeline_stage) {
+      set_pipeline_stage(job._batch->_pipeline_stage);
+    }
+    engine->run_cull_region(job._win, job._dr, current_thread);
+
+    engine->_cull_jobs_lock.acquire();
+    engine->finish_cull_job(job);
+  }
+}
@@ -27,8 +27,10 @@
 #include "reMutex.h"
 #include "lightReMutex.h"
 #include "conditionVar.h"
+#include "conditionVarFull.h"
 #include "pStatCollector.h"
 #include "pset.h"
+#include "pdeque.h"
 #include "ordered_vector.h"
 #include "indirectLess.h"
 #include "loader.h"
@@ -144,9 +146,17 @@ private:
   void cull_and_draw_together(GraphicsOutput *win, DisplayRegion *dr,
                               Thread *current_thread);
 
-  void cull_to_bins(const Windows &wlist, Thread *current_thread);
+  class CullBatch;
+  void cull_to_bins(const Windows &wlist, CullBatch &batch,
+                    Thread *current_thread);
   void cull_to_bins(GraphicsOutput *win, DisplayRegion *dr, Thread *current_thread);
-  void draw_bins(const Windows &wlist, Thread *current_thread);
+  void start_cull_threads();
+  void stop_cull_threads();
+  void wait_cull_region(CullBatch &batch, DisplayRegion *dr,
+                        Thread *current_thread);
+  void finish_cull_batch(CullBatch &batch, Thread *current_thread);
+  void draw_bins(const Windows &wlist, CullBatch &batch,
+                 Thread *current_thread);
   void draw_bins(GraphicsOutput *win, DisplayRegion *dr, Thread *current_thread);
   void make_contexts(const Windows &wlist, Thread *current_thread);
 
@@ -178,6 +188,9 @@ private:
   CyclerTypeCounters _dirty_cycler_types;
   static void pstats_count_cycler_type(TypeHandle type, int count, void *data);
   static void pstats_count_dirty_cycler_type(TypeHandle type, int count, void *data);
+
+  CyclerTypeCounters _cycle_cycler_types;
+  static void pstats_time_cycler_type(TypeHandle type, int count, double elapsed, void *data);
 #endif  // DO_PSTATS
 
   static const RenderState *get_invert_polygon_state();
@@ -303,6 +316,70 @@ private:
     ThreadState _thread_state;
   };
 
+  // The cull threads are a pool of helper threads that can be used by
+  // cull_to_bins() to cull several DisplayRegions at once, including
+  // DisplayRegions that share a GSG.  Unlike the RenderThreads, they
+  // own no windows; the thread that calls cull_to_bins() queues up a
+  // CullBatch with one CullJob per DisplayRegion and returns at once.
+  // draw_bins() then waits for (or runs) the cull of each
+  // DisplayRegion only when it is about to draw it, so the first
+  // DisplayRegions are drawn while the later ones are still being
+  // culled; finish_cull_batch() waits for whatever is left.  Each
+  // worker adopts the pipeline stage of the batch it is working on,
+  // so its results land in the same stage as if the calling thread
+  // had culled them itself.  The pool is only used when Panda is
+  // compiled with THREADED_PIPELINE.
+  class CullJob {
+  public:
+    GraphicsOutput *_win;
+    DisplayRegion *_dr;
+    CullBatch *_batch;
+  };
+
+  // A DisplayRegion whose camera is also used by an earlier
+  // DisplayRegion; it takes over that one's cull result.
+  class SharedCull {
+  public:
+    GraphicsOutput *_win;
+    DisplayRegion *_dr;
+    DisplayRegion *_source;
+  };
+
+  class CullBatch {
+  public:
+    CullBatch();
+
+    int _pipeline_stage;
+    bool _threaded;
+    int _num_pending;
+
+    // The DisplayRegions queued for the cull threads whose cull has
+    // not yet finished.  Protected by _cull_jobs_lock.
+    typedef pset<DisplayRegion *> Pending;
+    Pending _pending;
+
+    typedef pvector<SharedCull> SharedCulls;
+    SharedCulls _shared_culls;
+  };
+
+  typedef pdeque<CullJob> CullJobs;
+
+  class CullThread : public Thread {
+  public:
+    CullThread(const string &name, GraphicsEngine *engine);
+    virtual void thread_main();
+
+    GraphicsEngine *_engine;
+  };
+  typedef pvector< PT(CullThread) > CullThreads;
+
+  void run_cull_region(GraphicsOutput *win, DisplayRegion *dr,
+                       Thread *current_thread);
+  bool run_queued_cull_job(CullBatch &batch, DisplayRegion *dr,
+                           Thread *current_thread);
+  void finish_cull_job(const CullJob &job);
+  void apply_shared_cull(const SharedCull &shared, Thread *current_thread);
+
   WindowRenderer *get_window_renderer(const string &name, int pipeline_stage);
 
   Pipeline *_pipeline;
@@ -341,6 +418,14 @@ private:
   LoadedTextures _loaded_textures;
   Mutex _loaded_textures_lock;
 
+  CullThreads _cull_threads;
+  CullJobs _cull_jobs;
+  bool _cull_threads_started;
+  bool _cull_threads_terminate;
+  Mutex _cull_jobs_lock;
+  ConditionVarFull _cull_jobs_cvar;
+  ConditionVarFull _cull_done_cvar;
+
   static PT(GraphicsEngine) _global_ptr;
 
   static PStatCollector _wait_pcollector;
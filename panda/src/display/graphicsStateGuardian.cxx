@@ -16,6 +16,7 @@
 ////////////////////////////////////////////////////////////////////
 
 #include "graphicsStateGuardian.h"
+#include "lightMutexHolder.h"
 #include "graphicsEngine.h"
 #include "config_display.h"
 #include "textureContext.h"
@@ -779,37 +780,57 @@ get_geom_munger(const RenderState *state, Thread *current_thread) {
   // any of its properties.
   RenderState *nc_state = ((RenderState *)state);
 
-  // Before we even look up the map, see if the _last_mi value points
-  // to this GSG.  This is likely because we tend to visit the same
-  // state multiple times during a frame.  Also, this might well be
-  // the only GSG in the world anyway.
-  if (!nc_state->_mungers.empty()) {
-    RenderState::Mungers::const_iterator mi = nc_state->_last_mi;
-    if (!(*mi).first.was_deleted() && (*mi).first == this) {
-      if ((*mi).second->is_registered()) {
-        return (*mi).second;
+  {
+    // The cache may be shared with other GSG's that are being culled
+    // in other threads, so it is protected by the state's lock.
+    LightMutexHolder holder(nc_state->_lock);
+
+    // Before we even look up the map, see if the _last_mi value points
+    // to this GSG.  This is likely because we tend to visit the same
+    // state multiple times during a frame.  Also, this might well be
+    // the only GSG in the world anyway.
+    if (nc_state->_last_mi != nc_state->_mungers.end()) {
+      RenderState::Mungers::const_iterator mi = nc_state->_last_mi;
+      if (!(*mi).first.was_deleted() && (*mi).first == this) {
+        if ((*mi).second->is_registered()) {
+          return (*mi).second;
+        }
       }
     }
-  }
 
-  // Nope, we have to look it up in the map.
-  RenderState::Mungers::iterator mi = nc_state->_mungers.find(this);
-  if (mi != nc_state->_mungers.end() && !(*mi).first.was_deleted()) {
-    if ((*mi).second->is_registered()) {
-      nc_state->_last_mi = mi;
-      return (*mi).second;
+    // Nope, we have to look it up in the map.
+    RenderState::Mungers::iterator mi = nc_state->_mungers.find(this);
+    if (mi != nc_state->_mungers.end() && !(*mi).first.was_deleted()) {
+      if ((*mi).second->is_registered()) {
+        nc_state->_last_mi = mi;
+        return (*mi).second;
+      }
+      // This GeomMunger is no longer registered.  Remove it from the
+      // map.
+      if (nc_state->_last_mi == mi) {
+        nc_state->_last_mi = nc_state->_mungers.end();
+      }
+      nc_state->_mungers.erase(mi);
     }
-    // This GeomMunger is no longer registered.  Remove it from the
-    // map.
-    nc_state->_mungers.erase(mi);
   }
 
-  // Nothing in the map; create a new entry.
+  // Nothing in the map; create a new entry.  We can't hold the lock
+  // while we do this, since making the munger may query the state.
   PT(GeomMunger) munger = make_geom_munger(nc_state, current_thread);
   nassertr(munger != (GeomMunger *)NULL && munger->is_registered(), munger);
 
-  mi = nc_state->_mungers.insert(RenderState::Mungers::value_type(this, munger)).first;
-  nc_state->_last_mi = mi;
+  LightMutexHolder holder(nc_state->_lock);
+  pair<RenderState::Mungers::iterator, bool> result =
+    nc_state->_mungers.insert(RenderState::Mungers::value_type(this, munger));
+  if (!result.second) {
+    // Another thread got here first.
+    if ((*result.first).second->is_registered()) {
+      munger = (*result.first).second;
+    } else {
+      (*result.first).second = munger;
+    }
+  }
+  nc_state->_last_mi = result.first;
 
   return munger;
 }
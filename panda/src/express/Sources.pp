@@ -9,6 +9,7 @@
   #define COMBINED_SOURCES $[TARGET]_composite1.cxx $[TARGET]_composite2.cxx $[TARGET]_ext_composite.cxx
 
   #define SOURCES \
+    borrowedPointerTo.I borrowedPointerTo.h \
     buffer.I buffer.h \
     ca_bundle_data_src.c \
     checksumHashGenerator.I checksumHashGenerator.h circBuffer.I \
@@ -24,6 +25,8 @@
     error_utils.h \
     export_dtool.h \
     fileReference.h fileReference.I \
+    frameArena.h frameArena.I \
+    frameArenaAllocator.h frameArenaAllocator.T \
     hashGeneratorBase.I hashGeneratorBase.h \
     hashVal.I hashVal.h \
     indirectLess.I indirectLess.h \
@@ -92,6 +95,7 @@
     encrypt_string.cxx \
     error_utils.cxx \
     fileReference.cxx \
+    frameArena.cxx \
     hashGeneratorBase.cxx hashVal.cxx \
     memoryInfo.cxx memoryUsage.cxx memoryUsagePointerCounts.cxx \
     memoryUsagePointers_ext.cxx \
@@ -140,6 +144,7 @@
     zStream.cxx zStreamBuf.cxx
 
   #define INSTALL_HEADERS  \
+    borrowedPointerTo.I borrowedPointerTo.h \
     buffer.I buffer.h \
     ca_bundle_data_src.c \
     checksumHashGenerator.I checksumHashGenerator.h circBuffer.I \
@@ -154,6 +159,8 @@
     encrypt_string.h \
     error_utils.h \
     fileReference.h fileReference.I \
+    frameArena.h frameArena.I \
+    frameArenaAllocator.h frameArenaAllocator.T \
     hashGeneratorBase.I hashGeneratorBase.h \
     hashVal.I hashVal.h \
     indirectLess.I indirectLess.h \
@@ -0,0 +1,83 @@
+// Filename: borrowedPointerTo.h
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#ifndef BORROWEDPOINTERTO_H
+#define BORROWEDPOINTERTO_H
+
+#include "pandabase.h"
+#include "referenceCount.h"
+#include "pointerTo.h"
+
+////////////////////////////////////////////////////////////////////
+//       Class : BorrowedPointerTo
+// Description : A reference-counting pointer that may also hold a
+//               "borrowed" pointer: one that does not own a
+//               reference, because some other object that is known to
+//               outlive this one already holds a reference to the
+//               same pointer.
+//
+//               This is intended for data that is passed down a
+//               recursive traversal, such as CullTraverserData, in
+//               which each level usually inherits its parent's
+//               pointers unchanged.  Borrowing the parent's pointers
+//               avoids an atomic increment and decrement per pointer
+//               per level.  As soon as a new value is assigned, the
+//               pointer owns a reference as usual.
+//
+//               Copying a BorrowedPointerTo always produces an owning
+//               pointer, since the copy may outlive the lender.
+//
+//               The template parameter may be const-qualified, e.g.
+//               BorrowedPointerTo<const RenderState>.
+////////////////////////////////////////////////////////////////////
+template<class T>
+class BorrowedPointerTo {
+public:
+  INLINE BorrowedPointerTo(T *ptr = (T *)NULL);
+  INLINE BorrowedPointerTo(const BorrowedPointerTo<T> &lender, bool borrow);
+  INLINE BorrowedPointerTo(const BorrowedPointerTo<T> &copy);
+  INLINE ~BorrowedPointerTo();
+
+  INLINE BorrowedPointerTo<T> &operator = (T *ptr);
+  INLINE BorrowedPointerTo<T> &operator = (const BorrowedPointerTo<T> &copy);
+
+  INLINE operator T * () const;
+  INLINE T *operator -> () const;
+  INLINE T &operator * () const;
+  INLINE T *p() const;
+
+  // These allow a BorrowedPointerTo to be used wherever a PT or CPT
+  // is expected.  (Template member functions in VC++ can only be
+  // defined in-class.)
+  template<class U>
+  INLINE operator PointerTo<U> () const {
+    return PointerTo<U>(_ptr);
+  }
+  template<class U>
+  INLINE operator ConstPointerTo<U> () const {
+    return ConstPointerTo<U>(_ptr);
+  }
+
+  INLINE bool is_borrowed() const;
+
+private:
+  INLINE void release();
+
+  T *_ptr;
+  bool _owned;
+};
+
+#include "borrowedPointerTo.I"
+
+#endif
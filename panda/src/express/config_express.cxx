@@ -83,6 +83,24 @@ ConfigVariableBool collect_tcp
 ConfigVariableDouble collect_tcp_interval
 ("collect-tcp-interval", 0.2);
 
+ConfigVariableInt collect_tcp_max_bytes
+("collect-tcp-max-bytes", 65536,
+ PRC_DESC("When collect-tcp is in effect, this is the number of bytes that "
+          "may accumulate on a connection before they are sent, even if "
+          "collect-tcp-interval has not yet elapsed."));
+
+ConfigVariableInt frame_arena_chunk_size
+("frame-arena-chunk-size", 65536,
+ PRC_DESC("The size in bytes of each block of memory reserved by a "
+          "FrameArena, the bump allocator used for short-lived per-frame "
+          "objects such as the results of the cull traversal."));
+
+ConfigVariableInt frame_arena_max_pooled_chunks
+("frame-arena-max-pooled-chunks", 256,
+ PRC_DESC("The maximum number of FrameArena chunks that are kept in "
+          "reserve for reuse after their arena has been reset.  Chunks "
+          "beyond this are returned to the heap."));
+
 ////////////////////////////////////////////////////////////////////
 //     Function: init_libexpress
 //  Description: Initializes the library.  This must be called at
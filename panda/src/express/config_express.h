@@ -58,6 +58,10 @@ extern ConfigVariableBool multifile_always_binary;
 
 extern EXPCL_PANDAEXPRESS ConfigVariableBool collect_tcp;
 extern EXPCL_PANDAEXPRESS ConfigVariableDouble collect_tcp_interval;
+extern EXPCL_PANDAEXPRESS ConfigVariableInt collect_tcp_max_bytes;
+
+extern EXPCL_PANDAEXPRESS ConfigVariableInt frame_arena_chunk_size;
+extern EXPCL_PANDAEXPRESS ConfigVariableInt frame_arena_max_pooled_chunks;
 
 // Expose the Config variable for Python access.
 BEGIN_PUBLISH
@@ -0,0 +1,175 @@
+// Filename: frameArena.cxx
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#include "frameArena.h"
+#include "config_express.h"
+
+FrameArena::Chunk *FrameArena::_free_chunks = NULL;
+size_t FrameArena::_num_free_chunks = 0;
+MutexImpl FrameArena::_free_lock;
+
+////////////////////////////////////////////////////////////////////
+//     Function: FrameArena::Constructor
+//       Access: Public
+//  Description: Creates an empty arena.  No memory is reserved until
+//               the first call to allocate().
+////////////////////////////////////////////////////////////////////
+FrameArena::
+FrameArena() :
+  _chunks(NULL),
+  _ptr(NULL),
+  _end(NULL),
+  _bytes_used(0),
+  _bytes_reserved(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: FrameArena::reset
+//       Access: Public
+//  Description: Releases all of the memory allocated from the arena
+//               at once.  Standard-sized chunks are returned to the
+//               global pool, up to frame-arena-max-pooled-chunks;
+//               the rest are freed.
+//
+//               No destructors are called; it is the caller's
+//               responsibility to destruct any objects constructed
+//               within the arena first.
+////////////////////////////////////////////////////////////////////
+void FrameArena::
+reset() {
+  size_t chunk_size = (size_t)max((int)frame_arena_chunk_size, 1024);
+  size_t max_pooled = (size_t)max((int)frame_arena_max_pooled_chunks, 0);
+
+  Chunk *chunk = _chunks;
+  while (chunk != (Chunk *)NULL) {
+    Chunk *next = chunk->_next;
+    if (chunk->_size == chunk_size) {
+      _free_lock.acquire();
+      if (_num_free_chunks < max_pooled) {
+        chunk->_next = _free_chunks;
+        _free_chunks = chunk;
+        ++_num_free_chunks;
+        chunk = NULL;
+      }
+      _free_lock.release();
+    }
+    if (chunk != (Chunk *)NULL) {
+      free_chunk(chunk);
+    }
+    chunk = next;
+  }
+
+  _chunks = NULL;
+  _ptr = NULL;
+  _end = NULL;
+  _bytes_used = 0;
+  _bytes_reserved = 0;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: FrameArena::get_num_pooled_chunks
+//       Access: Public, Static
+//  Description: Returns the number of chunks that are sitting in the
+//               global pool, waiting to be used by some arena.
+////////////////////////////////////////////////////////////////////
+size_t FrameArena::
+get_num_pooled_chunks() {
+  _free_lock.acquire();
+  size_t result = _num_free_chunks;
+  _free_lock.release();
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: FrameArena::allocate_slow
+//       Access: Private
+//  Description: Called by allocate() when the current chunk is
+//               exhausted.  Starts a new chunk, or gives a large
+//               request a chunk of its own.
+////////////////////////////////////////////////////////////////////
+void *FrameArena::
+allocate_slow(size_t size) {
+  size_t chunk_size = (size_t)max((int)frame_arena_chunk_size, 1024);
+
+  if (size > chunk_size / 4) {
+    // This is a large request.  Give it its own chunk, and keep
+    // filling the current chunk for later requests.
+    Chunk *chunk = alloc_chunk(size);
+    if (_chunks == (Chunk *)NULL) {
+      _chunks = chunk;
+    } else {
+      chunk->_next = _chunks->_next;
+      _chunks->_next = chunk;
+    }
+    _bytes_used += size;
+    _bytes_reserved += size;
+    return chunk->_data;
+  }
+
+  Chunk *chunk = NULL;
+  _free_lock.acquire();
+  if (_free_chunks != (Chunk *)NULL) {
+    chunk = _free_chunks;
+    _free_chunks = chunk->_next;
+    --_num_free_chunks;
+  }
+  _free_lock.release();
+
+  if (chunk == (Chunk *)NULL || chunk->_size != chunk_size) {
+    // The chunk size has been changed since this chunk was pooled.
+    if (chunk != (Chunk *)NULL) {
+      free_chunk(chunk);
+    }
+    chunk = alloc_chunk(chunk_size);
+  }
+
+  chunk->_next = _chunks;
+  _chunks = chunk;
+  _bytes_reserved += chunk_size;
+
+  _ptr = chunk->_data + size;
+  _end = chunk->_data + chunk_size;
+  _bytes_used += size;
+  return chunk->_data;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: FrameArena::alloc_chunk
+//       Access: Private, Static
+//  Description: Allocates a new chunk from the heap, with room for
+//               size bytes of aligned data.
+////////////////////////////////////////////////////////////////////
+FrameArena::Chunk *FrameArena::
+alloc_chunk(size_t size) {
+  char *block = (char *)PANDA_MALLOC_ARRAY(sizeof(Chunk) + alignment + size);
+  Chunk *chunk = (Chunk *)block;
+  chunk->_next = NULL;
+  chunk->_size = size;
+
+  size_t data = (size_t)(block + sizeof(Chunk));
+  data = (data + (alignment - 1)) & ~(size_t)(alignment - 1);
+  chunk->_data = (char *)data;
+  return chunk;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: FrameArena::free_chunk
+//       Access: Private, Static
+//  Description: Returns a chunk to the heap.
+////////////////////////////////////////////////////////////////////
+void FrameArena::
+free_chunk(Chunk *chunk) {
+  PANDA_FREE_ARRAY(chunk);
+}
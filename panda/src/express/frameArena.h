@@ -0,0 +1,84 @@
+// Filename: frameArena.h
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+#include "pandabase.h"
+#include "mutexImpl.h"
+
+////////////////////////////////////////////////////////////////////
+//       Class : FrameArena
+// Description : A simple bump allocator for short-lived objects that
+//               all die at the same time, such as the objects
+//               generated by one frame's cull traversal.
+//
+//               Memory is handed out sequentially from large chunks,
+//               and is never freed individually; instead, reset()
+//               (or the destructor) releases everything at once.
+//               Released chunks are kept in a global pool for reuse
+//               by the next arena, so a steady-state frame makes no
+//               heap allocations at all.
+//
+//               A FrameArena is not thread-safe; it is intended to be
+//               filled by only one thread at a time.
+////////////////////////////////////////////////////////////////////
+class EXPCL_PANDAEXPRESS FrameArena {
+public:
+  FrameArena();
+  INLINE ~FrameArena();
+
+private:
+  FrameArena(const FrameArena &copy);
+  void operator = (const FrameArena &copy);
+
+public:
+  INLINE void *allocate(size_t size);
+  void reset();
+
+  INLINE size_t get_num_bytes_used() const;
+  INLINE size_t get_num_bytes_reserved() const;
+
+  static size_t get_num_pooled_chunks();
+
+private:
+  void *allocate_slow(size_t size);
+
+  class Chunk {
+  public:
+    Chunk *_next;
+    size_t _size;
+    char *_data;
+  };
+
+  static Chunk *alloc_chunk(size_t size);
+  static void free_chunk(Chunk *chunk);
+
+  enum { alignment = 16 };
+  static INLINE size_t align_size(size_t size);
+
+  Chunk *_chunks;
+  char *_ptr;
+  char *_end;
+  size_t _bytes_used;
+  size_t _bytes_reserved;
+
+  static Chunk *_free_chunks;
+  static size_t _num_free_chunks;
+  static MutexImpl _free_lock;
+};
+
+#include "frameArena.I"
+
+#endif
@@ -0,0 +1,78 @@
+// Filename: frameArenaAllocator.h
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#ifndef FRAMEARENAALLOCATOR_H
+#define FRAMEARENAALLOCATOR_H
+
+#include "pandabase.h"
+#include "frameArena.h"
+#include <memory>
+
+////////////////////////////////////////////////////////////////////
+//       Class : FrameArenaAllocator
+// Description : An STL allocator that draws its memory from a
+//               FrameArena, if one is given, or from the Panda heap
+//               otherwise.  Memory from the arena is not released by
+//               deallocate(); it goes away when the arena is reset,
+//               so a container using this allocator must be destroyed
+//               before its arena is.
+//
+//               This is a stateful allocator: containers that use it
+//               should be constructed with an explicit allocator
+//               instance, and should not be swapped with containers
+//               using a different arena.
+////////////////////////////////////////////////////////////////////
+template<class Type>
+class FrameArenaAllocator : public allocator<Type> {
+public:
+  // Nowadays we cannot implicitly inherit typedefs from base classes
+  // in a template class; we must explicitly copy them here.
+  typedef TYPENAME allocator<Type>::pointer pointer;
+  typedef TYPENAME allocator<Type>::reference reference;
+  typedef TYPENAME allocator<Type>::const_pointer const_pointer;
+  typedef TYPENAME allocator<Type>::const_reference const_reference;
+  typedef TYPENAME allocator<Type>::size_type size_type;
+
+  INLINE FrameArenaAllocator(FrameArena *arena = NULL) throw();
+
+  // template member functions in VC++ can only be defined in-class.
+  template<class U>
+  INLINE FrameArenaAllocator(const FrameArenaAllocator<U> &copy) throw() :
+    _arena(copy._arena) { }
+
+  INLINE pointer allocate(size_type n, allocator<void>::const_pointer hint = 0);
+  INLINE void deallocate(pointer p, size_type n);
+
+  template<class U> struct rebind { 
+    typedef FrameArenaAllocator<U> other;
+  };
+
+  FrameArena *_arena;
+};
+
+template<class Type, class U>
+INLINE bool operator == (const FrameArenaAllocator<Type> &a,
+                         const FrameArenaAllocator<U> &b) {
+  return a._arena == b._arena;
+}
+
+template<class Type, class U>
+INLINE bool operator != (const FrameArenaAllocator<Type> &a,
+                         const FrameArenaAllocator<U> &b) {
+  return a._arena != b._arena;
+}
+
+#include "frameArenaAllocator.T"
+
+#endif
@@ -1146,6 +1146,41 @@ ns_show_trend_ages() {
   _trend_ages.show();
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: MemoryUsage::ns_show_thread_caches
+//       Access: Private
+//  Description: Shows the hit rate of each of the per-thread
+//               deleted-chain caches.
+////////////////////////////////////////////////////////////////////
+void MemoryUsage::
+ns_show_thread_caches() {
+  size_t total_hits = 0;
+  size_t total_misses = 0;
+
+  int num_caches = get_num_thread_caches();
+  for (int i = 0; i < num_caches; ++i) {
+    size_t hits = get_thread_cache_hits(i);
+    size_t misses = get_thread_cache_misses(i);
+    total_hits += hits;
+    total_misses += misses;
+
+    nout << "thread cache " << i;
+    if (!DeletedBufferChain::is_thread_cache_active(i)) {
+      nout << " (idle)";
+    }
+    nout << " : " << hits << " hits, " << misses << " misses, "
+         << get_thread_cache_hit_rate(i) * 100.0 << "% hit rate\n";
+  }
+
+  size_t total = total_hits + total_misses;
+  nout << num_caches << " thread caches : " << total_hits << " hits, "
+       << total_misses << " misses";
+  if (total != 0) {
+    nout << ", " << (double)total_hits * 100.0 / (double)total << "% hit rate";
+  }
+  nout << "\n";
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: MemoryUsage::consolidate_void_ptr
 //       Access: Private
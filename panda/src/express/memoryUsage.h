@@ -24,6 +24,7 @@
 #include "memoryUsagePointerCounts.h"
 #include "pmap.h"
 #include "memoryHook.h"
+#include "deletedBufferChain.h"
 
 class ReferenceCount;
 class MemoryUsagePointers;
@@ -91,6 +92,12 @@ PUBLISHED:
   INLINE static void show_current_ages();
   INLINE static void show_trend_ages();
 
+  INLINE static int get_num_thread_caches();
+  INLINE static size_t get_thread_cache_hits(int n);
+  INLINE static size_t get_thread_cache_misses(int n);
+  INLINE static double get_thread_cache_hit_rate(int n);
+  INLINE static void show_thread_caches();
+
 protected:
   virtual void overflow_heap_size();
 
@@ -120,6 +127,7 @@ private:
   void ns_show_trend_types();
   void ns_show_current_ages();
   void ns_show_trend_ages();
+  void ns_show_thread_caches();
 
   void consolidate_void_ptr(MemoryInfo *info);
   void refresh_info_set();
@@ -11,6 +11,7 @@
 #include "encrypt_string.cxx"
 #include "error_utils.cxx"
 #include "fileReference.cxx"
+#include "frameArena.cxx"
 #include "hashGeneratorBase.cxx"
 #include "hashVal.cxx"
 #include "memoryInfo.cxx"
@@ -238,3 +238,12 @@
 
 #end test_bin_target
 
+#begin test_bin_target
+  #define TARGET test_geomVertexColumn
+  #define LOCAL_LIBS \
+    p3gobj p3putil
+
+  #define SOURCES \
+    test_geomVertexColumn.cxx
+
+#end test_bin_target
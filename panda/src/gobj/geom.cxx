@@ -826,6 +826,55 @@ make_patches_in_place() {
   nassertv(all_is_valid);
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: Geom::optimize_vertex_cache_in_place
+//       Access: Published
+//  Description: Reorders the triangles within this Geom for better
+//               use of the post-transform vertex cache, and, if
+//               sort_for_overdraw is true, to reduce overdraw,
+//               leaving the results in place.  See
+//               GeomPrimitive::optimize_vertex_cache() and
+//               GeomPrimitive::sort_for_overdraw().
+//
+//               This does not change the order of the vertices
+//               themselves, since the GeomVertexData may be shared
+//               with other Geoms; see
+//               SceneGraphReducer::optimize_vertex_cache().
+//
+//               Don't call this in a downstream thread unless you
+//               don't mind it blowing away other changes you might
+//               have recently made in an upstream thread.
+////////////////////////////////////////////////////////////////////
+void Geom::
+optimize_vertex_cache_in_place(int cache_size, bool sort_for_overdraw) {
+  Thread *current_thread = Thread::get_current_thread();
+  CDWriter cdata(_cycler, true, current_thread);
+  CPT(GeomVertexData) vdata = cdata->_data.get_read_pointer();
+
+#ifndef NDEBUG
+  bool all_is_valid = true;
+#endif
+  Primitives::iterator pi;
+  for (pi = cdata->_primitives.begin(); pi != cdata->_primitives.end(); ++pi) {
+    CPT(GeomPrimitive) new_prim = (*pi).get_read_pointer()->optimize_vertex_cache(cache_size);
+    if (sort_for_overdraw) {
+      new_prim = new_prim->sort_for_overdraw(vdata);
+    }
+    (*pi) = (GeomPrimitive *)new_prim.p();
+
+#ifndef NDEBUG
+    if (!new_prim->check_valid(vdata)) {
+      all_is_valid = false;
+    }
+#endif
+  }
+
+  cdata->_modified = Geom::get_next_modified();
+  clear_cache_stage(current_thread);
+
+  nassertv(all_is_valid);
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: Geom::copy_primitives_from
 //       Access: Published, Virtual
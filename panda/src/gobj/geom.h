@@ -103,6 +103,8 @@ PUBLISHED:
   INLINE PT(Geom) unify(int max_indices, bool preserve_order) const;
   INLINE PT(Geom) make_points() const;
   INLINE PT(Geom) make_patches() const;
+  INLINE PT(Geom) optimize_vertex_cache(int cache_size = 32,
+                                        bool sort_for_overdraw = false) const;
 
   void decompose_in_place();
   void doubleside_in_place();
@@ -111,6 +113,8 @@ PUBLISHED:
   void unify_in_place(int max_indices, bool preserve_order);
   void make_points_in_place();
   void make_patches_in_place();
+  void optimize_vertex_cache_in_place(int cache_size = 32,
+                                      bool sort_for_overdraw = false);
 
   virtual bool copy_primitives_from(const Geom *other);
 
@@ -279,6 +283,9 @@ public:
   private:
     static TypeHandle _type_handle;
   };
+  // This stays an ordered map rather than a SimpleHashMap: it is
+  // keyed on the contents of the CacheKey, and it rarely holds more
+  // than one entry per GSG, so a search is only a comparison or two.
   typedef pmap<const CacheKey *, PT(CacheEntry), IndirectLess<CacheKey> > Cache;
 
 private:
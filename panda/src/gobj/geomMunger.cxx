@@ -207,12 +207,11 @@ do_munge_format(const GeomVertexFormat *format,
 
   Formats &formats = _formats_by_animation[animation];
 
-  Formats::iterator fi;
-  fi = formats.find(format);
-  if (fi != formats.end()) {
+  int fi = formats.find(format);
+  if (fi != -1) {
     // This format was previously munged, so the answer will be the
     // same.
-    return (*fi).second;
+    return formats.get_data(fi);
   }
 
   // We have to munge this format for the first time.
@@ -220,8 +219,7 @@ do_munge_format(const GeomVertexFormat *format,
   nassertr(derived_format->is_registered(), NULL);
 
   // Store the answer in the map, so we can quickly get it next time.
-  bool inserted = formats.insert(Formats::value_type(format, derived_format)).second;
-  nassertr(inserted, NULL);
+  formats.store(format, derived_format);
 
   return derived_format;
 }
@@ -283,12 +281,11 @@ do_premunge_format(const GeomVertexFormat *format) {
 
   LightMutexHolder holder(_formats_lock);
 
-  Formats::iterator fi;
-  fi = _premunge_formats.find(format);
-  if (fi != _premunge_formats.end()) {
+  int fi = _premunge_formats.find(format);
+  if (fi != -1) {
     // This format was previously munged, so the answer will be the
     // same.
-    return (*fi).second;
+    return _premunge_formats.get_data(fi);
   }
 
   // We have to munge this format for the first time.
@@ -296,8 +293,7 @@ do_premunge_format(const GeomVertexFormat *format) {
   nassertr(derived_format->is_registered(), NULL);
 
   // Store the answer in the map, so we can quickly get it next time.
-  bool inserted = _premunge_formats.insert(Formats::value_type(format, derived_format)).second;
-  nassertr(inserted, NULL);
+  _premunge_formats.store(format, derived_format);
 
   return derived_format;
 }
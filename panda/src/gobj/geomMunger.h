@@ -28,6 +28,7 @@
 #include "pointerTo.h"
 #include "pmap.h"
 #include "pset.h"
+#include "simpleHashMap.h"
 
 class GraphicsStateGuardianBase;
 class RenderState;
@@ -121,7 +122,9 @@ private:
     PT(GeomMunger) _munger;
   };
 
-  typedef pmap<CPT(GeomVertexFormat), CPT(GeomVertexFormat) > Formats;
+  // These are consulted for every Geom munged, so they are hash maps
+  // keyed on the (unique, registered) format pointer.
+  typedef SimpleHashMap<CPT(GeomVertexFormat), CPT(GeomVertexFormat), pointer_hash> Formats;
   typedef pmap<GeomVertexAnimationSpec, Formats> FormatsByAnimation;
   FormatsByAnimation _formats_by_animation;
   Formats _premunge_formats;
@@ -132,6 +135,10 @@ private:
   GraphicsStateGuardianBase *_gsg;
 
   bool _is_registered;
+  // The registry finds equivalent mungers with compare_to(), not by
+  // pointer, and each munger keeps an iterator to its own entry; so
+  // this is an ordered set, whose iterators stay valid, rather than a
+  // SimpleHashMap, whose slots move.
   typedef pset<GeomMunger *, IndirectCompareTo<GeomMunger> > Mungers;
   class EXPCL_PANDA_GOBJ Registry {
   public:
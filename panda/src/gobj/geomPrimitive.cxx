@@ -37,6 +37,7 @@ PStatCollector GeomPrimitive::_decompose_pcollector("*:Munge:Decompose");
 PStatCollector GeomPrimitive::_doubleside_pcollector("*:Munge:Doubleside");
 PStatCollector GeomPrimitive::_reverse_pcollector("*:Munge:Reverse");
 PStatCollector GeomPrimitive::_rotate_pcollector("*:Munge:Rotate");
+PStatCollector GeomPrimitive::_vertex_cache_pcollector("*:Munge:Vertex cache");
 
 ////////////////////////////////////////////////////////////////////
 //     Function: GeomPrimitive::Default Constructor
@@ -1026,6 +1027,104 @@ make_patches() const {
   return patches;
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: GeomPrimitive::optimize_vertex_cache
+//       Access: Published
+//  Description: Returns a new primitive with the same triangles in a
+//               different order, chosen so that consecutive triangles
+//               tend to share vertices while they are still in the
+//               graphics card's post-transform vertex cache.  The
+//               cache_size should be the number of entries in that
+//               cache, or a little less.  The vertices within each
+//               triangle are not changed, so this does not affect
+//               the winding order or the provoking vertex.
+//
+//               This is only implemented for indexed GeomTriangles;
+//               for other primitive types, this returns the original
+//               object.  Call decompose() first to apply this to
+//               strips and fans.
+////////////////////////////////////////////////////////////////////
+CPT(GeomPrimitive) GeomPrimitive::
+optimize_vertex_cache(int cache_size) const {
+  if (gobj_cat.is_debug()) {
+    gobj_cat.debug()
+      << "Optimizing vertex cache for " << get_type() << ": "
+      << (void *)this << "\n";
+  }
+
+  PStatTimer timer(_vertex_cache_pcollector);
+  return optimize_vertex_cache_impl(cache_size);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomPrimitive::sort_for_overdraw
+//       Access: Published
+//  Description: Returns a new primitive whose triangles are grouped
+//               into clusters of cluster_size consecutive triangles,
+//               with the clusters reordered so that the ones facing
+//               outward from the center of the mesh are drawn first.
+//               These are the ones most likely to occlude the rest,
+//               so this reduces overdraw regardless of the view
+//               direction.
+//
+//               This is intended to be called after
+//               optimize_vertex_cache(); since the order within each
+//               cluster is preserved, most of the cache locality is
+//               kept.  The vertex_data is needed to find the
+//               positions of the vertices.
+//
+//               This is only implemented for indexed GeomTriangles;
+//               for other primitive types, this returns the original
+//               object.
+////////////////////////////////////////////////////////////////////
+CPT(GeomPrimitive) GeomPrimitive::
+sort_for_overdraw(const GeomVertexData *vertex_data, int cluster_size) const {
+  PStatTimer timer(_vertex_cache_pcollector);
+  return sort_for_overdraw_impl(vertex_data, cluster_size);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomPrimitive::get_acmr
+//       Access: Published
+//  Description: Returns the average cache miss ratio of the
+//               primitive: the number of vertices that would have to
+//               be transformed, per primitive drawn, given a FIFO
+//               post-transform vertex cache of the indicated size.
+//               For triangles, this ranges from 3.0 (no vertex is
+//               ever reused) down to about 0.5 for a well-ordered
+//               regular mesh.
+//
+//               This is useful to measure the effect of
+//               optimize_vertex_cache().
+////////////////////////////////////////////////////////////////////
+PN_stdfloat GeomPrimitive::
+get_acmr(int cache_size) const {
+  nassertr(cache_size > 0, 0.0f);
+
+  Thread *current_thread = Thread::get_current_thread();
+  CPT(GeomPrimitive) prim = decompose();
+  GeomPrimitivePipelineReader reader(prim, current_thread);
+  int num_primitives = reader.get_num_primitives();
+  if (num_primitives == 0) {
+    return 0.0f;
+  }
+
+  // A vertex is in the cache if it was loaded within the last
+  // cache_size misses.
+  int num_vertices = reader.get_num_vertices();
+  pvector<int> loaded_at(reader.get_max_vertex() + 1, -cache_size - 1);
+  int num_misses = 0;
+  for (int i = 0; i < num_vertices; ++i) {
+    int vertex = reader.get_vertex(i);
+    if (num_misses - loaded_at[vertex] >= cache_size) {
+      loaded_at[vertex] = num_misses;
+      ++num_misses;
+    }
+  }
+
+  return (PN_stdfloat)num_misses / (PN_stdfloat)num_primitives;
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeomPrimitive::get_num_bytes
 //       Access: Published
@@ -1712,6 +1811,27 @@ decompose_impl() const {
   return this;
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: GeomPrimitive::optimize_vertex_cache_impl
+//       Access: Protected, Virtual
+//  Description: The virtual implementation of
+//               optimize_vertex_cache().
+////////////////////////////////////////////////////////////////////
+CPT(GeomPrimitive) GeomPrimitive::
+optimize_vertex_cache_impl(int cache_size) const {
+  return this;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomPrimitive::sort_for_overdraw_impl
+//       Access: Protected, Virtual
+//  Description: The virtual implementation of sort_for_overdraw().
+////////////////////////////////////////////////////////////////////
+CPT(GeomPrimitive) GeomPrimitive::
+sort_for_overdraw_impl(const GeomVertexData *vertex_data, int cluster_size) const {
+  return this;
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeomPrimitive::rotate_impl
 //       Access: Protected, Virtual
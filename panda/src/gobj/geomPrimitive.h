@@ -134,6 +134,10 @@ PUBLISHED:
   CPT(GeomPrimitive) match_shade_model(ShadeModel shade_model) const;
   CPT(GeomPrimitive) make_points() const;
   CPT(GeomPrimitive) make_patches() const;
+  CPT(GeomPrimitive) optimize_vertex_cache(int cache_size = 32) const;
+  CPT(GeomPrimitive) sort_for_overdraw(const GeomVertexData *vertex_data,
+                                       int cluster_size = 64) const;
+  PN_stdfloat get_acmr(int cache_size = 32) const;
 
   int get_num_bytes() const;
   INLINE int get_data_size_bytes() const;
@@ -212,6 +216,9 @@ protected:
   virtual CPT(GeomVertexArrayData) rotate_impl() const;
   virtual CPT(GeomPrimitive) doubleside_impl() const;
   virtual CPT(GeomPrimitive) reverse_impl() const;
+  virtual CPT(GeomPrimitive) optimize_vertex_cache_impl(int cache_size) const;
+  virtual CPT(GeomPrimitive) sort_for_overdraw_impl(const GeomVertexData *vertex_data,
+                                                    int cluster_size) const;
   virtual bool requires_unused_vertices() const;
   virtual void append_unused_vertices(GeomVertexArrayData *vertices, 
                                       int vertex);
@@ -289,6 +296,7 @@ private:
   static PStatCollector _doubleside_pcollector;
   static PStatCollector _reverse_pcollector;
   static PStatCollector _rotate_pcollector;
+  static PStatCollector _vertex_cache_pcollector;
 
 public:
   virtual void write_datagram(BamWriter *manager, Datagram &dg);
@@ -14,6 +14,9 @@
 
 #include "geomTriangles.h"
 #include "geomVertexRewriter.h"
+#include "geomVertexReader.h"
+#include "geomVertexData.h"
+#include "cmath.h"
 #include "pStatTimer.h"
 #include "bamReader.h"
 #include "bamWriter.h"
@@ -278,6 +281,294 @@ rotate_impl() const {
   return new_vertices;
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: GeomTriangles::optimize_vertex_cache_impl
+//       Access: Protected, Virtual
+//  Description: The virtual implementation of
+//               optimize_vertex_cache().  This is Tom Forsyth's
+//               "linear-speed vertex cache optimisation": each
+//               vertex is scored by its position in a simulated LRU
+//               cache and by the number of triangles still waiting
+//               to use it, and the next triangle drawn is always the
+//               highest-scoring one among those touching the cache.
+////////////////////////////////////////////////////////////////////
+CPT(GeomPrimitive) GeomTriangles::
+optimize_vertex_cache_impl(int cache_size) const {
+  if (!is_indexed() || cache_size <= 3) {
+    return this;
+  }
+
+  Thread *current_thread = Thread::get_current_thread();
+  GeomPrimitivePipelineReader from(this, current_thread);
+  int num_triangles = from.get_num_vertices() / 3;
+  if (num_triangles < 2) {
+    return this;
+  }
+  int num_vertices = from.get_max_vertex() + 1;
+
+  pvector<int> indices(num_triangles * 3);
+  for (int i = 0; i < num_triangles * 3; ++i) {
+    indices[i] = from.get_vertex(i);
+  }
+
+  // For each vertex, the list of triangles that use it.  The first
+  // remaining[v] entries of each list are the triangles that have not
+  // yet been drawn.
+  pvector<int> remaining(num_vertices, 0);
+  for (int i = 0; i < num_triangles * 3; ++i) {
+    ++remaining[indices[i]];
+  }
+  pvector<int> adj_start(num_vertices + 1, 0);
+  for (int v = 0; v < num_vertices; ++v) {
+    adj_start[v + 1] = adj_start[v] + remaining[v];
+  }
+  pvector<int> adj(num_triangles * 3);
+  {
+    pvector<int> fill(adj_start);
+    for (int i = 0; i < num_triangles * 3; ++i) {
+      adj[fill[indices[i]]++] = i / 3;
+    }
+  }
+
+  pvector<int> cache_position(num_vertices, -1);
+  pvector<float> vertex_score(num_vertices);
+  for (int v = 0; v < num_vertices; ++v) {
+    vertex_score[v] = get_vertex_cache_score(-1, remaining[v], cache_size);
+  }
+
+  pvector<float> triangle_score(num_triangles);
+  pvector<bool> drawn(num_triangles, false);
+  for (int t = 0; t < num_triangles; ++t) {
+    triangle_score[t] = vertex_score[indices[t * 3]] +
+      vertex_score[indices[t * 3 + 1]] + vertex_score[indices[t * 3 + 2]];
+  }
+
+  pvector<int> order;
+  order.reserve(num_triangles * 3);
+  pvector<int> cache, new_cache;
+  cache.reserve(cache_size + 3);
+  new_cache.reserve(cache_size + 3);
+
+  int best = -1;
+  int next_undrawn = 0;
+  for (int n = 0; n < num_triangles; ++n) {
+    if (best < 0) {
+      // Nothing in the cache leads anywhere; start again with the
+      // next triangle that hasn't been drawn.
+      while (drawn[next_undrawn]) {
+        ++next_undrawn;
+      }
+      best = next_undrawn;
+    }
+
+    // Draw the best triangle, and remove it from its vertices'
+    // lists of waiting triangles.
+    drawn[best] = true;
+    const int *tri = &indices[best * 3];
+    for (int c = 0; c < 3; ++c) {
+      int v = tri[c];
+      order.push_back(v);
+      int *begin = &adj[adj_start[v]];
+      int *end = begin + remaining[v];
+      int *ti = find(begin, end, best);
+      nassertr(ti != end, this);
+      *ti = *(end - 1);
+      --remaining[v];
+    }
+
+    // Move its vertices to the front of the cache.
+    new_cache.clear();
+    new_cache.push_back(tri[0]);
+    new_cache.push_back(tri[1]);
+    new_cache.push_back(tri[2]);
+    for (size_t i = 0; i < cache.size(); ++i) {
+      int v = cache[i];
+      if (v != tri[0] && v != tri[1] && v != tri[2]) {
+        new_cache.push_back(v);
+      }
+    }
+
+    // Rescore the vertices in the cache, including any that just
+    // fell out of it, and then the triangles that use them.
+    for (size_t i = 0; i < new_cache.size(); ++i) {
+      int v = new_cache[i];
+      cache_position[v] = ((int)i < cache_size) ? (int)i : -1;
+      vertex_score[v] = get_vertex_cache_score(cache_position[v], remaining[v], cache_size);
+    }
+
+    best = -1;
+    float best_score = -1.0f;
+    for (size_t i = 0; i < new_cache.size(); ++i) {
+      int v = new_cache[i];
+      const int *begin = &adj[adj_start[v]];
+      const int *end = begin + remaining[v];
+      for (const int *ti = begin; ti != end; ++ti) {
+        int t = *ti;
+        const int *ttri = &indices[t * 3];
+        float score = vertex_score[ttri[0]] + vertex_score[ttri[1]] + vertex_score[ttri[2]];
+        triangle_score[t] = score;
+        if (score > best_score) {
+          best_score = score;
+          best = t;
+        }
+      }
+    }
+
+    if ((int)new_cache.size() > cache_size) {
+      new_cache.resize(cache_size);
+    }
+    cache.swap(new_cache);
+  }
+
+  PT(GeomTriangles) result = new GeomTriangles(*this);
+  PT(GeomVertexArrayData) new_vertices = result->make_index_data();
+  new_vertices->unclean_set_num_rows((int)order.size());
+  {
+    GeomVertexWriter to(new_vertices, 0, current_thread);
+    for (size_t i = 0; i < order.size(); ++i) {
+      to.set_data1i(order[i]);
+    }
+  }
+  result->set_vertices(new_vertices);
+
+  return result.p();
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomTriangles::sort_for_overdraw_impl
+//       Access: Protected, Virtual
+//  Description: The virtual implementation of sort_for_overdraw().
+//               This is the cluster sorting step of Sander et al's
+//               "Tipsify", using fixed-size clusters.
+////////////////////////////////////////////////////////////////////
+CPT(GeomPrimitive) GeomTriangles::
+sort_for_overdraw_impl(const GeomVertexData *vertex_data, int cluster_size) const {
+  if (!is_indexed() || cluster_size < 1 || vertex_data == (GeomVertexData *)NULL ||
+      !vertex_data->has_column(InternalName::get_vertex())) {
+    return this;
+  }
+
+  Thread *current_thread = Thread::get_current_thread();
+  GeomPrimitivePipelineReader from(this, current_thread);
+  int num_triangles = from.get_num_vertices() / 3;
+  int num_clusters = (num_triangles + cluster_size - 1) / cluster_size;
+  if (num_clusters < 2) {
+    return this;
+  }
+
+  GeomVertexReader vertex(vertex_data, InternalName::get_vertex(), current_thread);
+
+  // Compute the area-weighted centroid and the average normal of
+  // each cluster, and the centroid of the whole mesh.
+  pvector<OverdrawCluster> clusters(num_clusters);
+  LPoint3 mesh_centroid = LPoint3::zero();
+  PN_stdfloat mesh_area = 0.0f;
+  for (int c = 0; c < num_clusters; ++c) {
+    OverdrawCluster &cluster = clusters[c];
+    cluster._start = c * cluster_size;
+    cluster._end = min(cluster._start + cluster_size, num_triangles);
+
+    LPoint3 centroid = LPoint3::zero();
+    LVector3 normal = LVector3::zero();
+    PN_stdfloat area = 0.0f;
+    for (int t = cluster._start; t < cluster._end; ++t) {
+      vertex.set_row_unsafe(from.get_vertex(t * 3));
+      LPoint3 p0 = vertex.get_data3();
+      vertex.set_row_unsafe(from.get_vertex(t * 3 + 1));
+      LPoint3 p1 = vertex.get_data3();
+      vertex.set_row_unsafe(from.get_vertex(t * 3 + 2));
+      LPoint3 p2 = vertex.get_data3();
+
+      LVector3 n = (p1 - p0).cross(p2 - p0);
+      PN_stdfloat a = n.length();
+      centroid += (p0 + p1 + p2) * (a / 3.0f);
+      normal += n;
+      area += a;
+    }
+
+    mesh_centroid += centroid;
+    mesh_area += area;
+    if (area > 0.0f) {
+      centroid /= area;
+    }
+    normal.normalize();
+    cluster._centroid = centroid;
+    cluster._normal = normal;
+  }
+  if (mesh_area > 0.0f) {
+    mesh_centroid /= mesh_area;
+  }
+
+  for (int c = 0; c < num_clusters; ++c) {
+    OverdrawCluster &cluster = clusters[c];
+    cluster._sort = (cluster._centroid - mesh_centroid).dot(cluster._normal);
+  }
+  stable_sort(clusters.begin(), clusters.end());
+
+  PT(GeomTriangles) result = new GeomTriangles(*this);
+  PT(GeomVertexArrayData) new_vertices = result->make_index_data();
+  new_vertices->unclean_set_num_rows(num_triangles * 3);
+  {
+    GeomVertexWriter to(new_vertices, 0, current_thread);
+    for (int c = 0; c < num_clusters; ++c) {
+      const OverdrawCluster &cluster = clusters[c];
+      for (int i = cluster._start * 3; i < cluster._end * 3; ++i) {
+        to.set_data1i(from.get_vertex(i));
+      }
+    }
+  }
+  result->set_vertices(new_vertices);
+
+  return result.p();
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomTriangles::get_vertex_cache_score
+//       Access: Private, Static
+//  Description: Returns the score of a vertex for
+//               optimize_vertex_cache_impl(), given its position in
+//               the cache (or -1 if it is not in the cache) and the
+//               number of triangles that have yet to use it.
+//               Vertices that were just used, or that are nearly
+//               finished, score highest.
+////////////////////////////////////////////////////////////////////
+float GeomTriangles::
+get_vertex_cache_score(int cache_position, int remaining, int cache_size) {
+  if (remaining == 0) {
+    // No triangle needs this vertex any more.
+    return -1.0f;
+  }
+
+  float score = 0.0f;
+  if (cache_position >= 0) {
+    if (cache_position < 3) {
+      // The vertices of the triangle we just drew get a fixed score,
+      // so that we don't favor simply drawing the same triangle
+      // again (or a strip-like order, which is worse).
+      score = 0.75f;
+    } else {
+      float scale = 1.0f - (float)(cache_position - 3) / (float)(cache_size - 3);
+      score = cpow(scale, 1.5f);
+    }
+  }
+
+  // Boost vertices with few triangles left, so we don't leave lone
+  // triangles behind to draw later.
+  score += 2.0f / csqrt((float)remaining);
+  return score;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomTriangles::OverdrawCluster::operator <
+//       Access: Public
+//  Description: Sorts the clusters that face most directly away
+//               from the center of the mesh to the front.
+////////////////////////////////////////////////////////////////////
+bool GeomTriangles::OverdrawCluster::
+operator < (const GeomTriangles::OverdrawCluster &other) const {
+  return _sort > other._sort;
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeomTriangles::register_with_read_factory
 //       Access: Public, Static
@@ -44,6 +44,24 @@ protected:
   virtual CPT(GeomPrimitive) doubleside_impl() const;
   virtual CPT(GeomPrimitive) reverse_impl() const;
   virtual CPT(GeomVertexArrayData) rotate_impl() const;
+  virtual CPT(GeomPrimitive) optimize_vertex_cache_impl(int cache_size) const;
+  virtual CPT(GeomPrimitive) sort_for_overdraw_impl(const GeomVertexData *vertex_data,
+                                                    int cluster_size) const;
+
+private:
+  static float get_vertex_cache_score(int cache_position, int remaining,
+                                      int cache_size);
+
+  class OverdrawCluster {
+  public:
+    bool operator < (const OverdrawCluster &other) const;
+
+    int _start;
+    int _end;
+    LPoint3 _centroid;
+    LVector3 _normal;
+    PN_stdfloat _sort;
+  };
 
 public:
   static void register_with_read_factory();
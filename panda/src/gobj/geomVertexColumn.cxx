@@ -17,6 +17,14 @@
 #include "bamReader.h"
 #include "bamWriter.h"
 
+// The 8-bit color packers convert a whole row at a time with SSE2,
+// when the compiler is targeting a processor that has it.
+#if !defined(CPPPARSER) && \
+  (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define PACKER_SSE2 1
+#include <emmintrin.h>
+#endif
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeomVertexColumn::Copy Assignment Operator
 //       Access: Published
@@ -2140,6 +2148,62 @@ set_data4i(unsigned char *pointer, const LVecBase4i &data) {
   }
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer::get_data4f_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer::
+get_data4f_array(LVecBase4f *to, const unsigned char *from,
+                 size_t from_stride, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    to[i] = get_data4f(from);
+    from += from_stride;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer::get_data4d_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer::
+get_data4d_array(LVecBase4d *to, const unsigned char *from,
+                 size_t from_stride, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    to[i] = get_data4d(from);
+    from += from_stride;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer::set_data4f_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer::
+set_data4f_array(unsigned char *to, size_t to_stride,
+                 const LVecBase4f *from, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    set_data4f(to, from[i]);
+    to += to_stride;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer::set_data4d_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer::
+set_data4d_array(unsigned char *to, size_t to_stride,
+                 const LVecBase4d *from, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    set_data4d(to, from[i]);
+    to += to_stride;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeomVertexColumn::Packer_point::get_data1f
 //       Access: Public, Virtual
@@ -2953,6 +3017,70 @@ set_data3f(unsigned char *pointer, const LVecBase3f &data) {
   pi[2] = data[2];
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_float32_3::get_data4f_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_float32_3::
+get_data4f_array(LVecBase4f *to, const unsigned char *from,
+                 size_t from_stride, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    const PN_float32 *pi = (const PN_float32 *)from;
+    to[i].set(pi[0], pi[1], pi[2], 0.0f);
+    from += from_stride;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_float32_3::set_data4f_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_float32_3::
+set_data4f_array(unsigned char *to, size_t to_stride,
+                 const LVecBase4f *from, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    PN_float32 *pi = (PN_float32 *)to;
+    pi[0] = from[i][0];
+    pi[1] = from[i][1];
+    pi[2] = from[i][2];
+    to += to_stride;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_float32_3::get_data4d_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_float32_3::
+get_data4d_array(LVecBase4d *to, const unsigned char *from,
+                 size_t from_stride, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    const PN_float32 *pi = (const PN_float32 *)from;
+    to[i].set(pi[0], pi[1], pi[2], 0.0);
+    from += from_stride;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_float32_3::set_data4d_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_float32_3::
+set_data4d_array(unsigned char *to, size_t to_stride,
+                 const LVecBase4d *from, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    PN_float32 *pi = (PN_float32 *)to;
+    pi[0] = from[i][0];
+    pi[1] = from[i][1];
+    pi[2] = from[i][2];
+    to += to_stride;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeomVertexColumn::Packer_point_float32_2::get_data2f
 //       Access: Public, Virtual
@@ -3002,6 +3130,72 @@ set_data3f(unsigned char *pointer, const LVecBase3f &data) {
   pi[2] = data[2];
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_point_float32_3::get_data4f_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_point_float32_3::
+get_data4f_array(LVecBase4f *to, const unsigned char *from,
+                 size_t from_stride, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    const PN_float32 *pi = (const PN_float32 *)from;
+    to[i].set(pi[0], pi[1], pi[2], 1.0f);
+    from += from_stride;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_point_float32_3::set_data4f_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_point_float32_3::
+set_data4f_array(unsigned char *to, size_t to_stride,
+                 const LVecBase4f *from, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    const LVecBase4f &data = from[i];
+    PN_float32 *pi = (PN_float32 *)to;
+    pi[0] = data[0] / data[3];
+    pi[1] = data[1] / data[3];
+    pi[2] = data[2] / data[3];
+    to += to_stride;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_point_float32_3::get_data4d_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_point_float32_3::
+get_data4d_array(LVecBase4d *to, const unsigned char *from,
+                 size_t from_stride, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    const PN_float32 *pi = (const PN_float32 *)from;
+    to[i].set(pi[0], pi[1], pi[2], 1.0);
+    from += from_stride;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_point_float32_3::set_data4d_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_point_float32_3::
+set_data4d_array(unsigned char *to, size_t to_stride,
+                 const LVecBase4d *from, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    const LVecBase4d &data = from[i];
+    PN_float32 *pi = (PN_float32 *)to;
+    pi[0] = data[0] / data[3];
+    pi[1] = data[1] / data[3];
+    pi[2] = data[2] / data[3];
+    to += to_stride;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeomVertexColumn::Packer_point_float32_4::get_data4f
 //       Access: Public, Virtual
@@ -3028,6 +3222,72 @@ set_data4f(unsigned char *pointer, const LVecBase4f &data) {
   pi[3] = data[3];
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_point_float32_4::get_data4f_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_point_float32_4::
+get_data4f_array(LVecBase4f *to, const unsigned char *from,
+                 size_t from_stride, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    const PN_float32 *pi = (const PN_float32 *)from;
+    to[i].set(pi[0], pi[1], pi[2], pi[3]);
+    from += from_stride;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_point_float32_4::set_data4f_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_point_float32_4::
+set_data4f_array(unsigned char *to, size_t to_stride,
+                 const LVecBase4f *from, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    PN_float32 *pi = (PN_float32 *)to;
+    pi[0] = from[i][0];
+    pi[1] = from[i][1];
+    pi[2] = from[i][2];
+    pi[3] = from[i][3];
+    to += to_stride;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_point_float32_4::get_data4d_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_point_float32_4::
+get_data4d_array(LVecBase4d *to, const unsigned char *from,
+                 size_t from_stride, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    const PN_float32 *pi = (const PN_float32 *)from;
+    to[i].set(pi[0], pi[1], pi[2], pi[3]);
+    from += from_stride;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_point_float32_4::set_data4d_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_point_float32_4::
+set_data4d_array(unsigned char *to, size_t to_stride,
+                 const LVecBase4d *from, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    PN_float32 *pi = (PN_float32 *)to;
+    pi[0] = from[i][0];
+    pi[1] = from[i][1];
+    pi[2] = from[i][2];
+    pi[3] = from[i][3];
+    to += to_stride;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeomVertexColumn::Packer_nativefloat_3::get_data3f
 //       Access: Public, Virtual
@@ -3093,6 +3353,38 @@ set_data3d(unsigned char *pointer, const LVecBase3d &data) {
   pi[2] = data[2];
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_float64_3::get_data4d_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_float64_3::
+get_data4d_array(LVecBase4d *to, const unsigned char *from,
+                 size_t from_stride, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    const PN_float64 *pi = (const PN_float64 *)from;
+    to[i].set(pi[0], pi[1], pi[2], 0.0);
+    from += from_stride;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_float64_3::set_data4d_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_float64_3::
+set_data4d_array(unsigned char *to, size_t to_stride,
+                 const LVecBase4d *from, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    PN_float64 *pi = (PN_float64 *)to;
+    pi[0] = from[i][0];
+    pi[1] = from[i][1];
+    pi[2] = from[i][2];
+    to += to_stride;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeomVertexColumn::Packer_point_float64_2::get_data2d
 //       Access: Public, Virtual
@@ -3142,6 +3434,39 @@ set_data3d(unsigned char *pointer, const LVecBase3d &data) {
   pi[2] = data[2];
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_point_float64_3::get_data4d_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_point_float64_3::
+get_data4d_array(LVecBase4d *to, const unsigned char *from,
+                 size_t from_stride, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    const PN_float64 *pi = (const PN_float64 *)from;
+    to[i].set(pi[0], pi[1], pi[2], 1.0);
+    from += from_stride;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_point_float64_3::set_data4d_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_point_float64_3::
+set_data4d_array(unsigned char *to, size_t to_stride,
+                 const LVecBase4d *from, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    const LVecBase4d &data = from[i];
+    PN_float64 *pi = (PN_float64 *)to;
+    pi[0] = data[0] / data[3];
+    pi[1] = data[1] / data[3];
+    pi[2] = data[2] / data[3];
+    to += to_stride;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeomVertexColumn::Packer_point_float64_4::get_data4d
 //       Access: Public, Virtual
@@ -3168,6 +3493,39 @@ set_data4d(unsigned char *pointer, const LVecBase4d &data) {
   pi[3] = data[3];
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_point_float64_4::get_data4d_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_point_float64_4::
+get_data4d_array(LVecBase4d *to, const unsigned char *from,
+                 size_t from_stride, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    const PN_float64 *pi = (const PN_float64 *)from;
+    to[i].set(pi[0], pi[1], pi[2], pi[3]);
+    from += from_stride;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_point_float64_4::set_data4d_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_point_float64_4::
+set_data4d_array(unsigned char *to, size_t to_stride,
+                 const LVecBase4d *from, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    PN_float64 *pi = (PN_float64 *)to;
+    pi[0] = from[i][0];
+    pi[1] = from[i][1];
+    pi[2] = from[i][2];
+    pi[3] = from[i][3];
+    to += to_stride;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeomVertexColumn::Packer_nativedouble_3::get_data3d
 //       Access: Public, Virtual
@@ -3247,6 +3605,123 @@ set_data4f(unsigned char *pointer, const LVecBase4f &data) {
      (unsigned int)(newData[2] * 255.0f));
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_argb_packed::get_data4f_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_argb_packed::
+get_data4f_array(LVecBase4f *to, const unsigned char *from,
+                 size_t from_stride, size_t count) {
+#ifdef PACKER_SSE2
+  // In memory, the dword is stored in the byte order B, G, R, A.
+  // Widen the four bytes to floats, and then swap B and R.  The
+  // division is the same one the scalar code makes, so the results
+  // are identical.
+  __m128 scale = _mm_set1_ps(255.0f);
+  __m128i zero = _mm_setzero_si128();
+  for (size_t i = 0; i < count; ++i) {
+    __m128i bytes = _mm_cvtsi32_si128(*(const int *)from);
+    bytes = _mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero);
+    __m128 v = _mm_div_ps(_mm_cvtepi32_ps(bytes), scale);
+    _mm_storeu_ps(&to[i][0], _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 1, 2)));
+    from += from_stride;
+  }
+
+#else
+  for (size_t i = 0; i < count; ++i) {
+    PN_uint32 dword = *(const PN_uint32 *)from;
+    to[i].set((float)GeomVertexData::unpack_abcd_b(dword) / 255.0f,
+              (float)GeomVertexData::unpack_abcd_c(dword) / 255.0f,
+              (float)GeomVertexData::unpack_abcd_d(dword) / 255.0f,
+              (float)GeomVertexData::unpack_abcd_a(dword) / 255.0f);
+    from += from_stride;
+  }
+#endif  // PACKER_SSE2
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_argb_packed::set_data4f_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_argb_packed::
+set_data4f_array(unsigned char *to, size_t to_stride,
+                 const LVecBase4f *from, size_t count) {
+#ifdef PACKER_SSE2
+  // As in set_data4f(), cap the values at 1 so they don't wrap.  Each
+  // value is truncated and masked to a byte, as pack_abcd() does, and
+  // the R and B channels are swapped into the B, G, R, A byte order.
+  __m128 one = _mm_set1_ps(1.0f);
+  __m128 scale = _mm_set1_ps(255.0f);
+  __m128i mask = _mm_set1_epi32(0xff);
+  for (size_t i = 0; i < count; ++i) {
+    __m128 v = _mm_mul_ps(_mm_min_ps(_mm_loadu_ps(from[i].get_data()), one), scale);
+    v = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 1, 2));
+    __m128i ints = _mm_and_si128(_mm_cvttps_epi32(v), mask);
+    ints = _mm_packs_epi32(ints, ints);
+    ints = _mm_packus_epi16(ints, ints);
+    *(int *)to = _mm_cvtsi128_si32(ints);
+    to += to_stride;
+  }
+
+#else
+  for (size_t i = 0; i < count; ++i) {
+    // As in set_data4f(), cap the values at 1 so they don't wrap.
+    const LVecBase4f &data = from[i];
+    float r = min(data[0], 1.0f);
+    float g = min(data[1], 1.0f);
+    float b = min(data[2], 1.0f);
+    float a = min(data[3], 1.0f);
+    *(PN_uint32 *)to = GeomVertexData::pack_abcd
+      ((unsigned int)(a * 255.0f),
+       (unsigned int)(r * 255.0f),
+       (unsigned int)(g * 255.0f),
+       (unsigned int)(b * 255.0f));
+    to += to_stride;
+  }
+#endif  // PACKER_SSE2
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_argb_packed::get_data4d_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_argb_packed::
+get_data4d_array(LVecBase4d *to, const unsigned char *from,
+                 size_t from_stride, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    PN_uint32 dword = *(const PN_uint32 *)from;
+    to[i].set((double)GeomVertexData::unpack_abcd_b(dword) / 255.0,
+              (double)GeomVertexData::unpack_abcd_c(dword) / 255.0,
+              (double)GeomVertexData::unpack_abcd_d(dword) / 255.0,
+              (double)GeomVertexData::unpack_abcd_a(dword) / 255.0);
+    from += from_stride;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_argb_packed::set_data4d_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_argb_packed::
+set_data4d_array(unsigned char *to, size_t to_stride,
+                 const LVecBase4d *from, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    // Unlike set_data4f(), set_data4d() does not cap the values at 1,
+    // so neither does this.
+    const LVecBase4d &data = from[i];
+    *(PN_uint32 *)to = GeomVertexData::pack_abcd
+      ((unsigned int)(data[3] * 255.0),
+       (unsigned int)(data[0] * 255.0),
+       (unsigned int)(data[1] * 255.0),
+       (unsigned int)(data[2] * 255.0));
+    to += to_stride;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeomVertexColumn::Packer_rgba_uint8_4::get_data4f
 //       Access: Public, Virtual
@@ -3274,6 +3749,104 @@ set_data4f(unsigned char *pointer, const LVecBase4f &data) {
   pointer[3] = (unsigned int)(data[3] * 255.0f);
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_rgba_uint8_4::get_data4f_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_rgba_uint8_4::
+get_data4f_array(LVecBase4f *to, const unsigned char *from,
+                 size_t from_stride, size_t count) {
+#ifdef PACKER_SSE2
+  __m128 scale = _mm_set1_ps(255.0f);
+  __m128i zero = _mm_setzero_si128();
+  for (size_t i = 0; i < count; ++i) {
+    __m128i bytes = _mm_cvtsi32_si128(*(const int *)from);
+    bytes = _mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero);
+    _mm_storeu_ps(&to[i][0], _mm_div_ps(_mm_cvtepi32_ps(bytes), scale));
+    from += from_stride;
+  }
+
+#else
+  for (size_t i = 0; i < count; ++i) {
+    to[i].set((float)from[0] / 255.0f,
+              (float)from[1] / 255.0f,
+              (float)from[2] / 255.0f,
+              (float)from[3] / 255.0f);
+    from += from_stride;
+  }
+#endif  // PACKER_SSE2
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_rgba_uint8_4::set_data4f_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_rgba_uint8_4::
+set_data4f_array(unsigned char *to, size_t to_stride,
+                 const LVecBase4f *from, size_t count) {
+#ifdef PACKER_SSE2
+  // Truncate each value and keep its low byte, as the scalar
+  // conversion to unsigned char does.
+  __m128 scale = _mm_set1_ps(255.0f);
+  __m128i mask = _mm_set1_epi32(0xff);
+  for (size_t i = 0; i < count; ++i) {
+    __m128 v = _mm_mul_ps(_mm_loadu_ps(from[i].get_data()), scale);
+    __m128i ints = _mm_and_si128(_mm_cvttps_epi32(v), mask);
+    ints = _mm_packs_epi32(ints, ints);
+    ints = _mm_packus_epi16(ints, ints);
+    *(int *)to = _mm_cvtsi128_si32(ints);
+    to += to_stride;
+  }
+
+#else
+  for (size_t i = 0; i < count; ++i) {
+    const LVecBase4f &data = from[i];
+    to[0] = (unsigned int)(data[0] * 255.0f);
+    to[1] = (unsigned int)(data[1] * 255.0f);
+    to[2] = (unsigned int)(data[2] * 255.0f);
+    to[3] = (unsigned int)(data[3] * 255.0f);
+    to += to_stride;
+  }
+#endif  // PACKER_SSE2
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_rgba_uint8_4::get_data4d_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_rgba_uint8_4::
+get_data4d_array(LVecBase4d *to, const unsigned char *from,
+                 size_t from_stride, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    to[i].set((double)from[0] / 255.0,
+              (double)from[1] / 255.0,
+              (double)from[2] / 255.0,
+              (double)from[3] / 255.0);
+    from += from_stride;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_rgba_uint8_4::set_data4d_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_rgba_uint8_4::
+set_data4d_array(unsigned char *to, size_t to_stride,
+                 const LVecBase4d *from, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    const LVecBase4d &data = from[i];
+    to[0] = (unsigned int)(data[0] * 255.0);
+    to[1] = (unsigned int)(data[1] * 255.0);
+    to[2] = (unsigned int)(data[2] * 255.0);
+    to[3] = (unsigned int)(data[3] * 255.0);
+    to += to_stride;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeomVertexColumn::Packer_rgba_float32_4::get_data4f
 //       Access: Public, Virtual
@@ -3300,6 +3873,72 @@ set_data4f(unsigned char *pointer, const LVecBase4f &data) {
   pi[3] = data[3];
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_rgba_float32_4::get_data4f_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_rgba_float32_4::
+get_data4f_array(LVecBase4f *to, const unsigned char *from,
+                 size_t from_stride, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    const PN_float32 *pi = (const PN_float32 *)from;
+    to[i].set(pi[0], pi[1], pi[2], pi[3]);
+    from += from_stride;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_rgba_float32_4::set_data4f_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_rgba_float32_4::
+set_data4f_array(unsigned char *to, size_t to_stride,
+                 const LVecBase4f *from, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    PN_float32 *pi = (PN_float32 *)to;
+    pi[0] = from[i][0];
+    pi[1] = from[i][1];
+    pi[2] = from[i][2];
+    pi[3] = from[i][3];
+    to += to_stride;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_rgba_float32_4::get_data4d_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_rgba_float32_4::
+get_data4d_array(LVecBase4d *to, const unsigned char *from,
+                 size_t from_stride, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    const PN_float32 *pi = (const PN_float32 *)from;
+    to[i].set(pi[0], pi[1], pi[2], pi[3]);
+    from += from_stride;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexColumn::Packer_rgba_float32_4::set_data4d_array
+//       Access: Public, Virtual
+//  Description: 
+////////////////////////////////////////////////////////////////////
+void GeomVertexColumn::Packer_rgba_float32_4::
+set_data4d_array(unsigned char *to, size_t to_stride,
+                 const LVecBase4d *from, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    PN_float32 *pi = (PN_float32 *)to;
+    pi[0] = from[i][0];
+    pi[1] = from[i][1];
+    pi[2] = from[i][2];
+    pi[3] = from[i][3];
+    to += to_stride;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeomVertexColumn::Packer_rgba_nativefloat_4::get_data4f
 //       Access: Public, Virtual
@@ -76,6 +76,15 @@ public:
   INLINE bool is_packed_argb() const;
   INLINE bool is_uint8_rgba() const;
 
+  INLINE void get_data4f_array(LVecBase4f *to, const unsigned char *from,
+                               size_t from_stride, size_t count) const;
+  INLINE void get_data4d_array(LVecBase4d *to, const unsigned char *from,
+                               size_t from_stride, size_t count) const;
+  INLINE void set_data4f_array(unsigned char *to, size_t to_stride,
+                               const LVecBase4f *from, size_t count) const;
+  INLINE void set_data4d_array(unsigned char *to, size_t to_stride,
+                               const LVecBase4d *from, size_t count) const;
+
   INLINE int compare_to(const GeomVertexColumn &other) const;
   INLINE bool operator == (const GeomVertexColumn &other) const;
   INLINE bool operator != (const GeomVertexColumn &other) const;
@@ -143,6 +152,19 @@ private:
     virtual void set_data3i(unsigned char *pointer, const LVecBase3i &data);
     virtual void set_data4i(unsigned char *pointer, const LVecBase4i &data);
 
+    // The array forms unpack or pack count rows at once, stepping
+    // through the vertex data by the indicated stride.  The default
+    // implementations simply call the one-row methods in a loop; the
+    // specialized packers below override them with direct loops.
+    virtual void get_data4f_array(LVecBase4f *to, const unsigned char *from,
+                                  size_t from_stride, size_t count);
+    virtual void get_data4d_array(LVecBase4d *to, const unsigned char *from,
+                                  size_t from_stride, size_t count);
+    virtual void set_data4f_array(unsigned char *to, size_t to_stride,
+                                  const LVecBase4f *from, size_t count);
+    virtual void set_data4d_array(unsigned char *to, size_t to_stride,
+                                  const LVecBase4d *from, size_t count);
+
     virtual const char *get_name() const {
       return "Packer";
     }
@@ -241,6 +263,14 @@ private:
   public:
     virtual const LVecBase3f &get_data3f(const unsigned char *pointer);
     virtual void set_data3f(unsigned char *pointer, const LVecBase3f &value);
+    virtual void get_data4f_array(LVecBase4f *to, const unsigned char *from,
+                                  size_t from_stride, size_t count);
+    virtual void set_data4f_array(unsigned char *to, size_t to_stride,
+                                  const LVecBase4f *from, size_t count);
+    virtual void get_data4d_array(LVecBase4d *to, const unsigned char *from,
+                                  size_t from_stride, size_t count);
+    virtual void set_data4d_array(unsigned char *to, size_t to_stride,
+                                  const LVecBase4d *from, size_t count);
 
     virtual const char *get_name() const {
       return "Packer_float32_3";
@@ -261,6 +291,14 @@ private:
   public:
     virtual const LVecBase3f &get_data3f(const unsigned char *pointer);
     virtual void set_data3f(unsigned char *pointer, const LVecBase3f &value);
+    virtual void get_data4f_array(LVecBase4f *to, const unsigned char *from,
+                                  size_t from_stride, size_t count);
+    virtual void set_data4f_array(unsigned char *to, size_t to_stride,
+                                  const LVecBase4f *from, size_t count);
+    virtual void get_data4d_array(LVecBase4d *to, const unsigned char *from,
+                                  size_t from_stride, size_t count);
+    virtual void set_data4d_array(unsigned char *to, size_t to_stride,
+                                  const LVecBase4d *from, size_t count);
 
     virtual const char *get_name() const {
       return "Packer_point_float32_3";
@@ -271,6 +309,14 @@ private:
   public:
     virtual const LVecBase4f &get_data4f(const unsigned char *pointer);
     virtual void set_data4f(unsigned char *pointer, const LVecBase4f &value);
+    virtual void get_data4f_array(LVecBase4f *to, const unsigned char *from,
+                                  size_t from_stride, size_t count);
+    virtual void set_data4f_array(unsigned char *to, size_t to_stride,
+                                  const LVecBase4f *from, size_t count);
+    virtual void get_data4d_array(LVecBase4d *to, const unsigned char *from,
+                                  size_t from_stride, size_t count);
+    virtual void set_data4d_array(unsigned char *to, size_t to_stride,
+                                  const LVecBase4d *from, size_t count);
 
     virtual const char *get_name() const {
       return "Packer_point_float32_4";
@@ -317,6 +363,10 @@ private:
   public:
     virtual const LVecBase3d &get_data3d(const unsigned char *pointer);
     virtual void set_data3d(unsigned char *pointer, const LVecBase3d &value);
+    virtual void get_data4d_array(LVecBase4d *to, const unsigned char *from,
+                                  size_t from_stride, size_t count);
+    virtual void set_data4d_array(unsigned char *to, size_t to_stride,
+                                  const LVecBase4d *from, size_t count);
 
     virtual const char *get_name() const {
       return "Packer_float64_3";
@@ -337,6 +387,10 @@ private:
   public:
     virtual const LVecBase3d &get_data3d(const unsigned char *pointer);
     virtual void set_data3d(unsigned char *pointer, const LVecBase3d &value);
+    virtual void get_data4d_array(LVecBase4d *to, const unsigned char *from,
+                                  size_t from_stride, size_t count);
+    virtual void set_data4d_array(unsigned char *to, size_t to_stride,
+                                  const LVecBase4d *from, size_t count);
 
     virtual const char *get_name() const {
       return "Packer_point_float64_3";
@@ -347,6 +401,10 @@ private:
   public:
     virtual const LVecBase4d &get_data4d(const unsigned char *pointer);
     virtual void set_data4d(unsigned char *pointer, const LVecBase4d &value);
+    virtual void get_data4d_array(LVecBase4d *to, const unsigned char *from,
+                                  size_t from_stride, size_t count);
+    virtual void set_data4d_array(unsigned char *to, size_t to_stride,
+                                  const LVecBase4d *from, size_t count);
 
     virtual const char *get_name() const {
       return "Packer_point_float64_4";
@@ -393,6 +451,14 @@ private:
   public:
     virtual const LVecBase4f &get_data4f(const unsigned char *pointer);
     virtual void set_data4f(unsigned char *pointer, const LVecBase4f &value);
+    virtual void get_data4f_array(LVecBase4f *to, const unsigned char *from,
+                                  size_t from_stride, size_t count);
+    virtual void set_data4f_array(unsigned char *to, size_t to_stride,
+                                  const LVecBase4f *from, size_t count);
+    virtual void get_data4d_array(LVecBase4d *to, const unsigned char *from,
+                                  size_t from_stride, size_t count);
+    virtual void set_data4d_array(unsigned char *to, size_t to_stride,
+                                  const LVecBase4d *from, size_t count);
 
     virtual const char *get_name() const {
       return "Packer_argb_packed";
@@ -403,6 +469,14 @@ private:
   public:
     virtual const LVecBase4f &get_data4f(const unsigned char *pointer);
     virtual void set_data4f(unsigned char *pointer, const LVecBase4f &value);
+    virtual void get_data4f_array(LVecBase4f *to, const unsigned char *from,
+                                  size_t from_stride, size_t count);
+    virtual void set_data4f_array(unsigned char *to, size_t to_stride,
+                                  const LVecBase4f *from, size_t count);
+    virtual void get_data4d_array(LVecBase4d *to, const unsigned char *from,
+                                  size_t from_stride, size_t count);
+    virtual void set_data4d_array(unsigned char *to, size_t to_stride,
+                                  const LVecBase4d *from, size_t count);
 
     virtual const char *get_name() const {
       return "Packer_rgba_uint8_4";
@@ -413,6 +487,14 @@ private:
   public:
     virtual const LVecBase4f &get_data4f(const unsigned char *pointer);
     virtual void set_data4f(unsigned char *pointer, const LVecBase4f &value);
+    virtual void get_data4f_array(LVecBase4f *to, const unsigned char *from,
+                                  size_t from_stride, size_t count);
+    virtual void set_data4f_array(unsigned char *to, size_t to_stride,
+                                  const LVecBase4f *from, size_t count);
+    virtual void get_data4d_array(LVecBase4d *to, const unsigned char *from,
+                                  size_t from_stride, size_t count);
+    virtual void set_data4d_array(unsigned char *to, size_t to_stride,
+                                  const LVecBase4d *from, size_t count);
 
     virtual const char *get_name() const {
       return "Packer_rgba_float32_4";
@@ -664,14 +664,15 @@ copy_from(const GeomVertexData *source, bool keep_data_objects,
               << "generic copy " << *dest_column << " from " 
               << *source_column << "\n";
           }
-          GeomVertexWriter to(this);
-          to.set_column(dest_i, dest_column);
-          GeomVertexReader from(source);
-          from.set_column(source_i, source_column);
+          PT(GeomVertexArrayData) dest_array_obj = modify_array(dest_i);
+          PT(GeomVertexArrayDataHandle) dest_handle = dest_array_obj->modify_handle();
+          unsigned char *dest_array_data = dest_handle->get_write_pointer();
 
-          while (!from.is_at_end()) {
-            to.set_data4(from.get_data4());
-          }
+          packer_copy(dest_array_data + dest_column->get_start(), 
+                      dest_array_format->get_stride(), dest_column,
+                      array_data + source_column->get_start(), 
+                      source_array_format->get_stride(), source_column,
+                      num_rows);
         }
       }
     }
@@ -1226,6 +1227,41 @@ bytewise_copy(unsigned char *to, int to_stride,
   }
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: GeomVertexData::packer_copy
+//       Access: Private, Static
+//  Description: Copies data from one column to another of a
+//               different type, converting it through the columns'
+//               packers.  The rows are unpacked a block at a time
+//               into a temporary buffer and then packed again, so
+//               that each block costs only two calls into the
+//               packers, rather than two per row.
+////////////////////////////////////////////////////////////////////
+void GeomVertexData::
+packer_copy(unsigned char *to, int to_stride,
+            const GeomVertexColumn *to_type,
+            const unsigned char *from, int from_stride,
+            const GeomVertexColumn *from_type,
+            int num_records) {
+  static const int block_size = 256;
+  LVecBase4 buffer[block_size];
+
+  while (num_records > 0) {
+    int num_block = min(num_records, block_size);
+#ifdef STDFLOAT_DOUBLE
+    from_type->get_data4d_array(buffer, from, from_stride, num_block);
+    to_type->set_data4d_array(to, to_stride, buffer, num_block);
+#else
+    from_type->get_data4f_array(buffer, from, from_stride, num_block);
+    to_type->set_data4f_array(to, to_stride, buffer, num_block);
+#endif
+
+    to += to_stride * num_block;
+    from += from_stride * num_block;
+    num_records -= num_block;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeomVertexData::replace_column
 //       Access: Published
@@ -1876,9 +1912,9 @@ do_transform_point_column(const GeomVertexFormat *format, GeomVertexRewriter &da
     LMatrix4f matf = LCAST(float, mat);
 
     if (num_values == 3) {
-      table_xform_point3f(datat, num_rows, stride, matf);
+      matf.xform_points(datat, stride, datat, stride, num_rows);
     } else {
-      table_xform_vecbase4f(datat, num_rows, stride, matf);
+      matf.xform_vecbase4s(datat, stride, datat, stride, num_rows);
     }
     
   } else if (num_values == 4) {
@@ -1928,9 +1964,9 @@ do_transform_vector_column(const GeomVertexFormat *format, GeomVertexRewriter &d
     LMatrix4f matf = LCAST(float, mat);
 
     if (num_values == 3) {
-      table_xform_vector3f(datat, num_rows, stride, matf);
+      matf.xform_vecs(datat, stride, datat, stride, num_rows);
     } else {
-      table_xform_vecbase4f(datat, num_rows, stride, matf);
+      matf.xform_vecbase4s(datat, stride, datat, stride, num_rows);
     }
 
   } else {
@@ -1944,72 +1980,6 @@ do_transform_vector_column(const GeomVertexFormat *format, GeomVertexRewriter &d
   }
 }
 
-////////////////////////////////////////////////////////////////////
-//     Function: GeomVertexData::table_xform_point3f
-//       Access: Private, Static
-//  Description: Transforms each of the LPoint3f objects in the
-//               indicated table by the indicated matrix.
-////////////////////////////////////////////////////////////////////
-void GeomVertexData::
-table_xform_point3f(unsigned char *datat, size_t num_rows, size_t stride,
-                    const LMatrix4f &matf) {
-  // We don't bother checking for the unaligned case here, because in
-  // practice it doesn't matter with a 3-component point.
-  for (size_t i = 0; i < num_rows; ++i) {
-    LPoint3f &vertex = *(LPoint3f *)(&datat[i * stride]);
-    vertex *= matf;
-  }
-}
-
-////////////////////////////////////////////////////////////////////
-//     Function: GeomVertexData::table_xform_vector3f
-//       Access: Private, Static
-//  Description: Transforms each of the LVector3f objects in the
-//               indicated table by the indicated matrix.
-////////////////////////////////////////////////////////////////////
-void GeomVertexData::
-table_xform_vector3f(unsigned char *datat, size_t num_rows, size_t stride,
-                     const LMatrix4f &matf) {
-  // We don't bother checking for the unaligned case here, because in
-  // practice it doesn't matter with a 3-component vector.
-  for (size_t i = 0; i < num_rows; ++i) {
-    LVector3f &vertex = *(LVector3f *)(&datat[i * stride]);
-    vertex *= matf;
-  }
-}
-
-////////////////////////////////////////////////////////////////////
-//     Function: GeomVertexData::table_xform_vecbase4f
-//       Access: Private, Static
-//  Description: Transforms each of the LVecBase4f objects in the
-//               indicated table by the indicated matrix.
-////////////////////////////////////////////////////////////////////
-void GeomVertexData::
-table_xform_vecbase4f(unsigned char *datat, size_t num_rows, size_t stride,
-                      const LMatrix4f &matf) {
-#if defined(HAVE_EIGEN) && defined(LINMATH_ALIGN)
-  // Check if the table is unaligned.  If it is, we can't use the
-  // LVecBase4f object directly, which assumes 16-byte alignment.
-  if (((size_t)datat & 0xf) != 0 || (stride & 0xf) != 0) {
-    // Instead, we'll use low-level Eigen calls to multiply out the
-    // unaligned memory.
-    Eigen::Map<Eigen::Matrix<float, Eigen::Dynamic, 4, Eigen::RowMajor>, Eigen::Unaligned, Eigen::OuterStride<> > table((float *)datat, num_rows, 4, Eigen::OuterStride<>(stride / sizeof(float)));
-    for (size_t i = 0; i < num_rows; ++i) {
-      table.row(i) *= matf._m;
-    }
-    return;
-  }
-#endif  // HAVE_EIGEN
-
-  // If the table is properly aligned (or we don't require alignment),
-  // we can directly use the high-level LVecBase4f object, which will
-  // do the right thing.
-  for (size_t i = 0; i < num_rows; ++i) {
-    LVecBase4f &vertex = *(LVecBase4f *)(&datat[i * stride]);
-    vertex *= matf;
-  }
-}
-
 ////////////////////////////////////////////////////////////////////
 //     Function: GeomVertexData::register_with_read_factory
 //       Access: Public, Static
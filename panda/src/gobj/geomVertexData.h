@@ -181,6 +181,11 @@ private:
                             const unsigned char *from, int from_stride,
                             const GeomVertexColumn *from_type,
                             int num_records);
+  static void packer_copy(unsigned char *to, int to_stride,
+                          const GeomVertexColumn *to_type,
+                          const unsigned char *from, int from_stride,
+                          const GeomVertexColumn *from_type,
+                          int num_records);
   static void
   packed_argb_to_uint8_rgba(unsigned char *to, int to_stride,
                             const unsigned char *from, int from_stride,
@@ -268,6 +273,8 @@ public:
   private:
     static TypeHandle _type_handle;
   };
+  // As in Geom, this stays an ordered map; it rarely holds more than
+  // one entry per GSG.
   typedef pmap<const CacheKey *, PT(CacheEntry), IndirectLess<CacheKey> > Cache;
 
 private:
@@ -323,12 +330,6 @@ private:
                                  const LMatrix4 &mat, int begin_row, int end_row);
   void do_transform_vector_column(const GeomVertexFormat *format, GeomVertexRewriter &data,
                                   const LMatrix4 &mat, int begin_row, int end_row);
-  static void table_xform_point3f(unsigned char *datat, size_t num_rows, 
-                                  size_t stride, const LMatrix4f &matf);
-  static void table_xform_vector3f(unsigned char *datat, size_t num_rows, 
-                                   size_t stride, const LMatrix4f &matf);
-  static void table_xform_vecbase4f(unsigned char *datat, size_t num_rows, 
-                                    size_t stride, const LMatrix4f &matf);
 
   static PStatCollector _convert_pcollector;
   static PStatCollector _scale_color_pcollector;
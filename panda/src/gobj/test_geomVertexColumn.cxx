@@ -0,0 +1,356 @@
+// Filename: test_geomVertexColumn.cxx
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#include "geomVertexData.h"
+#include "geomVertexFormat.h"
+#include "geomVertexArrayFormat.h"
+#include "geomVertexReader.h"
+#include "geomVertexWriter.h"
+#include "internalName.h"
+#include "trueClock.h"
+#include "pnotify.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// This program checks the bulk get_data4f_array() and
+// set_data4f_array() conversions of the specialized column packers,
+// their double-precision counterparts, and the block-wise copy that
+// GeomVertexData::convert_to() makes with them, against the per-row
+// GeomVertexReader and GeomVertexWriter results.  The results must be
+// identical, not merely close.  It then times convert_to() against the
+// per-row copy it replaces.
+
+struct ColumnType {
+  const char *_name;
+  int _num_components;
+  GeomEnums::NumericType _numeric_type;
+  GeomEnums::Contents _contents;
+};
+
+static const ColumnType column_types[] = {
+  { "vertex", 3, GeomEnums::NT_float32, GeomEnums::C_point },
+  { "vertex", 4, GeomEnums::NT_float32, GeomEnums::C_point },
+  { "vertex", 3, GeomEnums::NT_float32, GeomEnums::C_vector },
+  { "vertex", 3, GeomEnums::NT_float64, GeomEnums::C_point },
+  { "vertex", 4, GeomEnums::NT_float64, GeomEnums::C_point },
+  { "vertex", 3, GeomEnums::NT_float64, GeomEnums::C_vector },
+  { "color", 4, GeomEnums::NT_uint8, GeomEnums::C_color },
+  { "color", 1, GeomEnums::NT_packed_dabc, GeomEnums::C_color },
+  { "color", 4, GeomEnums::NT_float32, GeomEnums::C_color },
+};
+static const int num_column_types = sizeof(column_types) / sizeof(ColumnType);
+
+static const int num_rows = 1000;
+
+static float
+random_float(float lo, float hi) {
+  return lo + (hi - lo) * (float)rand() / (float)RAND_MAX;
+}
+
+static LVecBase4f
+random_value(const ColumnType &type) {
+  if (type._contents == GeomEnums::C_color) {
+    return LVecBase4f(random_float(0.0f, 1.0f), random_float(0.0f, 1.0f),
+                      random_float(0.0f, 1.0f), random_float(0.0f, 1.0f));
+  }
+  return LVecBase4f(random_float(-10.0f, 10.0f), random_float(-10.0f, 10.0f),
+                    random_float(-10.0f, 10.0f), random_float(0.5f, 2.0f));
+}
+
+// Makes a format with the indicated column alone (so that the stride
+// equals the size of the column), or followed by a one-byte column
+// (so that the rows are not contiguous).
+static CPT(GeomVertexFormat)
+make_format(const ColumnType &type, bool padded) {
+  PT(GeomVertexArrayFormat) array_format = new GeomVertexArrayFormat;
+  array_format->add_column(InternalName::make(type._name),
+                           type._num_components, type._numeric_type,
+                           type._contents);
+  if (padded) {
+    array_format->add_column(InternalName::make("pad"), 1,
+                             GeomEnums::NT_uint8, GeomEnums::C_other);
+  }
+  return GeomVertexFormat::register_format(array_format);
+}
+
+static PT(GeomVertexData)
+make_data(const ColumnType &type, const GeomVertexFormat *format) {
+  PT(GeomVertexData) data =
+    new GeomVertexData("test", format, GeomEnums::UH_static);
+  data->set_num_rows(num_rows);
+
+  GeomVertexWriter writer(data, type._name);
+  for (int i = 0; i < num_rows; ++i) {
+    writer.set_data4f(random_value(type));
+  }
+  return data;
+}
+
+// Returns true if the named column holds the same bytes in both
+// tables.
+static bool
+same_column(const GeomVertexData *a, const GeomVertexData *b,
+            const char *name) {
+  const GeomVertexArrayFormat *array_format = a->get_format()->get_array(0);
+  const GeomVertexColumn *column =
+    array_format->get_column(InternalName::make(name));
+  int stride = array_format->get_stride();
+
+  CPT(GeomVertexArrayDataHandle) ha = a->get_array(0)->get_handle();
+  CPT(GeomVertexArrayDataHandle) hb = b->get_array(0)->get_handle();
+  const unsigned char *pa = ha->get_read_pointer(true) + column->get_start();
+  const unsigned char *pb = hb->get_read_pointer(true) + column->get_start();
+  for (int i = 0; i < num_rows; ++i) {
+    if (memcmp(pa, pb, column->get_total_bytes()) != 0) {
+      return false;
+    }
+    pa += stride;
+    pb += stride;
+  }
+  return true;
+}
+
+// These overloads let check_column() exercise either the single- or
+// the double-precision interface.
+static void
+read_row(GeomVertexReader &reader, LVecBase4f &value) {
+  value = reader.get_data4f();
+}
+
+static void
+read_row(GeomVertexReader &reader, LVecBase4d &value) {
+  value = reader.get_data4d();
+}
+
+static void
+write_row(GeomVertexWriter &writer, const LVecBase4f &value) {
+  writer.set_data4f(value);
+}
+
+static void
+write_row(GeomVertexWriter &writer, const LVecBase4d &value) {
+  writer.set_data4d(value);
+}
+
+static void
+read_array(const GeomVertexColumn *column, LVecBase4f *to,
+           const unsigned char *from, size_t stride) {
+  column->get_data4f_array(to, from, stride, num_rows);
+}
+
+static void
+read_array(const GeomVertexColumn *column, LVecBase4d *to,
+           const unsigned char *from, size_t stride) {
+  column->get_data4d_array(to, from, stride, num_rows);
+}
+
+static void
+write_array(const GeomVertexColumn *column, unsigned char *to,
+            size_t stride, const LVecBase4f *from) {
+  column->set_data4f_array(to, stride, from, num_rows);
+}
+
+static void
+write_array(const GeomVertexColumn *column, unsigned char *to,
+            size_t stride, const LVecBase4d *from) {
+  column->set_data4d_array(to, stride, from, num_rows);
+}
+
+static void
+set_random(LVecBase4f &value, const ColumnType &type) {
+  value = random_value(type);
+}
+
+static void
+set_random(LVecBase4d &value, const ColumnType &type) {
+  LVecBase4f v = random_value(type);
+  value.set(v[0], v[1], v[2], v[3]);
+}
+
+template<class Vec>
+static bool
+check_column(const ColumnType &type, bool padded, const char *suffix) {
+  CPT(GeomVertexFormat) format = make_format(type, padded);
+  const GeomVertexArrayFormat *array_format = format->get_array(0);
+  const GeomVertexColumn *column =
+    array_format->get_column(InternalName::make(type._name));
+  size_t stride = array_format->get_stride();
+  bool ok = true;
+
+  // The bulk get against the reader.
+  PT(GeomVertexData) data = make_data(type, format);
+  Vec *values = new Vec[num_rows];
+  {
+    CPT(GeomVertexArrayDataHandle) handle = data->get_array(0)->get_handle();
+    read_array(column, values, handle->get_read_pointer(true) +
+               column->get_start(), stride);
+  }
+  GeomVertexReader reader(data, type._name);
+  for (int i = 0; i < num_rows; ++i) {
+    Vec expected;
+    read_row(reader, expected);
+    if (memcmp(values[i].get_data(), expected.get_data(), sizeof(Vec)) != 0) {
+      nout << *column << ": get_data" << suffix << "_array row " << i
+           << " is " << values[i] << ", expected " << expected << "\n";
+      ok = false;
+      break;
+    }
+  }
+
+  // The bulk set against the writer.
+  for (int i = 0; i < num_rows; ++i) {
+    set_random(values[i], type);
+  }
+  PT(GeomVertexData) bulk = new GeomVertexData("bulk", format, GeomEnums::UH_static);
+  bulk->set_num_rows(num_rows);
+  {
+    PT(GeomVertexArrayDataHandle) handle = bulk->modify_array(0)->modify_handle();
+    write_array(column, handle->get_write_pointer() + column->get_start(),
+                stride, values);
+  }
+  PT(GeomVertexData) per_row = new GeomVertexData("per_row", format, GeomEnums::UH_static);
+  per_row->set_num_rows(num_rows);
+  GeomVertexWriter writer(per_row, type._name);
+  for (int i = 0; i < num_rows; ++i) {
+    write_row(writer, values[i]);
+  }
+  if (!same_column(bulk, per_row, type._name)) {
+    nout << *column << ": set_data" << suffix << "_array differs from set_data"
+         << suffix << "\n";
+    ok = false;
+  }
+
+  delete[] values;
+  return ok;
+}
+
+// Returns true if convert_to() copies between these two types with a
+// dedicated byte shuffle, rather than through the packers.
+static bool
+is_color_shuffle(const ColumnType &a, const ColumnType &b) {
+  return ((a._numeric_type == GeomEnums::NT_uint8 &&
+           b._numeric_type == GeomEnums::NT_packed_dabc) ||
+          (a._numeric_type == GeomEnums::NT_packed_dabc &&
+           b._numeric_type == GeomEnums::NT_uint8));
+}
+
+// Converts a table from one column type to another with convert_to(),
+// and compares the result to a per-row copy through a reader and a
+// writer, at the precision convert_to() itself uses.
+static bool
+check_copy(const ColumnType &from_type, const ColumnType &to_type,
+           bool padded) {
+  CPT(GeomVertexFormat) from_format = make_format(from_type, padded);
+  CPT(GeomVertexFormat) to_format = make_format(to_type, !padded);
+  PT(GeomVertexData) data = make_data(from_type, from_format);
+
+  CPT(GeomVertexData) converted = data->convert_to(to_format);
+
+  PT(GeomVertexData) per_row = new GeomVertexData("per_row", to_format, GeomEnums::UH_static);
+  per_row->set_num_rows(num_rows);
+  GeomVertexReader reader(data, from_type._name);
+  GeomVertexWriter writer(per_row, to_type._name);
+  for (int i = 0; i < num_rows; ++i) {
+    writer.set_data4(reader.get_data4());
+  }
+
+  if (!same_column(converted, per_row, to_type._name)) {
+    nout << *from_format->get_array(0)->get_column(0) << " to "
+         << *to_format->get_array(0)->get_column(0)
+         << ": convert_to differs from a per-row copy\n";
+    return false;
+  }
+  return true;
+}
+
+// Times convert_to() against the per-row reader and writer copy that
+// it replaces, reporting the time per row of each.
+static void
+time_copy(const ColumnType &from_type, const ColumnType &to_type,
+          int iterations) {
+  CPT(GeomVertexFormat) from_format = make_format(from_type, false);
+  CPT(GeomVertexFormat) to_format = make_format(to_type, true);
+  PT(GeomVertexData) data = make_data(from_type, from_format);
+  TrueClock *clock = TrueClock::get_global_ptr();
+
+  // convert_to() caches its result, so clear the cache each time
+  // around to measure the conversion itself.
+  double start = clock->get_short_time();
+  for (int n = 0; n < iterations; ++n) {
+    data->clear_cache();
+    CPT(GeomVertexData) converted = data->convert_to(to_format);
+  }
+  double bulk = clock->get_short_time() - start;
+
+  PT(GeomVertexData) per_row = new GeomVertexData("per_row", to_format, GeomEnums::UH_static);
+  per_row->set_num_rows(num_rows);
+  start = clock->get_short_time();
+  for (int n = 0; n < iterations; ++n) {
+    GeomVertexReader reader(data, from_type._name);
+    GeomVertexWriter writer(per_row, to_type._name);
+    for (int i = 0; i < num_rows; ++i) {
+      writer.set_data4(reader.get_data4());
+    }
+  }
+  double one_at_a_time = clock->get_short_time() - start;
+
+  double scale = 1.0e9 / ((double)iterations * num_rows);
+  nout << "  " << *from_format->get_array(0)->get_column(0) << " to "
+       << *to_format->get_array(0)->get_column(0) << ": convert_to "
+       << bulk * scale << " ns, per-row " << one_at_a_time * scale
+       << " ns\n";
+}
+
+int
+main(int argc, char *argv[]) {
+  int iterations = 1000;
+  if (argc > 1) {
+    iterations = atoi(argv[1]);
+  }
+
+  bool ok = true;
+  for (int i = 0; i < num_column_types; ++i) {
+    ok = check_column<LVecBase4f>(column_types[i], false, "4f") && ok;
+    ok = check_column<LVecBase4f>(column_types[i], true, "4f") && ok;
+    ok = check_column<LVecBase4d>(column_types[i], false, "4d") && ok;
+    ok = check_column<LVecBase4d>(column_types[i], true, "4d") && ok;
+  }
+
+  for (int i = 0; i < num_column_types; ++i) {
+    for (int j = 0; j < num_column_types; ++j) {
+      if (i != j && !is_color_shuffle(column_types[i], column_types[j]) &&
+          strcmp(column_types[i]._name, column_types[j]._name) == 0) {
+        ok = check_copy(column_types[i], column_types[j], false) && ok;
+        ok = check_copy(column_types[i], column_types[j], true) && ok;
+      }
+    }
+  }
+
+  if (!ok) {
+    return 1;
+  }
+
+  nout << "Time per row over " << iterations << " copies of "
+       << num_rows << " rows:\n";
+  for (int i = 0; i < num_column_types; ++i) {
+    for (int j = 0; j < num_column_types; ++j) {
+      if (i != j && !is_color_shuffle(column_types[i], column_types[j]) &&
+          strcmp(column_types[i]._name, column_types[j]._name) == 0) {
+        time_copy(column_types[i], column_types[j], iterations);
+      }
+    }
+  }
+  return 0;
+}
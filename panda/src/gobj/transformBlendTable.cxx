@@ -81,6 +81,7 @@ void TransformBlendTable::
 set_blend(int n, const TransformBlend &blend) {
   nassertv(n >= 0 && n < (int)_blends.size());
   _blends[n] = blend;
+  clear_index();
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -92,6 +93,7 @@ void TransformBlendTable::
 remove_blend(int n) {
   nassertv(n >= 0 && n < (int)_blends.size());
   _blends.erase(_blends.begin() + n);
+  clear_index();
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -21,8 +21,10 @@
     sceneGraphAnalyzerMeter.I sceneGraphAnalyzerMeter.h \
     heightfieldTesselator.I heightfieldTesselator.h \
     lineSegs.I lineSegs.h \
+    lodGenerator.I lodGenerator.h \
     multitexReducer.I multitexReducer.h multitexReducer.cxx \
     nodeVertexTransform.I nodeVertexTransform.h \
+    pagedHeightfield.I pagedHeightfield.h \
     pfmVizzer.I pfmVizzer.h \
     rigidBodyCombiner.I rigidBodyCombiner.h
     
@@ -38,9 +40,11 @@
     sceneGraphAnalyzerMeter.cxx \
     heightfieldTesselator.cxx \
     nodeVertexTransform.cxx \    
+    pagedHeightfield.cxx \
     pfmVizzer.cxx \
     pipeOcclusionCullTraverser.cxx \
     lineSegs.cxx \
+    lodGenerator.cxx \
     rigidBodyCombiner.cxx
     
   #define INSTALL_HEADERS \
@@ -54,8 +58,10 @@
     sceneGraphAnalyzerMeter.I sceneGraphAnalyzerMeter.h \
     heightfieldTesselator.I heightfieldTesselator.h \
     lineSegs.I lineSegs.h \
+    lodGenerator.I lodGenerator.h \
     multitexReducer.I multitexReducer.h \
     nodeVertexTransform.I nodeVertexTransform.h \
+    pagedHeightfield.I pagedHeightfield.h \
     pfmVizzer.I pfmVizzer.h \
     rigidBodyCombiner.I rigidBodyCombiner.h
 
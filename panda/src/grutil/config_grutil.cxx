@@ -18,6 +18,7 @@
 #include "meshDrawer.h"
 #include "meshDrawer2D.h"
 #include "geoMipTerrain.h"
+#include "pagedHeightfield.h"
 #include "movieTexture.h"
 #include "pandaSystem.h"
 #include "texturePool.h"
@@ -102,6 +103,19 @@ ConfigVariableDouble ae_undershift_factor_32
           "maximum pixel shift when applying a displacement map, in a 32-bit project file.  This is used "
           "to control PfmVizzer::make_displacement()."));
 
+ConfigVariableInt geomipterrain_threads
+("geomipterrain-threads", 1,
+ PRC_DESC("Specifies the number of threads that generate GeoMipTerrain "
+          "blocks in the background, for terrains on which set_async(true) "
+          "has been called.  If this is 0, or threading is not available, "
+          "blocks are always generated by update() itself."));
+
+ConfigVariableInt heightfield_max_tiles
+("heightfield-max-tiles", 64,
+ PRC_DESC("Specifies the default number of tiles that a PagedHeightfield "
+          "keeps in memory.  When more tiles than this have been read, the "
+          "tiles that were least recently used are released again."));
+
 ////////////////////////////////////////////////////////////////////
 //     Function: init_libgrutil
 //  Description: Initializes the library.  This must be called at
@@ -122,6 +136,7 @@ init_libgrutil() {
   MeshDrawer::init_type();
   MeshDrawer2D::init_type();
   GeoMipTerrain::init_type();
+  PagedHeightfield::init_type();
   NodeVertexTransform::init_type();
   RigidBodyCombiner::init_type();
   PipeOcclusionCullTraverser::init_type();
@@ -45,6 +45,9 @@ extern ConfigVariableInt pfm_vis_max_indices;
 extern ConfigVariableDouble ae_undershift_factor_16;
 extern ConfigVariableDouble ae_undershift_factor_32;
 
+extern ConfigVariableInt geomipterrain_threads;
+extern ConfigVariableInt heightfield_max_tiles;
+
 extern EXPCL_PANDA_GRUTIL void init_libgrutil();
 
 #endif
@@ -30,7 +30,13 @@
 
 #include "collideMask.h"
 
+#include "asyncTaskManager.h"
+#include "asyncTaskChain.h"
+#include "mutexHolder.h"
+#include "thread.h"
+
 TypeHandle GeoMipTerrain::_type_handle;
+TypeHandle GeoMipTerrain::BlockTask::_type_handle;
 
 ////////////////////////////////////////////////////////////////////
 //     Function: GeoMipTerrain::generate_block
@@ -49,6 +55,36 @@ generate_block(unsigned short mx,
   nassertr(mx < (_xsize - 1) / _block_size, NULL);
   nassertr(my < (_ysize - 1) / _block_size, NULL);
 
+  if (_bruteforce) {
+    // LOD Level when rendering bruteforce is always 0 (no lod)
+    // Unless a minlevel is set- this is handled later.
+    level = 0;
+  }
+  level = min(max(_min_level, level), _max_level);
+
+  PT(GeomNode) node = make_block(mx, my, level,
+                                 get_neighbor_level(mx, my, -1,  0),
+                                 get_neighbor_level(mx, my,  1,  0),
+                                 get_neighbor_level(mx, my,  0, -1),
+                                 get_neighbor_level(mx, my,  0,  1));
+  _old_levels.at(mx).at(my) = level;
+
+  return node;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeoMipTerrain::make_block
+//       Access: Private
+//  Description: Does the work of generate_block(), given the level
+//               of the block and of its four neighbors, which must
+//               already have been determined.  This reads only the
+//               heightfield and the color map, so it may be called
+//               from a geomipterrain thread.
+////////////////////////////////////////////////////////////////////
+PT(GeomNode) GeoMipTerrain::
+make_block(unsigned short mx, unsigned short my, unsigned short level,
+           unsigned short lnlevel, unsigned short rnlevel,
+           unsigned short bnlevel, unsigned short tnlevel) {
   unsigned short center = _block_size / 2;
   unsigned int vcounter = 0;
 
@@ -80,22 +116,11 @@ generate_block(unsigned short mx,
   GeomVertexWriter nwriter (vdata, "normal"  );
   PT(GeomTriangles) prim = new GeomTriangles(Geom::UH_stream);
 
-  if (_bruteforce) {
-    // LOD Level when rendering bruteforce is always 0 (no lod)
-    // Unless a minlevel is set- this is handled later.
-    level = 0;
-  }
-
   // Do some calculations with the level
-  level = min(max(_min_level, level), _max_level);
   unsigned short reallevel = level;
   level = int(pow(2.0, int(level)));
 
-  // Neighbor levels and junctions
-  unsigned short lnlevel = get_neighbor_level(mx, my, -1,  0);
-  unsigned short rnlevel = get_neighbor_level(mx, my,  1,  0);
-  unsigned short bnlevel = get_neighbor_level(mx, my,  0, -1);
-  unsigned short tnlevel = get_neighbor_level(mx, my,  0,  1);
+  // Neighbor junctions
   bool ljunction = (lnlevel != reallevel);
   bool rjunction = (rnlevel != reallevel);
   bool bjunction = (bnlevel != reallevel);
@@ -109,6 +134,8 @@ generate_block(unsigned short mx,
   // This is the number of vertices at the certain level.
   unsigned short lowblocksize = _block_size / level + 1;
 
+  BlockHeights heights(this, mx, my);
+
   for (int x = 0; x <= _block_size; x++) {
     for (int y = 0; y <= _block_size; y++) {
       if ((x % level) == 0 && (y % level) == 0) {
@@ -119,10 +146,10 @@ generate_block(unsigned short mx,
                                   / double(_ysize) * _color_map.get_y_size()));
           cwriter.add_data4(LCAST(PN_stdfloat, color));
         }
-        vwriter.add_data3(x - 0.5 * _block_size, y - 0.5 * _block_size, get_pixel_value(mx, my, x, y));
+        vwriter.add_data3(x - 0.5 * _block_size, y - 0.5 * _block_size, heights.get_value(x, y));
         twriter.add_data2((mx * _block_size + x) / double(_xsize - 1),
                            (my * _block_size + y) / double(_ysize - 1));
-        nwriter.add_data3(get_normal(mx, my, x, y));
+        nwriter.add_data3(heights.get_normal(x, y));
         if (x > 0 && y > 0) {
           // Left border
           if (x == level && ljunction) {
@@ -251,11 +278,54 @@ generate_block(unsigned short mx,
   PT(GeomNode) node = new GeomNode(sname.str());
   node->add_geom(geom);
   node->set_bounds_type(BoundingVolume::BT_box);
-  _old_levels.at(mx).at(my) = reallevel;
 
   return node;
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: GeoMipTerrain::BlockHeights::Constructor
+//       Access: Public
+//  Description: Reads the elevations under the indicated block.
+////////////////////////////////////////////////////////////////////
+GeoMipTerrain::BlockHeights::
+BlockHeights(GeoMipTerrain *terrain, unsigned short mx, unsigned short my) :
+  _size(terrain->_block_size + 3),
+  _values(_size * _size)
+{
+  // The upper-left corner of the block, and its border, in image
+  // coordinates.
+  int x0 = mx * terrain->_block_size - 1;
+  int y0 = (terrain->_ysize - 1) - (my * terrain->_block_size + _size - 2);
+
+  if (terrain->_paged != (PagedHeightfield *)NULL) {
+    terrain->_paged->get_values(x0, y0, _size, _size, &_values[0]);
+  } else {
+    for (int j = 0; j < _size; ++j) {
+      for (int i = 0; i < _size; ++i) {
+        _values[i + j * _size] = terrain->get_pixel_value(x0 + i, y0 + j);
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeoMipTerrain::BlockHeights::get_normal
+//       Access: Public
+//  Description: Returns the same normal as get_normal(mx, my, x, y),
+//               for 0 <= x, y <= block_size.
+////////////////////////////////////////////////////////////////////
+LVector3 GeoMipTerrain::BlockHeights::
+get_normal(int x, int y) const {
+  // The edge pixels are clamped when they are read, so the border
+  // holds what get_normal() would use at the edge of the terrain.
+  double drx = get_value(x + 1, y) - get_value(x - 1, y);
+  double dry = get_value(x, y - 1) - get_value(x, y + 1);
+  LVector3 normal(drx * 0.5, dry * 0.5, 1);
+  normal.normalize();
+
+  return normal;
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeoMipTerrain::get_elevation
 //       Access: Published
@@ -374,7 +444,11 @@ void GeoMipTerrain::
 calc_ambient_occlusion(PN_stdfloat radius, PN_stdfloat contrast, PN_stdfloat brightness) {
   _color_map = PNMImage(_xsize, _ysize);
   _color_map.make_grayscale();
-  _color_map.set_maxval(_heightfield.get_maxval());
+  if (_paged != (PagedHeightfield *)NULL) {
+    _color_map.set_maxval(_paged->get_maxval());
+  } else {
+    _color_map.set_maxval(_heightfield.get_maxval());
+  }
 
   for (unsigned int x = 0; x < _xsize; ++x) {
     for (unsigned int y = 0; y < _ysize; ++y) {
@@ -410,11 +484,15 @@ generate() {
     grutil_cat.error() << "No valid heightfield image has been set!\n";
     return;
   }
+  cancel_blocks();
   calc_levels();
   _root.node()->remove_all_children();
   _blocks.clear();
   _old_levels.clear();
   _old_levels.resize(int((_xsize - 1) / _block_size));
+  _pending.clear();
+  _pending.resize(int((_xsize - 1) / _block_size),
+                  pvector<PT(BlockTask)>(int((_ysize - 1) / _block_size)));
   _root_flattened = false;
   for (unsigned int mx = 0; mx < (_xsize - 1) / _block_size; mx++) {
     _old_levels[mx].resize(int((_ysize - 1) / _block_size));
@@ -459,17 +537,13 @@ update() {
     return true;
   } else if (!_bruteforce) {
     calc_levels();
-    if (root_flattened()) {
-      _root.node()->remove_all_children();
-      unsigned int xsize = _blocks.size();
-      for (unsigned int tx = 0; tx < xsize; tx++) {
-        unsigned int ysize = _blocks[tx].size();
-        for (unsigned int ty = 0;ty < ysize; ty++) {
-          _blocks[tx][ty].reparent_to(_root);
-        }
-      }
-      _root_flattened = false;
-    }
+    unflatten();
+
+    // First swap in the blocks that have been finished in the
+    // background since the last update.
+    bool async = use_async();
+    bool swapped = swap_blocks(false);
+
     bool returnVal = false;
     for (unsigned int mx = 0; mx < (_xsize - 1) / _block_size; mx++) {
       for (unsigned int my = 0; my < (_ysize - 1) / _block_size; my++) {
@@ -501,12 +575,67 @@ update() {
         }
       }
     }
+
+    if (!_batch.empty()) {
+      MutexHolder holder(_lock);
+      _batches.push_back(_batch);
+      _batch.clear();
+    }
+    if (async) {
+      // The blocks we have just requested will be swapped in by a
+      // later call to update() or flush().
+      returnVal = swapped;
+    } else {
+      returnVal = returnVal || swapped;
+    }
     auto_flatten();
     return returnVal;
   }
   return false;
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: GeoMipTerrain::flush
+//       Access: Published
+//  Description: Waits for all of the blocks that are being generated
+//               in the background to be finished, and swaps them
+//               into the terrain.  Returns true if the terrain has
+//               changed.  See set_async().
+////////////////////////////////////////////////////////////////////
+bool GeoMipTerrain::
+flush() {
+  if (get_num_pending_blocks() == 0) {
+    return false;
+  }
+  unflatten();
+  bool swapped = swap_blocks(true);
+  auto_flatten();
+  return swapped;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeoMipTerrain::get_num_pending_blocks
+//       Access: Published
+//  Description: Returns the number of blocks that have been requested
+//               by update() in async mode, but have not yet been
+//               swapped into the terrain.
+////////////////////////////////////////////////////////////////////
+int GeoMipTerrain::
+get_num_pending_blocks() const {
+  MutexHolder holder(_lock);
+  int count = 0;
+  pdeque<Batch>::const_iterator bi;
+  for (bi = _batches.begin(); bi != _batches.end(); ++bi) {
+    Batch::const_iterator ti;
+    for (ti = (*bi).begin(); ti != (*bi).end(); ++ti) {
+      if (!(*ti)->_stale) {
+        ++count;
+      }
+    }
+  }
+  return count;
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeoMipTerrain::root_flattened
 //       Access: Private
@@ -549,6 +678,28 @@ root_flattened() {
   return false;
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: GeoMipTerrain::unflatten
+//       Access: Private
+//  Description: If the root has been flattened, replaces its children
+//               with the terrain blocks again, so that they can be
+//               updated.
+////////////////////////////////////////////////////////////////////
+void GeoMipTerrain::
+unflatten() {
+  if (root_flattened()) {
+    _root.node()->remove_all_children();
+    unsigned int xsize = _blocks.size();
+    for (unsigned int tx = 0; tx < xsize; tx++) {
+      unsigned int ysize = _blocks[tx].size();
+      for (unsigned int ty = 0;ty < ysize; ty++) {
+        _blocks[tx][ty].reparent_to(_root);
+      }
+    }
+    _root_flattened = false;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeoMipTerrain::auto_flatten
 //       Access: Private
@@ -630,13 +781,195 @@ update_block(unsigned short mx, unsigned short my,
   }
   level = min(max(_min_level, (unsigned short) level), _max_level);
   if (forced || _old_levels[mx][my] != level) { // If the level has changed...
-    // Replaces the chunk with a regenerated one.
-    generate_block(mx, my, level)->replace_node(_blocks[mx][my].node());
+    if (use_async()) {
+      // Have the chunk regenerated in the background.
+      request_block(mx, my, level);
+    } else {
+      // Replaces the chunk with a regenerated one.
+      generate_block(mx, my, level)->replace_node(_blocks[mx][my].node());
+    }
     return true;
   }
   return false;
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: GeoMipTerrain::request_block
+//       Access: Private
+//  Description: Starts generating the specified block at the
+//               specified level in a geomipterrain thread.  The
+//               block is added to the batch of the current update,
+//               and supersedes any earlier request for the same
+//               block that has not yet been swapped in.
+////////////////////////////////////////////////////////////////////
+void GeoMipTerrain::
+request_block(unsigned short mx, unsigned short my, unsigned short level) {
+  PT(BlockTask) task =
+    new BlockTask(this, mx, my, level,
+                  get_neighbor_level(mx, my, -1,  0),
+                  get_neighbor_level(mx, my,  1,  0),
+                  get_neighbor_level(mx, my,  0, -1),
+                  get_neighbor_level(mx, my,  0,  1));
+  {
+    MutexHolder holder(_lock);
+    BlockTask *prev = _pending[mx][my];
+    if (prev != (BlockTask *)NULL) {
+      prev->_stale = true;
+    }
+    _pending[mx][my] = task;
+  }
+  _old_levels[mx][my] = level;
+  _batch.push_back(task);
+
+  get_task_chain();
+  AsyncTaskManager::get_global_ptr()->add(task);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeoMipTerrain::swap_blocks
+//       Access: Private
+//  Description: Replaces the terrain blocks with the ones that have
+//               been generated in the background, one whole batch at
+//               a time, so that the neighbors of a block always match
+//               its level.  If wait is true, waits for all of the
+//               batches to be finished; otherwise, stops at the first
+//               batch that is not yet finished.  Returns true if any
+//               block was replaced.
+////////////////////////////////////////////////////////////////////
+bool GeoMipTerrain::
+swap_blocks(bool wait) {
+  bool swapped = false;
+
+  MutexHolder holder(_lock);
+  while (!_batches.empty()) {
+    Batch &batch = _batches.front();
+    bool finished = true;
+    Batch::const_iterator ti;
+    for (ti = batch.begin(); ti != batch.end() && finished; ++ti) {
+      finished = (*ti)->_done;
+    }
+    if (!finished) {
+      if (!wait) {
+        break;
+      }
+      _cvar.wait();
+      continue;
+    }
+
+    // The blocks of a batch were stitched against each other's
+    // levels, so they are swapped in all together or not at all.  If
+    // some of them have been superseded by a later request, the rest
+    // are carried over into the next batch, which holds the
+    // replacements, and are swapped in along with it.
+    Batch current;
+    for (ti = batch.begin(); ti != batch.end(); ++ti) {
+      BlockTask *task = (*ti);
+      if (!task->_stale && _pending[task->_mx][task->_my] == task) {
+        current.push_back(task);
+      }
+    }
+    if (current.size() != batch.size() && _batches.size() > 1) {
+      Batch &next = _batches[1];
+      next.insert(next.end(), current.begin(), current.end());
+      _batches.pop_front();
+      continue;
+    }
+
+    for (ti = current.begin(); ti != current.end(); ++ti) {
+      BlockTask *task = (*ti);
+      task->_node->replace_node(_blocks[task->_mx][task->_my].node());
+      _pending[task->_mx][task->_my] = NULL;
+      swapped = true;
+    }
+    _batches.pop_front();
+  }
+
+  return swapped;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeoMipTerrain::cancel_blocks
+//       Access: Private
+//  Description: Abandons all of the blocks that are being generated
+//               in the background, and waits for the threads to stop
+//               using the terrain.  This must be called before
+//               changing anything that make_block() reads.  If any
+//               blocks were abandoned, the terrain is marked dirty,
+//               since the blocks in the scene graph no longer match
+//               the levels they were requested at.
+////////////////////////////////////////////////////////////////////
+void GeoMipTerrain::
+cancel_blocks() {
+  MutexHolder holder(_lock);
+  if (_batches.empty() && _batch.empty()) {
+    return;
+  }
+
+  pdeque<Batch>::iterator bi;
+  Batch::iterator ti;
+  for (bi = _batches.begin(); bi != _batches.end(); ++bi) {
+    for (ti = (*bi).begin(); ti != (*bi).end(); ++ti) {
+      (*ti)->_stale = true;
+    }
+  }
+  for (ti = _batch.begin(); ti != _batch.end(); ++ti) {
+    (*ti)->_stale = true;
+  }
+
+  // Now wait for the tasks that are already running.
+  for (bi = _batches.begin(); bi != _batches.end(); ++bi) {
+    for (ti = (*bi).begin(); ti != (*bi).end(); ++ti) {
+      while (!(*ti)->_done) {
+        _cvar.wait();
+      }
+    }
+  }
+  for (ti = _batch.begin(); ti != _batch.end(); ++ti) {
+    while (!(*ti)->_done) {
+      _cvar.wait();
+    }
+  }
+
+  _batches.clear();
+  _batch.clear();
+  for (size_t mx = 0; mx < _pending.size(); ++mx) {
+    for (size_t my = 0; my < _pending[mx].size(); ++my) {
+      _pending[mx][my] = NULL;
+    }
+  }
+  _is_dirty = true;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeoMipTerrain::use_async
+//       Access: Private
+//  Description: Returns true if blocks should be generated in the
+//               background at the moment.
+////////////////////////////////////////////////////////////////////
+bool GeoMipTerrain::
+use_async() const {
+  return _async && Thread::is_threading_supported() &&
+    geomipterrain_threads > 0;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeoMipTerrain::get_task_chain
+//       Access: Private, Static
+//  Description: Returns the task chain whose threads generate the
+//               blocks, creating it if necessary.
+////////////////////////////////////////////////////////////////////
+AsyncTaskChain *GeoMipTerrain::
+get_task_chain() {
+  AsyncTaskManager *task_mgr = AsyncTaskManager::get_global_ptr();
+  AsyncTaskChain *chain = task_mgr->find_task_chain("geomipterrain");
+  if (chain == (AsyncTaskChain *)NULL) {
+    chain = task_mgr->make_task_chain("geomipterrain");
+    chain->set_num_threads(geomipterrain_threads);
+    chain->set_thread_priority(TP_low);
+  }
+  return chain;
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeoMipTerrain::set_heightfield
 //       Access: Published
@@ -648,6 +981,8 @@ update_block(unsigned short mx, unsigned short my,
 ////////////////////////////////////////////////////////////////////
 bool GeoMipTerrain::
 set_heightfield(const Filename &filename, PNMFileType *ftype) {
+  cancel_blocks();
+
   // First, we need to load the header to determine the size and format.
   PNMImageHeader imgheader;
   if (imgheader.read_header(filename, ftype)) {
@@ -677,6 +1012,7 @@ set_heightfield(const Filename &filename, PNMFileType *ftype) {
       return false;
     }
 
+    _paged.clear();
     _is_dirty = true;
     _xsize = _heightfield.get_x_size();
     _ysize = _heightfield.get_y_size();
@@ -687,6 +1023,34 @@ set_heightfield(const Filename &filename, PNMFileType *ftype) {
   return false;
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: GeoMipTerrain::set_heightfield
+//       Access: Published
+//  Description: Specifies a PagedHeightfield from which the terrain
+//               should be generated, instead of an in-memory image.
+//               Only the tiles that are needed to generate a block
+//               are read, so this can be used for terrains that are
+//               too large to keep in memory.  The PagedHeightfield
+//               must be a power of two plus one in size.
+////////////////////////////////////////////////////////////////////
+bool GeoMipTerrain::
+set_heightfield(PagedHeightfield *source) {
+  nassertr(source != (PagedHeightfield *)NULL, false);
+  if (!is_power_of_two(source->get_x_size() - 1) ||
+      !is_power_of_two(source->get_y_size() - 1)) {
+    grutil_cat.error() << "Specified heightfield does not have a power-of-two-plus-one size!\n";
+    return false;
+  }
+
+  cancel_blocks();
+  _paged = source;
+  _heightfield.clear();
+  _is_dirty = true;
+  _xsize = source->get_x_size();
+  _ysize = source->get_y_size();
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeoMipTerrain::get_neighbor_level
 //       Access: Private
@@ -713,3 +1077,56 @@ get_neighbor_level(unsigned short mx, unsigned short my, short dmx, short dmy) {
   }
 }
 
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeoMipTerrain::BlockTask::Constructor
+//       Access: Public
+//  Description:
+////////////////////////////////////////////////////////////////////
+GeoMipTerrain::BlockTask::
+BlockTask(GeoMipTerrain *terrain, unsigned short mx, unsigned short my,
+          unsigned short level, unsigned short lnlevel,
+          unsigned short rnlevel, unsigned short bnlevel,
+          unsigned short tnlevel) :
+  AsyncTask("geomipterrain"),
+  _terrain(terrain),
+  _mx(mx),
+  _my(my),
+  _level(level),
+  _lnlevel(lnlevel),
+  _rnlevel(rnlevel),
+  _bnlevel(bnlevel),
+  _tnlevel(tnlevel),
+  _stale(false),
+  _done(false)
+{
+  set_task_chain("geomipterrain");
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeoMipTerrain::BlockTask::do_task
+//       Access: Protected, Virtual
+//  Description: Generates the block, unless it has been superseded
+//               in the meantime.
+////////////////////////////////////////////////////////////////////
+AsyncTask::DoneStatus GeoMipTerrain::BlockTask::
+do_task() {
+  bool stale;
+  {
+    MutexHolder holder(_terrain->_lock);
+    stale = _stale;
+  }
+
+  PT(GeomNode) node;
+  if (!stale) {
+    node = _terrain->make_block(_mx, _my, _level, _lnlevel, _rnlevel,
+                                _bnlevel, _tnlevel);
+  }
+
+  // After this, the terrain may be destroyed at any time.
+  MutexHolder holder(_terrain->_lock);
+  _node = node;
+  _done = true;
+  _terrain->_cvar.notify_all();
+  return DS_done;
+}
@@ -25,6 +25,11 @@
 #include "nodePath.h"
 
 #include "texture.h"
+#include "pagedHeightfield.h"
+#include "asyncTask.h"
+#include "pmutex.h"
+#include "conditionVarFull.h"
+#include "pdeque.h"
 
 ////////////////////////////////////////////////////////////////////
 //       Class : GeoMipTerrain
@@ -46,6 +51,8 @@ PUBLISHED:
   bool set_heightfield(const Filename &filename, PNMFileType *type = NULL);
   INLINE bool set_heightfield(const PNMImage &image);
   INLINE bool set_heightfield(const string &path);
+  bool set_heightfield(PagedHeightfield *source);
+  INLINE PagedHeightfield *get_paged_heightfield() const;
   INLINE PNMImage &color_map();
   INLINE bool set_color_map(const Filename &filename,
                                   PNMFileType *type = NULL);
@@ -109,18 +116,91 @@ PUBLISHED:
   INLINE double get_near();
   INLINE int get_flatten_mode();
 
+  INLINE void set_async(bool async);
+  INLINE bool get_async() const;
+  int get_num_pending_blocks() const;
+
   PNMImage make_slope_image();
   void generate();
   bool update();
+  bool flush();
 
 private:
+  // This task generates a single terrain block in one of the
+  // geomipterrain threads.
+  class BlockTask : public AsyncTask {
+  public:
+    BlockTask(GeoMipTerrain *terrain, unsigned short mx, unsigned short my,
+              unsigned short level, unsigned short lnlevel,
+              unsigned short rnlevel, unsigned short bnlevel,
+              unsigned short tnlevel);
+    ALLOC_DELETED_CHAIN(BlockTask);
+
+  protected:
+    virtual DoneStatus do_task();
+
+  public:
+    GeoMipTerrain *_terrain;
+    unsigned short _mx, _my;
+    unsigned short _level;
+    unsigned short _lnlevel, _rnlevel, _bnlevel, _tnlevel;
+
+    // These are protected by the terrain's _lock.
+    bool _stale;
+    bool _done;
+    PT(GeomNode) _node;
+
+  public:
+    static TypeHandle get_class_type() {
+      return _type_handle;
+    }
+    static void init_type() {
+      AsyncTask::init_type();
+      register_type(_type_handle, "GeoMipTerrain::BlockTask",
+                    AsyncTask::get_class_type());
+    }
+    virtual TypeHandle get_type() const {
+      return get_class_type();
+    }
+    virtual TypeHandle force_init_type() {init_type(); return get_class_type();}
+
+  private:
+    static TypeHandle _type_handle;
+  };
+
+  // The elevations under one block, plus a one-pixel border for the
+  // normals, read from the heightfield all at once so that
+  // make_block() resolves the heightfield pages once per block
+  // rather than once per sample.  Coordinates are relative to the
+  // block, as for get_pixel_value(mx, my, x, y).
+  class BlockHeights {
+  public:
+    BlockHeights(GeoMipTerrain *terrain, unsigned short mx, unsigned short my);
+
+    INLINE double get_value(int x, int y) const;
+    LVector3 get_normal(int x, int y) const;
+
+  private:
+    int _size;
+    pvector<double> _values;
+  };
 
   PT(GeomNode) generate_block(unsigned short mx, unsigned short my, unsigned short level);
+  PT(GeomNode) make_block(unsigned short mx, unsigned short my,
+                          unsigned short level, unsigned short lnlevel,
+                          unsigned short rnlevel, unsigned short bnlevel,
+                          unsigned short tnlevel);
+  void request_block(unsigned short mx, unsigned short my, unsigned short level);
+  bool swap_blocks(bool wait);
+  void cancel_blocks();
+  bool use_async() const;
+  static AsyncTaskChain *get_task_chain();
   bool update_block(unsigned short mx, unsigned short my,
                     signed short level = -1, bool forced = false);
   void calc_levels();
   void auto_flatten();
   bool root_flattened();
+  void unflatten();
 
   INLINE bool is_power_of_two(unsigned int i);
   INLINE float f_part(float i);
@@ -155,12 +235,26 @@ private:
   pvector<pvector<unsigned short> > _levels;
   pvector<pvector<unsigned short> > _old_levels;
 
+  PT(PagedHeightfield) _paged;
+
+  // The blocks that are being generated in the background.  Blocks
+  // requested by the same update() call form a batch, and are swapped
+  // in together once all of them are finished.
+  bool _async;
+  typedef pvector<PT(BlockTask)> Batch;
+  pdeque<Batch> _batches;
+  Batch _batch;
+  pvector<pvector<PT(BlockTask)> > _pending;
+  Mutex _lock;
+  ConditionVarFull _cvar;
+
 public:
   static TypeHandle get_class_type() {
     return _type_handle;
   }
   static void init_type() {
     TypedObject::init_type();
+    BlockTask::init_type();
     register_type(_type_handle, "GeoMipTerrain",
                   TypedObject::get_class_type());
   }
@@ -0,0 +1,225 @@
+// Filename: lodGenerator.cxx
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#include "lodGenerator.h"
+#include "config_grutil.h"
+#include "config_gobj.h"
+#include "boundingSphere.h"
+#include "boundingBox.h"
+#include "cmath.h"
+#include "deg_2_rad.h"
+
+////////////////////////////////////////////////////////////////////
+//     Function: LODGenerator::Constructor
+//       Access: Published
+//  Description:
+////////////////////////////////////////////////////////////////////
+LODGenerator::
+LODGenerator() :
+  _num_levels(4),
+  _reduction(0.5f),
+  _pixel_error(1.0f),
+  _screen_height(1080),
+  _fov(default_fov)
+{
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: LODGenerator::generate
+//       Access: Published
+//  Description: Replaces each GeomNode below the indicated root with
+//               an LODNode built by make_lod().  The existing
+//               LODNodes, and anything below them, are left alone, as
+//               are GeomNodes that have children.  The root itself is
+//               never replaced; call make_lod() directly for that.
+//
+//               Any transforms between the root and each GeomNode
+//               are taken into account when computing the switch
+//               distances, but the transform on the root itself and
+//               above is not.  For best results, call this on a model
+//               that will be rendered at unit scale.
+//
+//               The return value is the number of LODNodes created.
+////////////////////////////////////////////////////////////////////
+int LODGenerator::
+generate(PandaNode *root) {
+  return r_generate(root, TransformState::make_identity());
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: LODGenerator::make_lod
+//       Access: Published
+//  Description: Returns a new LODNode that may replace the indicated
+//               GeomNode.  It takes over the GeomNode's name,
+//               transform, state and tags, and has one GeomNode
+//               child per level, the first of which holds the
+//               original Geoms.  The scale is the factor by which
+//               the net transform above the GeomNode enlarges it, and
+//               is used to convert the simplification error into
+//               screen space.
+//
+//               Returns NULL if the GeomNode cannot be simplified at
+//               all.
+////////////////////////////////////////////////////////////////////
+PT(LODNode) LODGenerator::
+make_lod(GeomNode *gnode, PN_stdfloat scale) {
+  int num_geoms = gnode->get_num_geoms();
+  if (num_geoms == 0) {
+    return NULL;
+  }
+
+  // This converts an error in the node's coordinate space into the
+  // camera distance at which it covers pixel_error pixels.
+  PN_stdfloat factor = get_distance_factor() *
+    scale * gnode->get_transform()->get_mat().get_row3(0).length();
+
+  pvector<PT(GeomNode)> levels;
+  pvector<PN_stdfloat> distances;
+
+  PT(GeomNode) level = new GeomNode(gnode->get_name());
+  level->add_geoms_from(gnode);
+  levels.push_back(level);
+  distances.push_back(0.0f);
+
+  int prev_vertices = count_vertices(level);
+  PN_stdfloat ratio = 1.0f;
+  for (int li = 1; li < _num_levels; ++li) {
+    ratio *= _reduction;
+
+    PN_stdfloat error = 0.0f;
+    level = new GeomNode(gnode->get_name());
+    for (int gi = 0; gi < num_geoms; ++gi) {
+      PT(Geom) geom = _simplifier.simplify(gnode->get_geom(gi), ratio);
+      error = max(error, _simplifier.get_error());
+      if (geom->get_num_primitives() != 0) {
+        level->add_geom(geom, gnode->get_geom_state(gi));
+      }
+    }
+
+    int num_vertices = count_vertices(level);
+    if (num_vertices >= prev_vertices) {
+      // The simplifier couldn't reduce it any further.
+      break;
+    }
+    prev_vertices = num_vertices;
+
+    PN_stdfloat distance = error * factor;
+    if (distance <= distances.back()) {
+      // This level looks no worse than the previous one, so it may
+      // as well replace it.
+      levels.back() = level;
+    } else {
+      levels.push_back(level);
+      distances.push_back(distance);
+    }
+  }
+
+  if (levels.size() < 2) {
+    return NULL;
+  }
+
+  PT(LODNode) lod = new LODNode(gnode->get_name());
+  lod->copy_all_properties(gnode);
+
+  // The coarsest level switches out when the whole node would cover
+  // less than the pixel error.
+  PN_stdfloat far_distance = 0.0f;
+  CPT(BoundingVolume) bounds = gnode->get_internal_bounds();
+  const BoundingSphere *sphere = bounds->as_bounding_sphere();
+  const BoundingBox *box = bounds->as_bounding_box();
+  if (sphere != (const BoundingSphere *)NULL && !sphere->is_empty()) {
+    lod->set_center(sphere->get_center());
+    far_distance = sphere->get_radius() * factor;
+  } else if (box != (const BoundingBox *)NULL && !box->is_empty()) {
+    lod->set_center(box->get_approx_center());
+    far_distance = (box->get_maxq() - box->get_minq()).length() * 0.5f * factor;
+  }
+  far_distance = max(far_distance, distances.back() * 2.0f);
+
+  int num_levels = (int)levels.size();
+  for (int li = 0; li < num_levels; ++li) {
+    PN_stdfloat in = (li + 1 < num_levels) ? distances[li + 1] : far_distance;
+    lod->add_switch(in, distances[li]);
+    lod->add_child(levels[li]);
+  }
+
+  if (grutil_cat.is_debug()) {
+    grutil_cat.debug()
+      << "Generated " << num_levels << " levels for " << *gnode << "\n";
+  }
+
+  return lod;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: LODGenerator::r_generate
+//       Access: Private
+//  Description: The recursive implementation of generate().
+////////////////////////////////////////////////////////////////////
+int LODGenerator::
+r_generate(PandaNode *node, const TransformState *net_transform) {
+  int num_created = 0;
+
+  PandaNode::Children children = node->get_children();
+  int num_children = children.get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    PandaNode *child = children.get_child(i);
+    if (child->is_lod_node()) {
+      continue;
+    }
+
+    if (child->is_geom_node() && child->get_num_children() == 0) {
+      PN_stdfloat scale = net_transform->get_mat().get_row3(0).length();
+      PT(LODNode) lod = make_lod(DCAST(GeomNode, child), scale);
+      if (lod != (LODNode *)NULL) {
+        node->replace_child(child, lod);
+        ++num_created;
+      }
+    } else {
+      num_created +=
+        r_generate(child, net_transform->compose(child->get_transform()));
+    }
+  }
+
+  return num_created;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: LODGenerator::get_distance_factor
+//       Access: Private
+//  Description: Returns the factor that converts an error in world
+//               units into the distance from the camera at which it
+//               covers pixel_error pixels on the screen.
+////////////////////////////////////////////////////////////////////
+PN_stdfloat LODGenerator::
+get_distance_factor() const {
+  PN_stdfloat half_fov = deg_2_rad(_fov * 0.5f);
+  return (PN_stdfloat)_screen_height / (2.0f * _pixel_error * ctan(half_fov));
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: LODGenerator::count_vertices
+//       Access: Private, Static
+//  Description: Returns the total number of vertices referenced by
+//               the primitives of all of the Geoms in the node.
+////////////////////////////////////////////////////////////////////
+int LODGenerator::
+count_vertices(const GeomNode *gnode) {
+  int count = 0;
+  int num_geoms = gnode->get_num_geoms();
+  for (int i = 0; i < num_geoms; ++i) {
+    count += gnode->get_geom(i)->get_nested_vertices();
+  }
+  return count;
+}
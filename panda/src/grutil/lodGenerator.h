@@ -0,0 +1,78 @@
+// Filename: lodGenerator.h
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#ifndef LODGENERATOR_H
+#define LODGENERATOR_H
+
+#include "pandabase.h"
+
+#include "meshSimplifier.h"
+#include "lodNode.h"
+#include "geomNode.h"
+#include "transformState.h"
+#include "pointerTo.h"
+
+////////////////////////////////////////////////////////////////////
+//       Class : LODGenerator
+// Description : This class replaces GeomNodes with LODNodes whose
+//               children are successively simplified versions of the
+//               original geometry, as produced by a MeshSimplifier.
+//
+//               The switch distances are chosen so that each level
+//               appears when its geometric error, projected onto the
+//               screen, falls below the specified number of pixels,
+//               given the expected vertical resolution and field of
+//               view.
+////////////////////////////////////////////////////////////////////
+class EXPCL_PANDA_GRUTIL LODGenerator {
+PUBLISHED:
+  LODGenerator();
+
+  INLINE void set_num_levels(int num_levels);
+  INLINE int get_num_levels() const;
+
+  INLINE void set_reduction(PN_stdfloat reduction);
+  INLINE PN_stdfloat get_reduction() const;
+
+  INLINE void set_pixel_error(PN_stdfloat pixel_error);
+  INLINE PN_stdfloat get_pixel_error() const;
+
+  INLINE void set_screen_height(int screen_height);
+  INLINE int get_screen_height() const;
+
+  INLINE void set_fov(PN_stdfloat fov);
+  INLINE PN_stdfloat get_fov() const;
+
+  INLINE MeshSimplifier &get_simplifier();
+
+  int generate(PandaNode *root);
+  PT(LODNode) make_lod(GeomNode *gnode, PN_stdfloat scale = 1.0f);
+
+private:
+  int r_generate(PandaNode *node, const TransformState *net_transform);
+  PN_stdfloat get_distance_factor() const;
+  static int count_vertices(const GeomNode *gnode);
+
+  int _num_levels;
+  PN_stdfloat _reduction;
+  PN_stdfloat _pixel_error;
+  int _screen_height;
+  PN_stdfloat _fov;
+
+  MeshSimplifier _simplifier;
+};
+
+#include "lodGenerator.I"
+
+#endif
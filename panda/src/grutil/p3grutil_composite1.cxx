@@ -3,6 +3,7 @@
 #include "geoMipTerrain.cxx"
 #include "config_grutil.cxx"
 #include "lineSegs.cxx"
+#include "lodGenerator.cxx"
 #include "fisheyeMaker.cxx"
 #include "frameRateMeter.cxx"
 #include "sceneGraphAnalyzerMeter.cxx"
@@ -2,6 +2,7 @@
 #include "meshDrawer2D.cxx"
 #include "movieTexture.cxx"
 #include "nodeVertexTransform.cxx"
+#include "pagedHeightfield.cxx"
 #include "pipeOcclusionCullTraverser.cxx"
 #include "pfmVizzer.cxx"
 #include "rigidBodyCombiner.cxx"
@@ -0,0 +1,292 @@
+// Filename: pagedHeightfield.cxx
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#include "pagedHeightfield.h"
+#include "config_grutil.h"
+#include "mutexHolder.h"
+
+TypeHandle PagedHeightfield::_type_handle;
+
+////////////////////////////////////////////////////////////////////
+//     Function: PagedHeightfield::Constructor
+//       Access: Published
+//  Description: Creates a heightfield of the indicated size in
+//               pixels, stored in square tiles of tile_size pixels
+//               per side, whose filenames are made from the
+//               indicated pattern.  No tiles are read until they are
+//               needed.
+////////////////////////////////////////////////////////////////////
+PagedHeightfield::
+PagedHeightfield(const Filename &pattern, int x_size, int y_size,
+                 int tile_size) :
+  _pattern(pattern),
+  _x_size(x_size),
+  _y_size(y_size),
+  _tile_size(tile_size),
+  _max_tiles(max((int)heightfield_max_tiles, 1)),
+  _clock(0),
+  _lock("PagedHeightfield::_lock"),
+  _cvar(_lock)
+{
+  nassertv(x_size > 0 && y_size > 0 && tile_size > 0);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: PagedHeightfield::Destructor
+//       Access: Published, Virtual
+//  Description:
+////////////////////////////////////////////////////////////////////
+PagedHeightfield::
+~PagedHeightfield() {
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: PagedHeightfield::get_tile_filename
+//       Access: Published
+//  Description: Returns the filename of the tile in the indicated
+//               column and row, by substituting the numbers for %x
+//               and %y in the pattern.
+////////////////////////////////////////////////////////////////////
+Filename PagedHeightfield::
+get_tile_filename(int tx, int ty) const {
+  string pattern = _pattern.get_fullpath();
+  ostringstream result;
+  size_t p = 0;
+  while (p < pattern.length()) {
+    if (pattern[p] == '%' && p + 1 < pattern.length() &&
+        (pattern[p + 1] == 'x' || pattern[p + 1] == 'y')) {
+      result << ((pattern[p + 1] == 'x') ? tx : ty);
+      p += 2;
+    } else {
+      result << pattern[p];
+      ++p;
+    }
+  }
+
+  Filename filename(_pattern);
+  filename.set_fullpath(result.str());
+  return filename;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: PagedHeightfield::get_num_loaded_tiles
+//       Access: Published
+//  Description: Returns the number of tiles currently held in
+//               memory.
+////////////////////////////////////////////////////////////////////
+int PagedHeightfield::
+get_num_loaded_tiles() const {
+  MutexHolder holder(_lock);
+  return (int)_tiles.size();
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: PagedHeightfield::clear_cache
+//       Access: Published
+//  Description: Releases all of the tiles that are currently held in
+//               memory, for instance because the files on disk have
+//               changed.  Tiles that are still being read are kept.
+////////////////////////////////////////////////////////////////////
+void PagedHeightfield::
+clear_cache() {
+  MutexHolder holder(_lock);
+  Tiles::iterator ti = _tiles.begin();
+  while (ti != _tiles.end()) {
+    Tiles::iterator next = ti;
+    ++next;
+    if ((*ti).second->_loaded) {
+      _tiles.erase(ti);
+    }
+    ti = next;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: PagedHeightfield::get_value
+//       Access: Published
+//  Description: Returns the elevation stored at the indicated pixel,
+//               reading its tile from disk first if necessary.  The
+//               coordinates are clamped to the heightfield.
+//
+//               As with GeoMipTerrain, a grayscale tile stores the
+//               elevation as its brightness, while a color tile
+//               stores it in the red channel with additional
+//               precision in the green and blue channels.  A tile
+//               that could not be read has an elevation of 0.
+////////////////////////////////////////////////////////////////////
+double PagedHeightfield::
+get_value(int x, int y) {
+  x = max(min(x, _x_size - 1), 0);
+  y = max(min(y, _y_size - 1), 0);
+  int tx = x / _tile_size;
+  int ty = y / _tile_size;
+
+  PT(Tile) tile = get_tile(tx, ty);
+  return get_tile_value(tile->_image, x - tx * _tile_size, y - ty * _tile_size);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: PagedHeightfield::get_maxval
+//       Access: Published
+//  Description: Returns the maxval of the tile images, which is the
+//               precision with which the elevations are stored.  All
+//               of the tiles are assumed to share the format of the
+//               upper-left tile, which is read if necessary.
+////////////////////////////////////////////////////////////////////
+xelval PagedHeightfield::
+get_maxval() {
+  PT(Tile) tile = get_tile(0, 0);
+  return tile->_image.get_maxval();
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: PagedHeightfield::get_values
+//       Access: Public
+//  Description: Fills values with the elevations of the x_size by
+//               y_size rectangle of pixels whose upper-left corner
+//               is at (x, y), row by row.  The coordinates are
+//               clamped to the heightfield, as in get_value().
+//
+//               Each tile under the rectangle is looked up only
+//               once, which is much cheaper than calling get_value()
+//               for every pixel.
+////////////////////////////////////////////////////////////////////
+void PagedHeightfield::
+get_values(int x, int y, int x_size, int y_size, double *values) {
+  nassertv(x_size > 0 && y_size > 0);
+  int x0 = max(min(x, _x_size - 1), 0);
+  int y0 = max(min(y, _y_size - 1), 0);
+  int x1 = max(min(x + x_size - 1, _x_size - 1), 0);
+  int y1 = max(min(y + y_size - 1, _y_size - 1), 0);
+
+  for (int ty = y0 / _tile_size; ty <= y1 / _tile_size; ++ty) {
+    for (int tx = x0 / _tile_size; tx <= x1 / _tile_size; ++tx) {
+      PT(Tile) tile = get_tile(tx, ty);
+      const PNMImage &image = tile->_image;
+
+      for (int j = 0; j < y_size; ++j) {
+        int py = max(min(y + j, _y_size - 1), 0);
+        if (py / _tile_size != ty) {
+          continue;
+        }
+        for (int i = 0; i < x_size; ++i) {
+          int px = max(min(x + i, _x_size - 1), 0);
+          if (px / _tile_size == tx) {
+            values[i + j * x_size] =
+              get_tile_value(image, px - tx * _tile_size, py - ty * _tile_size);
+          }
+        }
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: PagedHeightfield::get_tile_value
+//       Access: Private, Static
+//  Description: Returns the elevation stored at the indicated pixel
+//               of a tile image, as described in get_value().
+////////////////////////////////////////////////////////////////////
+double PagedHeightfield::
+get_tile_value(const PNMImage &image, int x, int y) {
+  if (!image.is_valid()) {
+    return 0.0;
+  }
+
+  x = min(x, image.get_x_size() - 1);
+  y = min(y, image.get_y_size() - 1);
+  if (image.is_grayscale()) {
+    return double(image.get_bright(x, y));
+  } else {
+    return double(image.get_red(x, y))
+         + double(image.get_green(x, y)) / 256.0
+         + double(image.get_blue(x, y)) / 65536.0;
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: PagedHeightfield::get_tile
+//       Access: Private
+//  Description: Returns the tile in the indicated column and row,
+//               reading it from disk if it is not already in memory.
+//               The lock is not held while the file is read, so that
+//               other threads may use the tiles that are already
+//               resident in the meantime.
+////////////////////////////////////////////////////////////////////
+PT(PagedHeightfield::Tile) PagedHeightfield::
+get_tile(int tx, int ty) {
+  MutexHolder holder(_lock);
+  ++_clock;
+
+  pair<int, int> key(tx, ty);
+  Tiles::iterator ti = _tiles.find(key);
+  if (ti != _tiles.end()) {
+    PT(Tile) tile = (*ti).second;
+    tile->_last_used = _clock;
+    while (!tile->_loaded) {
+      // Another thread is reading this tile right now.
+      _cvar.wait();
+    }
+    return tile;
+  }
+
+  PT(Tile) tile = new Tile;
+  tile->_last_used = _clock;
+  _tiles[key] = tile;
+
+  Filename filename = get_tile_filename(tx, ty);
+  _lock.release();
+  if (grutil_cat.is_debug()) {
+    grutil_cat.debug()
+      << "Reading heightfield tile " << filename << "\n";
+  }
+  if (!tile->_image.read(filename)) {
+    grutil_cat.error()
+      << "Failed to read heightfield tile " << filename << "!\n";
+    tile->_image.clear();
+  }
+  _lock.acquire();
+
+  tile->_loaded = true;
+  _cvar.notify_all();
+  evict_tiles();
+  return tile;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: PagedHeightfield::evict_tiles
+//       Access: Private
+//  Description: Releases the least recently used tiles until no more
+//               than _max_tiles remain in memory.  Assumes the lock
+//               is held.
+////////////////////////////////////////////////////////////////////
+void PagedHeightfield::
+evict_tiles() {
+  while ((int)_tiles.size() > _max_tiles) {
+    Tiles::iterator oldest = _tiles.end();
+    Tiles::iterator ti;
+    for (ti = _tiles.begin(); ti != _tiles.end(); ++ti) {
+      if ((*ti).second->_loaded &&
+          (oldest == _tiles.end() ||
+           (*ti).second->_last_used < (*oldest).second->_last_used)) {
+        oldest = ti;
+      }
+    }
+    if (oldest == _tiles.end()) {
+      // All of the tiles are still being read.
+      return;
+    }
+    _tiles.erase(oldest);
+  }
+}
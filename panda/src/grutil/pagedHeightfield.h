@@ -0,0 +1,121 @@
+// Filename: pagedHeightfield.h
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#ifndef PAGEDHEIGHTFIELD_H
+#define PAGEDHEIGHTFIELD_H
+
+#include "pandabase.h"
+
+#include "typedReferenceCount.h"
+#include "referenceCount.h"
+#include "pnmImage.h"
+#include "filename.h"
+#include "pointerTo.h"
+#include "pmap.h"
+#include "pmutex.h"
+#include "mutexHolder.h"
+#include "conditionVarFull.h"
+
+////////////////////////////////////////////////////////////////////
+//       Class : PagedHeightfield
+// Description : A heightfield that is too large to be held in memory
+//               as a single PNMImage, and is instead stored on disk
+//               as a grid of square tile images.  Tiles are read the
+//               first time one of their pixels is requested, and the
+//               least recently used tiles are dropped again when more
+//               than get_max_tiles() of them are resident, so that
+//               only the neighborhood of the area being worked on
+//               needs to be kept in memory.
+//
+//               The tile filenames are made from a pattern that
+//               contains the sequences %x and %y, which are replaced
+//               by the column and row number of the tile, counting
+//               from the upper-left corner of the heightfield.  Pixel
+//               coordinates are image coordinates, as for PNMImage.
+//
+//               It is safe to query a PagedHeightfield from several
+//               threads at once.
+////////////////////////////////////////////////////////////////////
+class EXPCL_PANDA_GRUTIL PagedHeightfield : public TypedReferenceCount {
+PUBLISHED:
+  PagedHeightfield(const Filename &pattern, int x_size, int y_size,
+                   int tile_size);
+  virtual ~PagedHeightfield();
+
+  INLINE const Filename &get_pattern() const;
+  INLINE int get_x_size() const;
+  INLINE int get_y_size() const;
+  INLINE int get_tile_size() const;
+
+  INLINE void set_max_tiles(int max_tiles);
+  INLINE int get_max_tiles() const;
+
+  Filename get_tile_filename(int tx, int ty) const;
+  int get_num_loaded_tiles() const;
+  void clear_cache();
+
+  double get_value(int x, int y);
+  xelval get_maxval();
+
+public:
+  void get_values(int x, int y, int x_size, int y_size, double *values);
+
+private:
+  class Tile : public ReferenceCount {
+  public:
+    INLINE Tile();
+
+    PNMImage _image;
+    bool _loaded;
+    unsigned int _last_used;
+  };
+
+  PT(Tile) get_tile(int tx, int ty);
+  static double get_tile_value(const PNMImage &image, int x, int y);
+  void evict_tiles();
+
+  Filename _pattern;
+  int _x_size;
+  int _y_size;
+  int _tile_size;
+  int _max_tiles;
+
+  typedef pmap<pair<int, int>, PT(Tile) > Tiles;
+  Tiles _tiles;
+  unsigned int _clock;
+
+  Mutex _lock;
+  ConditionVarFull _cvar;
+
+public:
+  static TypeHandle get_class_type() {
+    return _type_handle;
+  }
+  static void init_type() {
+    TypedReferenceCount::init_type();
+    register_type(_type_handle, "PagedHeightfield",
+                  TypedReferenceCount::get_class_type());
+  }
+  virtual TypeHandle get_type() const {
+    return get_class_type();
+  }
+  virtual TypeHandle force_init_type() {init_type(); return get_class_type();}
+
+private:
+  static TypeHandle _type_handle;
+};
+
+#include "pagedHeightfield.I"
+
+#endif
@@ -22,6 +22,10 @@
 #include "geomVertexAnimationSpec.h"
 #include "sceneGraphReducer.h"
 #include "omniBoundingVolume.h"
+#include "geomVertexWriter.h"
+#include "geomVertexArrayData.h"
+#include "transformBlendTable.h"
+#include "config_grutil.h"
 
 TypeHandle RigidBodyCombiner::_type_handle;
 
@@ -102,6 +106,8 @@ collect() {
   _internal_root = new GeomNode(get_name());
   _internal_transforms.clear();
   _vd_table.clear();
+  _pools.clear();
+  _pieces.clear();
 
   Children cr = get_children();
   int num_children = cr.get_num_children();
@@ -117,6 +123,103 @@ collect() {
   gr.unify(_internal_root, false);
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: RigidBodyCombiner::add_collected_child
+//       Access: Published
+//  Description: Parents the indicated node to this node (if it is not
+//               already a child) and adds its geometry to the
+//               internal scene, without rebuilding the rest of the
+//               internal scene as collect() would.
+//
+//               The child is always treated as a "moving" node, even
+//               if its transform is initially identity; nodes below
+//               it follow the same rules as collect().  The geometry
+//               is appended to a pooled Geom that shares its state
+//               and vertex format, reusing the space left behind by
+//               a previously removed child when one of a suitable
+//               size is available.  This makes it practical to add
+//               and remove children every frame.
+//
+//               Unlike collect(), this does not apply attribs to the
+//               vertices or unify the resulting Geoms, so the
+//               internal scene may have more Geoms than it would
+//               after a full collect().
+////////////////////////////////////////////////////////////////////
+void RigidBodyCombiner::
+add_collected_child(PandaNode *child) {
+  nassertv(child != (PandaNode *)NULL);
+  if (_pieces.find(child) != _pieces.end()) {
+    // Already collected.
+    return;
+  }
+
+  if (!_internal_root->is_geom_node()) {
+    // collect() hasn't been called yet.
+    _internal_root = new GeomNode(get_name());
+  }
+
+  if (find_child(child) < 0) {
+    add_child(child);
+  }
+
+  Piece &piece = _pieces[child];
+  r_collect_piece(piece, child, RenderState::make_empty(), NULL);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: RigidBodyCombiner::remove_collected_child
+//       Access: Published
+//  Description: Removes the indicated child from this node, and
+//               removes its geometry from the internal scene.
+//
+//               If the child was added with add_collected_child(),
+//               this is a fast operation: its vertex indices are
+//               made degenerate, and its space in the pooled Geom is
+//               kept for reuse.  If it was collected by collect()
+//               instead, its geometry is baked into the internal
+//               scene, and the whole scene must be collected again.
+////////////////////////////////////////////////////////////////////
+void RigidBodyCombiner::
+remove_collected_child(PandaNode *child) {
+  Pieces::iterator pi = _pieces.find(child);
+  if (pi == _pieces.end()) {
+    remove_child(child);
+    collect();
+    return;
+  }
+
+  Piece &piece = (*pi).second;
+  Segments::iterator si;
+  for (si = piece._segments.begin(); si != piece._segments.end(); ++si) {
+    remove_segment(*si);
+  }
+
+  // Stop updating the piece's transforms each frame.
+  if (!piece._transforms.empty()) {
+    pset<NodeVertexTransform *> removed;
+    Transforms::const_iterator ti;
+    for (ti = piece._transforms.begin(); ti != piece._transforms.end(); ++ti) {
+      removed.insert(*ti);
+    }
+    Transforms::iterator wi = _internal_transforms.begin();
+    for (ti = _internal_transforms.begin();
+         ti != _internal_transforms.end();
+         ++ti) {
+      if (removed.find(*ti) == removed.end()) {
+        (*wi) = (*ti);
+        ++wi;
+      }
+    }
+    _internal_transforms.erase(wi, _internal_transforms.end());
+  }
+
+  // Keep a reference to the child until we have removed it from the
+  // scene graph; the piece's transforms may hold the last reference.
+  PT(PandaNode) hold_child = child;
+  _pieces.erase(pi);
+  remove_child(child);
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: RigidBodyCombiner::get_internal_scene
 //       Access: Published
@@ -241,20 +344,7 @@ convert_vd(const VertexTransform *transform, const GeomVertexData *orig) {
     return (*vdti).second;
   }
 
-  PT(GeomVertexFormat) format = new GeomVertexFormat(*orig->get_format());
-  if (!orig->get_format()->has_column(InternalName::get_transform_blend())) {
-    PT(GeomVertexArrayFormat) af = 
-      new GeomVertexArrayFormat(InternalName::get_transform_blend(), 1, 
-                                Geom::NT_uint16, Geom::C_index);
-    format->add_array(af);
-  }
-
-  GeomVertexAnimationSpec spec;
-  spec.set_panda();
-  format->set_animation(spec);
-  format->maybe_align_columns_for_animation();
-
-  CPT(GeomVertexFormat) new_format = GeomVertexFormat::register_format(format);
+  CPT(GeomVertexFormat) new_format = make_animated_format(orig->get_format());
   CPT(GeomVertexData) converted = orig->convert_to(new_format);
   PT(GeomVertexData) new_data = new GeomVertexData(*converted);
   
@@ -275,3 +365,315 @@ convert_vd(const VertexTransform *transform, const GeomVertexData *orig) {
 
   return new_data;
 }
+
+////////////////////////////////////////////////////////////////////
+//     Function: RigidBodyCombiner::make_animated_format
+//       Access: Private, Static
+//  Description: Returns the registered format that convert_vd() and
+//               add_collected_child() use for vertices from the
+//               indicated format: the same columns, plus a
+//               transform_blend index column, with Panda animation
+//               enabled.
+////////////////////////////////////////////////////////////////////
+CPT(GeomVertexFormat) RigidBodyCombiner::
+make_animated_format(const GeomVertexFormat *orig) {
+  PT(GeomVertexFormat) format = new GeomVertexFormat(*orig);
+  if (!orig->has_column(InternalName::get_transform_blend())) {
+    PT(GeomVertexArrayFormat) af = 
+      new GeomVertexArrayFormat(InternalName::get_transform_blend(), 1, 
+                                Geom::NT_uint16, Geom::C_index);
+    format->add_array(af);
+  }
+
+  GeomVertexAnimationSpec spec;
+  spec.set_panda();
+  format->set_animation(spec);
+  format->maybe_align_columns_for_animation();
+
+  return GeomVertexFormat::register_format(format);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: RigidBodyCombiner::r_collect_piece
+//       Access: Private
+//  Description: The add_collected_child() equivalent of r_collect().
+//               Visits the child and its descendants, and appends
+//               each of their Geoms' primitives to the appropriate
+//               pool, recording them in the indicated Piece.
+////////////////////////////////////////////////////////////////////
+void RigidBodyCombiner::
+r_collect_piece(Piece &piece, PandaNode *node, const RenderState *state,
+                const VertexTransform *transform) {
+  CPT(RenderState) next_state = state->compose(node->get_state());
+  CPT(VertexTransform) next_transform = transform;
+  if (transform == (const VertexTransform *)NULL ||
+      !node->get_transform()->is_identity() ||
+      node->is_of_type(ModelNode::get_class_type()) &&
+      DCAST(ModelNode, node)->get_preserve_transform() != ModelNode::PT_none) {
+    // The top node of the piece always gets its own transform, since
+    // the whole point is that it will be moved around.
+    PT(NodeVertexTransform) new_transform = new NodeVertexTransform(node, transform);
+    _internal_transforms.push_back(new_transform);
+    piece._transforms.push_back(new_transform);
+    next_transform = new_transform.p();
+  }
+
+  if (node->is_geom_node()) {
+    GeomNode *gnode = DCAST(GeomNode, node);
+
+    int num_geoms = gnode->get_num_geoms();
+    for (int i = 0; i < num_geoms; ++i) {
+      CPT(Geom) geom = gnode->get_geom(i);
+      CPT(GeomVertexData) vdata = geom->get_vertex_data();
+      if (vdata->get_transform_blend_table() != (TransformBlendTable *)NULL) {
+        grutil_cat.warning()
+          << "Cannot incrementally collect " << *geom << " in " << *node
+          << "; it is already animated.\n";
+        continue;
+      }
+
+      CPT(RenderState) gstate = next_state->compose(gnode->get_geom_state(i));
+      int num_primitives = geom->get_num_primitives();
+      for (int p = 0; p < num_primitives; ++p) {
+        add_segment(piece, vdata, geom->get_primitive(p), gstate, next_transform);
+      }
+    }
+  }
+
+  Children cr = node->get_children();
+  int num_children = cr.get_num_children();
+  for (int i = 0; i < num_children; i++) {
+    r_collect_piece(piece, cr.get_child(i), next_state, next_transform);
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: RigidBodyCombiner::add_segment
+//       Access: Private
+//  Description: Copies the vertices of the indicated primitive into
+//               the pool that matches its state and format, hard-
+//               assigned to the indicated transform, and appends its
+//               vertex indices to the pool's primitive.  A free slot
+//               is reused if one is large enough.
+////////////////////////////////////////////////////////////////////
+void RigidBodyCombiner::
+add_segment(Piece &piece, const GeomVertexData *vdata,
+            const GeomPrimitive *prim, const RenderState *state,
+            const VertexTransform *transform) {
+  CPT(GeomPrimitive) decomposed = prim->decompose();
+  if (decomposed->get_primitive_type() != GeomPrimitive::PT_polygons &&
+      decomposed->get_primitive_type() != GeomPrimitive::PT_lines) {
+    // We remove a slot's geometry by making its primitives
+    // degenerate, which doesn't work for points.
+    grutil_cat.warning()
+      << "Cannot incrementally collect " << decomposed->get_type() << "\n";
+    return;
+  }
+
+  int num_indices = decomposed->get_num_vertices();
+  if (num_indices == 0) {
+    return;
+  }
+
+  Thread *current_thread = Thread::get_current_thread();
+  CPT(GeomVertexFormat) format = make_animated_format(vdata->get_format());
+  CPT(GeomVertexData) converted = vdata->convert_to(format);
+  int num_vertices = converted->get_num_rows();
+
+  Pool &pool = _pools[PoolKey(state, format, decomposed->get_type())];
+  if (pool._geom == (Geom *)NULL) {
+    PT(GeomVertexData) pool_vdata =
+      new GeomVertexData(get_name(), format, Geom::UH_dynamic);
+    pool_vdata->set_transform_blend_table(new TransformBlendTable);
+
+    PT(GeomPrimitive) pool_prim = decomposed->make_copy();
+    pool_prim->clear_vertices();
+    pool_prim->set_index_type(Geom::NT_uint32);
+
+    pool._geom = new Geom(pool_vdata);
+    pool._geom->add_primitive(pool_prim);
+    DCAST(GeomNode, _internal_root)->add_geom(pool._geom, state);
+  }
+
+  Segment segment;
+  segment._pool = &pool;
+
+  bool found_slot = false;
+  Slots::iterator fi;
+  for (fi = pool._free_slots.begin(); fi != pool._free_slots.end(); ++fi) {
+    if ((*fi)._num_vertices >= num_vertices &&
+        (*fi)._num_indices >= num_indices) {
+      segment._slot = (*fi);
+      pool._free_slots.erase(fi);
+      found_slot = true;
+      break;
+    }
+  }
+
+  PT(GeomVertexData) pool_vdata = pool._geom->modify_vertex_data();
+  if (!found_slot) {
+    segment._slot._vertex_start = pool._num_vertices;
+    segment._slot._num_vertices = num_vertices;
+    segment._slot._index_start = pool._num_indices;
+    segment._slot._num_indices = num_indices;
+    pool._num_vertices += num_vertices;
+    pool._num_indices += num_indices;
+
+    pool_vdata->set_num_rows(pool._num_vertices);
+    pool_vdata->modify_transform_blend_table()->set_rows(SparseArray::range(0, pool._num_vertices));
+  }
+  const Slot &slot = segment._slot;
+
+  segment._blend_index = pool.acquire_blend(transform);
+  if (segment._blend_index > 0xffff) {
+    // The blend index doesn't fit in the uint16 column.  Give back
+    // the blend and the slot, so the pool is left as we found it.
+    pool.release_blend(segment._blend_index);
+    pool._free_slots.push_back(slot);
+    nassert_raise("too many transforms in RigidBodyCombiner pool");
+    return;
+  }
+
+  // Copy the vertices into the slot, array by array; the converted
+  // data has exactly the pool's format.
+  int num_arrays = format->get_num_arrays();
+  for (int a = 0; a < num_arrays; ++a) {
+    size_t stride = format->get_array(a)->get_stride();
+    size_t size = num_vertices * stride;
+    CPT(GeomVertexArrayDataHandle) from =
+      converted->get_array(a)->get_handle(current_thread);
+    PT(GeomVertexArrayDataHandle) to =
+      pool_vdata->modify_array(a)->modify_handle(current_thread);
+    to->copy_subdata_from(slot._vertex_start * stride, size, from, 0, size);
+  }
+
+  GeomVertexWriter blend(pool_vdata, InternalName::get_transform_blend(),
+                         current_thread);
+  blend.set_row(slot._vertex_start);
+  for (int i = 0; i < num_vertices; ++i) {
+    blend.set_data1i(segment._blend_index);
+  }
+
+  // Now write the indices, offset to the slot's vertices.  If we are
+  // reusing a larger slot, the leftover indices are degenerate.
+  PT(GeomVertexArrayData) indices = pool._geom->modify_primitive(0)->modify_vertices();
+  if (indices->get_num_rows() < pool._num_indices) {
+    indices->set_num_rows(pool._num_indices);
+  }
+  GeomVertexWriter index(indices, 0, current_thread);
+  index.set_row(slot._index_start);
+  for (int i = 0; i < num_indices; ++i) {
+    index.set_data1i(decomposed->get_vertex(i) + slot._vertex_start);
+  }
+  for (int i = num_indices; i < slot._num_indices; ++i) {
+    index.set_data1i(slot._vertex_start);
+  }
+
+  // The pool's Geom was patched in place, so the GeomNode's cached
+  // bounds no longer cover it.
+  _internal_root->mark_internal_bounds_stale(current_thread);
+
+  piece._segments.push_back(segment);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: RigidBodyCombiner::remove_segment
+//       Access: Private
+//  Description: Makes the segment's primitives degenerate, so that
+//               they no longer draw anything, and returns its slot
+//               to the pool's free list.
+////////////////////////////////////////////////////////////////////
+void RigidBodyCombiner::
+remove_segment(Segment &segment) {
+  Pool &pool = *segment._pool;
+  const Slot &slot = segment._slot;
+
+  PT(GeomVertexArrayData) indices = pool._geom->modify_primitive(0)->modify_vertices();
+  GeomVertexWriter index(indices, 0);
+  index.set_row(slot._index_start);
+  for (int i = 0; i < slot._num_indices; ++i) {
+    index.set_data1i(slot._vertex_start);
+  }
+
+  _internal_root->mark_internal_bounds_stale();
+
+  pool.release_blend(segment._blend_index);
+  pool._free_slots.push_back(slot);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: RigidBodyCombiner::Pool::Constructor
+//       Access: Public
+//  Description:
+////////////////////////////////////////////////////////////////////
+RigidBodyCombiner::Pool::
+Pool() :
+  _num_vertices(0),
+  _num_indices(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: RigidBodyCombiner::Pool::acquire_blend
+//       Access: Public
+//  Description: Returns the index of the blend in the pool's
+//               TransformBlendTable that hard-assigns vertices to the
+//               indicated transform, adding it (or recycling an
+//               unused entry) if necessary.  Each call must be
+//               balanced by a call to release_blend().
+////////////////////////////////////////////////////////////////////
+int RigidBodyCombiner::Pool::
+acquire_blend(const VertexTransform *transform) {
+  BlendLookup::iterator bi = _blend_lookup.find(transform);
+  if (bi != _blend_lookup.end()) {
+    int blend_index = (*bi).second;
+    ++_blend_refs[blend_index];
+    return blend_index;
+  }
+
+  PT(TransformBlendTable) table =
+    _geom->modify_vertex_data()->modify_transform_blend_table();
+
+  int blend_index;
+  if (!_free_blends.empty()) {
+    blend_index = _free_blends.back();
+    _free_blends.pop_back();
+    table->set_blend(blend_index, TransformBlend(transform, 1.0f));
+  } else {
+    blend_index = table->add_blend(TransformBlend(transform, 1.0f));
+    if (blend_index >= (int)_blend_refs.size()) {
+      _blend_refs.resize(blend_index + 1, 0);
+      _blend_transforms.resize(blend_index + 1, NULL);
+    }
+  }
+
+  _blend_lookup[transform] = blend_index;
+  _blend_transforms[blend_index] = transform;
+  _blend_refs[blend_index] = 1;
+  return blend_index;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: RigidBodyCombiner::Pool::release_blend
+//       Access: Public
+//  Description: Balances a previous call to acquire_blend().  When
+//               the last reference is released, the blend is cleared
+//               (so that it no longer holds the transform) and kept
+//               for reuse.
+////////////////////////////////////////////////////////////////////
+void RigidBodyCombiner::Pool::
+release_blend(int blend_index) {
+  nassertv(blend_index >= 0 && blend_index < (int)_blend_refs.size());
+  nassertv(_blend_refs[blend_index] > 0);
+  if (--_blend_refs[blend_index] != 0) {
+    return;
+  }
+
+  _blend_lookup.erase(_blend_transforms[blend_index]);
+  _blend_transforms[blend_index] = NULL;
+
+  PT(TransformBlendTable) table =
+    _geom->modify_vertex_data()->modify_transform_blend_table();
+  table->set_blend(blend_index, TransformBlend());
+  _free_blends.push_back(blend_index);
+}
@@ -19,7 +19,11 @@
 
 #include "pandaNode.h"
 #include "nodeVertexTransform.h"
+#include "geom.h"
+#include "geomVertexFormat.h"
+#include "renderState.h"
 #include "pvector.h"
+#include "pmap.h"
 
 class NodePath;
 
@@ -40,7 +44,10 @@ class NodePath;
 //
 //               You should call collect() only at startup or if you
 //               change the set of children; it is a relatively
-//               expensive call.
+//               expensive call.  For objects that come and go
+//               frequently, use add_collected_child() and
+//               remove_collected_child() instead, which patch the
+//               internal scene in place without rebuilding it.
 //
 //               Once you call collect(), you may change the
 //               transforms on the child nodes freely without having
@@ -58,6 +65,8 @@ protected:
 
 PUBLISHED:
   void collect();
+  void add_collected_child(PandaNode *child);
+  void remove_collected_child(PandaNode *child);
 
   NodePath get_internal_scene();
 
@@ -70,6 +79,7 @@ private:
                  const VertexTransform *transform);
   PT(GeomVertexData) convert_vd(const VertexTransform *transform, 
                                 const GeomVertexData *orig);
+  static CPT(GeomVertexFormat) make_animated_format(const GeomVertexFormat *orig);
 
   PT(PandaNode) _internal_root;
 
@@ -89,6 +99,80 @@ private:
   typedef pmap<VDUnifier, PT(GeomVertexData) > VDTable;
   VDTable _vd_table;
 
+  // The following structures support add_collected_child() and
+  // remove_collected_child().  Incrementally-added geometry is
+  // appended to one of a handful of pooled Geoms, one for each
+  // combination of state, vertex format and primitive type.  Each
+  // piece of geometry occupies a Slot: a range of vertex rows and a
+  // range of vertex indices within its pool.  When a child is
+  // removed, its indices are made degenerate and the slot is kept on
+  // a free list, to be reused by the next child of a suitable size.
+  class Slot {
+  public:
+    int _vertex_start;
+    int _num_vertices;
+    int _index_start;
+    int _num_indices;
+  };
+  typedef pvector<Slot> Slots;
+
+  class PoolKey {
+  public:
+    INLINE PoolKey(const RenderState *state, const GeomVertexFormat *format,
+                   TypeHandle prim_type);
+    INLINE bool operator < (const PoolKey &other) const;
+
+    CPT(RenderState) _state;
+    CPT(GeomVertexFormat) _format;
+    TypeHandle _prim_type;
+  };
+
+  class Pool {
+  public:
+    Pool();
+    int acquire_blend(const VertexTransform *transform);
+    void release_blend(int blend_index);
+
+    PT(Geom) _geom;
+    int _num_vertices;
+    int _num_indices;
+    Slots _free_slots;
+
+    // Each distinct transform in the pool has one entry in the
+    // pool's TransformBlendTable, reference-counted so that it can be
+    // recycled when the last piece using it is removed.
+    typedef pmap<const VertexTransform *, int> BlendLookup;
+    BlendLookup _blend_lookup;
+    pvector<const VertexTransform *> _blend_transforms;
+    pvector<int> _blend_refs;
+    pvector<int> _free_blends;
+  };
+  typedef pmap<PoolKey, Pool> Pools;
+  Pools _pools;
+
+  class Segment {
+  public:
+    Pool *_pool;
+    Slot _slot;
+    int _blend_index;
+  };
+  typedef pvector<Segment> Segments;
+
+  class Piece {
+  public:
+    Segments _segments;
+    Transforms _transforms;
+  };
+  typedef pmap<PandaNode *, Piece> Pieces;
+  Pieces _pieces;
+
+  void r_collect_piece(Piece &piece, PandaNode *node, const RenderState *state,
+                       const VertexTransform *transform);
+  void add_segment(Piece &piece, const GeomVertexData *vdata,
+                   const GeomPrimitive *prim, const RenderState *state,
+                   const VertexTransform *transform);
+  void remove_segment(Segment &segment);
+
 
 public:
   static TypeHandle get_class_type() {
@@ -89,3 +89,13 @@
 
 #end test_bin_target
 
+#begin test_bin_target
+  #define TARGET test_lmatrix4
+  #define LOCAL_LIBS \
+    p3linmath
+  #define OTHER_LIBS $[OTHER_LIBS] p3pystub
+
+  #define SOURCES \
+    test_lmatrix4.cxx
+
+#end test_bin_target
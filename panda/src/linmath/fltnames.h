@@ -38,8 +38,10 @@
 #undef FLOATTOKEN
 #undef FLOATCONST
 #undef FLOATTYPE_IS_INT
+#undef FLOATTYPE_IS_FLOAT
 
 #define FLOATTYPE float
 #define FLOATNAME(ARG) ARG##f
 #define FLOATTOKEN 'f'
 #define FLOATCONST(ARG) ARG##f
+#define FLOATTYPE_IS_FLOAT
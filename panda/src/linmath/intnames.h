@@ -38,6 +38,7 @@
 #undef FLOATTOKEN
 #undef FLOATCONST
 #undef FLOATTYPE_IS_INT
+#undef FLOATTYPE_IS_FLOAT
 
 #define FLOATTYPE int
 #define FLOATNAME(ARG) ARG##i
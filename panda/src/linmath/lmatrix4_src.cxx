@@ -312,6 +312,164 @@ almost_equal(const FLOATNAME(LMatrix4) &other, FLOATTYPE threshold) const {
 }
 
 
+////////////////////////////////////////////////////////////////////
+//     Function: LMatrix4::xform_points
+//       Access: Public
+//  Description: Transforms each of the count points in the from
+//               table, storing the results in the to table.  Each
+//               point is three FLOATTYPE values; from_stride and
+//               to_stride give the number of bytes from one point to
+//               the next.  The tables may be the same table.  This is
+//               equivalent to calling xform_point() on each one.
+////////////////////////////////////////////////////////////////////
+void FLOATNAME(LMatrix4)::
+xform_points(const unsigned char *from, size_t from_stride,
+             unsigned char *to, size_t to_stride, size_t count) const {
+#if defined(LINMATH_SSE) && defined(FLOATTYPE_IS_FLOAT)
+  __m128 r0 = _mm_loadu_ps(&_m(0, 0));
+  __m128 r1 = _mm_loadu_ps(&_m(1, 0));
+  __m128 r2 = _mm_loadu_ps(&_m(2, 0));
+  __m128 r3 = _mm_loadu_ps(&_m(3, 0));
+  for (size_t i = 0; i < count; ++i) {
+    const FLOATTYPE *f = (const FLOATTYPE *)from;
+    __m128 r = _mm_mul_ps(_mm_set1_ps(f[0]), r0);
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(f[1]), r1));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(f[2]), r2));
+    r = _mm_add_ps(r, r3);
+
+    FLOATTYPE *t = (FLOATTYPE *)to;
+    _mm_storel_pi((__m64 *)t, r);
+    _mm_store_ss(t + 2, _mm_movehl_ps(r, r));
+    from += from_stride;
+    to += to_stride;
+  }
+
+#else
+  // Copy the matrix into locals, so the compiler knows that storing
+  // the results can't modify it.
+  FLOATTYPE m00 = _m(0, 0), m01 = _m(0, 1), m02 = _m(0, 2);
+  FLOATTYPE m10 = _m(1, 0), m11 = _m(1, 1), m12 = _m(1, 2);
+  FLOATTYPE m20 = _m(2, 0), m21 = _m(2, 1), m22 = _m(2, 2);
+  FLOATTYPE m30 = _m(3, 0), m31 = _m(3, 1), m32 = _m(3, 2);
+  for (size_t i = 0; i < count; ++i) {
+    const FLOATTYPE *f = (const FLOATTYPE *)from;
+    FLOATTYPE x = f[0];
+    FLOATTYPE y = f[1];
+    FLOATTYPE z = f[2];
+
+    FLOATTYPE *t = (FLOATTYPE *)to;
+    t[0] = x * m00 + y * m10 + z * m20 + m30;
+    t[1] = x * m01 + y * m11 + z * m21 + m31;
+    t[2] = x * m02 + y * m12 + z * m22 + m32;
+    from += from_stride;
+    to += to_stride;
+  }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: LMatrix4::xform_vecs
+//       Access: Public
+//  Description: Transforms each of the count vectors in the from
+//               table, storing the results in the to table.  Each
+//               vector is three FLOATTYPE values; from_stride and
+//               to_stride give the number of bytes from one vector to
+//               the next.  The tables may be the same table.  This is
+//               equivalent to calling xform_vec() on each one.
+////////////////////////////////////////////////////////////////////
+void FLOATNAME(LMatrix4)::
+xform_vecs(const unsigned char *from, size_t from_stride,
+           unsigned char *to, size_t to_stride, size_t count) const {
+#if defined(LINMATH_SSE) && defined(FLOATTYPE_IS_FLOAT)
+  __m128 r0 = _mm_loadu_ps(&_m(0, 0));
+  __m128 r1 = _mm_loadu_ps(&_m(1, 0));
+  __m128 r2 = _mm_loadu_ps(&_m(2, 0));
+  for (size_t i = 0; i < count; ++i) {
+    const FLOATTYPE *f = (const FLOATTYPE *)from;
+    __m128 r = _mm_mul_ps(_mm_set1_ps(f[0]), r0);
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(f[1]), r1));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(f[2]), r2));
+
+    FLOATTYPE *t = (FLOATTYPE *)to;
+    _mm_storel_pi((__m64 *)t, r);
+    _mm_store_ss(t + 2, _mm_movehl_ps(r, r));
+    from += from_stride;
+    to += to_stride;
+  }
+
+#else
+  FLOATTYPE m00 = _m(0, 0), m01 = _m(0, 1), m02 = _m(0, 2);
+  FLOATTYPE m10 = _m(1, 0), m11 = _m(1, 1), m12 = _m(1, 2);
+  FLOATTYPE m20 = _m(2, 0), m21 = _m(2, 1), m22 = _m(2, 2);
+  for (size_t i = 0; i < count; ++i) {
+    const FLOATTYPE *f = (const FLOATTYPE *)from;
+    FLOATTYPE x = f[0];
+    FLOATTYPE y = f[1];
+    FLOATTYPE z = f[2];
+
+    FLOATTYPE *t = (FLOATTYPE *)to;
+    t[0] = x * m00 + y * m10 + z * m20;
+    t[1] = x * m01 + y * m11 + z * m21;
+    t[2] = x * m02 + y * m12 + z * m22;
+    from += from_stride;
+    to += to_stride;
+  }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: LMatrix4::xform_vecbase4s
+//       Access: Public
+//  Description: Transforms each of the count 4-component vectors in
+//               the from table, storing the results in the to table.
+//               Each vector is four FLOATTYPE values, which need not
+//               be aligned; from_stride and to_stride give the number
+//               of bytes from one vector to the next.  The tables may
+//               be the same table.  This is equivalent to calling
+//               xform() on each one.
+////////////////////////////////////////////////////////////////////
+void FLOATNAME(LMatrix4)::
+xform_vecbase4s(const unsigned char *from, size_t from_stride,
+                unsigned char *to, size_t to_stride, size_t count) const {
+#if defined(LINMATH_SSE) && defined(FLOATTYPE_IS_FLOAT)
+  __m128 r0 = _mm_loadu_ps(&_m(0, 0));
+  __m128 r1 = _mm_loadu_ps(&_m(1, 0));
+  __m128 r2 = _mm_loadu_ps(&_m(2, 0));
+  __m128 r3 = _mm_loadu_ps(&_m(3, 0));
+  for (size_t i = 0; i < count; ++i) {
+    __m128 v = _mm_loadu_ps((const FLOATTYPE *)from);
+    __m128 r = _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)), r0);
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), r1));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), r2));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)), r3));
+    _mm_storeu_ps((FLOATTYPE *)to, r);
+    from += from_stride;
+    to += to_stride;
+  }
+
+#else
+  FLOATTYPE m00 = _m(0, 0), m01 = _m(0, 1), m02 = _m(0, 2), m03 = _m(0, 3);
+  FLOATTYPE m10 = _m(1, 0), m11 = _m(1, 1), m12 = _m(1, 2), m13 = _m(1, 3);
+  FLOATTYPE m20 = _m(2, 0), m21 = _m(2, 1), m22 = _m(2, 2), m23 = _m(2, 3);
+  FLOATTYPE m30 = _m(3, 0), m31 = _m(3, 1), m32 = _m(3, 2), m33 = _m(3, 3);
+  for (size_t i = 0; i < count; ++i) {
+    const FLOATTYPE *f = (const FLOATTYPE *)from;
+    FLOATTYPE x = f[0];
+    FLOATTYPE y = f[1];
+    FLOATTYPE z = f[2];
+    FLOATTYPE w = f[3];
+
+    FLOATTYPE *t = (FLOATTYPE *)to;
+    t[0] = x * m00 + y * m10 + z * m20 + w * m30;
+    t[1] = x * m01 + y * m11 + z * m21 + w * m31;
+    t[2] = x * m02 + y * m12 + z * m22 + w * m32;
+    t[3] = x * m03 + y * m13 + z * m23 + w * m33;
+    from += from_stride;
+    to += to_stride;
+  }
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: LMatrix4::output
 //       Access: Public
@@ -163,6 +163,10 @@ PUBLISHED:
 
   // this = other1 * other2
   INLINE_LINMATH void multiply(const FLOATNAME(LMatrix4) &other1, const FLOATNAME(LMatrix4) &other2);
+  // this = transpose(other1) * other2
+  INLINE_LINMATH void transpose_multiply(const FLOATNAME(LMatrix4) &other1, const FLOATNAME(LMatrix4) &other2);
+  // this = other1 * transpose(other2)
+  INLINE_LINMATH void multiply_transpose(const FLOATNAME(LMatrix4) &other1, const FLOATNAME(LMatrix4) &other2);
 
   INLINE_LINMATH FLOATNAME(LMatrix4) operator * (const FLOATNAME(LMatrix4) &other) const;
 
@@ -267,6 +271,25 @@ PUBLISHED:
   void write_datagram(Datagram &destination) const;
   void read_datagram(DatagramIterator &source);
 
+public:
+  // These transform a whole array of points or vectors at once.  The
+  // strided versions operate on tables of FLOATTYPE values with the
+  // indicated number of bytes from one element to the next, as in a
+  // column of a GeomVertexArrayData.  In either case, from and to may
+  // be the same array.
+  INLINE_LINMATH void xform_points(const FLOATNAME(LVecBase3) *from,
+                                   FLOATNAME(LVecBase3) *to, size_t count) const;
+  void xform_points(const unsigned char *from, size_t from_stride,
+                    unsigned char *to, size_t to_stride, size_t count) const;
+  INLINE_LINMATH void xform_vecs(const FLOATNAME(LVecBase3) *from,
+                                 FLOATNAME(LVecBase3) *to, size_t count) const;
+  void xform_vecs(const unsigned char *from, size_t from_stride,
+                  unsigned char *to, size_t to_stride, size_t count) const;
+  INLINE_LINMATH void xform_vecbase4s(const FLOATNAME(LVecBase4) *from,
+                                      FLOATNAME(LVecBase4) *to, size_t count) const;
+  void xform_vecbase4s(const unsigned char *from, size_t from_stride,
+                       unsigned char *to, size_t to_stride, size_t count) const;
+
 public:
   // The underlying implementation is via the Eigen library, if available.
 
@@ -67,6 +67,15 @@ private:
 #define ALIGN_LINMATH 
 #endif  // LINMATH_ALIGN
 
+// In the absence of Eigen, we can still use SSE directly for a few of
+// the hottest single-precision operations in LMatrix4, if the
+// compiler is targeting a processor that has it.
+#if !defined(HAVE_EIGEN) && !defined(CPPPARSER) && \
+  (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define LINMATH_SSE 1
+#include <xmmintrin.h>
+#endif
+
 #endif
 
   
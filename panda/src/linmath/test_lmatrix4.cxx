@@ -0,0 +1,325 @@
+// Filename: test_lmatrix4.cxx
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+#include "luse.h"
+#include "lmatrix.h"
+#include "trueClock.h"
+#include "pnotify.h"
+
+#include <stdlib.h>
+
+// This program measures how far the LMatrix4f operations stray from
+// the results they should give, and how long each takes.  Each
+// operation is compared with an identity it must satisfy, such as
+// (a b)^T = b^T a^T or m m^-1 = I, or with the same computation
+// written out as scalar arithmetic, and the largest error over many
+// random matrices is reported.  Run it in builds with and without
+// Eigen (or SSE) to compare the back ends.
+
+static float
+random_float() {
+  return (float)rand() / (float)RAND_MAX - 0.5f;
+}
+
+static LMatrix4f
+random_mat() {
+  LMatrix4f mat;
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      mat(i, j) = random_float();
+    }
+  }
+  return mat;
+}
+
+// The largest error seen for one identity.
+class ErrorBound {
+public:
+  ErrorBound(const char *name) : _name(name), _max_error(0.0f) {}
+
+  void add(float result, float expected) {
+    _max_error = max(_max_error, (float)fabs(result - expected));
+  }
+  void add(const LMatrix4f &result, const LMatrix4f &expected) {
+    for (int i = 0; i < 4; ++i) {
+      for (int j = 0; j < 4; ++j) {
+        add(result(i, j), expected(i, j));
+      }
+    }
+  }
+  bool report(float tolerance) const {
+    bool ok = (_max_error <= tolerance);
+    nout << "  " << _name << ": " << _max_error
+         << (ok ? "" : "  ** too large **") << "\n";
+    return ok;
+  }
+
+private:
+  const char *_name;
+  float _max_error;
+};
+
+static bool
+measure_products(int num_samples) {
+  ErrorBound multiply("a * b, by definition");
+  ErrorBound xform("xform(v), by definition");
+  ErrorBound xform_point("xform_point(p), by definition");
+  ErrorBound xform_vec("xform_vec(d), by definition");
+  ErrorBound transpose("(a * b)^T = b^T * a^T");
+  ErrorBound transpose_multiply("transpose_multiply(a, b) = a^T * b");
+  ErrorBound multiply_transpose("multiply_transpose(a, b) = a * b^T");
+  ErrorBound invert("m * m^-1 = I");
+
+  for (int n = 0; n < num_samples; ++n) {
+    LMatrix4f a = random_mat();
+    LMatrix4f b = random_mat();
+    LVecBase4f v(random_float(), random_float(), random_float(), random_float());
+    LVecBase3f p(v[0], v[1], v[2]);
+
+    LMatrix4f c = a * b;
+    LVecBase4f xv = b.xform(v);
+    LVecBase3f xp = b.xform_point(p);
+    LVecBase3f xd = b.xform_vec(p);
+    for (int j = 0; j < 4; ++j) {
+      for (int i = 0; i < 4; ++i) {
+        multiply.add(c(i, j), a(i, 0) * b(0, j) + a(i, 1) * b(1, j) +
+                     a(i, 2) * b(2, j) + a(i, 3) * b(3, j));
+      }
+      xform.add(xv[j], v[0] * b(0, j) + v[1] * b(1, j) +
+                v[2] * b(2, j) + v[3] * b(3, j));
+      if (j < 3) {
+        xform_point.add(xp[j], p[0] * b(0, j) + p[1] * b(1, j) +
+                        p[2] * b(2, j) + b(3, j));
+        xform_vec.add(xd[j], p[0] * b(0, j) + p[1] * b(1, j) +
+                      p[2] * b(2, j));
+      }
+    }
+
+    LMatrix4f at, bt, ct;
+    at.transpose_from(a);
+    bt.transpose_from(b);
+    ct.transpose_from(c);
+    transpose.add(ct, bt * at);
+
+    LMatrix4f tm, mt;
+    tm.transpose_multiply(a, b);
+    mt.multiply_transpose(a, b);
+    transpose_multiply.add(tm, at * b);
+    multiply_transpose.add(mt, a * bt);
+
+    // A diagonally dominant matrix is comfortably invertible.
+    LMatrix4f d = a;
+    for (int i = 0; i < 4; ++i) {
+      d(i, i) += 2.0f;
+    }
+    LMatrix4f inv;
+    if (inv.invert_from(d)) {
+      invert.add(d * inv, LMatrix4f::ident_mat());
+    } else {
+      invert.add(1.0f, 0.0f);
+    }
+  }
+
+  nout << "Largest error over " << num_samples << " random matrices:\n";
+  bool ok = multiply.report(1.0e-5f);
+  ok = xform.report(1.0e-5f) && ok;
+  ok = xform_point.report(1.0e-5f) && ok;
+  ok = xform_vec.report(1.0e-5f) && ok;
+  ok = transpose.report(1.0e-5f) && ok;
+  ok = transpose_multiply.report(1.0e-5f) && ok;
+  ok = multiply_transpose.report(1.0e-5f) && ok;
+  ok = invert.report(1.0e-4f) && ok;
+  return ok;
+}
+
+// The array transforms must give the same results as transforming
+// each point on its own, including in place in an interleaved table.
+static bool
+measure_arrays() {
+  static const int num_points = 100;
+  LMatrix4f mat = random_mat();
+  LPoint3f points[num_points];
+  LVecBase4f vec4s[num_points];
+  for (int i = 0; i < num_points; ++i) {
+    points[i].set(random_float(), random_float(), random_float());
+    vec4s[i].set(random_float(), random_float(), random_float(), random_float());
+  }
+
+  LPoint3f xpoints[num_points];
+  LPoint3f xvecs[num_points];
+  LVecBase4f xvec4s[num_points];
+  mat.xform_points(points, xpoints, num_points);
+  mat.xform_vecs(points, xvecs, num_points);
+  mat.xform_vecbase4s(vec4s, xvec4s, num_points);
+
+  // Each point is followed by two floats that must not be touched.
+  static const int row_floats = 5;
+  float table[num_points * row_floats];
+  for (int i = 0; i < num_points; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      table[i * row_floats + j] = points[i][j];
+    }
+    table[i * row_floats + 3] = -1.0f;
+    table[i * row_floats + 4] = -1.0f;
+  }
+  size_t stride = sizeof(float) * row_floats;
+  mat.xform_points((unsigned char *)table, stride, (unsigned char *)table,
+                   stride, num_points);
+
+  ErrorBound xform_points("xform_points = xform_point each");
+  ErrorBound xform_vecs("xform_vecs = xform_vec each");
+  ErrorBound xform_vecbase4s("xform_vecbase4s = xform each");
+  ErrorBound strided("strided xform_points, in place");
+  ErrorBound padding("strided xform_points, padding untouched");
+  for (int i = 0; i < num_points; ++i) {
+    LVecBase3f p = mat.xform_point(points[i]);
+    LVecBase3f v = mat.xform_vec(points[i]);
+    LVecBase4f v4 = mat.xform(vec4s[i]);
+    for (int j = 0; j < 3; ++j) {
+      xform_points.add(xpoints[i][j], p[j]);
+      xform_vecs.add(xvecs[i][j], v[j]);
+      strided.add(table[i * row_floats + j], p[j]);
+    }
+    for (int j = 0; j < 4; ++j) {
+      xform_vecbase4s.add(xvec4s[i][j], v4[j]);
+    }
+    padding.add(table[i * row_floats + 3], -1.0f);
+    padding.add(table[i * row_floats + 4], -1.0f);
+  }
+
+  bool ok = xform_points.report(1.0e-6f);
+  ok = xform_vecs.report(1.0e-6f) && ok;
+  ok = xform_vecbase4s.report(1.0e-6f) && ok;
+  ok = strided.report(1.0e-6f) && ok;
+  ok = padding.report(0.0f) && ok;
+  return ok;
+}
+
+// Each timed operation feeds its result back into its input, so that
+// the compiler can't hoist it out of the loop.
+class MultiplyOp {
+public:
+  MultiplyOp(const LMatrix4f &a, const LMatrix4f &b) : _a(a), _b(b) {}
+  void operator () () { _c.multiply(_a, _b); _a(0, 0) = _c(3, 3); }
+  float result() const { return _a(0, 0); }
+  LMatrix4f _a, _b, _c;
+};
+
+class XformOp {
+public:
+  XformOp(const LMatrix4f &m) : _m(m), _v(1, 2, 3, 1) {}
+  void operator () () { _v = _m.xform(_v); }
+  float result() const { return _v[0]; }
+  LMatrix4f _m;
+  LVecBase4f _v;
+};
+
+class XformPointOp {
+public:
+  XformPointOp(const LMatrix4f &m) : _m(m), _p(1, 2, 3) {}
+  void operator () () { _p = _m.xform_point(_p); }
+  float result() const { return _p[0]; }
+  LMatrix4f _m;
+  LPoint3f _p;
+};
+
+class InvertOp {
+public:
+  InvertOp(const LMatrix4f &m, bool feed_back) : _m(m), _feed_back(feed_back) {}
+  void operator () () {
+    _inv.invert_from(_m);
+    if (_feed_back) {
+      _m(3, 0) = _inv(3, 0);
+    }
+    _sum += _inv(0, 0);
+  }
+  float result() const { return _sum; }
+  LMatrix4f _m, _inv;
+  bool _feed_back;
+  float _sum;
+};
+
+template<class Op>
+static void
+time_op(const char *name, Op op, int iterations) {
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  for (int i = 0; i < iterations; ++i) {
+    op();
+  }
+  double elapsed = clock->get_short_time() - start;
+  nout << "  " << name << ": " << elapsed * 1.0e9 / iterations
+       << " ns (" << op.result() << ")\n";
+}
+
+// Transforms a batch of points one at a time, and then all at once
+// with xform_points(), to show what the array entry point saves.
+static void
+time_point_arrays(const LMatrix4f &m, int iterations) {
+  static const int num_points = 1000;
+  LPoint3f *points = new LPoint3f[num_points];
+  for (int i = 0; i < num_points; ++i) {
+    points[i].set(random_float(), random_float(), random_float());
+  }
+  int num_batches = iterations / num_points + 1;
+  double count = (double)num_batches * num_points;
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  for (int n = 0; n < num_batches; ++n) {
+    for (int i = 0; i < num_points; ++i) {
+      points[i] = m.xform_point(points[i]);
+    }
+  }
+  double one_at_a_time = clock->get_short_time() - start;
+
+  start = clock->get_short_time();
+  for (int n = 0; n < num_batches; ++n) {
+    m.xform_points(points, points, num_points);
+  }
+  double all_at_once = clock->get_short_time() - start;
+
+  nout << "  xform_point per point: " << one_at_a_time * 1.0e9 / count
+       << " ns\n"
+       << "  xform_points per point: " << all_at_once * 1.0e9 / count
+       << " ns (" << points[0][0] << ")\n";
+  delete[] points;
+}
+
+int
+main(int argc, char *argv[]) {
+  int iterations = 1000000;
+  if (argc > 1) {
+    iterations = atoi(argv[1]);
+  }
+
+  bool ok = measure_products(1000);
+  ok = measure_arrays() && ok;
+  if (!ok) {
+    return 1;
+  }
+
+  LMatrix4f general = random_mat();
+  LMatrix4f affine = LMatrix4f::rotate_mat(30.0f, LVector3f(1, 2, 3)) *
+    LMatrix4f::translate_mat(1, 2, 3);
+
+  nout << "Time per operation over " << iterations << " iterations:\n";
+  time_op("multiply", MultiplyOp(general, affine), iterations);
+  time_op("xform", XformOp(affine), iterations);
+  time_op("xform_point", XformPointOp(affine), iterations);
+  time_point_arrays(affine, iterations);
+  time_op("invert (affine)", InvertOp(affine, true), iterations);
+  time_op("invert (general)", InvertOp(general, false), iterations);
+
+  return 0;
+}
@@ -108,10 +108,16 @@ xform(const LMatrix4 &mat) {
   if (!is_empty() && !is_infinite()) {
     // We need to transform the eight corners of the cube, and then
     // determine the new box.
-    LPoint3 x = get_point(0) * mat;
+    LPoint3 points[8];
+    for (int i = 0; i < 8; ++i) {
+      points[i] = get_point(i);
+    }
+    mat.xform_points(points, points, 8);
+
+    LPoint3 x = points[0];
     LPoint3 n = x;
     for (int i = 1; i < 8; ++i) {
-      LPoint3 p = get_point(i) * mat;
+      const LPoint3 &p = points[i];
       n.set(min(n[0], p[0]), min(n[1], p[1]), min(n[2], p[2]));
       x.set(max(x[0], p[0]), max(x[1], p[1]), max(x[2], p[2]));
     }
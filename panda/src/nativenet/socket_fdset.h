@@ -30,8 +30,11 @@ PUBLISHED:
     
     inline int WaitForRead(bool zeroFds, const Time_Span & timeout);
     inline void clear();
-private:
+public:
+    // Exposed so that descriptors that aren't wrapped in a Socket_IP
+    // (for instance, an epoll descriptor) can be added to the set.
     inline void setForSocketNative(const SOCKET inid);
+private:
     inline bool isSetForNative(const SOCKET inid) const;
     
     friend struct Socket_Selector;
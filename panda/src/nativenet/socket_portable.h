@@ -263,6 +263,8 @@ const int LOCAL_CONNECT_BLOCKING = EINPROGRESS;
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <sys/uio.h>
+#include <string.h>
 
 typedef struct sockaddr_in AddressType; 
 
@@ -285,6 +287,19 @@ inline int DO_SOCKET_WRITE(const SOCKET a, const char * buff, const int len)
 {
     return send(a, buff, len, 0);
 }
+// Gathers several buffers into a single send() call.  flags may
+// include MSG_DONTWAIT.
+inline int DO_SOCKET_WRITEV(const SOCKET a, const struct iovec * iov, const int iovcnt, int flags)
+{
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = const_cast<struct iovec *>(iov);
+    msg.msg_iovlen = iovcnt;
+#ifdef MSG_NOSIGNAL
+    flags |= MSG_NOSIGNAL;
+#endif
+    return sendmsg(a, &msg, flags);
+}
 ///////////////////////////////////////////////
 inline int DO_SOCKET_WRITE_TO(const SOCKET a, const char * buffer, const int buf_len, const sockaddr_in * addr)
 {
@@ -348,6 +363,8 @@ inline bool do_shutdown_send(SOCKET s)
 
 
 #define  BSDBLOCK
+// Defined when DO_SOCKET_WRITEV() is available.
+#define  BSDWRITEV
 
 
 const long LOCAL_NONBLOCK = 1;
@@ -34,6 +34,10 @@ PUBLISHED:
 public:
     inline int  SendData(const char * data, int size);
     inline int  RecvData(char * data, int size);
+#ifdef BSDWRITEV
+    inline int  SendDataV(const struct iovec * iov, int count);
+    inline int  SendDataVNonBlocking(const struct iovec * iov, int count);
+#endif
   
 public:
   static TypeHandle get_class_type() {
@@ -183,6 +187,38 @@ inline int Socket_TCP::SendData(const char * data, int size)
     return DO_SOCKET_WRITE(_socket, data, size);
 }
 
+#ifdef BSDWRITEV
+////////////////////////////////////////////////////////////////////
+// Function name : Socket_TCP::SendDataV
+// Description   : Sends the contents of several buffers, in order,
+//      with a single system call.
+//
+// Return type  : int
+//      - if error
+//      + bytes writen ( May be smaller than requested)
+////////////////////////////////////////////////////////////////////
+inline int Socket_TCP::SendDataV(const struct iovec * iov, int count)
+{
+    return DO_SOCKET_WRITEV(_socket, iov, count, 0);
+}
+
+////////////////////////////////////////////////////////////////////
+// Function name : Socket_TCP::SendDataVNonBlocking
+// Description   : As SendDataV, but sends only as much as the socket
+//      will take right now, without blocking, even if the socket itself
+//      is in blocking mode.  The socket's mode is left unchanged, so a
+//      reader thread may continue to block on it.
+//
+// Return type  : int
+//      - if error (LOCAL_BLOCKING_ERROR if nothing could be sent)
+//      + bytes writen ( May be smaller than requested)
+////////////////////////////////////////////////////////////////////
+inline int Socket_TCP::SendDataVNonBlocking(const struct iovec * iov, int count)
+{
+    return DO_SOCKET_WRITEV(_socket, iov, count, MSG_DONTWAIT);
+}
+#endif  // BSDWRITEV
+
 ////////////////////////////////////////////////////////////////////
 // Function name : Socket_TCP::RecvData
 // Description   : Read the data from the connection
@@ -17,7 +17,8 @@
      config_net.h connection.h connectionListener.h  \
      connectionManager.N connectionManager.h \
      connectionReader.I connectionReader.h  \
-     connectionWriter.h datagramQueue.h \
+     connectionWriter.h datagramBufferPool.I datagramBufferPool.h \
+     datagramQueue.h \
      datagramTCPHeader.I datagramTCPHeader.h  \
      datagramUDPHeader.I datagramUDPHeader.h  \
      netAddress.h netDatagram.I netDatagram.h  \
@@ -31,7 +32,8 @@
   #define INCLUDED_SOURCES \
      config_net.cxx connection.cxx connectionListener.cxx  \
      connectionManager.cxx connectionReader.cxx  \
-     connectionWriter.cxx datagramQueue.cxx datagramTCPHeader.cxx  \
+     connectionWriter.cxx datagramBufferPool.cxx datagramQueue.cxx \
+     datagramTCPHeader.cxx  \
      datagramUDPHeader.cxx netAddress.cxx netDatagram.cxx  \
      datagramGeneratorNet.cxx \
      datagramSinkNet.cxx \
@@ -42,7 +44,8 @@
   #define INSTALL_HEADERS \
     config_net.h connection.h connectionListener.h connectionManager.h \
     connectionReader.I connectionReader.h  \
-    connectionWriter.h datagramQueue.h \
+    connectionWriter.h datagramBufferPool.I datagramBufferPool.h \
+    datagramQueue.h \
     datagramTCPHeader.I datagramTCPHeader.h \
     datagramUDPHeader.I datagramUDPHeader.h \
     netAddress.h netDatagram.I \
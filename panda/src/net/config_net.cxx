@@ -138,6 +138,56 @@ ConfigVariableInt net_max_write_per_epoch
           "to minimize the impact of the networking layer on the other "
           "threads."));
 
+ConfigVariableBool net_use_epoll
+("net-use-epoll", true,
+ PRC_DESC("Set this true to have ConnectionReader and ConnectionListener "
+          "wait for activity with epoll() rather than select(), on "
+          "platforms that support it.  This removes the FD_SETSIZE limit "
+          "on the number of sockets that can be monitored, and makes the "
+          "cost of each poll independent of the number of connections."));
+
+ConfigVariableInt net_epoll_max_events
+("net-epoll-max-events", 256,
+ PRC_DESC("The maximum number of ready sockets a ConnectionReader will "
+          "collect from a single call to epoll_wait().  This only has "
+          "meaning when net-use-epoll is in effect."));
+
+ConfigVariableBool net_nonblocking_writes
+("net-nonblocking-writes", false,
+ PRC_DESC("Set this true to have newly-created ConnectionWriters never "
+          "block on a TCP socket whose send buffer is full.  Instead, the "
+          "unsent data is held on the Connection and retried later; see "
+          "ConnectionWriter::set_nonblocking_writes().  This is only "
+          "supported when Panda is built with HAVE_EPOLL."));
+
+ConfigVariableInt net_max_write_backlog
+("net-max-write-backlog", 1048576,
+ PRC_DESC("The maximum number of bytes that may be held waiting on a "
+          "single TCP connection when nonblocking writes are in effect.  "
+          "If a client falls further behind than this, the connection is "
+          "considered to be reset."));
+
+ConfigVariableInt net_receive_pool_size
+("net-receive-pool-size", 64,
+ PRC_DESC("The number of receive buffers each ConnectionReader keeps for "
+          "reuse.  Incoming datagrams are read directly into these "
+          "buffers, which are recycled once the application has released "
+          "every datagram that refers to them.  Set this to 0 to allocate "
+          "a new buffer for every datagram."));
+
+ConfigVariableInt net_receive_pool_max_buffer
+("net-receive-pool-max-buffer", 16384,
+ PRC_DESC("The largest datagram, in bytes, that a ConnectionReader will "
+          "read into a pooled buffer.  Larger datagrams get a buffer of "
+          "their own, which is freed when they are."));
+
+ConfigVariableInt net_max_datagram_size
+("net-max-datagram-size", 16777216,
+ PRC_DESC("The largest TCP datagram, in bytes, that a ConnectionReader will "
+          "accept.  The size comes from the datagram header, which is "
+          "supplied by the remote end; a connection that announces a "
+          "larger datagram than this is considered to be reset."));
+
 ConfigVariableEnum<ThreadPriority> net_thread_priority
 ("net-thread-priority", TP_low,
  PRC_DESC("The default thread priority when creating threaded readers "
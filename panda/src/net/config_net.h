@@ -37,6 +37,14 @@ extern string make_thread_name(const string &thread_name, int thread_index);
 extern ConfigVariableInt net_max_read_per_epoch;
 extern ConfigVariableInt net_max_write_per_epoch;
 
+extern ConfigVariableBool net_use_epoll;
+extern ConfigVariableInt net_epoll_max_events;
+extern ConfigVariableBool net_nonblocking_writes;
+extern ConfigVariableInt net_max_write_backlog;
+extern ConfigVariableInt net_receive_pool_size;
+extern ConfigVariableInt net_receive_pool_max_buffer;
+extern ConfigVariableInt net_max_datagram_size;
+
 extern ConfigVariableEnum<ThreadPriority> net_thread_priority;
 
 extern EXPCL_PANDA_NET void init_libnet();
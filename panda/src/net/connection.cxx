@@ -43,8 +43,13 @@ Connection(ConnectionManager *manager, Socket_IP *socket) :
 {
   _collect_tcp = collect_tcp;
   _collect_tcp_interval = collect_tcp_interval;
+  _collect_tcp_max_bytes = collect_tcp_max_bytes;
   _queued_data_start = 0.0;
-  _queued_count = 0;
+  _queued_offset = 0;
+  _queued_bytes = 0;
+  _write_blocked = false;
+  _num_tcp_datagrams_sent = 0;
+  _num_tcp_send_calls = 0;
 
 #if defined(HAVE_THREADS) && defined(SIMPLE_THREADS)
   // In the presence of SIMPLE_THREADS, we use non-blocking I/O.  We
@@ -173,6 +178,56 @@ get_collect_tcp_interval() const {
   return _collect_tcp_interval;
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: Connection::set_collect_tcp_max_bytes
+//       Access: Published
+//  Description: Specifies the maximum number of bytes that will be
+//               held in "collect-tcp" mode before they are sent,
+//               regardless of the collect-tcp interval.  This only has
+//               meaning if "collect-tcp" mode is enabled; see
+//               set_collect_tcp().
+////////////////////////////////////////////////////////////////////
+void Connection::
+set_collect_tcp_max_bytes(int max_bytes) {
+  _collect_tcp_max_bytes = (size_t)max(max_bytes, 0);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: Connection::get_collect_tcp_max_bytes
+//       Access: Published
+//  Description: Returns the maximum number of bytes that will be held
+//               in "collect-tcp" mode before they are sent.  See
+//               set_collect_tcp_max_bytes().
+////////////////////////////////////////////////////////////////////
+int Connection::
+get_collect_tcp_max_bytes() const {
+  return (int)_collect_tcp_max_bytes;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: Connection::get_num_tcp_datagrams_sent
+//       Access: Published
+//  Description: Returns the total number of TCP datagrams that have
+//               been written to this connection.  Compare this to
+//               get_num_tcp_send_calls() to see how many system calls
+//               were saved by collecting datagrams together.
+////////////////////////////////////////////////////////////////////
+PN_uint64 Connection::
+get_num_tcp_datagrams_sent() const {
+  return _num_tcp_datagrams_sent;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: Connection::get_num_tcp_send_calls
+//       Access: Published
+//  Description: Returns the total number of socket write calls that
+//               have been made to send TCP data on this connection.
+////////////////////////////////////////////////////////////////////
+PN_uint64 Connection::
+get_num_tcp_send_calls() const {
+  return _num_tcp_send_calls;
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: Connection::consider_flush
 //       Access: Published
@@ -354,9 +409,15 @@ set_max_segment(int size) {
 //               datagram to the socket, returning true on success,
 //               false on failure.  If the socket seems to be closed,
 //               it notifies the ConnectionManager.
+//
+//               If nonblocking is true, a TCP datagram that cannot be
+//               written immediately is held on the connection's
+//               backlog rather than blocking the caller; see
+//               flush_backlog().
 ////////////////////////////////////////////////////////////////////
 bool Connection::
-send_datagram(const NetDatagram &datagram, int tcp_header_size) {
+send_datagram(const NetDatagram &datagram, int tcp_header_size,
+              bool nonblocking) {
   nassertr(_socket != (Socket_IP *)NULL, false);
 
   if (_socket->is_exact_type(Socket_UDP::get_class_type())) {
@@ -407,17 +468,14 @@ send_datagram(const NetDatagram &datagram, int tcp_header_size) {
   DatagramTCPHeader header(datagram, tcp_header_size);
 
   LightReMutexHolder holder(_write_mutex);
-  _queued_data += header.get_header();
-  _queued_data += datagram.get_message();
-  _queued_count++;
+  queue_tcp_datagram(datagram, header.get_header());
   
   if (net_cat.is_debug()) {
     header.verify_datagram(datagram, tcp_header_size);
   }
 
-  if (!_collect_tcp || 
-      TrueClock::get_global_ptr()->get_short_time() - _queued_data_start >= _collect_tcp_interval) {
-    return do_flush();
+  if (should_flush()) {
+    return do_flush(nonblocking);
   }
 
   return true;
@@ -429,9 +487,10 @@ send_datagram(const NetDatagram &datagram, int tcp_header_size) {
 //  Description: This method is intended only to be called by
 //               ConnectionWriter.  It atomically writes the given
 //               datagram to the socket, without the Datagram header.
+//               See send_datagram() for the meaning of nonblocking.
 ////////////////////////////////////////////////////////////////////
 bool Connection::
-send_raw_datagram(const NetDatagram &datagram) {
+send_raw_datagram(const NetDatagram &datagram, bool nonblocking) {
   nassertr(_socket != (Socket_IP *)NULL, false);
 
   if (_socket->is_exact_type(Socket_UDP::get_class_type())) {
@@ -463,45 +522,182 @@ send_raw_datagram(const NetDatagram &datagram) {
 
   // We might queue up TCP packets for later sending.
   LightReMutexHolder holder(_write_mutex);
-  _queued_data += datagram.get_message();
-  _queued_count++;
+  queue_tcp_datagram(datagram, string());
 
-  if (!_collect_tcp || 
-      TrueClock::get_global_ptr()->get_short_time() - _queued_data_start >= _collect_tcp_interval) {
-    return do_flush();
+  if (should_flush()) {
+    return do_flush(nonblocking);
   }
 
   return true;
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: Connection::flush_backlog
+//       Access: Private
+//  Description: Attempts to send, without blocking, whatever data was
+//               left over from a previous nonblocking write.  Returns
+//               true if the backlog is now empty, false if the socket
+//               is still not ready to accept it all (or the connection
+//               has failed).
+////////////////////////////////////////////////////////////////////
+bool Connection::
+flush_backlog() {
+  LightReMutexHolder holder(_write_mutex);
+  if (!_write_blocked) {
+    return true;
+  }
+  if (!do_flush(true)) {
+    return false;
+  }
+  return !_write_blocked;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: Connection::is_write_blocked
+//       Access: Private
+//  Description: Returns true if a previous nonblocking write left
+//               some data unsent on this connection.
+////////////////////////////////////////////////////////////////////
+bool Connection::
+is_write_blocked() {
+  LightReMutexHolder holder(_write_mutex);
+  return _write_blocked;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: Connection::queue_tcp_datagram
+//       Access: Private
+//  Description: Adds the datagram, preceded by the indicated header
+//               bytes, to the end of the outgoing TCP queue.  The
+//               datagram's buffer is shared, not copied.  Assumes the
+//               _write_mutex is already held.
+////////////////////////////////////////////////////////////////////
+void Connection::
+queue_tcp_datagram(const Datagram &datagram, const string &header) {
+  nassertv(header.size() <= sizeof(QueuedDatagram::_header));
+
+  _queued_datagrams.push_back(QueuedDatagram());
+  QueuedDatagram &qd = _queued_datagrams.back();
+  memcpy(qd._header, header.data(), header.size());
+  qd._header_size = header.size();
+  qd._datagram = datagram;
+
+  _queued_bytes += header.size() + datagram.get_length();
+  ++_num_tcp_datagrams_sent;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: Connection::should_flush
+//       Access: Private
+//  Description: Returns true if the queued TCP data should be sent
+//               now, according to the collect-tcp policy: either
+//               collection is disabled, or the interval has elapsed,
+//               or too many bytes have accumulated.  Assumes the
+//               _write_mutex is already held.
+////////////////////////////////////////////////////////////////////
+bool Connection::
+should_flush() const {
+  if (_write_blocked || !_collect_tcp) {
+    return true;
+  }
+  if (_queued_bytes >= _collect_tcp_max_bytes) {
+    return true;
+  }
+  double elapsed =
+    TrueClock::get_global_ptr()->get_short_time() - _queued_data_start;
+  return (elapsed < 0.0 || elapsed >= _collect_tcp_interval);
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: Connection::do_flush
 //       Access: Private
 //  Description: The private implementation of flush(), this assumes
 //               the _write_mutex is already held.
+//
+//               If nonblocking is true, only as much data as the
+//               socket will accept right now is sent; the remainder
+//               stays at the front of the queue, and _write_blocked
+//               is set.
 ////////////////////////////////////////////////////////////////////
 bool Connection::
-do_flush() {
-  if (_queued_data.empty()) {
-    _queued_count = 0;
-    _queued_data_start = TrueClock::get_global_ptr()->get_short_time();
+do_flush(bool nonblocking) {
+  _queued_data_start = TrueClock::get_global_ptr()->get_short_time();
+  _write_blocked = false;
+
+  if (_queued_datagrams.empty()) {
     return true;
   }
 
   if (net_cat.is_spam()) {
     net_cat.spam()
-      << "Sending " << _queued_count << " TCP datagram(s) with " 
-      << _queued_data.length() << " total bytes to " << (void *)this << "\n";
+      << "Sending " << _queued_datagrams.size() << " TCP datagram(s) with " 
+      << _queued_bytes << " total bytes to " << (void *)this << "\n";
   }
 
   Socket_TCP *tcp;
   DCAST_INTO_R(tcp, _socket, false);
 
-  string sending_data;
-  _queued_data.swap(sending_data);
+#if defined(BSDWRITEV) && !(defined(HAVE_THREADS) && defined(SIMPLE_THREADS))
+  // Hand the kernel all of the queued headers and datagram buffers
+  // at once, so that many datagrams cost only one system call and no
+  // copying.
+  static const int max_iov = 256;
+  struct iovec iov[max_iov];
+
+  while (!_queued_datagrams.empty()) {
+    int iov_count = fill_iovecs(iov, max_iov);
+    int data_sent;
+#ifdef HAVE_EPOLL
+    if (nonblocking) {
+      data_sent = tcp->SendDataVNonBlocking(iov, iov_count);
+    } else
+#endif  // HAVE_EPOLL
+      {
+        data_sent = tcp->SendDataV(iov, iov_count);
+      }
+    ++_num_tcp_send_calls;
 
-  _queued_count = 0;
-  _queued_data_start = TrueClock::get_global_ptr()->get_short_time();
+    if (data_sent < 0 && tcp->GetLastError() == EINTR) {
+      continue;
+    }
+
+#ifdef HAVE_EPOLL
+    if (nonblocking && data_sent < 0 &&
+        tcp->GetLastError() == LOCAL_BLOCKING_ERROR) {
+      // The socket couldn't take any more.  Leave the rest on the
+      // queue; it will go out ahead of anything queued after it.
+      _write_blocked = true;
+
+      if ((int)_queued_bytes > net_max_write_backlog) {
+        net_cat.warning()
+          << "Write backlog of " << _queued_bytes << " bytes on "
+          << (void *)this << " exceeds net-max-write-backlog.\n";
+        _queued_datagrams.clear();
+        _queued_offset = 0;
+        _queued_bytes = 0;
+        _write_blocked = false;
+        return check_send_error(false);
+      }
+      return true;
+    }
+#endif  // HAVE_EPOLL
+
+    if (data_sent <= 0) {
+      _queued_datagrams.clear();
+      _queued_offset = 0;
+      _queued_bytes = 0;
+      return check_send_error(false);
+    }
+
+    consume_queued_data(data_sent);
+  }
+
+  return true;
+
+#else  // BSDWRITEV
+  string sending_data;
+  gather_queued_data(sending_data);
+  ++_num_tcp_send_calls;
 
 #if defined(HAVE_THREADS) && defined(SIMPLE_THREADS)
   int max_send = net_max_write_per_epoch;
@@ -535,6 +731,109 @@ do_flush() {
 #endif  // SIMPLE_THREADS
 
   return check_send_error(okflag);
+#endif  // BSDWRITEV
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: Connection::gather_queued_data
+//       Access: Private
+//  Description: Concatenates all of the unsent queued TCP data into a
+//               single string, for platforms that can't send it with
+//               a vectored write, and empties the queue.  Assumes the
+//               _write_mutex is already held.
+////////////////////////////////////////////////////////////////////
+void Connection::
+gather_queued_data(string &data) {
+  data.reserve(_queued_bytes);
+
+  size_t skip = _queued_offset;
+  QueuedDatagrams::const_iterator qi;
+  for (qi = _queued_datagrams.begin(); qi != _queued_datagrams.end(); ++qi) {
+    const QueuedDatagram &qd = (*qi);
+    if (skip < qd._header_size) {
+      data.append((const char *)qd._header + skip, qd._header_size - skip);
+      skip = 0;
+    } else {
+      skip -= qd._header_size;
+    }
+    size_t length = qd._datagram.get_length();
+    if (skip < length) {
+      data.append((const char *)qd._datagram.get_data() + skip, length - skip);
+    }
+    skip = 0;
+  }
+
+  _queued_datagrams.clear();
+  _queued_offset = 0;
+  _queued_bytes = 0;
+}
+
+#ifdef BSDWRITEV
+////////////////////////////////////////////////////////////////////
+//     Function: Connection::fill_iovecs
+//       Access: Private
+//  Description: Fills up to max_iov entries of the indicated array
+//               with pointers to the unsent queued TCP data, in
+//               order.  Returns the number of entries filled.
+//               Assumes the _write_mutex is already held.
+////////////////////////////////////////////////////////////////////
+int Connection::
+fill_iovecs(struct iovec *iov, int max_iov) const {
+  int count = 0;
+  size_t skip = _queued_offset;
+
+  QueuedDatagrams::const_iterator qi;
+  for (qi = _queued_datagrams.begin();
+       qi != _queued_datagrams.end() && count + 2 <= max_iov;
+       ++qi) {
+    const QueuedDatagram &qd = (*qi);
+    if (skip < qd._header_size) {
+      iov[count].iov_base = (void *)(qd._header + skip);
+      iov[count].iov_len = qd._header_size - skip;
+      ++count;
+      skip = 0;
+    } else {
+      skip -= qd._header_size;
+    }
+    size_t length = qd._datagram.get_length();
+    if (skip < length) {
+      iov[count].iov_base = (void *)((const char *)qd._datagram.get_data() + skip);
+      iov[count].iov_len = length - skip;
+      ++count;
+    }
+    skip = 0;
+  }
+
+  return count;
+}
+#endif  // BSDWRITEV
+
+////////////////////////////////////////////////////////////////////
+//     Function: Connection::consume_queued_data
+//       Access: Private
+//  Description: Removes the indicated number of bytes, which have
+//               just been written to the socket, from the front of
+//               the outgoing TCP queue.  Assumes the _write_mutex is
+//               already held.
+////////////////////////////////////////////////////////////////////
+void Connection::
+consume_queued_data(size_t num_bytes) {
+  nassertv(num_bytes <= _queued_bytes);
+  _queued_bytes -= num_bytes;
+
+  num_bytes += _queued_offset;
+  _queued_offset = 0;
+  while (!_queued_datagrams.empty()) {
+    const QueuedDatagram &qd = _queued_datagrams.front();
+    size_t entry_size = qd._header_size + qd._datagram.get_length();
+    if (num_bytes < entry_size) {
+      // This entry has only been partially written.
+      _queued_offset = num_bytes;
+      break;
+    }
+    num_bytes -= entry_size;
+    _queued_datagrams.pop_front();
+  }
 }
 
 ////////////////////////////////////////////////////////////////////
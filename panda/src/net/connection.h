@@ -19,6 +19,9 @@
 #include "referenceCount.h"
 #include "netAddress.h"
 #include "lightReMutex.h"
+#include "datagram.h"
+#include "pdeque.h"
+#include "numeric_types.h"
 
 class Socket_IP;
 class ConnectionManager;
@@ -43,6 +46,11 @@ PUBLISHED:
   bool get_collect_tcp() const;
   void set_collect_tcp_interval(double interval);
   double get_collect_tcp_interval() const;
+  void set_collect_tcp_max_bytes(int max_bytes);
+  int get_collect_tcp_max_bytes() const;
+
+  PN_uint64 get_num_tcp_datagrams_sent() const;
+  PN_uint64 get_num_tcp_send_calls() const;
 
   BLOCKING bool consider_flush();
   BLOCKING bool flush();
@@ -60,9 +68,20 @@ PUBLISHED:
   void set_max_segment(int size);
 
 private:
-  bool send_datagram(const NetDatagram &datagram, int tcp_header_size);
-  bool send_raw_datagram(const NetDatagram &datagram);
-  bool do_flush();
+  bool send_datagram(const NetDatagram &datagram, int tcp_header_size,
+                     bool nonblocking = false);
+  bool send_raw_datagram(const NetDatagram &datagram,
+                         bool nonblocking = false);
+  bool flush_backlog();
+  bool is_write_blocked();
+  void queue_tcp_datagram(const Datagram &datagram, const string &header);
+  bool should_flush() const;
+  bool do_flush(bool nonblocking = false);
+  void gather_queued_data(string &data);
+#ifdef BSDWRITEV
+  int fill_iovecs(struct iovec *iov, int max_iov) const;
+#endif
+  void consume_queued_data(size_t num_bytes);
   bool check_send_error(bool okflag);
 
   ConnectionManager *_manager;
@@ -71,9 +90,31 @@ private:
 
   bool _collect_tcp;
   double _collect_tcp_interval;
+  size_t _collect_tcp_max_bytes;
   double _queued_data_start;
-  string _queued_data;
-  int _queued_count;
+
+  // Outgoing TCP datagrams are queued here, each one still sharing
+  // the buffer of the Datagram it was sent from, and gathered into a
+  // single vectored write when it is time to flush.
+  // _queued_offset is the number of bytes at the front of the first
+  // entry that have already been written.
+  class QueuedDatagram {
+  public:
+    unsigned char _header[4];
+    size_t _header_size;
+    Datagram _datagram;
+  };
+  typedef pdeque<QueuedDatagram> QueuedDatagrams;
+  QueuedDatagrams _queued_datagrams;
+  size_t _queued_offset;
+  size_t _queued_bytes;
+
+  // True if a nonblocking write found the socket's send buffer full,
+  // and some of _queued_datagrams is still waiting to be sent.
+  bool _write_blocked;
+
+  PN_uint64 _num_tcp_datagrams_sent;
+  PN_uint64 _num_tcp_send_calls;
 
   friend class ConnectionWriter;
 };
@@ -27,6 +27,11 @@
 #include "atomicAdjust.h"
 #include "config_downloader.h"
 
+#ifdef HAVE_EPOLL
+#include <sys/epoll.h>
+#include <poll.h>
+#endif
+
 static const int read_buffer_size = maximum_udp_datagram + datagram_udp_header_size;
 
 ////////////////////////////////////////////////////////////////////
@@ -40,6 +45,9 @@ SocketInfo(const PT(Connection) &connection) :
 {
   _busy = false;
   _error = false;
+#ifdef HAVE_EPOLL
+  _epoll_registered = false;
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -99,7 +107,8 @@ thread_main() {
 ConnectionReader::
 ConnectionReader(ConnectionManager *manager, int num_threads,
                  const string &thread_name) :
-  _manager(manager)
+  _manager(manager),
+  _receive_pool(net_receive_pool_size, net_receive_pool_max_buffer)
 {
   if (!Thread::is_threading_supported()) {
 #ifndef NDEBUG
@@ -124,6 +133,23 @@ ConnectionReader(ConnectionManager *manager, int num_threads,
 
   _currently_polling_thread = -1;
 
+#ifdef HAVE_EPOLL
+  _epoll_fd = -1;
+  _epoll_events = (struct epoll_event *)NULL;
+  _max_epoll_events = 0;
+  if (net_use_epoll) {
+    _epoll_fd = epoll_create(64);
+    if (_epoll_fd < 0) {
+      net_cat.warning()
+        << "Unable to create epoll descriptor; falling back to select().\n";
+    } else {
+      _max_epoll_events = max((int)net_epoll_max_events, 1);
+      _epoll_events = (struct epoll_event *)
+        PANDA_MALLOC_ARRAY(_max_epoll_events * sizeof(struct epoll_event));
+    }
+  }
+#endif  // HAVE_EPOLL
+
   string reader_thread_name = thread_name;
   if (thread_name.empty()) {
     reader_thread_name = "ReaderThread";
@@ -171,6 +197,15 @@ ConnectionReader::
       sinfo->_connection.clear();
     }
   }
+
+#ifdef HAVE_EPOLL
+  if (_epoll_fd >= 0) {
+    close(_epoll_fd);
+    _epoll_fd = -1;
+    PANDA_FREE_ARRAY(_epoll_events);
+    _epoll_events = (struct epoll_event *)NULL;
+  }
+#endif  // HAVE_EPOLL
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -205,7 +240,14 @@ add_connection(Connection *connection) {
     }
   }
 
-  _sockets.push_back(new SocketInfo(connection));
+  SocketInfo *sinfo = new SocketInfo(connection);
+  _sockets.push_back(sinfo);
+
+#ifdef HAVE_EPOLL
+  if (_epoll_fd >= 0) {
+    epoll_register(sinfo);
+  }
+#endif
 
   return true;
 }
@@ -235,6 +277,12 @@ remove_connection(Connection *connection) {
     return false;
   }
 
+#ifdef HAVE_EPOLL
+  if (_epoll_fd >= 0) {
+    epoll_unregister(*si);
+  }
+#endif
+
   _removed_sockets.push_back(*si);
   _sockets.erase(si);
 
@@ -441,6 +489,25 @@ flush_read_connection(Connection *connection) {
   // right here in this thread, since we've already removed this
   // connection from the reader.
 
+#ifdef HAVE_EPOLL
+  if (_epoll_fd >= 0) {
+    // The socket descriptor may be too large to put in an fdset, so
+    // use poll() to check this one socket.
+    struct pollfd pfd;
+    pfd.fd = sinfo.get_socket()->GetSocket();
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    while (::poll(&pfd, 1, 0) > 0) {
+      sinfo._busy = true;
+      if (!process_incoming_data(&sinfo)) {
+        break;
+      }
+      pfd.revents = 0;
+    }
+    return;
+  }
+#endif  // HAVE_EPOLL
+
   Socket_fdset fdset;
   fdset.clear();
   fdset.setForSocket(*(sinfo.get_socket()));
@@ -480,6 +547,20 @@ void ConnectionReader::
 finish_socket(SocketInfo *sinfo) {
   nassertv(sinfo->_busy);
 
+#ifdef HAVE_EPOLL
+  if (_epoll_fd >= 0) {
+    // The socket was disarmed by EPOLLONESHOT when it was reported;
+    // arm it again so we hear about the next datagram.  Both steps
+    // are made while holding _sockets_mutex: once the socket is
+    // nonbusy, rebuild_select_list() may delete it, and it must not
+    // do so until we are done with it here.
+    LightMutexHolder holder(_sockets_mutex);
+    sinfo->_busy = false;
+    epoll_rearm(sinfo);
+    return;
+  }
+#endif
+
   // By marking the SocketInfo nonbusy, we make it available for
   // future polls.
   sinfo->_busy = false;
@@ -522,8 +603,10 @@ process_incoming_udp_data(SocketInfo *sinfo) {
   DCAST_INTO_R(socket, sinfo->get_socket(), false);
   Socket_Address addr;
 
-  // Read as many bytes as we can.
-  char buffer[read_buffer_size];
+  // Read as many bytes as we can, directly into the buffer that will
+  // become the datagram's storage.
+  PTA_uchar data = _receive_pool.get_buffer(read_buffer_size);
+  char *buffer = (char *)data.p();
   int bytes_read = read_buffer_size;
 
   bool okflag = socket->GetPacket(buffer, &bytes_read, addr);
@@ -554,10 +637,15 @@ process_incoming_udp_data(SocketInfo *sinfo) {
   
   DatagramUDPHeader header(buffer);
   
-  char *dp = buffer + datagram_udp_header_size;
+  // The datagram's data follows the header in the same packet.  Slide
+  // it down over the header, in place; there is no portable way to
+  // have GetPacket() put the header somewhere else.
   bytes_read -= datagram_udp_header_size;
-  
-  NetDatagram datagram(dp, bytes_read);
+  memmove(buffer, buffer + datagram_udp_header_size, bytes_read);
+  data.resize(bytes_read);
+
+  NetDatagram datagram;
+  datagram.set_array(data);
   
   // Now that we've read all the data, it's time to finish the socket
   // so another thread can read the next datagram.
@@ -644,35 +732,63 @@ process_incoming_tcp_data(SocketInfo *sinfo) {
   DatagramTCPHeader header(buffer, _tcp_header_size);
   int size = header.get_datagram_size(_tcp_header_size);
 
-  // We have to loop until the entire datagram is read.
-  NetDatagram datagram;
+  // The size comes from the other end of the connection, so don't
+  // trust it.  A 32-bit header may also announce more than 2GB,
+  // which shows up here as a negative number.  Either way we can't
+  // find the next datagram boundary, so the connection is finished.
+  if (size < 0 || size > net_max_datagram_size) {
+    net_cat.error()
+      << "TCP datagram header reports " << (unsigned int)size
+      << " bytes, more than net-max-datagram-size; resetting connection.\n";
+    if (_manager != (ConnectionManager *)NULL) {
+      _manager->connection_reset(sinfo->_connection, 0);
+    }
+    finish_socket(sinfo);
+    return false;
+  }
+
+  // We have to loop until the entire datagram is read.  We read it
+  // directly into the buffer that will become the datagram's
+  // storage, so it is never copied again.  A datagram too big for
+  // the pool is not allocated up front, though; its buffer grows
+  // only as the data actually arrives.
+  size_t max_chunk = _receive_pool.get_max_buffer_size();
+  bool incremental = ((size_t)size > max_chunk);
+  max_chunk = max(max_chunk, (size_t)read_buffer_size);
+
+  PTA_uchar data;
+  if (incremental) {
+    data = PTA_uchar::empty_array(0);
+  } else {
+    data = _receive_pool.get_buffer(size);
+  }
+  int bytes_so_far = 0;
 
-  while (!_shutdown && (int)datagram.get_length() < size) {
+  while (!_shutdown && bytes_so_far < size) {
     int bytes_read;
 
-    int read_bytes = read_buffer_size;
+    int read_bytes = size - bytes_so_far;
 #ifdef SIMPLE_THREADS
     // In the SIMPLE_THREADS case, we want to limit the number of
     // bytes we read in a single epoch, to minimize the impact on the
     // other threads.
-    read_bytes = min(read_buffer_size, (int)net_max_read_per_epoch);
+    read_bytes = min(read_bytes, (int)net_max_read_per_epoch);
 #endif
+    if (incremental) {
+      read_bytes = min(read_bytes, (int)max_chunk);
+      data.resize(bytes_so_far + read_bytes);
+    }
 
-    bytes_read =
-      socket->RecvData(buffer, min(read_bytes,
-                                   (int)(size - datagram.get_length())));
+    char *dp = (char *)data.p() + bytes_so_far;
+    bytes_read = socket->RecvData(dp, read_bytes);
 #if defined(HAVE_THREADS) && defined(SIMPLE_THREADS)
     while (bytes_read < 0 && socket->GetLastError() == LOCAL_BLOCKING_ERROR &&
            socket->Active()) {
       Thread::force_yield();
-      bytes_read =
-        socket->RecvData(buffer, min(read_bytes,
-                                     (int)(size - datagram.get_length())));
+      bytes_read = socket->RecvData(dp, read_bytes);
     }
 #endif  // SIMPLE_THREADS
 
-    char *dp = buffer;
-
     if (bytes_read <= 0) {
       // The socket was closed.  Report that and return.
       if (_manager != (ConnectionManager *)NULL) {
@@ -682,17 +798,7 @@ process_incoming_tcp_data(SocketInfo *sinfo) {
       return false;
     }
 
-    int datagram_bytes =
-      min(bytes_read, (int)(size - datagram.get_length()));
-    datagram.append_data(dp, datagram_bytes);
-
-    if (bytes_read > datagram_bytes) {
-      // There were some extra bytes at the end of the datagram.  Maybe
-      // the beginning of the next datagram?  Huh.
-      net_cat.error()
-        << "Discarding " << bytes_read - datagram_bytes
-        << " bytes following TCP datagram.\n";
-    }
+    bytes_so_far += bytes_read;
     Thread::consider_yield();
   }
 
@@ -704,6 +810,9 @@ process_incoming_tcp_data(SocketInfo *sinfo) {
     return false;
   }
 
+  NetDatagram datagram;
+  datagram.set_array(data);
+
   // And now do whatever we need to do to process the datagram.
   if (!header.verify_datagram(datagram, _tcp_header_size)) {
     net_cat.error()
@@ -737,11 +846,12 @@ process_raw_incoming_udp_data(SocketInfo *sinfo) {
   DCAST_INTO_R(socket, sinfo->get_socket(), false);
   Socket_Address addr;
 
-  // Read as many bytes as we can.
-  char buffer[read_buffer_size];
+  // Read as many bytes as we can, directly into the datagram's
+  // buffer.
+  PTA_uchar data = _receive_pool.get_buffer(read_buffer_size);
   int bytes_read = read_buffer_size;
 
-  bool okflag = socket->GetPacket(buffer, &bytes_read, addr);
+  bool okflag = socket->GetPacket((char *)data.p(), &bytes_read, addr);
 
   if (!okflag) {
     finish_socket(sinfo);
@@ -759,7 +869,9 @@ process_raw_incoming_udp_data(SocketInfo *sinfo) {
 
   // In raw mode, we simply extract all the bytes and make that a
   // datagram.
-  NetDatagram datagram(buffer, bytes_read);
+  data.resize(bytes_read);
+  NetDatagram datagram;
+  datagram.set_array(data);
   
   // Now that we've read all the data, it's time to finish the socket
   // so another thread can read the next datagram.
@@ -794,8 +906,10 @@ process_raw_incoming_tcp_data(SocketInfo *sinfo) {
   Socket_TCP *socket;
   DCAST_INTO_R(socket, sinfo->get_socket(), false);
 
-  // Read as many bytes as we can.
-  char buffer[read_buffer_size];
+  // Read as many bytes as we can, directly into the datagram's
+  // buffer.
+  PTA_uchar data = _receive_pool.get_buffer(read_buffer_size);
+  char *buffer = (char *)data.p();
   int bytes_read = socket->RecvData(buffer, read_buffer_size);
 #if defined(HAVE_THREADS) && defined(SIMPLE_THREADS)
   while (bytes_read < 0 && socket->GetLastError() == LOCAL_BLOCKING_ERROR && 
@@ -816,7 +930,9 @@ process_raw_incoming_tcp_data(SocketInfo *sinfo) {
 
   // In raw mode, we simply extract all the bytes and make that a
   // datagram.
-  NetDatagram datagram(buffer, bytes_read);
+  data.resize(bytes_read);
+  NetDatagram datagram;
+  datagram.set_array(data);
   
   // Now that we've read all the data, it's time to finish the socket
   // so another thread can read the next datagram.
@@ -886,6 +1002,20 @@ get_next_available_socket(bool allow_block, int current_thread_index) {
     // First, check the result from the previous select call.  If
     // there are any sockets remaining there, process them first.
     while (!_shutdown && _num_results > 0) {
+#ifdef HAVE_EPOLL
+      if (_epoll_fd >= 0) {
+        // Every result returned by epoll_wait() represents a socket
+        // with noise on it; no need to scan for it.
+        nassertr(_next_index < _max_epoll_events, NULL);
+        SocketInfo *sinfo =
+          (SocketInfo *)_epoll_events[_next_index].data.ptr;
+        _next_index++;
+        _num_results--;
+
+        sinfo->_busy = true;
+        return sinfo;
+      }
+#endif  // HAVE_EPOLL
       nassertr(_next_index < (int)_selecting_sockets.size(), NULL);
       int i = _next_index;
       _next_index++;
@@ -930,7 +1060,19 @@ get_next_available_socket(bool allow_block, int current_thread_index) {
         timeout = 0;
 #endif
 
-        _num_results = _fdset.WaitForRead(false, timeout);
+#ifdef HAVE_EPOLL
+        if (_epoll_fd >= 0) {
+          _num_results = epoll_wait(_epoll_fd, _epoll_events,
+                                    _max_epoll_events, (int)timeout);
+          if (_num_results < 0 && errno == EINTR) {
+            // A signal is not an error; just treat it as a timeout.
+            _num_results = 0;
+          }
+        } else
+#endif  // HAVE_EPOLL
+          {
+            _num_results = _fdset.WaitForRead(false, timeout);
+          }
       }
 
       if (_num_results == 0 && allow_block) {
@@ -972,13 +1114,21 @@ rebuild_select_list() {
 
   LightMutexHolder holder(_sockets_mutex);
   Sockets::const_iterator si;
-  for (si = _sockets.begin(); si != _sockets.end(); ++si) {
-    SocketInfo *sinfo = (*si);
-    if (!sinfo->_busy && !sinfo->_error) {
-      _fdset.setForSocket(*sinfo->get_socket());
-      _selecting_sockets.push_back(sinfo);
+
+#ifdef HAVE_EPOLL
+  // With epoll, the kernel maintains the set of sockets for us, so
+  // there is no need to walk the entire list each time.
+  if (_epoll_fd < 0)
+#endif
+    {
+      for (si = _sockets.begin(); si != _sockets.end(); ++si) {
+        SocketInfo *sinfo = (*si);
+        if (!sinfo->_busy && !sinfo->_error) {
+          _fdset.setForSocket(*sinfo->get_socket());
+          _selecting_sockets.push_back(sinfo);
+        }
+      }
     }
-  }
 
   // This is also a fine time to delete the contents of the
   // _removed_sockets list.
@@ -1006,6 +1156,15 @@ rebuild_select_list() {
 ////////////////////////////////////////////////////////////////////
 void ConnectionReader::
 accumulate_fdset(Socket_fdset &fdset) {
+#ifdef HAVE_EPOLL
+  if (_epoll_fd >= 0) {
+    // The epoll descriptor itself becomes readable when any of its
+    // armed sockets has noise on it.
+    fdset.setForSocketNative(_epoll_fd);
+    return;
+  }
+#endif  // HAVE_EPOLL
+
   LightMutexHolder holder(_sockets_mutex);
   Sockets::const_iterator si;
   for (si = _sockets.begin(); si != _sockets.end(); ++si) {
@@ -1015,3 +1174,75 @@ accumulate_fdset(Socket_fdset &fdset) {
     }
   }
 }
+
+#ifdef HAVE_EPOLL
+////////////////////////////////////////////////////////////////////
+//     Function: ConnectionReader::epoll_register
+//       Access: Private
+//  Description: Adds the indicated socket to the epoll set.  Assumes
+//               _sockets_mutex is already held.
+////////////////////////////////////////////////////////////////////
+void ConnectionReader::
+epoll_register(SocketInfo *sinfo) {
+  struct epoll_event event;
+  memset(&event, 0, sizeof(event));
+  event.events = EPOLLIN | EPOLLONESHOT;
+  event.data.ptr = sinfo;
+
+  if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, sinfo->get_socket()->GetSocket(),
+                &event) != 0) {
+    net_cat.error()
+      << "Unable to add socket to epoll set: errno " << errno << "\n";
+    sinfo->_error = true;
+    return;
+  }
+  sinfo->_epoll_registered = true;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: ConnectionReader::epoll_unregister
+//       Access: Private
+//  Description: Removes the indicated socket from the epoll set.
+//               Assumes _sockets_mutex is already held.
+////////////////////////////////////////////////////////////////////
+void ConnectionReader::
+epoll_unregister(SocketInfo *sinfo) {
+  if (!sinfo->_epoll_registered) {
+    return;
+  }
+  sinfo->_epoll_registered = false;
+
+  // Older kernels require a non-NULL event pointer even for DEL.
+  struct epoll_event event;
+  memset(&event, 0, sizeof(event));
+  epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, sinfo->get_socket()->GetSocket(),
+            &event);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: ConnectionReader::epoll_rearm
+//       Access: Private
+//  Description: Re-enables reporting of the indicated socket after it
+//               has been reported once and disarmed.  Does nothing if
+//               the socket has since been removed from the reader.
+//               Assumes _sockets_mutex is already held.
+////////////////////////////////////////////////////////////////////
+void ConnectionReader::
+epoll_rearm(SocketInfo *sinfo) {
+  if (!sinfo->_epoll_registered || sinfo->_error) {
+    return;
+  }
+
+  struct epoll_event event;
+  memset(&event, 0, sizeof(event));
+  event.events = EPOLLIN | EPOLLONESHOT;
+  event.data.ptr = sinfo;
+
+  if (epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, sinfo->get_socket()->GetSocket(),
+                &event) != 0) {
+    net_cat.error()
+      << "Unable to re-arm socket in epoll set: errno " << errno << "\n";
+    sinfo->_error = true;
+  }
+}
+#endif  // HAVE_EPOLL
@@ -26,11 +26,13 @@
 #include "pset.h"
 #include "socket_fdset.h"
 #include "atomicAdjust.h"
+#include "datagramBufferPool.h"
 
 class NetDatagram;
 class ConnectionManager;
 class Socket_Address;
 class Socket_IP;
+struct epoll_event;
 
 ////////////////////////////////////////////////////////////////////
 //       Class : ConnectionReader
@@ -79,6 +81,7 @@ PUBLISHED:
 
   ConnectionManager *get_manager() const;
   INLINE bool is_polling() const;
+  INLINE bool is_using_epoll() const;
   int get_num_threads() const;
 
   void set_raw_mode(bool mode);
@@ -87,6 +90,8 @@ PUBLISHED:
   void set_tcp_header_size(int tcp_header_size);
   int get_tcp_header_size() const;
 
+  INLINE DatagramBufferPool *get_receive_pool();
+
   void shutdown();
 
 protected:
@@ -102,6 +107,11 @@ protected:
     PT(Connection) _connection;
     bool _busy;
     bool _error;
+#ifdef HAVE_EPOLL
+    // True while the socket is registered with the reader's epoll
+    // set.  Protected by _sockets_mutex.
+    bool _epoll_registered;
+#endif
   };
   typedef pvector<SocketInfo *> Sockets;
 
@@ -135,11 +145,20 @@ private:
   void rebuild_select_list();
   void accumulate_fdset(Socket_fdset &fdset);
 
+#ifdef HAVE_EPOLL
+  void epoll_register(SocketInfo *sinfo);
+  void epoll_unregister(SocketInfo *sinfo);
+  void epoll_rearm(SocketInfo *sinfo);
+#endif
+
 private:
   bool _raw_mode;
   int _tcp_header_size;
   bool _shutdown;
 
+  // Incoming datagrams are read into buffers from this pool.
+  DatagramBufferPool _receive_pool;
+
   class ReaderThread : public Thread {
   public:
     ReaderThread(ConnectionReader *reader, const string &thread_name, 
@@ -164,6 +183,17 @@ private:
   // read a socket.
   Mutex _select_mutex;
 
+#ifdef HAVE_EPOLL
+  // If epoll is in use, this is the epoll descriptor, and
+  // _epoll_events replaces _fdset and _selecting_sockets.  Each
+  // socket is registered with EPOLLONESHOT, so that it is
+  // automatically disarmed while it is _busy; finish_socket() re-arms
+  // it.  If epoll is not in use, _epoll_fd is -1.
+  int _epoll_fd;
+  struct epoll_event *_epoll_events;
+  int _max_epoll_events;
+#endif
+
   // This is atomically updated with the index (in _threads) of the
   // thread that is currently waiting on the PR_Poll() call.  It
   // contains -1 if no thread is so waiting.
@@ -20,6 +20,7 @@
 #include "socket_udp.h"
 #include "pnotify.h"
 #include "config_downloader.h"
+#include "lightMutexHolder.h"
 
 ////////////////////////////////////////////////////////////////////
 //     Function: ConnectionWriter::WriterThread::Constructor
@@ -77,6 +78,10 @@ ConnectionWriter(ConnectionManager *manager, int num_threads,
   _tcp_header_size = tcp_header_size;
   _immediate = (num_threads <= 0);
   _shutdown = false;
+  _nonblocking = false;
+#ifdef HAVE_EPOLL
+  _nonblocking = net_nonblocking_writes;
+#endif
 
   string writer_thread_name = thread_name;
   if (thread_name.empty()) {
@@ -172,11 +177,7 @@ send(const Datagram &datagram, const PT(Connection) &connection, bool block) {
   copy.set_connection(connection);
 
   if (_immediate) {
-    if (_raw_mode) {
-      return connection->send_raw_datagram(copy);
-    } else {
-      return connection->send_datagram(copy, _tcp_header_size);
-    }
+    return do_send(copy);
   } else {
     return _queue.insert(copy, block);
   }
@@ -222,11 +223,7 @@ send(const Datagram &datagram, const PT(Connection) &connection,
   copy.set_address(address);
 
   if (_immediate) {
-    if (_raw_mode) {
-      return connection->send_raw_datagram(copy);
-    } else {
-      return connection->send_datagram(copy, _tcp_header_size);
-    }
+    return do_send(copy);
   } else {
     return _queue.insert(copy, block);
   }
@@ -331,6 +328,100 @@ get_tcp_header_size() const {
   return _tcp_header_size;
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: ConnectionWriter::set_nonblocking_writes
+//       Access: Published
+//  Description: Enables or disables nonblocking writes.  When this is
+//               enabled, a TCP datagram sent to a connection whose
+//               socket buffer is full does not block the writer (and
+//               therefore every other connection behind it); instead,
+//               the unsent data is held on that connection, and the
+//               connection is remembered as blocked.  You must then
+//               call flush_backlog() periodically to finish sending
+//               it.
+//
+//               This is only supported when Panda has been compiled
+//               with HAVE_EPOLL; otherwise, this call has no effect
+//               and all writes block.
+////////////////////////////////////////////////////////////////////
+void ConnectionWriter::
+set_nonblocking_writes(bool flag) {
+#ifdef HAVE_EPOLL
+  _nonblocking = flag;
+#else
+  if (flag) {
+    net_cat.warning()
+      << "Nonblocking writes are not supported in this build.\n";
+  }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: ConnectionWriter::get_nonblocking_writes
+//       Access: Published
+//  Description: Returns true if nonblocking writes are in effect.
+//               See set_nonblocking_writes().
+////////////////////////////////////////////////////////////////////
+bool ConnectionWriter::
+get_nonblocking_writes() const {
+  return _nonblocking;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: ConnectionWriter::get_num_blocked_connections
+//       Access: Published
+//  Description: Returns the number of connections that still have
+//               data waiting to be sent from a previous nonblocking
+//               write.
+////////////////////////////////////////////////////////////////////
+int ConnectionWriter::
+get_num_blocked_connections() const {
+  LightMutexHolder holder(_blocked_mutex);
+  return _blocked.size();
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: ConnectionWriter::flush_backlog
+//       Access: Published
+//  Description: Attempts to finish sending the data held on each
+//               connection whose socket was previously too full to
+//               accept it.  This never blocks.  Returns true if all
+//               of the backlog has now been sent, or false if some
+//               connections are still blocked.
+//
+//               This should be called periodically (for instance,
+//               once per frame) when nonblocking writes are enabled.
+//               Its cost is proportional to the number of blocked
+//               connections, not the total number of connections.
+////////////////////////////////////////////////////////////////////
+bool ConnectionWriter::
+flush_backlog() {
+  BlockedConnections blocked;
+  {
+    LightMutexHolder holder(_blocked_mutex);
+    _blocked.swap(blocked);
+  }
+
+  BlockedConnections still_blocked;
+  BlockedConnections::iterator bi;
+  for (bi = blocked.begin(); bi != blocked.end(); ++bi) {
+    Connection *connection = (*bi);
+    if (!connection->flush_backlog() &&
+        connection->get_socket()->Active()) {
+      still_blocked.insert(connection);
+    }
+  }
+
+  if (still_blocked.empty()) {
+    LightMutexHolder holder(_blocked_mutex);
+    return _blocked.empty();
+  }
+
+  LightMutexHolder holder(_blocked_mutex);
+  _blocked.insert(still_blocked.begin(), still_blocked.end());
+  return false;
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: ConnectionWriter::shutdown
 //       Access: Published
@@ -385,11 +476,36 @@ thread_run(int thread_index) {
 
   NetDatagram datagram;
   while (_queue.extract(datagram)) {
-    if (_raw_mode) {
-      datagram.get_connection()->send_raw_datagram(datagram);
-    } else {
-      datagram.get_connection()->send_datagram(datagram, _tcp_header_size);
-    }
+    do_send(datagram);
     Thread::consider_yield();
   }
 }
+
+////////////////////////////////////////////////////////////////////
+//     Function: ConnectionWriter::do_send
+//       Access: Private
+//  Description: Writes the datagram to its connection, either
+//               immediately or from a writer thread.  If nonblocking
+//               writes are in effect and the socket could not accept
+//               all of the data, the connection is added to the
+//               blocked set for flush_backlog().
+////////////////////////////////////////////////////////////////////
+bool ConnectionWriter::
+do_send(const NetDatagram &datagram) {
+  Connection *connection = datagram.get_connection();
+  bool nonblocking = _nonblocking;
+
+  bool okflag;
+  if (_raw_mode) {
+    okflag = connection->send_raw_datagram(datagram, nonblocking);
+  } else {
+    okflag = connection->send_datagram(datagram, _tcp_header_size, nonblocking);
+  }
+
+  if (okflag && nonblocking && connection->is_write_blocked()) {
+    LightMutexHolder holder(_blocked_mutex);
+    _blocked.insert(connection);
+  }
+
+  return okflag;
+}
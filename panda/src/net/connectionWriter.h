@@ -21,6 +21,8 @@
 #include "pointerTo.h"
 #include "thread.h"
 #include "pvector.h"
+#include "pset.h"
+#include "lightMutex.h"
 
 class ConnectionManager;
 class NetAddress;
@@ -66,6 +68,11 @@ PUBLISHED:
   void set_tcp_header_size(int tcp_header_size);
   int get_tcp_header_size() const;
 
+  void set_nonblocking_writes(bool flag);
+  bool get_nonblocking_writes() const;
+  int get_num_blocked_connections() const;
+  bool flush_backlog();
+
   void shutdown();
 
 protected:
@@ -74,6 +81,7 @@ protected:
 private:
   void thread_run(int thread_index);
   bool send_datagram(const NetDatagram &datagram);
+  bool do_send(const NetDatagram &datagram);
 
 protected:
   ConnectionManager *_manager;
@@ -84,6 +92,13 @@ private:
   DatagramQueue _queue;
   bool _shutdown;
 
+  // The set of connections that have data left over from a
+  // nonblocking write, waiting for flush_backlog().
+  bool _nonblocking;
+  typedef pset< PT(Connection) > BlockedConnections;
+  BlockedConnections _blocked;
+  mutable LightMutex _blocked_mutex;
+
   class WriterThread : public Thread {
   public:
     WriterThread(ConnectionWriter *writer, const string &thread_name,
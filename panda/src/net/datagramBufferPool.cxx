@@ -0,0 +1,106 @@
+// Filename: datagramBufferPool.cxx
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#include "datagramBufferPool.h"
+#include "lightMutexHolder.h"
+
+////////////////////////////////////////////////////////////////////
+//     Function: DatagramBufferPool::Constructor
+//       Access: Published
+//  Description: Creates a pool that will retain up to num_buffers
+//               buffers, each used for datagrams of up to
+//               max_buffer_size bytes.  If num_buffers is 0, nothing
+//               is pooled and every call to get_buffer() allocates.
+////////////////////////////////////////////////////////////////////
+DatagramBufferPool::
+DatagramBufferPool(int num_buffers, size_t max_buffer_size) :
+  _next_index(0),
+  _num_buffers(max(num_buffers, 0)),
+  _max_buffer_size(max_buffer_size),
+  _num_hits(0),
+  _num_misses(0)
+{
+  _buffers.reserve(_num_buffers);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: DatagramBufferPool::get_num_free_buffers
+//       Access: Published
+//  Description: Returns the number of buffers currently in the pool
+//               that are not referenced by any datagram.
+////////////////////////////////////////////////////////////////////
+int DatagramBufferPool::
+get_num_free_buffers() const {
+  LightMutexHolder holder(_lock);
+  int count = 0;
+  Buffers::const_iterator bi;
+  for (bi = _buffers.begin(); bi != _buffers.end(); ++bi) {
+    if ((*bi).get_ref_count() == 1) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: DatagramBufferPool::get_buffer
+//       Access: Public
+//  Description: Returns a buffer of exactly size bytes, suitable for
+//               reading a datagram into and then passing to
+//               Datagram::set_array().  The contents of the buffer
+//               are undefined.
+//
+//               The pool is searched in ring order, starting after
+//               the most recently returned buffer; since datagrams
+//               are normally consumed in the order they arrive, the
+//               oldest buffer is usually free, and the search
+//               usually ends at the first slot it examines.
+////////////////////////////////////////////////////////////////////
+PTA_uchar DatagramBufferPool::
+get_buffer(size_t size) {
+  if (size <= _max_buffer_size) {
+    LightMutexHolder holder(_lock);
+
+    size_t num_slots = _buffers.size();
+    for (size_t i = 0; i < num_slots; ++i) {
+      size_t index = (_next_index + i) % num_slots;
+      PTA_uchar &buffer = _buffers[index];
+      if (buffer.get_ref_count() == 1) {
+        // Nobody else is holding this one; we can reuse it.  Its
+        // capacity is never shrunk, so once the pool has warmed up
+        // this does not normally reallocate.
+        _next_index = index + 1;
+        ++_num_hits;
+        buffer.resize(size);
+        return buffer;
+      }
+    }
+
+    ++_num_misses;
+    if ((int)num_slots < _num_buffers) {
+      // Grow the pool.
+      PTA_uchar buffer = PTA_uchar::empty_array(size);
+      _buffers.push_back(buffer);
+      _next_index = num_slots + 1;
+      return buffer;
+    }
+
+  } else {
+    LightMutexHolder holder(_lock);
+    ++_num_misses;
+  }
+
+  // The pool is exhausted, or the datagram is too big to pool.
+  return PTA_uchar::empty_array(size);
+}
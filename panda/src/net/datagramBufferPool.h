@@ -0,0 +1,81 @@
+// Filename: datagramBufferPool.h
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#ifndef DATAGRAMBUFFERPOOL_H
+#define DATAGRAMBUFFERPOOL_H
+
+#include "pandabase.h"
+#include "pointerToArray.h"
+#include "pta_uchar.h"
+#include "pvector.h"
+#include "lightMutex.h"
+
+////////////////////////////////////////////////////////////////////
+//       Class : DatagramBufferPool
+// Description : A fixed ring of reference-counted byte arrays that
+//               ConnectionReader reads incoming datagrams into.
+//
+//               Each buffer handed out by get_buffer() becomes the
+//               storage of a NetDatagram directly, so the received
+//               bytes are never copied again on their way to the
+//               application, and DatagramIterator reads them in
+//               place.  The pool keeps its own reference to every
+//               buffer; once all the datagrams sharing a buffer have
+//               been destroyed, its reference count drops back to
+//               one and the buffer (with its already-allocated
+//               capacity) is reused for a later datagram.  This
+//               removes the heap allocation per message in the
+//               steady state.
+//
+//               Since Datagram is copy-on-write, a client that
+//               modifies a received datagram gets its own copy and
+//               cannot disturb the pool.
+//
+//               Only requests of up to max_buffer_size bytes are
+//               pooled.  A UDP or raw-mode read asks for one full
+//               read buffer (a maximum UDP packet plus its header),
+//               so those are pooled unless max_buffer_size is set
+//               below that; larger TCP datagrams always get a
+//               buffer of their own.
+////////////////////////////////////////////////////////////////////
+class EXPCL_PANDA_NET DatagramBufferPool {
+PUBLISHED:
+  DatagramBufferPool(int num_buffers, size_t max_buffer_size);
+
+  INLINE int get_num_buffers() const;
+  INLINE size_t get_max_buffer_size() const;
+  int get_num_free_buffers() const;
+
+  INLINE unsigned int get_num_hits() const;
+  INLINE unsigned int get_num_misses() const;
+
+public:
+  PTA_uchar get_buffer(size_t size);
+
+private:
+  typedef pvector<PTA_uchar> Buffers;
+  Buffers _buffers;
+  size_t _next_index;
+  int _num_buffers;
+  size_t _max_buffer_size;
+
+  unsigned int _num_hits;
+  unsigned int _num_misses;
+
+  mutable LightMutex _lock;
+};
+
+#include "datagramBufferPool.I"
+
+#endif
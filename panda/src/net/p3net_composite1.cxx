@@ -5,6 +5,7 @@
 #include "connectionManager.cxx"
 #include "connectionReader.cxx"
 #include "connectionWriter.cxx"
+#include "datagramBufferPool.cxx"
 #include "datagramGeneratorNet.cxx"
 #include "datagramSinkNet.cxx"
 #include "datagramQueue.cxx"
@@ -49,12 +49,14 @@
     eventStorePandaNode.I eventStorePandaNode.h \
     findApproxLevelEntry.I findApproxLevelEntry.h \
     findApproxPath.I findApproxPath.h \
+    flattenBatch.h \
     fog.I fog.h \
     fogAttrib.I fogAttrib.h \
     geomDrawCallbackData.I geomDrawCallbackData.h \
     geomNode.I geomNode.h \
     geomTransformer.I geomTransformer.h \
     internalNameCollection.I internalNameCollection.h \
+    instancedNode.I instancedNode.h \
     lensNode.I lensNode.h \
     light.I light.h \
     lightAttrib.I lightAttrib.h \
@@ -65,6 +67,7 @@
     loaderFileTypeRegistry.h \
     materialAttrib.I materialAttrib.h \
     materialCollection.I materialCollection.h \
+    meshSimplifier.I meshSimplifier.h \
     modelFlattenRequest.I modelFlattenRequest.h \
     modelLoadRequest.I modelLoadRequest.h \
     modelSaveRequest.I modelSaveRequest.h \
@@ -158,12 +161,14 @@
     eventStorePandaNode.cxx \
     findApproxLevelEntry.cxx \
     findApproxPath.cxx \
+    flattenBatch.cxx \
     fog.cxx \
     fogAttrib.cxx \
     geomDrawCallbackData.cxx \
     geomNode.cxx \
     geomTransformer.cxx \
     internalNameCollection.cxx \
+    instancedNode.cxx \
     lensNode.cxx \
     light.cxx \
     lightAttrib.cxx \
@@ -174,6 +179,7 @@
     loaderFileTypeRegistry.cxx  \
     materialAttrib.cxx \
     materialCollection.cxx \
+    meshSimplifier.cxx \
     modelFlattenRequest.cxx \
     modelLoadRequest.cxx \
     modelSaveRequest.cxx \
@@ -259,12 +265,14 @@
     depthTestAttrib.I depthTestAttrib.h \
     depthWriteAttrib.I depthWriteAttrib.h \
     eventStorePandaNode.I eventStorePandaNode.h \
+    flattenBatch.h \
     fog.I fog.h \
     fogAttrib.I fogAttrib.h \
     geomDrawCallbackData.I geomDrawCallbackData.h \
     geomNode.I geomNode.h \
     geomTransformer.I geomTransformer.h \
     internalNameCollection.I internalNameCollection.h \
+    instancedNode.I instancedNode.h \
     lensNode.I lensNode.h \
     light.I light.h \
     lightAttrib.I lightAttrib.h \
@@ -275,6 +283,7 @@
     loaderFileTypeRegistry.h \
     materialAttrib.I materialAttrib.h \
     materialCollection.I materialCollection.h \
+    meshSimplifier.I meshSimplifier.h \
     modelFlattenRequest.I modelFlattenRequest.h \
     modelLoadRequest.I modelLoadRequest.h \
     modelSaveRequest.I modelSaveRequest.h \
@@ -349,3 +358,36 @@
   #define OTHER_LIBS $[OTHER_LIBS] p3pystub
 
 #end test_bin_target
+
+#begin test_bin_target
+  #define TARGET test_flatten
+
+  #define SOURCES \
+    test_flatten.cxx
+
+  #define LOCAL_LIBS $[LOCAL_LIBS] p3pgraph
+  #define OTHER_LIBS $[OTHER_LIBS] p3pystub
+
+#end test_bin_target
+
+#begin test_bin_target
+  #define TARGET test_cull_borrow
+
+  #define SOURCES \
+    test_cull_borrow.cxx
+
+  #define LOCAL_LIBS $[LOCAL_LIBS] p3pgraph
+  #define OTHER_LIBS $[OTHER_LIBS] p3pystub
+
+#end test_bin_target
+
+#begin test_bin_target
+  #define TARGET test_instancedNode
+
+  #define SOURCES \
+    test_instancedNode.cxx
+
+  #define LOCAL_LIBS $[LOCAL_LIBS] p3pgraph
+  #define OTHER_LIBS $[OTHER_LIBS] p3pystub
+
+#end test_bin_target
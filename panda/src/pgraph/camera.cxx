@@ -126,6 +126,7 @@ safe_to_transform() const {
 void Camera::
 set_tag_state(const string &tag_state, const RenderState *state) {
   _tag_states[tag_state] = state;
+  ++_tag_state_seq;
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -136,7 +137,9 @@ set_tag_state(const string &tag_state, const RenderState *state) {
 ////////////////////////////////////////////////////////////////////
 void Camera::
 clear_tag_state(const string &tag_state) {
-  _tag_states.erase(tag_state);
+  if (_tag_states.erase(tag_state) != 0) {
+    ++_tag_state_seq;
+  }
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -25,6 +25,7 @@
 #include "renderState.h"
 #include "pointerTo.h"
 #include "pmap.h"
+#include "updateSeq.h"
 #include "auxSceneData.h"
 #include "displayRegionBase.h"
 
@@ -89,6 +90,9 @@ PUBLISHED:
   void list_aux_scene_data(ostream &out) const;
   int cleanup_aux_scene_data(Thread *current_thread = Thread::get_current_thread());
 
+public:
+  INLINE UpdateSeq get_tag_state_seq() const;
+
 private:
   void add_display_region(DisplayRegionBase *display_region);
   void remove_display_region(DisplayRegionBase *display_region);
@@ -110,6 +114,7 @@ private:
 
   typedef pmap<string, CPT(RenderState) > TagStates;
   TagStates _tag_states;
+  UpdateSeq _tag_state_seq;
 
   typedef pmap<NodePath, PT(AuxSceneData) > AuxData;
   AuxData _aux_data;
@@ -39,11 +39,13 @@
 #include "depthWriteAttrib.h"
 #include "eventStorePandaNode.h"
 #include "findApproxLevelEntry.h"
+#include "flattenBatch.h"
 #include "fog.h"
 #include "fogAttrib.h"
 #include "geomDrawCallbackData.h"
 #include "geomNode.h"
 #include "geomTransformer.h"
+#include "instancedNode.h"
 #include "lensNode.h"
 #include "light.h"
 #include "lightAttrib.h"
@@ -284,6 +286,15 @@ ConfigVariableInt max_collect_indices
           "imposing a limit on the original size of any one "
           "GeomPrimitive."));
 
+ConfigVariableInt flatten_threads
+("flatten-threads", 0,
+ PRC_DESC("The number of helper threads that the SceneGraphReducer may use "
+          "to flatten independent subgraphs of a large scene at the same "
+          "time, and to transform and collect their vertices.  The result "
+          "is the same as flattening serially.  This has no effect unless "
+          "Panda was compiled with THREADED_PIPELINE.  Set this to 0 to do "
+          "all flattening in the calling thread."));
+
 ConfigVariableBool premunge_data
 ("premunge-data", true,
  PRC_DESC("Set this true to preconvert vertex data at model load time to "
@@ -318,6 +329,14 @@ ConfigVariableInt max_lenses
           "this can be used as a simple sanity check.  Set it larger or "
           "smaller to suit your needs."));
 
+ConfigVariableInt instanced_node_batch_size
+("instanced-node-batch-size", 256,
+ PRC_DESC("Specifies the maximum number of instances that an InstancedNode "
+          "draws with a single draw call.  When hardware instancing is used, "
+          "this must not exceed the size of the instance_transforms array "
+          "declared in the shader.  Otherwise, it controls how many "
+          "instances are baked into each expanded Geom."));
+
 ConfigVariableBool default_antialias_enable
 ("default-antialias-enable", false,
  PRC_DESC("Set this true to enable the M_auto antialiasing mode for all "
@@ -358,6 +377,24 @@ ConfigVariableBool m_dual_flash
 ("m-dual-flash", false,
  PRC_DESC("Set this true to flash any objects that use M_dual, for debugging."));
 
+ConfigVariableBool cull_borrow_pointers
+("cull-borrow-pointers", true,
+ PRC_DESC("Set this true to have each level of the cull traversal borrow "
+          "its parent's net transform, state, and frustum pointers instead "
+          "of taking new references to them, which saves several atomic "
+          "operations per node.  Set it false to have every level own its "
+          "references; this is slower, but may help to track down a "
+          "cull_callback() that holds on to a CullTraverserData's "
+          "pointers longer than it should."));
+
+ConfigVariableBool cull_frame_arena
+("cull-frame-arena", true,
+ PRC_DESC("Set this true to allocate the CullableObjects and bin lists "
+          "generated by each cull traversal from a FrameArena owned by "
+          "the CullResult, which is released in one step when the frame "
+          "has been drawn, rather than from the heap one object at a "
+          "time."));
+
 ConfigVariableList load_file_type
 ("load-file-type",
  PRC_DESC("List the model loader modules that Panda will automatically "
@@ -383,6 +420,20 @@ ConfigVariableBool allow_live_flatten
           "only has an effect when Panda is not compiled for a release "
           "build."));
 
+// These must be defined after the variables they copy.
+ConfigSnapshotBool clip_plane_cull_snapshot(clip_plane_cull);
+ConfigSnapshotBool paranoid_compose_snapshot(paranoid_compose);
+ConfigSnapshotBool compose_componentwise_snapshot(compose_componentwise);
+ConfigSnapshotBool uniquify_matrix_snapshot(uniquify_matrix);
+ConfigSnapshotBool garbage_collect_states_snapshot(garbage_collect_states);
+ConfigSnapshotBool transform_cache_snapshot(transform_cache);
+ConfigSnapshotBool state_cache_snapshot(state_cache);
+ConfigSnapshotBool uniquify_transforms_snapshot(uniquify_transforms);
+ConfigSnapshotBool uniquify_states_snapshot(uniquify_states);
+ConfigSnapshotBool uniquify_attribs_snapshot(uniquify_attribs);
+ConfigSnapshotBool show_transparency_snapshot(show_transparency);
+ConfigSnapshotBool m_dual_snapshot(m_dual);
+
 ////////////////////////////////////////////////////////////////////
 //     Function: init_libpgraph
 //  Description: Initializes the library.  This must be called at
@@ -424,11 +475,13 @@ init_libpgraph() {
   DepthWriteAttrib::init_type();
   EventStorePandaNode::init_type();
   FindApproxLevelEntry::init_type();
+  FlattenBatch::init_type();
   Fog::init_type();
   FogAttrib::init_type();
   GeomDrawCallbackData::init_type();
   GeomNode::init_type();
   GeomTransformer::init_type();
+  InstancedNode::init_type();
   LensNode::init_type();
   Light::init_type();
   LightAttrib::init_type();
@@ -496,6 +549,7 @@ init_libpgraph() {
   Fog::register_with_read_factory();
   FogAttrib::register_with_read_factory();
   GeomNode::register_with_read_factory();
+  InstancedNode::register_with_read_factory();
   LensNode::register_with_read_factory();
   LightAttrib::register_with_read_factory();
   LightRampAttrib::register_with_read_factory();
@@ -22,6 +22,7 @@
 #include "configVariableInt.h"
 #include "configVariableDouble.h"
 #include "configVariableList.h"
+#include "configSnapshot.h"
 
 class DSearchPath;
 
@@ -55,10 +56,12 @@ extern ConfigVariableBool retransform_sprites;
 extern ConfigVariableBool depth_offset_decals;
 extern ConfigVariableInt max_collect_vertices;
 extern ConfigVariableInt max_collect_indices;
+extern ConfigVariableInt flatten_threads;
 extern EXPCL_PANDA_PGRAPH ConfigVariableBool premunge_data;
 extern ConfigVariableBool preserve_geom_nodes;
 extern ConfigVariableBool flatten_geoms;
 extern EXPCL_PANDA_PGRAPH ConfigVariableInt max_lenses;
+extern ConfigVariableInt instanced_node_batch_size;
 extern ConfigVariableBool default_antialias_enable;
 
 extern ConfigVariableBool polylight_info;
@@ -70,6 +73,24 @@ extern ConfigVariableBool m_dual;
 extern ConfigVariableBool m_dual_opaque;
 extern ConfigVariableBool m_dual_transparent;
 extern ConfigVariableBool m_dual_flash;
+extern ConfigVariableBool cull_borrow_pointers;
+extern ConfigVariableBool cull_frame_arena;
+
+// Copies of the above variables that are consulted in the innermost
+// loops.  When ConfigSnapshot::set_frozen() is in effect, these are
+// refreshed only once per frame.  See ConfigSnapshot.
+extern ConfigSnapshotBool clip_plane_cull_snapshot;
+extern ConfigSnapshotBool paranoid_compose_snapshot;
+extern ConfigSnapshotBool compose_componentwise_snapshot;
+extern ConfigSnapshotBool uniquify_matrix_snapshot;
+extern EXPCL_PANDA_PGRAPH ConfigSnapshotBool garbage_collect_states_snapshot;
+extern ConfigSnapshotBool transform_cache_snapshot;
+extern ConfigSnapshotBool state_cache_snapshot;
+extern ConfigSnapshotBool uniquify_transforms_snapshot;
+extern ConfigSnapshotBool uniquify_states_snapshot;
+extern ConfigSnapshotBool uniquify_attribs_snapshot;
+extern ConfigSnapshotBool show_transparency_snapshot;
+extern ConfigSnapshotBool m_dual_snapshot;
 
 extern ConfigVariableList load_file_type;
 extern ConfigVariableString default_model_extension;
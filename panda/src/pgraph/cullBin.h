@@ -21,6 +21,9 @@
 #include "pStatCollector.h"
 #include "pointerTo.h"
 #include "luse.h"
+#include "frameArena.h"
+#include "frameArenaAllocator.h"
+#include "thread.h"
 
 class CullableObject;
 class GraphicsStateGuardianBase;
@@ -69,6 +72,8 @@ protected:
   class ResultGraphBuilder;
   virtual void fill_result_graph(ResultGraphBuilder &builder)=0;
 
+  INLINE static FrameArena *get_current_frame_arena();
+
 private:
   void check_flash_color();
 
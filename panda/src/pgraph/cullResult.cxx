@@ -156,7 +156,7 @@ add_object(CullableObject *object, const CullTraverser *traverser) {
       check_flash_transparency(object->_state, flash_dual_color);
       state = object->_state;
 #endif
-      if (!m_dual) {
+      if (!m_dual_snapshot) {
         // If m_dual is configured off, it becomes M_alpha.
         break;
       }
@@ -425,7 +425,7 @@ check_flash_bin(CPT(RenderState) &state, CullBin *bin) {
 ////////////////////////////////////////////////////////////////////
 void CullResult::
 check_flash_transparency(CPT(RenderState) &state, const LColor &transparency) {
-  if (show_transparency) {
+  if (show_transparency_snapshot) {
     int cycle = (int)(ClockObject::get_global_clock()->get_frame_time() * bin_color_flash_rate);
     if ((cycle & 1) == 0) {
       state = state->remove_attrib(TextureAttrib::get_class_slot());
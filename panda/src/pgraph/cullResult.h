@@ -25,6 +25,8 @@
 #include "pvector.h"
 #include "pset.h"
 #include "pmap.h"
+#include "frameArena.h"
+#include "config_pgraph.h"
 
 
 class GraphicsStateGuardianBase;
@@ -62,6 +64,8 @@ PUBLISHED:
   PT(PandaNode) make_result_graph();
 
 public:
+  INLINE FrameArena *get_frame_arena();
+
   static void bin_removed(int bin_index);
 
 private:
@@ -77,6 +81,11 @@ private:
 
   GraphicsStateGuardianBase *_gsg;
   PStatCollector _draw_region_pcollector;
+
+  // The CullableObjects and bin lists created while culling into
+  // this result are allocated from here.  It must be declared before
+  // _bins, so that the bins (and their objects) are destructed first.
+  FrameArena _arena;
   
   typedef pvector< PT(CullBin) > Bins;
   Bins _bins;
@@ -60,6 +60,7 @@ CullTraverser() :
   _cull_handler = (CullHandler *)NULL;
   _portal_clipper = (PortalClipper *)NULL;
   _effective_incomplete_render = true;
+  _num_cull_callbacks = 0;
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -80,7 +81,8 @@ CullTraverser(const CullTraverser &copy) :
   _view_frustum(copy._view_frustum),
   _cull_handler(copy._cull_handler),
   _portal_clipper(copy._portal_clipper),
-  _effective_incomplete_render(copy._effective_incomplete_render)
+  _effective_incomplete_render(copy._effective_incomplete_render),
+  _num_cull_callbacks(copy._num_cull_callbacks)
 {
 }
 
@@ -108,6 +110,7 @@ set_scene(SceneSetup *scene_setup, GraphicsStateGuardianBase *gsg,
   _camera_mask = camera->get_camera_mask();
 
   _effective_incomplete_render = _gsg->get_incomplete_render() && dr_incomplete_render;
+  _num_cull_callbacks = 0;
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -221,6 +224,7 @@ traverse(CullTraverserData &data) {
       
       if (fancy_bits & PandaNode::FB_cull_callback) {
         PandaNode *node = data.node();
+        ++_num_cull_callbacks;
         if (!node->cull_callback(this, data)) {
           return;
         }
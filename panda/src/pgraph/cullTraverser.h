@@ -78,6 +78,7 @@ PUBLISHED:
   INLINE PortalClipper *get_portal_clipper() const;
 
   INLINE bool get_effective_incomplete_render() const;
+  INLINE int get_num_cull_callbacks() const;
 
   void traverse(const NodePath &root);
   void traverse(CullTraverserData &data);
@@ -95,6 +96,8 @@ protected:
   virtual bool is_in_view(CullTraverserData &data);
 
 public:
+  INLINE void inc_num_cull_callbacks();
+
   // Statistics
   static PStatCollector _nodes_pcollector;
   static PStatCollector _geom_nodes_pcollector;
@@ -126,6 +129,7 @@ private:
   CullHandler *_cull_handler;
   PortalClipper *_portal_clipper;
   bool _effective_incomplete_render;
+  int _num_cull_callbacks;
   
 public:
   static TypeHandle get_class_type() {
@@ -114,7 +114,7 @@ apply_transform_and_state(CullTraverser *trav,
 
   _state = _state->compose(node_state);
 
-  if (clip_plane_cull) {
+  if (clip_plane_cull_snapshot) {
     _cull_planes = _cull_planes->apply_state(trav, this, 
                                              DCAST(ClipPlaneAttrib, node_state->get_attrib(ClipPlaneAttrib::get_class_slot())),
                                              DCAST(ClipPlaneAttrib, off_clip_planes),
@@ -176,7 +176,11 @@ is_in_view_impl() {
   if (!_cull_planes->is_empty()) {
     // Also cull against the current clip planes.
     int result;
-    _cull_planes = _cull_planes->do_cull(result, _state, node_gbv);
+    CPT(RenderState) state = _state.p();
+    _cull_planes = _cull_planes->do_cull(result, state, node_gbv);
+    if (state != _state.p()) {
+      _state = state;
+    }
     
     if (pgraph_cat.is_spam()) {
       pgraph_cat.spam()
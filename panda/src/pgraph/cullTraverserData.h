@@ -22,6 +22,8 @@
 #include "transformState.h"
 #include "geometricBoundingVolume.h"
 #include "pointerTo.h"
+#include "borrowedPointerTo.h"
+#include "config_pgraph.h"
 #include "drawMask.h"
 #include "cullTraverser.h"
 #include "pvector.h"
@@ -41,6 +43,12 @@ class PandaNode;
 //               to add cull parameters, and provides a place to
 //               abstract out some of the cull behavior (like
 //               view-frustum culling).
+//
+//               A CullTraverserData made for a child node borrows
+//               its parent's transform, state, and frustum pointers
+//               rather than taking new references to them, since the
+//               parent is guaranteed to outlive the child during the
+//               traversal.  Copies always own their references.
 ////////////////////////////////////////////////////////////////////
 class EXPCL_PANDA_PGRAPH CullTraverserData {
 public:
@@ -79,14 +87,18 @@ PUBLISHED:
 public:
   WorkingNodePath _node_path;
   PandaNodePipelineReader _node_reader;
-  CPT(TransformState) _net_transform;
-  CPT(RenderState) _state;
-  PT(GeometricBoundingVolume) _view_frustum;
-  CPT(CullPlanes) _cull_planes;
+  BorrowedPointerTo<const TransformState> _net_transform;
+  BorrowedPointerTo<const RenderState> _state;
+  BorrowedPointerTo<GeometricBoundingVolume> _view_frustum;
+  BorrowedPointerTo<const CullPlanes> _cull_planes;
   DrawMask _draw_mask;
   int _portal_depth;
 
 private:
+  // True if child nodes should borrow this node's pointers; see
+  // cull-borrow-pointers.
+  bool _borrow_pointers;
+
   bool is_in_view_impl();
   static CPT(RenderState) get_fake_view_frustum_cull_state();
 };
@@ -32,6 +32,8 @@
 #include "sceneSetup.h"
 #include "lightMutex.h"
 #include "callbackObject.h"
+#include "frameArena.h"
+#include "thread.h"
 
 class CullTraverser;
 
@@ -79,7 +81,15 @@ public:
 
 public:
   ~CullableObject();
-  ALLOC_DELETED_CHAIN(CullableObject);
+
+  // CullableObjects are allocated from the current thread's
+  // FrameArena, if it has one, or from a DeletedBufferChain
+  // otherwise.  See operator new.
+  INLINE void *operator new(size_t size);
+  INLINE void *operator new(size_t size, void *ptr);
+  INLINE void operator delete(void *ptr);
+  INLINE void operator delete(void *, void *);
+  INLINE static bool validate_ptr(const void *ptr);
 
   void output(ostream &out) const;
 
@@ -102,6 +112,7 @@ private:
 
 private:
   INLINE void make_fancy();
+  INLINE static DeletedBufferChain *get_deleted_chain();
   bool munge_points_to_quads(const CullTraverser *traverser, bool force);
   bool munge_texcoord_light_vector(const CullTraverser *traverser, bool force);
 
@@ -144,6 +155,12 @@ private:
   static FormatMap _format_map;
   static LightMutex _format_lock;
 
+  // Each allocation is preceded by this many bytes, which record the
+  // FrameArena it came from (or NULL).  This is a multiple of 16 to
+  // preserve alignment.
+  enum { alloc_header_size = 16 };
+  static DeletedBufferChain *_deleted_chain;
+
   static PStatCollector _munge_geom_pcollector;
   static PStatCollector _munge_sprites_pcollector;
   static PStatCollector _munge_sprites_verts_pcollector;
@@ -0,0 +1,233 @@
+// Filename: flattenBatch.cxx
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#include "flattenBatch.h"
+#include "config_pgraph.h"
+#include "asyncTaskManager.h"
+#include "asyncTaskChain.h"
+#include "mutexHolder.h"
+#include "thread.h"
+
+TypeHandle FlattenBatch::Task::_type_handle;
+
+////////////////////////////////////////////////////////////////////
+//     Function: FlattenBatch::Constructor
+//       Access: Public
+//  Description:
+////////////////////////////////////////////////////////////////////
+FlattenBatch::
+FlattenBatch() :
+  _lock("FlattenBatch::_lock"),
+  _cvar(_lock),
+  _num_jobs(0),
+  _next_job(0),
+  _num_done(0),
+  _num_tasks(0),
+  _pipeline_stage(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: FlattenBatch::Destructor
+//       Access: Public, Virtual
+//  Description:
+////////////////////////////////////////////////////////////////////
+FlattenBatch::
+~FlattenBatch() {
+  nassertv(_num_tasks == 0);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: FlattenBatch::run
+//       Access: Public
+//  Description: Performs jobs 0 through num_jobs - 1, and returns
+//               when all of them are finished.  If threading is not
+//               available, or flatten-threads is 0, or this is
+//               already being called from one of the flatten
+//               threads, the jobs are simply performed in order in
+//               the calling thread.
+////////////////////////////////////////////////////////////////////
+void FlattenBatch::
+run(int num_jobs) {
+  nassertv(_num_tasks == 0);
+  _num_jobs = num_jobs;
+  _next_job = 0;
+  _num_done = 0;
+
+  Thread *current_thread = Thread::get_current_thread();
+  int num_threads = get_num_threads();
+  AsyncTaskBase *current_task = current_thread->get_current_task();
+  if (num_jobs < 2 || num_threads <= 0 ||
+      (current_task != (AsyncTaskBase *)NULL &&
+       current_task->is_exact_type(Task::get_class_type()))) {
+    // Do it all ourselves.  We don't hand out work from within a
+    // flatten thread, since the other flatten threads might all be
+    // waiting for us.
+    for (int n = 0; n < num_jobs; ++n) {
+      do_job(n);
+    }
+    _num_done = num_jobs;
+    return;
+  }
+
+  _pipeline_stage = current_thread->get_pipeline_stage();
+
+  // The calling thread takes one share of the work itself.
+  int num_tasks = min(num_threads, num_jobs - 1);
+  AsyncTaskManager *task_mgr = AsyncTaskManager::get_global_ptr();
+  get_task_chain();
+  {
+    MutexHolder holder(_lock);
+    _num_tasks = num_tasks;
+  }
+  for (int i = 0; i < num_tasks; ++i) {
+    PT(Task) task = new Task(this);
+    task_mgr->add(task);
+  }
+
+  while (do_next_job()) {
+  }
+
+  // Now wait for the other threads to finish their jobs.  We also
+  // wait for the tasks that never got a job, since they still hold
+  // a pointer to us.
+  MutexHolder holder(_lock);
+  while (_num_done < _num_jobs || _num_tasks != 0) {
+    _cvar.wait();
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: FlattenBatch::get_num_threads
+//       Access: Public, Static
+//  Description: Returns the number of threads that will help with
+//               each FlattenBatch, in addition to the calling thread.
+//               This is the value of flatten-threads, or 0 if
+//               threading is not available.
+//
+//               The jobs modify nodes whose bounds changes propagate
+//               up into the shared parents.  That is only safe when
+//               the cyclers are locked, so without THREADED_PIPELINE
+//               this always returns 0.
+////////////////////////////////////////////////////////////////////
+int FlattenBatch::
+get_num_threads() {
+#ifdef THREADED_PIPELINE
+  if (!Thread::is_threading_supported()) {
+    return 0;
+  }
+  return max((int)flatten_threads, 0);
+#else
+  return 0;
+#endif  // THREADED_PIPELINE
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: FlattenBatch::do_next_job
+//       Access: Private
+//  Description: Claims the next unclaimed job, if any, and performs
+//               it.  Returns true if a job was performed, false if
+//               there are none left.
+////////////////////////////////////////////////////////////////////
+bool FlattenBatch::
+do_next_job() {
+  int n;
+  {
+    MutexHolder holder(_lock);
+    if (_next_job >= _num_jobs) {
+      return false;
+    }
+    n = _next_job;
+    ++_next_job;
+  }
+
+  do_job(n);
+
+  MutexHolder holder(_lock);
+  ++_num_done;
+  if (_num_done == _num_jobs) {
+    _cvar.notify();
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: FlattenBatch::task_finished
+//       Access: Private
+//  Description: Called by each Task when it finds no more work to do.
+//               After this call, the Task may no longer reference the
+//               FlattenBatch.
+////////////////////////////////////////////////////////////////////
+void FlattenBatch::
+task_finished() {
+  MutexHolder holder(_lock);
+  --_num_tasks;
+  if (_num_tasks == 0) {
+    _cvar.notify();
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: FlattenBatch::get_task_chain
+//       Access: Private, Static
+//  Description: Returns the task chain whose threads perform the
+//               jobs, creating it if necessary.
+////////////////////////////////////////////////////////////////////
+AsyncTaskChain *FlattenBatch::
+get_task_chain() {
+  AsyncTaskManager *task_mgr = AsyncTaskManager::get_global_ptr();
+  AsyncTaskChain *chain = task_mgr->find_task_chain("flatten");
+  if (chain == (AsyncTaskChain *)NULL) {
+    chain = task_mgr->make_task_chain("flatten");
+    chain->set_num_threads(get_num_threads());
+    chain->set_thread_priority(TP_normal);
+  }
+  return chain;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: FlattenBatch::Task::Constructor
+//       Access: Public
+//  Description:
+////////////////////////////////////////////////////////////////////
+FlattenBatch::Task::
+Task(FlattenBatch *batch) :
+  AsyncTask("flatten"),
+  _batch(batch)
+{
+  set_task_chain("flatten");
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: FlattenBatch::Task::do_task
+//       Access: Protected, Virtual
+//  Description: Performs jobs from the batch until there are none
+//               left.
+////////////////////////////////////////////////////////////////////
+AsyncTask::DoneStatus FlattenBatch::Task::
+do_task() {
+  Thread *current_thread = Thread::get_current_thread();
+  int orig_stage = current_thread->get_pipeline_stage();
+  current_thread->set_pipeline_stage(_batch->_pipeline_stage);
+
+  while (_batch->do_next_job()) {
+  }
+
+  current_thread->set_pipeline_stage(orig_stage);
+
+  FlattenBatch *batch = _batch;
+  _batch = NULL;
+  batch->task_finished();
+  return DS_done;
+}
@@ -0,0 +1,104 @@
+// Filename: flattenBatch.h
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#ifndef FLATTENBATCH_H
+#define FLATTENBATCH_H
+
+#include "pandabase.h"
+
+#include "asyncTask.h"
+#include "pmutex.h"
+#include "conditionVar.h"
+#include "pointerTo.h"
+
+////////////////////////////////////////////////////////////////////
+//       Class : FlattenBatch
+// Description : This is an abstract base class for a set of
+//               independent jobs performed while flattening the scene
+//               graph, such as flattening the subgraphs below each
+//               child of a node.  The jobs are handed out to the
+//               threads of the "flatten" task chain, if flatten-threads
+//               is nonzero and Panda was compiled with
+//               THREADED_PIPELINE, and the calling thread works on
+//               them too while it waits for the rest.
+//
+//               Each job should store its results by its own index,
+//               and the caller should combine them in index order
+//               after run() returns, so that the outcome does not
+//               depend on which thread performed which job.
+////////////////////////////////////////////////////////////////////
+class EXPCL_PANDA_PGRAPH FlattenBatch {
+public:
+  FlattenBatch();
+  virtual ~FlattenBatch();
+
+  void run(int num_jobs);
+
+  static int get_num_threads();
+
+protected:
+  virtual void do_job(int n)=0;
+
+private:
+  bool do_next_job();
+  void task_finished();
+
+  Mutex _lock;
+  ConditionVar _cvar;
+  int _num_jobs;
+  int _next_job;
+  int _num_done;
+  int _num_tasks;
+  int _pipeline_stage;
+
+  static AsyncTaskChain *get_task_chain();
+
+  // This task is added to the flatten task chain to pick up jobs in
+  // a sub-thread.
+  class Task : public AsyncTask {
+  public:
+    Task(FlattenBatch *batch);
+    ALLOC_DELETED_CHAIN(Task);
+
+  protected:
+    virtual DoneStatus do_task();
+
+  private:
+    FlattenBatch *_batch;
+
+  public:
+    static TypeHandle get_class_type() {
+      return _type_handle;
+    }
+    static void init_type() {
+      AsyncTask::init_type();
+      register_type(_type_handle, "FlattenBatch::Task",
+                    AsyncTask::get_class_type());
+    }
+    virtual TypeHandle get_type() const {
+      return get_class_type();
+    }
+    virtual TypeHandle force_init_type() {init_type(); return get_class_type();}
+
+  private:
+    static TypeHandle _type_handle;
+  };
+
+public:
+  static void init_type() {
+    Task::init_type();
+  }
+};
+
+#endif
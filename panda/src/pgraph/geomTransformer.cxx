@@ -29,6 +29,8 @@
 #include "texture.h"
 #include "texturePeeker.h"
 #include "config_pgraph.h"
+#include "flattenBatch.h"
+#include "reMutexHolder.h"
 
 PStatCollector GeomTransformer::_apply_vertex_collector("*:Flatten:apply:vertex");
 PStatCollector GeomTransformer::_apply_texcoord_collector("*:Flatten:apply:texcoord");
@@ -39,6 +41,21 @@ PStatCollector GeomTransformer::_apply_set_format_collector("*:Flatten:apply:set
 
 TypeHandle GeomTransformer::NewCollectedData::_type_handle;
 
+// The FlattenBatch used by finish_collect().
+class GeomTransformer::CollectBatch : public FlattenBatch {
+public:
+  CollectBatch(bool format_only);
+
+  NewCollectedList _list;
+  vector_int _results;
+
+protected:
+  virtual void do_job(int n);
+
+private:
+  bool _format_only;
+};
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeomTransformer::Constructor
 //       Access: Public
@@ -47,7 +64,8 @@ TypeHandle GeomTransformer::NewCollectedData::_type_handle;
 GeomTransformer::
 GeomTransformer() :
   // The default value here comes from the Config file.
-  _max_collect_vertices(max_collect_vertices)
+  _max_collect_vertices(max_collect_vertices),
+  _lock("GeomTransformer::_lock")
 {
 }
 
@@ -58,7 +76,8 @@ GeomTransformer() :
 ////////////////////////////////////////////////////////////////////
 GeomTransformer::
 GeomTransformer(const GeomTransformer &copy) :
-  _max_collect_vertices(copy._max_collect_vertices)
+  _max_collect_vertices(copy._max_collect_vertices),
+  _lock("GeomTransformer::_lock")
 {
 }
 
@@ -81,6 +100,7 @@ GeomTransformer::
 ////////////////////////////////////////////////////////////////////
 void GeomTransformer::
 register_vertices(Geom *geom, bool might_have_unused) {
+  ReMutexHolder holder(_lock);
   VertexDataAssoc &assoc = _vdata_assoc[geom->get_vertex_data()];
   assoc._geoms.push_back(geom);
   if (might_have_unused) {
@@ -126,18 +146,38 @@ transform_vertices(Geom *geom, const LMatrix4 &mat) {
   SourceVertices sv;
   sv._mat = mat;
   sv._vertex_data = geom->get_vertex_data();
-  
-  NewVertexData &new_data = _vertices[sv];
-  if (new_data._vdata.is_null()) {
-    // We have not yet converted these vertices.  Do so now.
+
+  CPT(GeomVertexData) result;
+  {
+    ReMutexHolder holder(_lock);
+    NewVertices::const_iterator vi = _vertices.find(sv);
+    if (vi != _vertices.end()) {
+      result = (*vi).second._vdata;
+    }
+  }
+
+  if (result.is_null()) {
+    // We have not yet converted these vertices.  Do so now.  We
+    // don't hold the lock while we do this, since it is the bulk of
+    // the work of apply_attribs(); if another thread beats us to the
+    // same vertices, we use its result instead, so the Geoms still
+    // end up sharing.
     PT(GeomVertexData) new_vdata = new GeomVertexData(*sv._vertex_data);
     new_vdata->transform_vertices(mat);
-    new_data._vdata = new_vdata;
+
+    ReMutexHolder holder(_lock);
+    NewVertexData &new_data = _vertices[sv];
+    if (new_data._vdata.is_null()) {
+      new_data._vdata = new_vdata;
+    }
+    result = new_data._vdata;
   }
-  
-  geom->set_vertex_data(new_data._vdata);
+
+  geom->set_vertex_data(result);
+
+  ReMutexHolder holder(_lock);
   if (sv._vertex_data->get_ref_count() > 1) {
-    _vdata_assoc[new_data._vdata]._might_have_unused = true;
+    _vdata_assoc[result]._might_have_unused = true;
     _vdata_assoc[sv._vertex_data]._might_have_unused = true;
   }
 
@@ -197,6 +237,7 @@ transform_texcoords(Geom *geom, const InternalName *from_name,
   PStatTimer timer(_apply_texcoord_collector);
 
   nassertr(geom != (Geom *)NULL, false);
+  ReMutexHolder holder(_lock);
 
   SourceTexCoords st;
   st._mat = mat;
@@ -289,6 +330,7 @@ transform_texcoords(GeomNode *node, const InternalName *from_name,
 bool GeomTransformer::
 set_color(Geom *geom, const LColor &color) {
   PStatTimer timer(_apply_set_color_collector);
+  ReMutexHolder holder(_lock);
 
   SourceColors sc;
   sc._color = color;
@@ -354,6 +396,7 @@ transform_colors(Geom *geom, const LVecBase4 &scale) {
   PStatTimer timer(_apply_scale_color_collector);
 
   nassertr(geom != (Geom *)NULL, false);
+  ReMutexHolder holder(_lock);
 
   SourceColors sc;
   sc._color = scale;
@@ -425,6 +468,7 @@ apply_texture_colors(Geom *geom, TextureStage *ts, Texture *tex,
   PStatTimer timer(_apply_texture_color_collector);
 
   nassertr(geom != (Geom *)NULL, false);
+  ReMutexHolder holder(_lock);
 
   PT(TexturePeeker) peeker = tex->peek();
   if (peeker == (TexturePeeker *)NULL) {
@@ -712,6 +756,7 @@ set_format(Geom *geom, const GeomVertexFormat *new_format) {
   PStatTimer timer(_apply_set_format_collector);
 
   nassertr(geom != (Geom *)NULL, false);
+  ReMutexHolder holder(_lock);
 
   SourceFormat sf;
   sf._format = new_format;
@@ -885,6 +930,7 @@ make_compatible_state(GeomNode *node) {
 bool GeomTransformer::
 reverse_normals(Geom *geom) {
   nassertr(geom != (Geom *)NULL, false);
+  ReMutexHolder holder(_lock);
   CPT(GeomVertexData) orig_data = geom->get_vertex_data();
   NewVertexData &new_data = _reversed_normals[orig_data];
   if (new_data._vdata.is_null()) {
@@ -980,6 +1026,127 @@ reverse(GeomNode *node) {
   return (num_geoms != 0);
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: GeomTransformer::optimize_vertex_cache
+//       Access: Public
+//  Description: Reorders the triangles of each Geom in the GeomNode
+//               for the post-transform vertex cache (see
+//               Geom::optimize_vertex_cache()), and then renumbers
+//               the vertices of each GeomVertexData in the order the
+//               triangles first use them, so that vertex fetches
+//               also walk through memory in order.
+//
+//               All the Geoms in the node that share a
+//               GeomVertexData continue to share the renumbered
+//               one, as do Geoms in other nodes processed by the
+//               same GeomTransformer.  Vertices that are animated by
+//               a TransformBlendTable or SliderTable are not
+//               renumbered.
+////////////////////////////////////////////////////////////////////
+bool GeomTransformer::
+optimize_vertex_cache(GeomNode *node, int cache_size, bool sort_for_overdraw) {
+  GeomNode::CDWriter cdata(node->_cycler);
+  GeomNode::GeomList::iterator gi;
+  PT(GeomNode::GeomList) geoms = cdata->modify_geoms();
+  if (geoms->empty()) {
+    return false;
+  }
+
+  // First, reorder the triangles within each Geom.
+  for (gi = geoms->begin(); gi != geoms->end(); ++gi) {
+    GeomNode::GeomEntry &entry = (*gi);
+    entry._geom = entry._geom.get_read_pointer()->optimize_vertex_cache(cache_size, sort_for_overdraw);
+  }
+
+  // Now renumber the vertices.
+  for (gi = geoms->begin(); gi != geoms->end(); ++gi) {
+    GeomNode::GeomEntry &entry = (*gi);
+    PT(Geom) geom = entry._geom.get_write_pointer();
+    CPT(GeomVertexData) vdata = geom->get_vertex_data();
+
+    NewReordered::iterator ri = _reordered.find(vdata);
+    if (ri == _reordered.end()) {
+      ri = _reordered.insert(NewReordered::value_type(vdata, ReorderedVertices())).first;
+      ReorderedVertices &reordered = (*ri).second;
+
+      bool can_reorder = (vdata->get_transform_blend_table() == (TransformBlendTable *)NULL &&
+                          vdata->get_slider_table() == (SliderTable *)NULL);
+
+      // Number the vertices in the order they are first used by the
+      // Geoms in this node that share this vdata.
+      int num_rows = vdata->get_num_rows();
+      vector_int &remap = reordered._remap;
+      remap.assign(num_rows, -1);
+      int next_row = 0;
+      GeomNode::GeomList::const_iterator gj;
+      for (gj = gi; gj != geoms->end() && can_reorder; ++gj) {
+        CPT(Geom) other = (*gj)._geom.get_read_pointer();
+        if (other->get_vertex_data() != vdata) {
+          continue;
+        }
+        int num_primitives = other->get_num_primitives();
+        for (int p = 0; p < num_primitives && can_reorder; ++p) {
+          CPT(GeomPrimitive) prim = other->get_primitive(p);
+          if (!prim->is_indexed()) {
+            // A nonindexed primitive depends on its vertices being
+            // consecutive.
+            can_reorder = false;
+            break;
+          }
+          int num_vertices = prim->get_num_vertices();
+          for (int i = 0; i < num_vertices; ++i) {
+            int v = prim->get_vertex(i);
+            if (remap[v] < 0) {
+              remap[v] = next_row++;
+            }
+          }
+        }
+      }
+
+      if (can_reorder) {
+        // Any unused vertices go at the end.
+        for (int v = 0; v < num_rows; ++v) {
+          if (remap[v] < 0) {
+            remap[v] = next_row++;
+          }
+        }
+
+        PT(GeomVertexData) new_data = new GeomVertexData(*vdata);
+        int num_arrays = vdata->get_num_arrays();
+        for (int a = 0; a < num_arrays; ++a) {
+          CPT(GeomVertexArrayData) from_array = vdata->get_array(a);
+          int stride = from_array->get_array_format()->get_stride();
+          CPT(GeomVertexArrayDataHandle) from = from_array->get_handle();
+          PT(GeomVertexArrayDataHandle) to = new_data->modify_array(a)->modify_handle();
+          const unsigned char *from_pointer = from->get_read_pointer(true);
+          unsigned char *to_pointer = to->get_write_pointer();
+          for (int v = 0; v < num_rows; ++v) {
+            memcpy(to_pointer + remap[v] * stride, from_pointer + v * stride, stride);
+          }
+        }
+        reordered._vdata = new_data;
+      }
+    }
+
+    const ReorderedVertices &reordered = (*ri).second;
+    if (reordered._vdata == (GeomVertexData *)NULL) {
+      continue;
+    }
+
+    int num_primitives = geom->get_num_primitives();
+    for (int p = 0; p < num_primitives; ++p) {
+      PT(GeomPrimitive) prim = geom->modify_primitive(p);
+      GeomVertexRewriter index(prim->modify_vertices(), 0);
+      while (!index.is_at_end()) {
+        index.set_data1i(reordered._remap[index.get_data1i()]);
+      }
+    }
+    geom->set_vertex_data(reordered._vdata);
+  }
+
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeomTransformer::finish_apply
 //       Access: Public
@@ -1009,6 +1176,7 @@ finish_apply() {
   _tcolors.clear();
   _format.clear();
   _reversed_normals.clear();
+  _reordered.clear();
 }
   
 ////////////////////////////////////////////////////////////////////
@@ -1189,17 +1357,43 @@ int GeomTransformer::
 finish_collect(bool format_only) {
   int num_adjusted = 0;
 
+  // Each NewCollectedData builds its own GeomVertexData from its own
+  // set of Geoms, so they may be built in parallel.  Those with
+  // animation tables are built afterwards, one at a time, since they
+  // register new tables.
+  CollectBatch batch(format_only);
+  NewCollectedList serial_list;
   NewCollectedList::iterator nci;
   for (nci = _new_collected_list.begin(); 
        nci != _new_collected_list.end();
        ++nci) {
     NewCollectedData *ncd = (*nci);
+    if (ncd->has_animation_tables()) {
+      serial_list.push_back(ncd);
+    } else {
+      batch._list.push_back(ncd);
+    }
+  }
+
+  batch._results.assign(batch._list.size(), 0);
+  batch.run((int)batch._list.size());
+  for (size_t i = 0; i < batch._list.size(); ++i) {
+    num_adjusted += batch._results[i];
+  }
+
+  for (nci = serial_list.begin(); nci != serial_list.end(); ++nci) {
+    NewCollectedData *ncd = (*nci);
     if (format_only) {
       num_adjusted += ncd->apply_format_only_changes();
     } else {
       num_adjusted += ncd->apply_collect_changes();
     }
-    delete ncd;
+  }
+
+  for (nci = _new_collected_list.begin(); 
+       nci != _new_collected_list.end();
+       ++nci) {
+    delete (*nci);
   }
 
   _new_collected_list.clear();
@@ -1249,6 +1443,27 @@ NewCollectedData(const GeomVertexData *source_data) {
   _num_vertices = 0;
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: GeomTransformer::NewCollectedData::has_animation_tables
+//       Access: Public
+//  Description: Returns true if any of the source datas carries a
+//               TransformTable, TransformBlendTable or SliderTable,
+//               which must be merged into a newly registered table.
+////////////////////////////////////////////////////////////////////
+bool GeomTransformer::NewCollectedData::
+has_animation_tables() const {
+  SourceDatas::const_iterator sdi;
+  for (sdi = _source_datas.begin(); sdi != _source_datas.end(); ++sdi) {
+    const GeomVertexData *vdata = (*sdi)._vdata;
+    if (vdata->get_transform_table() != (TransformTable *)NULL ||
+        vdata->get_transform_blend_table() != (TransformBlendTable *)NULL ||
+        vdata->get_slider_table() != (SliderTable *)NULL) {
+      return true;
+    }
+  }
+  return false;
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: GeomTransformer::NewCollectedData::apply_format_only_changes
 //       Access: Public
@@ -1677,3 +1892,29 @@ remove_unused_vertices(const GeomVertexData *vdata) {
     geom->set_vertex_data(new_vdata);
   }
 }
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomTransformer::CollectBatch::Constructor
+//       Access: Public
+//  Description:
+////////////////////////////////////////////////////////////////////
+GeomTransformer::CollectBatch::
+CollectBatch(bool format_only) :
+  _format_only(format_only)
+{
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: GeomTransformer::CollectBatch::do_job
+//       Access: Protected, Virtual
+//  Description: Applies the changes for the nth NewCollectedData.
+////////////////////////////////////////////////////////////////////
+void GeomTransformer::CollectBatch::
+do_job(int n) {
+  NewCollectedData *ncd = _list[n];
+  if (_format_only) {
+    _results[n] = ncd->apply_format_only_changes();
+  } else {
+    _results[n] = ncd->apply_collect_changes();
+  }
+}
@@ -20,6 +20,8 @@
 #include "luse.h"
 #include "geom.h"
 #include "geomVertexData.h"
+#include "vector_int.h"
+#include "reMutex.h"
 
 class GeomNode;
 class RenderState;
@@ -86,6 +88,9 @@ public:
   bool doubleside(GeomNode *node);
   bool reverse(GeomNode *node);
 
+  bool optimize_vertex_cache(GeomNode *node, int cache_size,
+                             bool sort_for_overdraw);
+
   void finish_apply();
 
   int collect_vertex_data(Geom *geom, int collect_bits, bool format_only);
@@ -97,6 +102,11 @@ public:
 private:
   int _max_collect_vertices;
 
+  // This protects the tables below, so that a SceneGraphReducer may
+  // apply attribs to several subgraphs at once with the same
+  // GeomTransformer.
+  ReMutex _lock;
+
   typedef pvector<PT(Geom) > GeomList;
 
   // Keeps track of the Geoms that are associated with a particular
@@ -196,6 +206,18 @@ private:
   typedef pmap<CPT(GeomVertexData), NewVertexData> ReversedNormals;
   ReversedNormals _reversed_normals;
 
+  // The table of GeomVertexData objects whose vertices have been
+  // renumbered by optimize_vertex_cache(), along with the mapping from
+  // old vertex numbers to new.  _vdata is NULL if the vertices could
+  // not be renumbered.
+  class ReorderedVertices {
+  public:
+    CPT(GeomVertexData) _vdata;
+    vector_int _remap;
+  };
+  typedef pmap<CPT(GeomVertexData), ReorderedVertices> NewReordered;
+  NewReordered _reordered;
+
   class NewCollectedKey {
   public:
     INLINE bool operator < (const NewCollectedKey &other) const;
@@ -224,6 +246,7 @@ private:
 
     NewCollectedData(const GeomVertexData *source_data);
     void add_source_data(const GeomVertexData *source_data);
+    bool has_animation_tables() const;
     int apply_format_only_changes();
     int apply_collect_changes();
 
@@ -258,6 +281,7 @@ private:
     static TypeHandle _type_handle;
   };
   typedef pvector<NewCollectedData *> NewCollectedList;
+  class CollectBatch;
   typedef pmap<NewCollectedKey, NewCollectedData *> NewCollectedMap;
   NewCollectedList _new_collected_list;
   NewCollectedMap _new_collected_map;
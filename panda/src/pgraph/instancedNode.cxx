@@ -0,0 +1,914 @@
+// Filename: instancedNode.cxx
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#include "instancedNode.h"
+#include "config_pgraph.h"
+#include "cullTraverser.h"
+#include "cullTraverserData.h"
+#include "cullableObject.h"
+#include "cullHandler.h"
+#include "shaderAttrib.h"
+#include "transformState.h"
+#include "graphicsStateGuardianBase.h"
+#include "boundingSphere.h"
+#include "boundingBox.h"
+#include "boundingHexahedron.h"
+#include "geomVertexData.h"
+#include "geomVertexArrayData.h"
+#include "geomPrimitive.h"
+#include "pta_LMatrix4.h"
+#include "clockObject.h"
+#include "cmath.h"
+#include "datagram.h"
+#include "datagramIterator.h"
+#include "bamReader.h"
+#include "bamWriter.h"
+
+TypeHandle InstancedNode::_type_handle;
+PT(InternalName) InstancedNode::_transforms_name;
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::Constructor
+//       Access: Published
+//  Description:
+////////////////////////////////////////////////////////////////////
+InstancedNode::
+InstancedNode(const string &name) :
+  PandaNode(name),
+  _geom_state(RenderState::make_empty()),
+  _bounds_stale(true),
+  _geom_radius(0.0f),
+  _geom_is_box(false),
+  _geom_bounds_empty(true)
+{
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::Copy Constructor
+//       Access: Protected
+//  Description:
+////////////////////////////////////////////////////////////////////
+InstancedNode::
+InstancedNode(const InstancedNode &copy) :
+  PandaNode(copy),
+  _bounds_stale(true),
+  _geom_radius(0.0f),
+  _geom_is_box(false),
+  _geom_bounds_empty(true)
+{
+  LightMutexHolder holder(copy._lock);
+  _geom = copy._geom;
+  _geom_state = copy._geom_state;
+  _instances = copy._instances;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::Destructor
+//       Access: Public, Virtual
+//  Description:
+////////////////////////////////////////////////////////////////////
+InstancedNode::
+~InstancedNode() {
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::make_copy
+//       Access: Public, Virtual
+//  Description: Returns a newly-allocated Node that is a shallow copy
+//               of this one.  It will be a different Node pointer,
+//               but its internal data may or may not be shared with
+//               that of the original Node.
+////////////////////////////////////////////////////////////////////
+PandaNode *InstancedNode::
+make_copy() const {
+  return new InstancedNode(*this);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::safe_to_combine
+//       Access: Public, Virtual
+//  Description: Returns true if it is generally safe to combine this
+//               particular kind of PandaNode with other kinds of
+//               PandaNodes of compatible type, adding children or
+//               whatever.  For instance, an LODNode should not be
+//               combined with any other PandaNode, because its set of
+//               children is meaningful.
+////////////////////////////////////////////////////////////////////
+bool InstancedNode::
+safe_to_combine() const {
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::xform
+//       Access: Public, Virtual
+//  Description: Transforms the contents of this node by the indicated
+//               matrix, if it means anything to do so.  For an
+//               InstancedNode, this applies the matrix to each of
+//               the instance transforms; the Geom itself is left
+//               alone.
+////////////////////////////////////////////////////////////////////
+void InstancedNode::
+xform(const LMatrix4 &mat) {
+  LightMutexHolder holder(_lock);
+  Instances::iterator ii;
+  for (ii = _instances.begin(); ii != _instances.end(); ++ii) {
+    (*ii) = (*ii) * mat;
+  }
+  _bounds_stale = true;
+  _region_caches.clear();
+  mark_internal_bounds_stale();
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::is_renderable
+//       Access: Public, Virtual
+//  Description: Returns true if there is some value to visiting this
+//               particular node during the cull traversal for any
+//               camera, false otherwise.  This will be used to
+//               optimize the result of get_net_draw_show_mask(), so
+//               that any subgraphs that contain nothing renderable
+//               can be quickly pruned.
+////////////////////////////////////////////////////////////////////
+bool InstancedNode::
+is_renderable() const {
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::add_for_draw
+//       Access: Public, Virtual
+//  Description: Adds the node's contents to the CullResult we are
+//               building up during the cull traversal, so that it
+//               will be drawn at render time.
+//
+//               The instances that survive the frustum test are
+//               grouped into batches of instanced-node-batch-size,
+//               and each batch becomes one CullableObject.
+////////////////////////////////////////////////////////////////////
+void InstancedNode::
+add_for_draw(CullTraverser *trav, CullTraverserData &data) {
+  trav->_geom_nodes_pcollector.add_level(1);
+
+  CPT(RenderState) state;
+  {
+    LightMutexHolder holder(_lock);
+    if (_geom == (Geom *)NULL || _geom->is_empty() || _instances.empty()) {
+      return;
+    }
+    state = data._state->compose(_geom_state);
+  }
+
+  if (state->has_cull_callback() && !state->cull_callback(trav, data)) {
+    // Cull.
+    return;
+  }
+
+  // We can only use hardware instancing if there is a shader to read
+  // the instance transforms.
+  const ShaderAttrib *sattr = DCAST(ShaderAttrib, state->get_attrib_def(ShaderAttrib::get_class_slot()));
+  bool hardware = (sattr->get_shader() != (Shader *)NULL &&
+                   trav->get_gsg()->get_supports_geometry_instancing());
+
+  Thread *current_thread = trav->get_current_thread();
+  DrawBatches batches;
+  make_batches(batches, state, data._view_frustum, hardware,
+               trav->get_scene()->get_display_region(), current_thread);
+  if (batches.empty()) {
+    return;
+  }
+  trav->_geoms_pcollector.add_level(batches.size());
+
+  CPT(TransformState) net_transform = data.get_net_transform(trav);
+  CPT(TransformState) modelview_transform = data.get_modelview_transform(trav);
+  CPT(TransformState) internal_transform = trav->get_scene()->get_cs_transform()->compose(modelview_transform);
+
+  DrawBatches::const_iterator bi;
+  for (bi = batches.begin(); bi != batches.end(); ++bi) {
+    CullableObject *object =
+      new CullableObject((*bi)._geom, (*bi)._state,
+                         net_transform, modelview_transform,
+                         internal_transform);
+    trav->get_cull_handler()->record_object(object, trav);
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::make_batches
+//       Access: Public
+//  Description: Does the work of add_for_draw(): culls the instances
+//               against the view frustum, which is in the node's
+//               coordinate space (or NULL to draw all of them), and
+//               adds one DrawBatch to batches for each batch of
+//               visible instances.  state is the net state of the
+//               node, already composed with the Geom's state.
+//
+//               If hardware is true, each batch draws the Geom
+//               itself, with its instance count and transforms in
+//               the ShaderAttrib; otherwise, each batch draws an
+//               expanded Geom.  The batches are cached for the
+//               indicated DisplayRegion from frame to frame.
+////////////////////////////////////////////////////////////////////
+void InstancedNode::
+make_batches(DrawBatches &batches, const RenderState *state,
+             const GeometricBoundingVolume *view_frustum, bool hardware,
+             const DisplayRegion *region, Thread *current_thread) {
+  int frame = ClockObject::get_global_clock()->get_frame_count(current_thread);
+
+  // Cull the instances and copy out what is needed to draw them
+  // with the node locked.  The batches are built afterwards with only
+  // this DisplayRegion's cache locked, so that other threads may
+  // cull the node for other DisplayRegions in the meantime.
+  CPT(Geom) geom;
+  Indices visible;
+  Instances transforms;
+  PT(RegionCache) cache;
+  {
+    LightMutexHolder holder(_lock);
+    if (_geom == (Geom *)NULL || _geom->is_empty() || _instances.empty()) {
+      return;
+    }
+    if (_bounds_stale) {
+      do_update_bounds();
+    }
+
+    do_cull_instances(visible, view_frustum);
+    if (visible.empty()) {
+      return;
+    }
+    transforms.reserve(visible.size());
+    Indices::const_iterator vi;
+    for (vi = visible.begin(); vi != visible.end(); ++vi) {
+      transforms.push_back(_instances[*vi]);
+    }
+
+    geom = _geom;
+    cache = do_get_region_cache(region, frame);
+  }
+
+  int num_visible = (int)visible.size();
+  int batch_size = max((int)instanced_node_batch_size, 1);
+  int num_batches = (num_visible + batch_size - 1) / batch_size;
+  int set = (frame & 1);
+
+  LightMutexHolder holder(cache->_lock);
+  cache->_batches.resize(num_batches);
+  batches.reserve(batches.size() + num_batches);
+
+  for (int b = 0; b < num_batches; ++b) {
+    const int *indices = &visible[b * batch_size];
+    const LMatrix4 *batch_transforms = &transforms[b * batch_size];
+    int num_indices = min(batch_size, num_visible - b * batch_size);
+    CachedBatch &cached = cache->_batches[b];
+
+    DrawBatch batch;
+    if (hardware) {
+      cached._indices.clear();
+      cached._expanded.clear();
+
+      // The shader declares an array of batch_size matrices, and the
+      // GSG uploads that many, so the last, partial batch is padded
+      // out with identity matrices.  The state refers to the array,
+      // so it needs to be made again only if the state or the number
+      // of instances has changed.
+      PTA_LMatrix4 &pta = cached._transforms[set];
+      if (cached._state[set] == (RenderState *)NULL ||
+          cached._base_state[set] != state ||
+          cached._num_instances[set] != num_indices ||
+          (int)pta.size() != batch_size) {
+        pta = PTA_LMatrix4::empty_array(batch_size);
+        const ShaderAttrib *sattr = DCAST(ShaderAttrib, state->get_attrib_def(ShaderAttrib::get_class_slot()));
+        CPT(RenderAttrib) batch_sattr =
+          DCAST(ShaderAttrib, sattr->set_instance_count(num_indices))
+          ->set_shader_input(get_transforms_name(), pta);
+        cached._state[set] = state->set_attrib(batch_sattr);
+        cached._base_state[set] = state;
+        cached._num_instances[set] = num_indices;
+      }
+
+      for (int i = 0; i < num_indices; ++i) {
+        pta[i] = batch_transforms[i];
+      }
+      for (int i = num_indices; i < batch_size; ++i) {
+        pta[i] = LMatrix4::ident_mat();
+      }
+
+      batch._geom = geom;
+      batch._state = cached._state[set];
+
+    } else {
+      if (cached._expanded == (Geom *)NULL ||
+          (int)cached._indices.size() != num_indices ||
+          !equal(cached._indices.begin(), cached._indices.end(), indices)) {
+        cached._indices.assign(indices, indices + num_indices);
+        cached._expanded = make_expanded_geom(geom, batch_transforms,
+                                              num_indices, current_thread);
+      }
+
+      batch._geom = cached._expanded;
+      batch._state = state;
+    }
+
+    batches.push_back(batch);
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::output
+//       Access: Public, Virtual
+//  Description:
+////////////////////////////////////////////////////////////////////
+void InstancedNode::
+output(ostream &out) const {
+  PandaNode::output(out);
+  LightMutexHolder holder(_lock);
+  out << " (" << _instances.size() << " instances)";
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::set_geom
+//       Access: Published
+//  Description: Specifies the Geom that is drawn at each instance,
+//               and the state with which it is drawn.
+//
+//               If the state includes a shader, and the GSG supports
+//               it, the instances are drawn with hardware instancing;
+//               in this case the shader is responsible for applying
+//               the instance transforms; see get_transforms_name().
+////////////////////////////////////////////////////////////////////
+void InstancedNode::
+set_geom(const Geom *geom, const RenderState *state) {
+  LightMutexHolder holder(_lock);
+  _geom = geom;
+  _geom_state = state;
+  do_geom_changed();
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::add_instance
+//       Access: Published
+//  Description: Adds a new instance of the Geom, with the indicated
+//               transform relative to this node.  Returns the index
+//               of the new instance.
+////////////////////////////////////////////////////////////////////
+int InstancedNode::
+add_instance(const LMatrix4 &mat) {
+  LightMutexHolder holder(_lock);
+  int n = (int)_instances.size();
+  _instances.push_back(mat);
+  if (!_bounds_stale) {
+    _center_x.push_back(0.0f);
+    _center_y.push_back(0.0f);
+    _center_z.push_back(0.0f);
+    _radius.push_back(0.0f);
+    do_compute_instance_bounds(n);
+  }
+  _region_caches.clear();
+  mark_internal_bounds_stale();
+  return n;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::set_instance
+//       Access: Published
+//  Description: Replaces the transform of the nth instance.
+////////////////////////////////////////////////////////////////////
+void InstancedNode::
+set_instance(int n, const LMatrix4 &mat) {
+  LightMutexHolder holder(_lock);
+  nassertv(n >= 0 && n < (int)_instances.size());
+  _instances[n] = mat;
+  if (!_bounds_stale) {
+    do_compute_instance_bounds(n);
+  }
+  _region_caches.clear();
+  mark_internal_bounds_stale();
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::remove_instance
+//       Access: Published
+//  Description: Removes the nth instance.  The indices of the
+//               instances that follow it are shifted down by one.
+////////////////////////////////////////////////////////////////////
+void InstancedNode::
+remove_instance(int n) {
+  LightMutexHolder holder(_lock);
+  nassertv(n >= 0 && n < (int)_instances.size());
+  _instances.erase(_instances.begin() + n);
+  if (!_bounds_stale) {
+    _center_x.erase(_center_x.begin() + n);
+    _center_y.erase(_center_y.begin() + n);
+    _center_z.erase(_center_z.begin() + n);
+    _radius.erase(_radius.begin() + n);
+  }
+  _region_caches.clear();
+  mark_internal_bounds_stale();
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::clear_instances
+//       Access: Published
+//  Description: Removes all of the instances.
+////////////////////////////////////////////////////////////////////
+void InstancedNode::
+clear_instances() {
+  LightMutexHolder holder(_lock);
+  _instances.clear();
+  _center_x.clear();
+  _center_y.clear();
+  _center_z.clear();
+  _radius.clear();
+  _region_caches.clear();
+  mark_internal_bounds_stale();
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::compute_internal_bounds
+//       Access: Protected, Virtual
+//  Description: Called when needed to recompute the node's
+//               _internal_bound object.  This is a box around the
+//               bounding spheres of all of the instances.
+////////////////////////////////////////////////////////////////////
+void InstancedNode::
+compute_internal_bounds(CPT(BoundingVolume) &internal_bounds,
+                        int &internal_vertices,
+                        int pipeline_stage,
+                        Thread *current_thread) const {
+  LightMutexHolder holder(_lock);
+  if (_bounds_stale) {
+    do_update_bounds();
+  }
+
+  int num_instances = (int)_instances.size();
+  if (_geom_bounds_empty || num_instances == 0) {
+    internal_bounds = new BoundingSphere;
+    internal_vertices = 0;
+    return;
+  }
+
+  LPoint3 min_point(_center_x[0] - _radius[0],
+                    _center_y[0] - _radius[0],
+                    _center_z[0] - _radius[0]);
+  LPoint3 max_point(_center_x[0] + _radius[0],
+                    _center_y[0] + _radius[0],
+                    _center_z[0] + _radius[0]);
+  for (int i = 1; i < num_instances; ++i) {
+    PN_stdfloat r = _radius[i];
+    min_point.set(min(min_point[0], _center_x[i] - r),
+                  min(min_point[1], _center_y[i] - r),
+                  min(min_point[2], _center_z[i] - r));
+    max_point.set(max(max_point[0], _center_x[i] + r),
+                  max(max_point[1], _center_y[i] + r),
+                  max(max_point[2], _center_z[i] + r));
+  }
+
+  internal_bounds = new BoundingBox(min_point, max_point);
+  internal_vertices = _geom->get_nested_vertices(current_thread) * num_instances;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::do_geom_changed
+//       Access: Private
+//  Description: Called with the lock held when the Geom or its state
+//               has changed.
+////////////////////////////////////////////////////////////////////
+void InstancedNode::
+do_geom_changed() {
+  _bounds_stale = true;
+  _region_caches.clear();
+  mark_internal_bounds_stale();
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::do_update_bounds
+//       Access: Private
+//  Description: Recomputes the bounding sphere of the Geom and of
+//               each instance.  Assumes the lock is held.
+////////////////////////////////////////////////////////////////////
+void InstancedNode::
+do_update_bounds() const {
+  _geom_bounds_empty = true;
+  _geom_center = LPoint3::zero();
+  _geom_radius = 0.0f;
+  _geom_half_size = LVecBase3::zero();
+  _geom_is_box = false;
+
+  if (_geom != (Geom *)NULL) {
+    CPT(BoundingVolume) bounds = _geom->get_bounds();
+    if (bounds->is_infinite()) {
+      // There's no sensible finite sphere; make it big enough that no
+      // instance is ever culled.
+      _geom_bounds_empty = false;
+      _geom_radius = 1.0e30f;
+
+    } else if (!bounds->is_empty()) {
+      if (bounds->is_of_type(BoundingSphere::get_class_type())) {
+        const BoundingSphere *sphere = DCAST(BoundingSphere, bounds);
+        _geom_center = sphere->get_center();
+        _geom_radius = sphere->get_radius();
+        _geom_bounds_empty = false;
+
+      } else if (bounds->is_of_type(FiniteBoundingVolume::get_class_type())) {
+        const FiniteBoundingVolume *fbv = DCAST(FiniteBoundingVolume, bounds);
+        LPoint3 min_point = fbv->get_min();
+        LPoint3 max_point = fbv->get_max();
+        _geom_center = (min_point + max_point) * 0.5f;
+        _geom_half_size = (max_point - min_point) * 0.5f;
+        _geom_radius = _geom_half_size.length();
+        _geom_is_box = true;
+        _geom_bounds_empty = false;
+      }
+    }
+  }
+
+  int num_instances = (int)_instances.size();
+  _center_x.resize(num_instances);
+  _center_y.resize(num_instances);
+  _center_z.resize(num_instances);
+  _radius.resize(num_instances);
+  for (int i = 0; i < num_instances; ++i) {
+    do_compute_instance_bounds(i);
+  }
+
+  _bounds_stale = false;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::do_compute_instance_bounds
+//       Access: Private
+//  Description: Recomputes the bounding sphere of the nth instance
+//               from the bounding sphere of the Geom.  Assumes the
+//               lock is held and the Geom bounds are up to date.
+////////////////////////////////////////////////////////////////////
+void InstancedNode::
+do_compute_instance_bounds(int n) const {
+  const LMatrix4 &mat = _instances[n];
+  LPoint3 center = _geom_center * mat;
+
+  PN_stdfloat radius;
+  if (_geom_is_box) {
+    // The box becomes a parallelepiped around the new center; the
+    // sphere must reach its farthest corner.  Opposite corners are
+    // the same distance away, so only four need to be checked.
+    const LVecBase3 &h = _geom_half_size;
+    PN_stdfloat dist2 = mat.xform_vec(LVector3(h[0], h[1], h[2])).length_squared();
+    dist2 = max(dist2, mat.xform_vec(LVector3(-h[0], h[1], h[2])).length_squared());
+    dist2 = max(dist2, mat.xform_vec(LVector3(h[0], -h[1], h[2])).length_squared());
+    dist2 = max(dist2, mat.xform_vec(LVector3(h[0], h[1], -h[2])).length_squared());
+    radius = csqrt(dist2);
+
+  } else {
+    // A sphere is stretched by at most the largest singular value of
+    // the upper 3x3, which covers shears as well as nonuniform
+    // scales.
+    radius = _geom_radius * csqrt(max_stretch_squared(mat));
+  }
+
+  _center_x[n] = center[0];
+  _center_y[n] = center[1];
+  _center_z[n] = center[2];
+  _radius[n] = radius;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::max_stretch_squared
+//       Access: Private, Static
+//  Description: Returns the square of the largest factor by which the
+//               upper 3x3 of the matrix can lengthen a vector: the
+//               largest eigenvalue of M * M^T.  The result is rounded
+//               up slightly, so that it is safe to use as a bound.
+////////////////////////////////////////////////////////////////////
+PN_stdfloat InstancedNode::
+max_stretch_squared(const LMatrix4 &mat) {
+  // Build the symmetric matrix A = M * M^T.
+  double a[3][3];
+  for (int i = 0; i < 3; ++i) {
+    for (int j = i; j < 3; ++j) {
+      a[i][j] = a[j][i] =
+        (double)mat(i, 0) * mat(j, 0) +
+        (double)mat(i, 1) * mat(j, 1) +
+        (double)mat(i, 2) * mat(j, 2);
+    }
+  }
+
+  double lambda;
+  double p1 = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+  if (p1 == 0.0) {
+    // A is diagonal.
+    lambda = max(max(a[0][0], a[1][1]), a[2][2]);
+
+  } else {
+    // The closed-form solution for the eigenvalues of a symmetric
+    // 3x3 matrix (O. K. Smith, 1961).
+    double q = (a[0][0] + a[1][1] + a[2][2]) / 3.0;
+    double p2 = (a[0][0] - q) * (a[0][0] - q) +
+      (a[1][1] - q) * (a[1][1] - q) +
+      (a[2][2] - q) * (a[2][2] - q) + 2.0 * p1;
+    double p = sqrt(p2 / 6.0);
+
+    double b[3][3];
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        b[i][j] = (a[i][j] - (i == j ? q : 0.0)) / p;
+      }
+    }
+    double r = 0.5 *
+      (b[0][0] * (b[1][1] * b[2][2] - b[1][2] * b[2][1]) -
+       b[0][1] * (b[1][0] * b[2][2] - b[1][2] * b[2][0]) +
+       b[0][2] * (b[1][0] * b[2][1] - b[1][1] * b[2][0]));
+    r = max(-1.0, min(r, 1.0));
+    lambda = q + 2.0 * p * cos(acos(r) / 3.0);
+  }
+
+  return (PN_stdfloat)(lambda * (1.0 + 1.0e-5));
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::do_cull_instances
+//       Access: Private
+//  Description: Fills visible with the indices of the instances that
+//               are at least partly within the indicated frustum,
+//               which is in the node's coordinate space.  Assumes
+//               the lock is held and the bounds are up to date.
+////////////////////////////////////////////////////////////////////
+void InstancedNode::
+do_cull_instances(Indices &visible,
+                  const GeometricBoundingVolume *frustum) const {
+  int num_instances = (int)_instances.size();
+  visible.reserve(num_instances);
+
+  if (_geom_bounds_empty) {
+    return;
+  }
+
+  if (frustum == (GeometricBoundingVolume *)NULL) {
+    // The node is entirely within the frustum, so all of the
+    // instances are too.
+    for (int i = 0; i < num_instances; ++i) {
+      visible.push_back(i);
+    }
+    return;
+  }
+
+  if (!frustum->is_exact_type(BoundingHexahedron::get_class_type())) {
+    // Some other kind of volume; fall back to the general test.
+    for (int i = 0; i < num_instances; ++i) {
+      BoundingSphere sphere(LPoint3(_center_x[i], _center_y[i], _center_z[i]),
+                            _radius[i]);
+      if (frustum->contains(&sphere) != BoundingVolume::IF_no_intersection) {
+        visible.push_back(i);
+      }
+    }
+    return;
+  }
+
+  // The usual case: a hexahedron made of six planes, each with its
+  // normal pointing out.  A sphere is outside if it is entirely in
+  // front of any one plane.  This loop has no branches within it, so
+  // the compiler is free to vectorize it.
+  const BoundingHexahedron *hexahedron = DCAST(BoundingHexahedron, frustum);
+  static const int num_planes = 6;
+  nassertv(hexahedron->get_num_planes() == num_planes);
+  PN_stdfloat pa[num_planes], pb[num_planes], pc[num_planes], pd[num_planes];
+  for (int p = 0; p < num_planes; ++p) {
+    LPlane plane = hexahedron->get_plane(p);
+    pa[p] = plane[0];
+    pb[p] = plane[1];
+    pc[p] = plane[2];
+    pd[p] = plane[3];
+  }
+
+  const PN_stdfloat *cx = &_center_x[0];
+  const PN_stdfloat *cy = &_center_y[0];
+  const PN_stdfloat *cz = &_center_z[0];
+  const PN_stdfloat *cr = &_radius[0];
+  for (int i = 0; i < num_instances; ++i) {
+    PN_stdfloat x = cx[i];
+    PN_stdfloat y = cy[i];
+    PN_stdfloat z = cz[i];
+    PN_stdfloat r = cr[i];
+    bool outside = false;
+    for (int p = 0; p < num_planes; ++p) {
+      outside |= (pa[p] * x + pb[p] * y + pc[p] * z + pd[p] > r);
+    }
+    if (!outside) {
+      visible.push_back(i);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::do_get_region_cache
+//       Access: Private
+//  Description: Returns the cache of batches for the indicated
+//               DisplayRegion, creating it if necessary, and marks it
+//               used in the indicated frame.  The caches of
+//               DisplayRegions that have not drawn the node for a few
+//               frames are dropped.  Assumes the lock is held.
+////////////////////////////////////////////////////////////////////
+PT(InstancedNode::RegionCache) InstancedNode::
+do_get_region_cache(const DisplayRegion *region, int frame) {
+  RegionCaches::iterator ci = _region_caches.begin();
+  while (ci != _region_caches.end()) {
+    RegionCaches::iterator next = ci;
+    ++next;
+    if (frame - (*ci).second->_last_frame > 2) {
+      _region_caches.erase(ci);
+    }
+    ci = next;
+  }
+
+  PT(RegionCache) &cache = _region_caches[region];
+  if (cache == (RegionCache *)NULL) {
+    cache = new RegionCache;
+  }
+  cache->_last_frame = frame;
+  return cache;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::CachedBatch::Constructor
+//       Access: Public
+//  Description:
+////////////////////////////////////////////////////////////////////
+InstancedNode::CachedBatch::
+CachedBatch() {
+  _num_instances[0] = 0;
+  _num_instances[1] = 0;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::make_expanded_geom
+//       Access: Private, Static
+//  Description: Returns a new Geom that contains one copy of the
+//               Geom's vertices for each of the indicated transforms,
+//               transformed by that matrix, and
+//               primitives that reference all of them.  This is used
+//               to draw a batch when the GSG can't draw it with
+//               hardware instancing.
+////////////////////////////////////////////////////////////////////
+PT(Geom) InstancedNode::
+make_expanded_geom(const Geom *orig_geom, const LMatrix4 *transforms,
+                   int num_transforms, Thread *current_thread) {
+  CPT(GeomVertexData) orig_vdata = orig_geom->get_vertex_data(current_thread);
+  int num_rows = orig_vdata->get_num_rows();
+
+  PT(GeomVertexData) vdata = new GeomVertexData(*orig_vdata);
+  vdata->set_usage_hint(Geom::UH_dynamic);
+  vdata->unclean_set_num_rows(num_rows * num_transforms);
+
+  int num_arrays = orig_vdata->get_num_arrays();
+  for (int a = 0; a < num_arrays; ++a) {
+    CPT(GeomVertexArrayData) from_array = orig_vdata->get_array(a);
+    CPT(GeomVertexArrayDataHandle) from = from_array->get_handle(current_thread);
+    PT(GeomVertexArrayDataHandle) to = vdata->modify_array(a)->modify_handle(current_thread);
+    size_t size = (size_t)num_rows * from_array->get_array_format()->get_stride();
+    for (int i = 0; i < num_transforms; ++i) {
+      to->copy_subdata_from(i * size, size, from, 0, size);
+    }
+  }
+
+  for (int i = 0; i < num_transforms; ++i) {
+    vdata->transform_vertices(transforms[i],
+                              i * num_rows, (i + 1) * num_rows);
+  }
+
+  PT(Geom) geom = new Geom(vdata);
+  int num_primitives = orig_geom->get_num_primitives();
+  for (int p = 0; p < num_primitives; ++p) {
+    CPT(GeomPrimitive) prim = orig_geom->get_primitive(p);
+    int num_sub = prim->get_num_primitives();
+
+    PT(GeomPrimitive) new_prim = prim->make_copy();
+    new_prim->clear_vertices();
+    if (num_rows * num_transforms > 0xffff) {
+      new_prim->set_index_type(GeomEnums::NT_uint32);
+    }
+    new_prim->reserve_num_vertices(prim->get_num_vertices() * num_transforms);
+
+    for (int i = 0; i < num_transforms; ++i) {
+      int offset = i * num_rows;
+      for (int s = 0; s < num_sub; ++s) {
+        int start = prim->get_primitive_start(s);
+        int end = prim->get_primitive_end(s);
+        for (int v = start; v < end; ++v) {
+          new_prim->add_vertex(prim->get_vertex(v) + offset);
+        }
+        new_prim->close_primitive();
+      }
+    }
+    geom->add_primitive(new_prim);
+  }
+
+  return geom;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::register_with_read_factory
+//       Access: Public, Static
+//  Description: Tells the BamReader how to create objects of type
+//               InstancedNode.
+////////////////////////////////////////////////////////////////////
+void InstancedNode::
+register_with_read_factory() {
+  BamReader::get_factory()->register_factory(get_class_type(), make_from_bam);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::write_datagram
+//       Access: Public, Virtual
+//  Description: Writes the contents of this object to the datagram
+//               for shipping out to a Bam file.
+////////////////////////////////////////////////////////////////////
+void InstancedNode::
+write_datagram(BamWriter *manager, Datagram &dg) {
+  PandaNode::write_datagram(manager, dg);
+
+  LightMutexHolder holder(_lock);
+  manager->write_pointer(dg, _geom);
+  manager->write_pointer(dg, _geom_state);
+
+  dg.add_uint32(_instances.size());
+  Instances::const_iterator ii;
+  for (ii = _instances.begin(); ii != _instances.end(); ++ii) {
+    (*ii).write_datagram(dg);
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::complete_pointers
+//       Access: Public, Virtual
+//  Description: Receives an array of pointers, one for each time
+//               manager->read_pointer() was called in fillin().
+//               Returns the number of pointers processed.
+////////////////////////////////////////////////////////////////////
+int InstancedNode::
+complete_pointers(TypedWritable **p_list, BamReader *manager) {
+  int pi = PandaNode::complete_pointers(p_list, manager);
+
+  _geom = DCAST(Geom, p_list[pi++]);
+  _geom_state = DCAST(RenderState, p_list[pi++]);
+  if (_geom_state == (RenderState *)NULL) {
+    _geom_state = RenderState::make_empty();
+  }
+
+  return pi;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::make_from_bam
+//       Access: Protected, Static
+//  Description: This function is called by the BamReader's factory
+//               when a new object of type InstancedNode is
+//               encountered in the Bam file.  It should create the
+//               InstancedNode and extract its information from the
+//               file.
+////////////////////////////////////////////////////////////////////
+TypedWritable *InstancedNode::
+make_from_bam(const FactoryParams &params) {
+  InstancedNode *node = new InstancedNode("");
+  DatagramIterator scan;
+  BamReader *manager;
+
+  parse_params(params, scan, manager);
+  node->fillin(scan, manager);
+
+  return node;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: InstancedNode::fillin
+//       Access: Protected
+//  Description: This internal function is called by make_from_bam to
+//               read in all of the relevant data from the BamFile for
+//               the new InstancedNode.
+////////////////////////////////////////////////////////////////////
+void InstancedNode::
+fillin(DatagramIterator &scan, BamReader *manager) {
+  PandaNode::fillin(scan, manager);
+
+  manager->read_pointer(scan);
+  manager->read_pointer(scan);
+
+  int num_instances = scan.get_uint32();
+  _instances.clear();
+  _instances.reserve(num_instances);
+  for (int i = 0; i < num_instances; ++i) {
+    LMatrix4 mat;
+    mat.read_datagram(scan);
+    _instances.push_back(mat);
+  }
+  _bounds_stale = true;
+}
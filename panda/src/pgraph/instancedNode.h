@@ -0,0 +1,226 @@
+// Filename: instancedNode.h
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#ifndef INSTANCEDNODE_H
+#define INSTANCEDNODE_H
+
+#include "pandabase.h"
+
+#include "pandaNode.h"
+#include "geom.h"
+#include "renderState.h"
+#include "internalName.h"
+#include "luse.h"
+#include "pvector.h"
+#include "pmap.h"
+#include "pta_LMatrix4.h"
+#include "referenceCount.h"
+#include "lightMutex.h"
+#include "lightMutexHolder.h"
+
+class GeometricBoundingVolume;
+class DisplayRegion;
+
+////////////////////////////////////////////////////////////////////
+//       Class : InstancedNode
+// Description : A node that draws many copies of the same Geom, each
+//               with its own transform, without requiring a separate
+//               PandaNode (and a separate CullableObject) per copy.
+//               This is intended for large numbers of identical
+//               objects, such as trees or rocks scattered over a
+//               terrain.
+//
+//               The instances are culled individually against the
+//               view frustum.  The visible instances are then drawn
+//               in batches of up to instanced-node-batch-size.  If
+//               the Geom's state includes a shader and the GSG
+//               supports geometry instancing, each batch is one
+//               instanced draw call; the shader receives the
+//               instance transforms in the mat4 array named by
+//               get_transforms_name(), to be indexed by
+//               gl_InstanceID.  Otherwise, each batch is expanded on
+//               the CPU into a single Geom containing all of its
+//               instances, which works with any GSG, including
+//               tinydisplay.
+////////////////////////////////////////////////////////////////////
+class EXPCL_PANDA_PGRAPH InstancedNode : public PandaNode {
+PUBLISHED:
+  InstancedNode(const string &name);
+
+protected:
+  InstancedNode(const InstancedNode &copy);
+
+public:
+  virtual ~InstancedNode();
+  virtual PandaNode *make_copy() const;
+  virtual bool safe_to_combine() const;
+  virtual void xform(const LMatrix4 &mat);
+
+  virtual bool is_renderable() const;
+  virtual void add_for_draw(CullTraverser *trav, CullTraverserData &data);
+
+  virtual void output(ostream &out) const;
+
+  // One batch of visible instances, as it should be drawn.
+  class DrawBatch {
+  public:
+    CPT(Geom) _geom;
+    CPT(RenderState) _state;
+  };
+  typedef pvector<DrawBatch> DrawBatches;
+
+  void make_batches(DrawBatches &batches, const RenderState *state,
+                    const GeometricBoundingVolume *view_frustum,
+                    bool hardware, const DisplayRegion *region,
+                    Thread *current_thread);
+
+PUBLISHED:
+  void set_geom(const Geom *geom,
+                const RenderState *state = RenderState::make_empty());
+  INLINE CPT(Geom) get_geom() const;
+  INLINE CPT(RenderState) get_geom_state() const;
+
+  int add_instance(const LMatrix4 &mat);
+  void set_instance(int n, const LMatrix4 &mat);
+  INLINE LMatrix4 get_instance(int n) const;
+  INLINE int get_num_instances() const;
+  MAKE_SEQ(get_instances, get_num_instances, get_instance);
+  void remove_instance(int n);
+  void clear_instances();
+
+  INLINE static const InternalName *get_transforms_name();
+
+protected:
+  virtual void compute_internal_bounds(CPT(BoundingVolume) &internal_bounds,
+                                       int &internal_vertices,
+                                       int pipeline_stage,
+                                       Thread *current_thread) const;
+
+private:
+  typedef pvector<int> Indices;
+
+  class RegionCache;
+
+  void do_geom_changed();
+  void do_update_bounds() const;
+  void do_compute_instance_bounds(int n) const;
+  static PN_stdfloat max_stretch_squared(const LMatrix4 &mat);
+  void do_cull_instances(Indices &visible,
+                         const GeometricBoundingVolume *frustum) const;
+  PT(RegionCache) do_get_region_cache(const DisplayRegion *region, int frame);
+  static PT(Geom) make_expanded_geom(const Geom *orig_geom,
+                                     const LMatrix4 *transforms,
+                                     int num_transforms,
+                                     Thread *current_thread);
+
+private:
+  CPT(Geom) _geom;
+  CPT(RenderState) _geom_state;
+
+  typedef pvector<LMatrix4> Instances;
+  Instances _instances;
+
+  // A bounding sphere around the Geom, in its own coordinate space
+  // (and the half-size of its bounding box, if it has one), and a
+  // bounding sphere around each instance, in the node's
+  // coordinate space.  The latter are stored in separate arrays,
+  // rather than as an array of BoundingSpheres, so that the frustum
+  // test can run through them in a tight loop.  These are computed
+  // lazily, since the Geom may not be complete yet when the node is
+  // read from a bam file.
+  typedef pvector<PN_stdfloat> Floats;
+  mutable bool _bounds_stale;
+  mutable LPoint3 _geom_center;
+  mutable PN_stdfloat _geom_radius;
+  mutable LVecBase3 _geom_half_size;
+  mutable bool _geom_is_box;
+  mutable bool _geom_bounds_empty;
+  mutable Floats _center_x, _center_y, _center_z, _radius;
+
+  // What each batch was last drawn with, kept from frame to frame so
+  // that it can be reused.
+  class CachedBatch {
+  public:
+    CachedBatch();
+
+    // When the GSG can't draw instanced batches, each batch is drawn
+    // as one Geom that has all of its instances baked into it,
+    // rebuilt only when the batch's set of visible instances
+    // changes.
+    Indices _indices;
+    PT(Geom) _expanded;
+
+    // Otherwise, the instance transforms are uploaded as a shader
+    // input, which is rewritten in place.  There are two of these,
+    // used on alternate frames, so that the array is not rewritten
+    // while the previous frame may still be drawn from it, and so
+    // that the GSG sees a new state each frame and issues the input
+    // again.
+    PTA_LMatrix4 _transforms[2];
+    CPT(RenderState) _base_state[2];
+    CPT(RenderState) _state[2];
+    int _num_instances[2];
+  };
+  typedef pvector<CachedBatch> CachedBatches;
+
+  // The batches are cached separately for each DisplayRegion that
+  // draws the node, since each sees a different set of instances.
+  // Each has its own lock, so that several DisplayRegions may be
+  // culled at once.
+  class RegionCache : public ReferenceCount {
+  public:
+    LightMutex _lock;
+    CachedBatches _batches;
+    int _last_frame;
+  };
+  typedef pmap<const DisplayRegion *, PT(RegionCache) > RegionCaches;
+  RegionCaches _region_caches;
+
+  // Protects all of the above, apart from the contents of each
+  // RegionCache, since the node may be culled by several threads at
+  // once.
+  mutable LightMutex _lock;
+
+  static PT(InternalName) _transforms_name;
+
+public:
+  static void register_with_read_factory();
+  virtual void write_datagram(BamWriter *manager, Datagram &dg);
+  virtual int complete_pointers(TypedWritable **plist, BamReader *manager);
+
+protected:
+  static TypedWritable *make_from_bam(const FactoryParams &params);
+  void fillin(DatagramIterator &scan, BamReader *manager);
+
+public:
+  static TypeHandle get_class_type() {
+    return _type_handle;
+  }
+  static void init_type() {
+    PandaNode::init_type();
+    register_type(_type_handle, "InstancedNode",
+                  PandaNode::get_class_type());
+  }
+  virtual TypeHandle get_type() const {
+    return get_class_type();
+  }
+  virtual TypeHandle force_init_type() {init_type(); return get_class_type();}
+
+private:
+  static TypeHandle _type_handle;
+};
+
+#include "instancedNode.I"
+
+#endif
@@ -0,0 +1,557 @@
+// Filename: meshSimplifier.cxx
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#include "meshSimplifier.h"
+#include "geomTriangles.h"
+#include "geomVertexReader.h"
+#include "internalName.h"
+#include "pmap.h"
+#include "config_pgraph.h"
+
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////
+//     Function: MeshSimplifier::Constructor
+//       Access: Published
+//  Description:
+////////////////////////////////////////////////////////////////////
+MeshSimplifier::
+MeshSimplifier() :
+  _boundary_weight(10.0f),
+  _max_error(-1.0f),
+  _error(0.0f),
+  _num_alive(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: MeshSimplifier::simplify
+//       Access: Published
+//  Description: Returns a new Geom with approximately ratio times as
+//               many triangles as the original (0 < ratio <= 1).
+//               Fewer triangles may be removed if the mesh cannot be
+//               reduced further without tearing a seam, flipping a
+//               face, or exceeding the max_error.
+//
+//               The new Geom shares the original GeomVertexData;
+//               only its primitives are replaced.  Geoms that do not
+//               contain polygons are returned unchanged.  Use
+//               get_error() afterwards to learn how far the result
+//               deviates from the original.
+////////////////////////////////////////////////////////////////////
+PT(Geom) MeshSimplifier::
+simplify(const Geom *geom, PN_stdfloat ratio) {
+  _error = 0.0f;
+  PT(Geom) result = geom->make_copy();
+
+  CPT(GeomVertexData) vdata = geom->get_vertex_data();
+  if (geom->get_primitive_type() != Geom::PT_polygons ||
+      !vdata->has_column(InternalName::get_vertex())) {
+    return result;
+  }
+
+  // Collect the triangles of all of the primitives.
+  int num_prims = geom->get_num_primitives();
+  pvector<CPT(GeomPrimitive)> prims;
+  prims.reserve(num_prims);
+  _triangles.clear();
+  for (int pi = 0; pi < num_prims; ++pi) {
+    CPT(GeomPrimitive) prim = geom->get_primitive(pi)->decompose();
+    prims.push_back(prim);
+    int num_vertices = prim->get_num_vertices();
+    for (int vi = 0; vi + 2 < num_vertices; vi += 3) {
+      Triangle tri;
+      tri._rows[0] = prim->get_vertex(vi);
+      tri._rows[1] = prim->get_vertex(vi + 1);
+      tri._rows[2] = prim->get_vertex(vi + 2);
+      tri._prim = pi;
+      tri._alive = true;
+      _triangles.push_back(tri);
+    }
+  }
+  _num_alive = (int)_triangles.size();
+  int target = (int)(_triangles.size() * max(min(ratio, (PN_stdfloat)1.0f), (PN_stdfloat)0.0f));
+
+  // Weld the rows into groups by position.
+  int num_rows = vdata->get_num_rows();
+  _row_group.assign(num_rows, -1);
+  _groups.clear();
+  _group_triangles.clear();
+
+  typedef pmap<LPoint3d, int> GroupsByPos;
+  GroupsByPos groups_by_pos;
+  GeomVertexReader vertex(vdata, InternalName::get_vertex());
+  Triangles::iterator ti;
+  for (ti = _triangles.begin(); ti != _triangles.end(); ++ti) {
+    for (int k = 0; k < 3; ++k) {
+      int row = (*ti)._rows[k];
+      if (_row_group[row] != -1) {
+        continue;
+      }
+      vertex.set_row(row);
+      LPoint3d pos = LCAST(double, vertex.get_data3());
+      pair<GroupsByPos::iterator, bool> gi =
+        groups_by_pos.insert(GroupsByPos::value_type(pos, (int)_groups.size()));
+      if (gi.second) {
+        Group group;
+        group._pos = pos;
+        group._version = 0;
+        group._alive = true;
+        _groups.push_back(group);
+        _group_triangles.push_back(vector_int());
+      }
+      _row_group[row] = (*gi.first).second;
+      _groups[(*gi.first).second]._rows.push_back(row);
+    }
+  }
+
+  // Triangles that are degenerate to begin with are dropped.
+  for (int t = 0; t < (int)_triangles.size(); ++t) {
+    Triangle &tri = _triangles[t];
+    int g0 = _row_group[tri._rows[0]];
+    int g1 = _row_group[tri._rows[1]];
+    int g2 = _row_group[tri._rows[2]];
+    if (g0 == g1 || g1 == g2 || g0 == g2) {
+      tri._alive = false;
+      --_num_alive;
+      continue;
+    }
+    _group_triangles[g0].push_back(t);
+    _group_triangles[g1].push_back(t);
+    _group_triangles[g2].push_back(t);
+  }
+
+  // Read the skinning columns, which must match for two rows to be
+  // collapsed together.
+  _skinning.clear();
+  CPT(InternalName) skinning_names[3] = {
+    InternalName::get_transform_blend(),
+    InternalName::get_transform_index(),
+    InternalName::get_transform_weight(),
+  };
+  for (int n = 0; n < 3; ++n) {
+    if (vdata->has_column(skinning_names[n])) {
+      GeomVertexReader reader(vdata, skinning_names[n]);
+      _skinning.push_back(pvector<LVecBase4>());
+      pvector<LVecBase4> &values = _skinning.back();
+      values.reserve(num_rows);
+      for (int row = 0; row < num_rows; ++row) {
+        values.push_back(reader.get_data4());
+      }
+    }
+  }
+
+  compute_quadrics(_boundary_weight);
+
+  _heap.clear();
+  for (int g = 0; g < (int)_groups.size(); ++g) {
+    push_candidates(g, true);
+  }
+
+  double max_cost = -1.0;
+  if (_max_error >= 0.0f) {
+    max_cost = (double)_max_error * (double)_max_error;
+  }
+
+  vector_int partners;
+  while (_num_alive > target && !_heap.empty()) {
+    pop_heap(_heap.begin(), _heap.end());
+    Candidate candidate = _heap.back();
+    _heap.pop_back();
+
+    Group &from = _groups[candidate._from];
+    Group &to = _groups[candidate._to];
+    if (!from._alive || !to._alive ||
+        from._version != candidate._from_version ||
+        to._version != candidate._to_version) {
+      // This candidate is stale.
+      continue;
+    }
+    if (max_cost >= 0.0 && candidate._cost > max_cost) {
+      break;
+    }
+    if (!find_partners(candidate._from, candidate._to, partners) ||
+        would_flip(candidate._from, candidate._to)) {
+      continue;
+    }
+
+    collapse(candidate._from, candidate._to, partners);
+    _error = max(_error, (PN_stdfloat)sqrt(max(candidate._cost, 0.0)));
+    push_candidates(candidate._to, false);
+  }
+
+  // Now rebuild the primitives from the surviving triangles.
+  result->clear_primitives();
+  for (int pi = 0; pi < num_prims; ++pi) {
+    PT(GeomPrimitive) new_prim = prims[pi]->make_copy();
+    new_prim->clear_vertices();
+    for (ti = _triangles.begin(); ti != _triangles.end(); ++ti) {
+      if ((*ti)._alive && (*ti)._prim == pi) {
+        new_prim->add_vertices((*ti)._rows[0], (*ti)._rows[1], (*ti)._rows[2]);
+        new_prim->close_primitive();
+      }
+    }
+    if (new_prim->get_num_vertices() != 0) {
+      result->add_primitive(new_prim);
+    }
+  }
+
+  if (pgraph_cat.is_debug()) {
+    pgraph_cat.debug()
+      << "Simplified " << _triangles.size() << " triangles to "
+      << _num_alive << ", error " << _error << "\n";
+  }
+
+  _triangles.clear();
+  _groups.clear();
+  _row_group.clear();
+  _group_triangles.clear();
+  _skinning.clear();
+  _heap.clear();
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: MeshSimplifier::compute_quadrics
+//       Access: Private
+//  Description: Accumulates the plane of each triangle into the
+//               quadrics of its corners, along with a plane
+//               perpendicular to each open edge to hold the boundary
+//               of the mesh in place.
+////////////////////////////////////////////////////////////////////
+void MeshSimplifier::
+compute_quadrics(PN_stdfloat boundary_weight) {
+  typedef pmap<pair<int, int>, int> EdgeCount;
+  EdgeCount edge_count;
+
+  int num_triangles = (int)_triangles.size();
+  for (int t = 0; t < num_triangles; ++t) {
+    const Triangle &tri = _triangles[t];
+    if (!tri._alive) {
+      continue;
+    }
+    int g[3];
+    for (int k = 0; k < 3; ++k) {
+      g[k] = _row_group[tri._rows[k]];
+    }
+    const LPoint3d &p0 = _groups[g[0]]._pos;
+    LVector3d normal = (_groups[g[1]]._pos - p0).cross(_groups[g[2]]._pos - p0);
+    double length = normal.length();
+    if (length == 0.0) {
+      continue;
+    }
+    normal /= length;
+    LVecBase4d plane(normal[0], normal[1], normal[2], -normal.dot(p0));
+    for (int k = 0; k < 3; ++k) {
+      _groups[g[k]]._quadric.add_plane(plane, 1.0);
+
+      int a = g[k];
+      int b = g[(k + 1) % 3];
+      ++edge_count[pair<int, int>(min(a, b), max(a, b))];
+    }
+  }
+
+  if (boundary_weight <= 0.0f) {
+    return;
+  }
+
+  for (int t = 0; t < num_triangles; ++t) {
+    const Triangle &tri = _triangles[t];
+    if (!tri._alive) {
+      continue;
+    }
+    int g[3];
+    for (int k = 0; k < 3; ++k) {
+      g[k] = _row_group[tri._rows[k]];
+    }
+    const LPoint3d &p0 = _groups[g[0]]._pos;
+    LVector3d normal = (_groups[g[1]]._pos - p0).cross(_groups[g[2]]._pos - p0);
+    if (!normal.normalize()) {
+      continue;
+    }
+    for (int k = 0; k < 3; ++k) {
+      int a = g[k];
+      int b = g[(k + 1) % 3];
+      if (edge_count[pair<int, int>(min(a, b), max(a, b))] != 1) {
+        continue;
+      }
+      LVector3d edge = _groups[b]._pos - _groups[a]._pos;
+      double length_sq = edge.length_squared();
+      LVector3d side = edge.cross(normal);
+      if (!side.normalize()) {
+        continue;
+      }
+      LVecBase4d plane(side[0], side[1], side[2], -side.dot(_groups[a]._pos));
+      double weight = boundary_weight * length_sq;
+      _groups[a]._quadric.add_plane(plane, weight);
+      _groups[b]._quadric.add_plane(plane, weight);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: MeshSimplifier::get_neighbors
+//       Access: Private
+//  Description: Fills neighbors with the groups that share a living
+//               triangle with group g.
+////////////////////////////////////////////////////////////////////
+void MeshSimplifier::
+get_neighbors(int g, vector_int &neighbors) const {
+  neighbors.clear();
+  const vector_int &tris = _group_triangles[g];
+  vector_int::const_iterator ti;
+  for (ti = tris.begin(); ti != tris.end(); ++ti) {
+    const Triangle &tri = _triangles[*ti];
+    if (!tri._alive) {
+      continue;
+    }
+    for (int k = 0; k < 3; ++k) {
+      int n = _row_group[tri._rows[k]];
+      if (n != g) {
+        neighbors.push_back(n);
+      }
+    }
+  }
+  sort(neighbors.begin(), neighbors.end());
+  neighbors.erase(unique(neighbors.begin(), neighbors.end()), neighbors.end());
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: MeshSimplifier::push_candidates
+//       Access: Private
+//  Description: Adds the collapses in both directions along each
+//               edge from group g to the heap.  If only_higher is
+//               true, only edges to groups with a higher index are
+//               considered, so that each edge is visited once during
+//               the initial pass.
+////////////////////////////////////////////////////////////////////
+void MeshSimplifier::
+push_candidates(int g, bool only_higher) {
+  vector_int neighbors;
+  get_neighbors(g, neighbors);
+
+  vector_int::const_iterator ni;
+  for (ni = neighbors.begin(); ni != neighbors.end(); ++ni) {
+    int n = (*ni);
+    if (only_higher && n < g) {
+      continue;
+    }
+    Quadric quadric = _groups[g]._quadric;
+    quadric += _groups[n]._quadric;
+
+    Candidate candidate;
+    candidate._from = g;
+    candidate._to = n;
+    candidate._from_version = _groups[g]._version;
+    candidate._to_version = _groups[n]._version;
+    candidate._cost = quadric.evaluate(_groups[n]._pos);
+    push_candidate(candidate);
+
+    candidate._from = n;
+    candidate._to = g;
+    candidate._from_version = _groups[n]._version;
+    candidate._to_version = _groups[g]._version;
+    candidate._cost = quadric.evaluate(_groups[g]._pos);
+    push_candidate(candidate);
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: MeshSimplifier::push_candidate
+//       Access: Private
+//  Description:
+////////////////////////////////////////////////////////////////////
+void MeshSimplifier::
+push_candidate(const Candidate &candidate) {
+  _heap.push_back(candidate);
+  push_heap(_heap.begin(), _heap.end());
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: MeshSimplifier::find_partners
+//       Access: Private
+//  Description: For each row of group from, finds the row of group to
+//               it will be merged with: a row that shares a triangle
+//               with it, and so has the same UV's and normal on that
+//               side of any seam.  Returns false if some row of from
+//               has no such partner, or if the partner's skinning
+//               differs, in which case the collapse would tear a
+//               seam or disturb the animation.
+//
+//               On success, partners[i] holds the partner of the ith
+//               row of from, or -1 if that row is no longer used.
+////////////////////////////////////////////////////////////////////
+bool MeshSimplifier::
+find_partners(int from, int to, vector_int &partners) const {
+  const vector_int &rows = _groups[from]._rows;
+  partners.assign(rows.size(), -1);
+
+  const vector_int &tris = _group_triangles[from];
+  for (size_t ri = 0; ri < rows.size(); ++ri) {
+    int row = rows[ri];
+    bool used = false;
+    vector_int::const_iterator ti;
+    for (ti = tris.begin(); ti != tris.end(); ++ti) {
+      const Triangle &tri = _triangles[*ti];
+      if (!tri._alive) {
+        continue;
+      }
+      int k;
+      for (k = 0; k < 3 && tri._rows[k] != row; ++k) {
+      }
+      if (k == 3) {
+        continue;
+      }
+      used = true;
+      for (int j = 0; j < 3; ++j) {
+        if (_row_group[tri._rows[j]] == to) {
+          if (partners[ri] == -1) {
+            partners[ri] = tri._rows[j];
+          } else if (partners[ri] != tri._rows[j]) {
+            // This row borders two different rows of the target,
+            // so the collapse would merge attributes that differ.
+            return false;
+          }
+        }
+      }
+    }
+    if (used && partners[ri] == -1) {
+      return false;
+    }
+    if (partners[ri] != -1 && !same_skinning(row, partners[ri])) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: MeshSimplifier::would_flip
+//       Access: Private
+//  Description: Returns true if moving group from onto group to
+//               would turn any of the surviving triangles around
+//               from inside out.
+////////////////////////////////////////////////////////////////////
+bool MeshSimplifier::
+would_flip(int from, int to) const {
+  const LPoint3d &new_pos = _groups[to]._pos;
+  const vector_int &tris = _group_triangles[from];
+  vector_int::const_iterator ti;
+  for (ti = tris.begin(); ti != tris.end(); ++ti) {
+    const Triangle &tri = _triangles[*ti];
+    if (!tri._alive) {
+      continue;
+    }
+    LPoint3d before[3], after[3];
+    bool removed = false;
+    for (int k = 0; k < 3; ++k) {
+      int g = _row_group[tri._rows[k]];
+      removed = removed || (g == to);
+      before[k] = _groups[g]._pos;
+      after[k] = (g == from) ? new_pos : before[k];
+    }
+    if (removed) {
+      continue;
+    }
+    LVector3d n0 = (before[1] - before[0]).cross(before[2] - before[0]);
+    LVector3d n1 = (after[1] - after[0]).cross(after[2] - after[0]);
+    if (n0.dot(n1) <= 0.0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: MeshSimplifier::collapse
+//       Access: Private
+//  Description: Merges group from into group to, replacing each row
+//               of from with its partner, and removes the triangles
+//               that become degenerate.
+////////////////////////////////////////////////////////////////////
+void MeshSimplifier::
+collapse(int from, int to, const vector_int &partners) {
+  Group &from_group = _groups[from];
+  Group &to_group = _groups[to];
+
+  for (size_t ri = 0; ri < from_group._rows.size(); ++ri) {
+    if (partners[ri] != -1) {
+      _row_group[from_group._rows[ri]] = to;
+    }
+  }
+
+  vector_int &from_tris = _group_triangles[from];
+  vector_int &to_tris = _group_triangles[to];
+  vector_int::const_iterator ti;
+  for (ti = from_tris.begin(); ti != from_tris.end(); ++ti) {
+    Triangle &tri = _triangles[*ti];
+    if (!tri._alive) {
+      continue;
+    }
+    for (int k = 0; k < 3; ++k) {
+      vector_int::const_iterator ri =
+        find(from_group._rows.begin(), from_group._rows.end(), tri._rows[k]);
+      if (ri != from_group._rows.end()) {
+        tri._rows[k] = partners[ri - from_group._rows.begin()];
+      }
+    }
+    if (tri._rows[0] == tri._rows[1] || tri._rows[1] == tri._rows[2] ||
+        tri._rows[0] == tri._rows[2] ||
+        _row_group[tri._rows[0]] == _row_group[tri._rows[1]] ||
+        _row_group[tri._rows[1]] == _row_group[tri._rows[2]] ||
+        _row_group[tri._rows[0]] == _row_group[tri._rows[2]]) {
+      tri._alive = false;
+      --_num_alive;
+    } else {
+      to_tris.push_back(*ti);
+    }
+  }
+
+  // Drop the dead triangles from the target's list while we're here.
+  vector_int live_tris;
+  live_tris.reserve(to_tris.size());
+  for (ti = to_tris.begin(); ti != to_tris.end(); ++ti) {
+    if (_triangles[*ti]._alive) {
+      live_tris.push_back(*ti);
+    }
+  }
+  sort(live_tris.begin(), live_tris.end());
+  live_tris.erase(unique(live_tris.begin(), live_tris.end()), live_tris.end());
+  to_tris.swap(live_tris);
+
+  to_group._quadric += from_group._quadric;
+  ++to_group._version;
+  from_group._alive = false;
+  from_group._rows.clear();
+  from_tris.clear();
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: MeshSimplifier::same_skinning
+//       Access: Private
+//  Description: Returns true if the two rows are animated by the same
+//               joints with the same weights.
+////////////////////////////////////////////////////////////////////
+bool MeshSimplifier::
+same_skinning(int row_a, int row_b) const {
+  pvector<pvector<LVecBase4> >::const_iterator si;
+  for (si = _skinning.begin(); si != _skinning.end(); ++si) {
+    if ((*si)[row_a] != (*si)[row_b]) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,127 @@
+// Filename: meshSimplifier.h
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#ifndef MESHSIMPLIFIER_H
+#define MESHSIMPLIFIER_H
+
+#include "pandabase.h"
+
+#include "geom.h"
+#include "luse.h"
+#include "pvector.h"
+#include "vector_int.h"
+
+////////////////////////////////////////////////////////////////////
+//       Class : MeshSimplifier
+// Description : Reduces the number of triangles in a Geom by
+//               repeatedly collapsing the edge whose removal changes
+//               the shape the least, as measured by the quadric error
+//               metric of Garland and Heckbert.
+//
+//               Vertices are collapsed onto one of their neighbors,
+//               rather than to a new optimal position, so the
+//               simplified Geom uses a subset of the original
+//               vertices and can share the original GeomVertexData.
+//               Vertices that are duplicated at the same position
+//               (because of a UV seam or a crease in the normals)
+//               are collapsed together, so seams stay closed, and
+//               vertices are never collapsed onto a vertex with
+//               different skinning (transform_blend, transform_index
+//               or transform_weight) values.  Open boundaries of the
+//               mesh are weighted to preserve its outline.
+////////////////////////////////////////////////////////////////////
+class EXPCL_PANDA_PGRAPH MeshSimplifier {
+PUBLISHED:
+  MeshSimplifier();
+
+  INLINE void set_boundary_weight(PN_stdfloat boundary_weight);
+  INLINE PN_stdfloat get_boundary_weight() const;
+
+  INLINE void set_max_error(PN_stdfloat max_error);
+  INLINE PN_stdfloat get_max_error() const;
+
+  PT(Geom) simplify(const Geom *geom, PN_stdfloat ratio);
+  INLINE PN_stdfloat get_error() const;
+
+private:
+  // A symmetric 4x4 matrix that sums the squared distances to a set
+  // of planes.
+  class Quadric {
+  public:
+    INLINE Quadric();
+    INLINE void add_plane(const LVecBase4d &plane, double weight);
+    INLINE void operator += (const Quadric &other);
+    INLINE double evaluate(const LPoint3d &point) const;
+
+    double _q[10];
+  };
+
+  class Triangle {
+  public:
+    int _rows[3];
+    int _prim;
+    bool _alive;
+  };
+  typedef pvector<Triangle> Triangles;
+
+  // A group of vertex rows that share a position.  The quadric and
+  // the collapses apply to whole groups.
+  class Group {
+  public:
+    LPoint3d _pos;
+    Quadric _quadric;
+    vector_int _rows;
+    int _version;
+    bool _alive;
+  };
+  typedef pvector<Group> Groups;
+
+  class Candidate {
+  public:
+    INLINE bool operator < (const Candidate &other) const;
+
+    double _cost;
+    int _from;
+    int _to;
+    int _from_version;
+    int _to_version;
+  };
+  typedef pvector<Candidate> Candidates;
+
+  void compute_quadrics(PN_stdfloat boundary_weight);
+  void push_candidates(int g, bool only_higher);
+  void get_neighbors(int g, vector_int &neighbors) const;
+  bool find_partners(int from, int to, vector_int &partners) const;
+  bool would_flip(int from, int to) const;
+  void collapse(int from, int to, const vector_int &partners);
+  bool same_skinning(int row_a, int row_b) const;
+  void push_candidate(const Candidate &candidate);
+
+  PN_stdfloat _boundary_weight;
+  PN_stdfloat _max_error;
+  PN_stdfloat _error;
+
+  // These are used only during simplify().
+  Triangles _triangles;
+  int _num_alive;
+  Groups _groups;
+  vector_int _row_group;
+  pvector<vector_int> _group_triangles;
+  pvector<pvector<LVecBase4> > _skinning;
+  Candidates _heap;
+};
+
+#include "meshSimplifier.I"
+
+#endif
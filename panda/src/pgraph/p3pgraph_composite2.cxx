@@ -16,6 +16,7 @@
 #include "eventStorePandaNode.cxx"
 #include "findApproxPath.cxx"
 #include "findApproxLevelEntry.cxx"
+#include "flattenBatch.cxx"
 #include "fog.cxx"
 #include "fogAttrib.cxx"
 #include "geomDrawCallbackData.cxx"
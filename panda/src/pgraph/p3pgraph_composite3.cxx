@@ -1,4 +1,5 @@
 #include "internalNameCollection.cxx"
+#include "instancedNode.cxx"
 #include "lensNode.cxx"
 #include "light.cxx"
 #include "lightAttrib.cxx"
@@ -9,6 +10,7 @@
 #include "loaderFileTypeRegistry.cxx"
 #include "materialAttrib.cxx"
 #include "materialCollection.cxx"
+#include "meshSimplifier.cxx"
 #include "modelFlattenRequest.cxx"
 #include "modelLoadRequest.cxx"
 #include "modelSaveRequest.cxx"
@@ -1259,12 +1259,23 @@ void PandaNode::
 set_effects(const RenderEffects *effects, Thread *current_thread) {
   // Apply this operation to the current stage as well as to all
   // upstream stages.
+  bool any_changed = false;
   OPEN_ITERATE_CURRENT_AND_UPSTREAM(_cycler, current_thread) {
     CDStageWriter cdata(_cycler, pipeline_stage, current_thread);
-    cdata->_effects = effects;
-    cdata->set_fancy_bit(FB_effects, !effects->is_empty());
+    if (cdata->_effects != effects) {
+      cdata->_effects = effects;
+      cdata->set_fancy_bit(FB_effects, !effects->is_empty());
+      any_changed = true;
+    }
   }
   CLOSE_ITERATE_CURRENT_AND_UPSTREAM(_cycler);
+
+  // The effects don't change the bounding volume, but marking it
+  // stale lets anything watching the bounds sequence (for instance,
+  // a DisplayRegion's cull cache) know that the subgraph changed.
+  if (any_changed) {
+    mark_bounds_stale(current_thread);
+  }
   mark_bam_modified();
 }
 
@@ -1415,12 +1426,26 @@ void PandaNode::
 set_tag(const string &key, const string &value, Thread *current_thread) {
   // Apply this operation to the current stage as well as to all
   // upstream stages.
+  bool any_changed = false;
   OPEN_ITERATE_CURRENT_AND_UPSTREAM(_cycler, current_thread) {
     CDStageWriter cdata(_cycler, pipeline_stage, current_thread);
-    cdata->_tag_data[key] = value;
+    TagData::iterator ti = cdata->_tag_data.find(key);
+    if (ti == cdata->_tag_data.end()) {
+      cdata->_tag_data[key] = value;
+      any_changed = true;
+    } else if ((*ti).second != value) {
+      (*ti).second = value;
+      any_changed = true;
+    }
     cdata->set_fancy_bit(FB_tag, true);
   }
   CLOSE_ITERATE_CURRENT_AND_UPSTREAM(_cycler);
+
+  // A tag may select a Camera's tag state, so as in set_effects(),
+  // a change marks the bounds stale for the sake of the cull cache.
+  if (any_changed) {
+    mark_bounds_stale(current_thread);
+  }
   mark_bam_modified();
 }
 
@@ -1433,12 +1458,20 @@ set_tag(const string &key, const string &value, Thread *current_thread) {
 ////////////////////////////////////////////////////////////////////
 void PandaNode::
 clear_tag(const string &key, Thread *current_thread) {
+  bool any_changed = false;
   OPEN_ITERATE_CURRENT_AND_UPSTREAM(_cycler, current_thread) {
     CDStageWriter cdata(_cycler, pipeline_stage, current_thread);
-    cdata->_tag_data.erase(key);
+    if (cdata->_tag_data.erase(key) != 0) {
+      any_changed = true;
+    }
     cdata->set_fancy_bit(FB_tag, !cdata->_tag_data.empty());
   }
   CLOSE_ITERATE_CURRENT_AND_UPSTREAM(_cycler);
+
+  // As in set_tag().
+  if (any_changed) {
+    mark_bounds_stale(current_thread);
+  }
   mark_bam_modified();
 }
 
@@ -1460,6 +1493,7 @@ copy_tags(PandaNode *other) {
   // Apply this operation to the current stage as well as to all
   // upstream stages.
   Thread *current_thread = Thread::get_current_thread();
+  bool any_changed = false;
   OPEN_ITERATE_CURRENT_AND_UPSTREAM(_cycler, current_thread) {
     CDStageWriter cdataw(_cycler, pipeline_stage, current_thread);
     CDStageReader cdatar(other->_cycler, pipeline_stage, current_thread);
@@ -1469,6 +1503,7 @@ copy_tags(PandaNode *other) {
          ti != cdatar->_tag_data.end();
          ++ti) {
       cdataw->_tag_data[(*ti).first] = (*ti).second;
+      any_changed = true;
     }
     cdataw->set_fancy_bit(FB_tag, !cdataw->_tag_data.empty());
     
@@ -1498,6 +1533,11 @@ copy_tags(PandaNode *other) {
 #endif // HAVE_PYTHON
   }
   CLOSE_ITERATE_CURRENT_AND_UPSTREAM(_cycler);
+
+  // As in set_tag().
+  if (any_changed) {
+    mark_bounds_stale(current_thread);
+  }
   mark_bam_modified();
 }
 
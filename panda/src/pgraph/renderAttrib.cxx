@@ -159,7 +159,7 @@ get_auto_shader_attrib_impl(const RenderState *state) const {
 ////////////////////////////////////////////////////////////////////
 bool RenderAttrib::
 unref() const {
-  if (!state_cache || garbage_collect_states) {
+  if (!state_cache_snapshot || garbage_collect_states_snapshot) {
     // If we're not using the cache at all, or if we're relying on
     // garbage collection, just allow the pointer to unref normally.
     return ReferenceCount::unref();
@@ -256,7 +256,7 @@ list_attribs(ostream &out) {
 ////////////////////////////////////////////////////////////////////
 int RenderAttrib::
 garbage_collect() {
-  if (_attribs == (Attribs *)NULL || !garbage_collect_states) {
+  if (_attribs == (Attribs *)NULL || !garbage_collect_states_snapshot) {
     return 0;
   }
   LightReMutexHolder holder(*_attribs_lock);
@@ -390,7 +390,7 @@ validate_attribs() {
 CPT(RenderAttrib) RenderAttrib::
 return_new(RenderAttrib *attrib) {
   nassertr(attrib != (RenderAttrib *)NULL, attrib);
-  if (!uniquify_attribs) {
+  if (!uniquify_attribs_snapshot) {
     return attrib;
   }
 
@@ -415,7 +415,7 @@ CPT(RenderAttrib) RenderAttrib::
 return_unique(RenderAttrib *attrib) {
   nassertr(attrib != (RenderAttrib *)NULL, attrib);
 
-  if (!state_cache) {
+  if (!state_cache_snapshot) {
     return attrib;
   }
 
@@ -444,7 +444,7 @@ return_unique(RenderAttrib *attrib) {
   }
   
   // Not already in the set; add it.
-  if (garbage_collect_states) {
+  if (garbage_collect_states_snapshot) {
     // If we'll be garbage collecting attribs explicitly, we'll
     // increment the reference count when we store it in the cache, so
     // that it won't be deleted while it's in it.
@@ -611,7 +611,7 @@ return_new(RenderEffects *state) {
   nassertr(state != (RenderEffects *)NULL, state);
 
 #ifndef NDEBUG
-  if (!state_cache) {
+  if (!state_cache_snapshot) {
     return state;
   }
 #endif
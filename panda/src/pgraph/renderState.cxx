@@ -25,6 +25,7 @@
 #include "textureAttrib.h"
 #include "texGenAttrib.h"
 #include "shaderAttrib.h"
+#include "cullTraverser.h"
 #include "pStatTimer.h"
 #include "config_pgraph.h"
 #include "bamReader.h"
@@ -240,6 +241,8 @@ compare_sort(const RenderState &other) const {
 ////////////////////////////////////////////////////////////////////
 bool RenderState::
 cull_callback(CullTraverser *trav, const CullTraverserData &data) const {
+  trav->inc_num_cull_callbacks();
+
   SlotMask mask = _filled_slots;
   int slot = mask.get_lowest_on_bit();
   while (slot >= 0) {
@@ -409,7 +412,7 @@ compose(const RenderState *other) const {
     return this;
   }
 
-  if (!state_cache) {
+  if (!state_cache_snapshot) {
     return do_compose(other);
   }
 
@@ -504,7 +507,7 @@ invert_compose(const RenderState *other) const {
     return make_empty();
   }
 
-  if (!state_cache) {
+  if (!state_cache_snapshot) {
     return do_invert_compose(other);
   }
 
@@ -692,7 +695,7 @@ adjust_all_priorities(int adjustment) const {
 ////////////////////////////////////////////////////////////////////
 bool RenderState::
 unref() const {
-  if (!state_cache || garbage_collect_states) {
+  if (!state_cache_snapshot || garbage_collect_states_snapshot) {
     // If we're not using the cache at all, or if we're relying on
     // garbage collection, just allow the pointer to unref normally.
     return ReferenceCount::unref();
@@ -708,7 +711,7 @@ unref() const {
   // limiting factor on parallelization.
   LightReMutexHolder holder(*_states_lock);
 
-  if (auto_break_cycles && uniquify_states) {
+  if (auto_break_cycles && uniquify_states_snapshot) {
     if (get_cache_ref_count() > 0 &&
         get_ref_count() == get_cache_ref_count() + 1) {
       // If we are about to remove the one reference that is not in the
@@ -1046,7 +1049,7 @@ int RenderState::
 garbage_collect() {
   int num_attribs = RenderAttrib::garbage_collect();
 
-  if (_states == (States *)NULL || !garbage_collect_states) {
+  if (_states == (States *)NULL || !garbage_collect_states_snapshot) {
     return num_attribs;
   }
   LightReMutexHolder holder(*_states_lock);
@@ -1069,7 +1072,7 @@ garbage_collect() {
     if (_states->has_element(si)) {
       ++num_elements;
       RenderState *state = (RenderState *)_states->get_key(si);
-      if (auto_break_cycles && uniquify_states) {
+      if (auto_break_cycles && uniquify_states_snapshot) {
         if (state->get_cache_ref_count() > 0 &&
             state->get_ref_count() == state->get_cache_ref_count()) {
           // If we have removed all the references to this state not in
@@ -1120,6 +1123,7 @@ clear_munger_cache() {
       continue;
     }
     RenderState *state = (RenderState *)(_states->get_key(si));
+    LightMutexHolder state_holder(state->_lock);
     state->_mungers.clear();
     state->_last_mi = state->_mungers.end();
   }
@@ -1497,7 +1501,7 @@ return_new(RenderState *state) {
   nassertr(state->validate_filled_slots(), state);
 #endif
 
-  if (!uniquify_states && !state->is_empty()) {
+  if (!uniquify_states_snapshot && !state->is_empty()) {
     return state;
   }
 
@@ -1520,7 +1524,7 @@ CPT(RenderState) RenderState::
 return_unique(RenderState *state) {
   nassertr(state != (RenderState *)NULL, state);
 
-  if (!state_cache) {
+  if (!state_cache_snapshot) {
     return state;
   }
 
@@ -1544,7 +1548,7 @@ return_unique(RenderState *state) {
 
   // Ensure each of the individual attrib pointers has been uniquified
   // before we add the state to the cache.
-  if (!uniquify_attribs && !state->is_empty()) {
+  if (!uniquify_attribs_snapshot && !state->is_empty()) {
     SlotMask mask = state->_filled_slots;
     int slot = mask.get_lowest_on_bit();
     while (slot >= 0) {
@@ -1563,7 +1567,7 @@ return_unique(RenderState *state) {
   }
   
   // Not already in the set; add it.
-  if (garbage_collect_states) {
+  if (garbage_collect_states_snapshot) {
     // If we'll be garbage collecting states explicitly, we'll
     // increment the reference count when we store it in the cache, so
     // that it won't be deleted while it's in it.
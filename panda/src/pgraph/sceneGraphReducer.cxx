@@ -23,6 +23,8 @@
 #include "geomNode.h"
 #include "config_gobj.h"
 #include "thread.h"
+#include "flattenBatch.h"
+#include "vector_int.h"
 
 PStatCollector SceneGraphReducer::_flatten_collector("*:Flatten:flatten");
 PStatCollector SceneGraphReducer::_apply_collector("*:Flatten:apply");
@@ -32,8 +34,57 @@ PStatCollector SceneGraphReducer::_collect_collector("*:Flatten:collect");
 PStatCollector SceneGraphReducer::_make_nonindexed_collector("*:Flatten:make nonindexed");
 PStatCollector SceneGraphReducer::_unify_collector("*:Flatten:unify");
 PStatCollector SceneGraphReducer::_remove_unused_collector("*:Flatten:remove unused vertices");
+PStatCollector SceneGraphReducer::_vertex_cache_collector("*:Flatten:vertex cache");
+PStatCollector SceneGraphReducer::_simplify_collector("*:Flatten:simplify");
 PStatCollector SceneGraphReducer::_premunge_collector("*:Premunge");
 
+// The FlattenBatch used by flatten_children().  Each job flattens the
+// subgraph below one child.
+class SceneGraphReducer::FlattenChildrenBatch : public FlattenBatch {
+public:
+  FlattenChildrenBatch(SceneGraphReducer *reducer) :
+    _reducer(reducer) { }
+
+  pvector<PandaNode *> _nodes;
+  vector_int _bits;
+  vector_int _results;
+
+protected:
+  virtual void do_job(int n) {
+    _results[n] = _reducer->flatten_children(_nodes[n], _bits[n], false);
+  }
+
+private:
+  SceneGraphReducer *_reducer;
+};
+
+// The FlattenBatch used by apply_attribs_children().  Each job
+// applies the attribs to the subgraph below one child.
+class SceneGraphReducer::ApplyAttribsBatch : public FlattenBatch {
+public:
+  ApplyAttribsBatch(SceneGraphReducer *reducer,
+                    const AccumulatedAttribs &attribs,
+                    int attrib_types, GeomTransformer &transformer) :
+    _reducer(reducer),
+    _attribs(attribs),
+    _attrib_types(attrib_types),
+    _transformer(transformer) { }
+
+  pvector<PandaNode *> _nodes;
+
+protected:
+  virtual void do_job(int n) {
+    _reducer->r_apply_attribs(_nodes[n], _attribs, _attrib_types,
+                              _transformer);
+  }
+
+private:
+  SceneGraphReducer *_reducer;
+  const AccumulatedAttribs &_attribs;
+  int _attrib_types;
+  GeomTransformer &_transformer;
+};
+
 ////////////////////////////////////////////////////////////////////
 //     Function: SceneGraphReducer::set_gsg
 //       Access: Published
@@ -106,16 +157,9 @@ flatten(PandaNode *root, int combine_siblings_bits) {
   do {
     num_pass_nodes = 0;
 
-    // Get a copy of the children list, so we don't have to worry
-    // about self-modifications.
-    PandaNode::Children cr = root->get_children();
-
-    // Now visit each of the children in turn.
-    int num_children = cr.get_num_children();
-    for (int i = 0; i < num_children; i++) {
-      PT(PandaNode) child_node = cr.get_child(i);
-      num_pass_nodes += r_flatten(root, child_node, combine_siblings_bits);
-    }
+    // Visit each of the children in turn.  If flatten-threads is
+    // nonzero, independent subgraphs may be visited in parallel.
+    num_pass_nodes += flatten_children(root, combine_siblings_bits, true);
 
     if (combine_siblings_bits != 0 && 
         root->get_num_children() >= 2 && 
@@ -194,6 +238,63 @@ decompose(PandaNode *root) {
   }
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: SceneGraphReducer::optimize_vertex_cache
+//       Access: Published
+//  Description: Reorders the triangles of every GeomNode at this
+//               level and below for better use of the post-transform
+//               vertex cache, and renumbers their vertices in the
+//               order the triangles use them.  If sort_for_overdraw
+//               is true, the triangles are also grouped into
+//               clusters that are sorted to reduce overdraw.  See
+//               GeomTransformer::optimize_vertex_cache().
+//
+//               Triangle strips and fans are decomposed into
+//               triangles first, unless preserve-triangle-strips is
+//               set, in which case they are left alone.  This is
+//               best done after collect_vertex_data() and unify(),
+//               which may otherwise undo its work.
+//
+//               The return value is the number of GeomNodes
+//               modified.
+////////////////////////////////////////////////////////////////////
+int SceneGraphReducer::
+optimize_vertex_cache(PandaNode *root, int cache_size, bool sort_for_overdraw) {
+  nassertr(check_live_flatten(root), 0);
+
+  if (!preserve_triangle_strips) {
+    PStatTimer timer(_unify_collector);
+    r_decompose(root);
+  }
+
+  PStatTimer timer(_vertex_cache_collector);
+  int count = r_optimize_vertex_cache(root, cache_size, sort_for_overdraw,
+                                      _transformer);
+  _transformer.finish_apply();
+  return count;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: SceneGraphReducer::simplify
+//       Access: Published
+//  Description: Reduces the number of triangles in every GeomNode at
+//               this level and below to approximately ratio times
+//               the original count, using a MeshSimplifier.  The
+//               simplified Geoms share the vertex data of the
+//               originals.
+//
+//               The return value is the number of GeomNodes
+//               modified.
+////////////////////////////////////////////////////////////////////
+int SceneGraphReducer::
+simplify(PandaNode *root, PN_stdfloat ratio) {
+  nassertr(check_live_flatten(root), 0);
+  PStatTimer timer(_simplify_collector);
+
+  MeshSimplifier simplifier;
+  return r_simplify(root, simplifier, ratio);
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: SceneGraphReducer::unify
 //       Access: Published
@@ -269,7 +370,8 @@ check_live_flatten(PandaNode *node) {
 ////////////////////////////////////////////////////////////////////
 void SceneGraphReducer::
 r_apply_attribs(PandaNode *node, const AccumulatedAttribs &attribs,
-                int attrib_types, GeomTransformer &transformer) {
+                int attrib_types, GeomTransformer &transformer,
+                bool parallel) {
   if (pgraph_cat.is_spam()) {
     pgraph_cat.spam()
       << "r_apply_attribs(" << *node << "), node's attribs are:\n";
@@ -398,13 +500,51 @@ r_apply_attribs(PandaNode *node, const AccumulatedAttribs &attribs,
 
   // Now it's safe to traverse through all of our children.
   nassertv(num_children == node->get_num_children());
-  for (i = 0; i < num_children; i++) {
-    PandaNode *child_node = node->get_child(i);
-    r_apply_attribs(child_node, next_attribs, attrib_types, transformer);
+  if (parallel && num_children >= 2 && FlattenBatch::get_num_threads() != 0) {
+    apply_attribs_children(node, next_attribs, attrib_types, transformer);
+  } else {
+    for (i = 0; i < num_children; i++) {
+      PandaNode *child_node = node->get_child(i);
+      r_apply_attribs(child_node, next_attribs, attrib_types, transformer,
+                      parallel);
+    }
   }
   Thread::consider_yield();
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: SceneGraphReducer::apply_attribs_children
+//       Access: Protected
+//  Description: Calls r_apply_attribs() on each of the children of
+//               the indicated node, applying the attribs to the
+//               independent subgraphs below them in parallel.  The
+//               transformer is shared, so vertices shared between
+//               subgraphs are still transformed only once.
+////////////////////////////////////////////////////////////////////
+void SceneGraphReducer::
+apply_attribs_children(PandaNode *node, const AccumulatedAttribs &attribs,
+                       int attrib_types, GeomTransformer &transformer) {
+  PandaNode::Children cr = node->get_children();
+  int num_children = cr.get_num_children();
+
+  ApplyAttribsBatch batch(this, attribs, attrib_types, transformer);
+  pvector<PandaNode *> serial_nodes;
+  for (int i = 0; i < num_children; i++) {
+    PandaNode *child_node = cr.get_child(i);
+    if (is_independent_subgraph(child_node)) {
+      batch._nodes.push_back(child_node);
+    } else {
+      serial_nodes.push_back(child_node);
+    }
+  }
+  batch.run((int)batch._nodes.size());
+
+  pvector<PandaNode *>::const_iterator ni;
+  for (ni = serial_nodes.begin(); ni != serial_nodes.end(); ++ni) {
+    r_apply_attribs(*ni, attribs, attrib_types, transformer);
+  }
+}
+
 
 ////////////////////////////////////////////////////////////////////
 //     Function: SceneGraphReducer::r_flatten
@@ -413,7 +553,7 @@ r_apply_attribs(PandaNode *node, const AccumulatedAttribs &attribs,
 ////////////////////////////////////////////////////////////////////
 int SceneGraphReducer::
 r_flatten(PandaNode *grandparent_node, PandaNode *parent_node,
-          int combine_siblings_bits) {
+          int combine_siblings_bits, bool parallel) {
   if (pgraph_cat.is_spam()) {
     pgraph_cat.spam()
       << "SceneGraphReducer::r_flatten(" << *grandparent_node << ", " 
@@ -430,92 +570,184 @@ r_flatten(PandaNode *grandparent_node, PandaNode *parent_node,
     }
     
   } else {
-    if ((combine_siblings_bits & CS_within_radius) != 0) {
-      CPT(BoundingVolume) bv = parent_node->get_bounds();
-      if (bv->is_of_type(BoundingSphere::get_class_type())) {
-        const BoundingSphere *bs = DCAST(BoundingSphere, bv);
+    combine_siblings_bits = check_combine_radius(parent_node, combine_siblings_bits);
+
+    // First, recurse on each of the children.
+    num_nodes += flatten_children(parent_node, combine_siblings_bits, parallel);
+
+    // Then flatten this node with its children, or its children with
+    // each other.
+    num_nodes += flatten_parent(grandparent_node, parent_node,
+                                combine_siblings_bits);
+  }
+
+  return num_nodes;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: SceneGraphReducer::check_combine_radius
+//       Access: Protected
+//  Description: If CS_within_radius is set, and the indicated node
+//               fits within the combine radius, returns the
+//               combine_siblings_bits that should be used to flatten
+//               more tightly from here on down.  Otherwise, returns
+//               combine_siblings_bits unchanged.
+////////////////////////////////////////////////////////////////////
+int SceneGraphReducer::
+check_combine_radius(PandaNode *parent_node, int combine_siblings_bits) {
+  if ((combine_siblings_bits & CS_within_radius) != 0) {
+    CPT(BoundingVolume) bv = parent_node->get_bounds();
+    if (bv->is_of_type(BoundingSphere::get_class_type())) {
+      const BoundingSphere *bs = DCAST(BoundingSphere, bv);
+      if (pgraph_cat.is_spam()) {
+        pgraph_cat.spam()
+          << "considering radius of " << *parent_node
+          << ": " << *bs << " vs. " << _combine_radius << "\n";
+      }
+      if (!bs->is_infinite() && (bs->is_empty() || bs->get_radius() <= _combine_radius)) {
+        // This node fits within the specified radius; from here on
+        // down, we will have CS_other set, instead of
+        // CS_within_radius.
         if (pgraph_cat.is_spam()) {
           pgraph_cat.spam()
-            << "considering radius of " << *parent_node
-            << ": " << *bs << " vs. " << _combine_radius << "\n";
-        }
-        if (!bs->is_infinite() && (bs->is_empty() || bs->get_radius() <= _combine_radius)) {
-          // This node fits within the specified radius; from here on
-          // down, we will have CS_other set, instead of
-          // CS_within_radius.
-          if (pgraph_cat.is_spam()) {
-            pgraph_cat.spam()
-              << "node fits within radius; flattening tighter.\n";
-          }
-          combine_siblings_bits &= ~CS_within_radius;
-          combine_siblings_bits |= (CS_geom_node | CS_other | CS_recurse);
+            << "node fits within radius; flattening tighter.\n";
         }
+        combine_siblings_bits &= ~CS_within_radius;
+        combine_siblings_bits |= (CS_geom_node | CS_other | CS_recurse);
       }
     }
+  }
 
-    // First, recurse on each of the children.
-    {
-      PandaNode::Children cr = parent_node->get_children();
-      int num_children = cr.get_num_children();
-      for (int i = 0; i < num_children; i++) {
-        PT(PandaNode) child_node = cr.get_child(i);
-        num_nodes += r_flatten(parent_node, child_node, combine_siblings_bits);
-      }
+  return combine_siblings_bits;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: SceneGraphReducer::flatten_children
+//       Access: Protected
+//  Description: Calls r_flatten() on each of the children of the
+//               indicated node.
+//
+//               If parallel is true and flatten-threads is nonzero,
+//               the subgraphs below the children are flattened at the
+//               same time, except for those that share nodes with
+//               other parts of the graph.  The children themselves
+//               are then flattened with their own children in order,
+//               so the result is the same as flattening serially.  If
+//               there is only one child, we look further down for a
+//               node with several children to split the work on.
+////////////////////////////////////////////////////////////////////
+int SceneGraphReducer::
+flatten_children(PandaNode *parent_node, int combine_siblings_bits,
+                 bool parallel) {
+  int num_nodes = 0;
+
+  // Get a copy of the children list, so we don't have to worry
+  // about self-modifications.
+  PandaNode::Children cr = parent_node->get_children();
+  int num_children = cr.get_num_children();
+
+  if (!parallel || num_children < 2 || FlattenBatch::get_num_threads() == 0) {
+    for (int i = 0; i < num_children; i++) {
+      PT(PandaNode) child_node = cr.get_child(i);
+      num_nodes += r_flatten(parent_node, child_node, combine_siblings_bits,
+                             parallel);
     }
-    
-    // Now that the above loop has removed some children, the child
-    // list saved above is no longer accurate, so hereafter we must
-    // ask the node for its real child list.
-    
-    // If we have CS_recurse set, then we flatten siblings before
-    // trying to flatten children.  Otherwise, we flatten children
-    // first, and then flatten siblings, which avoids overly
-    // enthusiastic flattening.
-    if ((combine_siblings_bits & CS_recurse) != 0 && 
-        parent_node->get_num_children() >= 2 &&
-        parent_node->safe_to_combine_children()) {
-      num_nodes += flatten_siblings(parent_node, combine_siblings_bits);
+    return num_nodes;
+  }
+
+  FlattenChildrenBatch batch(this);
+  vector_int job_index(num_children, -1);
+  for (int i = 0; i < num_children; i++) {
+    PandaNode *child_node = cr.get_child(i);
+    if (child_node->safe_to_flatten_below() &&
+        is_independent_subgraph(child_node)) {
+      job_index[i] = (int)batch._nodes.size();
+      batch._nodes.push_back(child_node);
+      batch._bits.push_back(check_combine_radius(child_node, combine_siblings_bits));
     }
+  }
+  batch._results.assign(batch._nodes.size(), 0);
+  batch.run((int)batch._nodes.size());
+
+  for (int i = 0; i < num_children; i++) {
+    PT(PandaNode) child_node = cr.get_child(i);
+    int ji = job_index[i];
+    if (ji >= 0) {
+      num_nodes += batch._results[ji];
+      num_nodes += flatten_parent(parent_node, child_node, batch._bits[ji]);
+    } else {
+      num_nodes += r_flatten(parent_node, child_node, combine_siblings_bits);
+    }
+  }
+
+  return num_nodes;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: SceneGraphReducer::flatten_parent
+//       Access: Protected
+//  Description: The second half of r_flatten(), called after the
+//               children of parent_node have been flattened.  Removes
+//               parent_node if it can be combined with its one
+//               remaining child, combines its children with each
+//               other, and removes any leftover empty children.
+////////////////////////////////////////////////////////////////////
+int SceneGraphReducer::
+flatten_parent(PandaNode *grandparent_node, PandaNode *parent_node,
+               int combine_siblings_bits) {
+  int num_nodes = 0;
+
+  // Now that the children have been flattened, some of them may have
+  // been removed, so we must ask the node for its real child list.
+    
+  // If we have CS_recurse set, then we flatten siblings before
+  // trying to flatten children.  Otherwise, we flatten children
+  // first, and then flatten siblings, which avoids overly
+  // enthusiastic flattening.
+  if ((combine_siblings_bits & CS_recurse) != 0 && 
+      parent_node->get_num_children() >= 2 &&
+      parent_node->safe_to_combine_children()) {
+    num_nodes += flatten_siblings(parent_node, combine_siblings_bits);
+  }
 
-    if (parent_node->get_num_children() == 1) {
-      // If we now have exactly one child, consider flattening the node
-      // out.
-      PT(PandaNode) child_node = parent_node->get_child(0);
-      int child_sort = parent_node->get_child_sort(0);
+  if (parent_node->get_num_children() == 1) {
+    // If we now have exactly one child, consider flattening the node
+    // out.
+    PT(PandaNode) child_node = parent_node->get_child(0);
+    int child_sort = parent_node->get_child_sort(0);
+    
+    if (consider_child(grandparent_node, parent_node, child_node)) {
+      // Ok, do it.
+      parent_node->remove_child(child_node);
       
-      if (consider_child(grandparent_node, parent_node, child_node)) {
-        // Ok, do it.
-        parent_node->remove_child(child_node);
-        
-        if (do_flatten_child(grandparent_node, parent_node, child_node)) {
-          // Done!
-          num_nodes++;
-        } else {
-          // Chicken out.
-          parent_node->add_child(child_node, child_sort);
-        }
+      if (do_flatten_child(grandparent_node, parent_node, child_node)) {
+        // Done!
+        num_nodes++;
+      } else {
+        // Chicken out.
+        parent_node->add_child(child_node, child_sort);
       }
     }
+  }
 
-    if ((combine_siblings_bits & CS_recurse) == 0 &&
-        (combine_siblings_bits & ~CS_recurse) != 0 && 
-        parent_node->get_num_children() >= 2 &&
-        parent_node->safe_to_combine_children()) {
-      num_nodes += flatten_siblings(parent_node, combine_siblings_bits);
-    }
+  if ((combine_siblings_bits & CS_recurse) == 0 &&
+      (combine_siblings_bits & ~CS_recurse) != 0 && 
+      parent_node->get_num_children() >= 2 &&
+      parent_node->safe_to_combine_children()) {
+    num_nodes += flatten_siblings(parent_node, combine_siblings_bits);
+  }
 
-    // Finally, if any of our remaining children are plain PandaNodes
-    // with no children, just remove them.
-    if (parent_node->safe_to_combine_children()) {
-      for (int i = parent_node->get_num_children() - 1; i >= 0; --i) {
-        PandaNode *child_node = parent_node->get_child(i);
-        if (child_node->is_exact_type(PandaNode::get_class_type()) &&
-            child_node->get_num_children() == 0 &&
-            child_node->get_transform()->is_identity() &&
-            child_node->get_effects()->is_empty()) {
-          parent_node->remove_child(child_node);
-          ++num_nodes;
-        }
+  // Finally, if any of our remaining children are plain PandaNodes
+  // with no children, just remove them.
+  if (parent_node->safe_to_combine_children()) {
+    for (int i = parent_node->get_num_children() - 1; i >= 0; --i) {
+      PandaNode *child_node = parent_node->get_child(i);
+      if (child_node->is_exact_type(PandaNode::get_class_type()) &&
+          child_node->get_num_children() == 0 &&
+          child_node->get_transform()->is_identity() &&
+          child_node->get_effects()->is_empty()) {
+        parent_node->remove_child(child_node);
+        ++num_nodes;
       }
     }
   }
@@ -523,6 +755,30 @@ r_flatten(PandaNode *grandparent_node, PandaNode *parent_node,
   return num_nodes;
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: SceneGraphReducer::is_independent_subgraph
+//       Access: Protected, Static
+//  Description: Returns true if no node at the indicated node or
+//               below has more than one parent, so that the subgraph
+//               may be modified without affecting any other part of
+//               the scene graph.
+////////////////////////////////////////////////////////////////////
+bool SceneGraphReducer::
+is_independent_subgraph(PandaNode *node) {
+  if (node->get_num_parents() > 1) {
+    return false;
+  }
+
+  PandaNode::Children cr = node->get_children();
+  int num_children = cr.get_num_children();
+  for (int i = 0; i < num_children; i++) {
+    if (!is_independent_subgraph(cr.get_child(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
 class SortByState {
 public:
   INLINE bool
@@ -1023,6 +1279,71 @@ r_decompose(PandaNode *node) {
   }
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: SceneGraphReducer::r_optimize_vertex_cache
+//       Access: Private
+//  Description: The recursive implementation of
+//               optimize_vertex_cache().
+////////////////////////////////////////////////////////////////////
+int SceneGraphReducer::
+r_optimize_vertex_cache(PandaNode *node, int cache_size,
+                        bool sort_for_overdraw,
+                        GeomTransformer &transformer) {
+  int num_changed = 0;
+
+  if (node->is_geom_node()) {
+    if (transformer.optimize_vertex_cache(DCAST(GeomNode, node), cache_size,
+                                          sort_for_overdraw)) {
+      ++num_changed;
+    }
+  }
+
+  PandaNode::Children children = node->get_children();
+  int num_children = children.get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    num_changed +=
+      r_optimize_vertex_cache(children.get_child(i), cache_size,
+                              sort_for_overdraw, transformer);
+  }
+
+  return num_changed;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: SceneGraphReducer::r_simplify
+//       Access: Private
+//  Description: The recursive implementation of simplify().
+////////////////////////////////////////////////////////////////////
+int SceneGraphReducer::
+r_simplify(PandaNode *node, MeshSimplifier &simplifier, PN_stdfloat ratio) {
+  int num_changed = 0;
+
+  if (node->is_geom_node()) {
+    GeomNode *gnode = DCAST(GeomNode, node);
+    bool any_changed = false;
+    int num_geoms = gnode->get_num_geoms();
+    for (int i = 0; i < num_geoms; ++i) {
+      CPT(Geom) geom = gnode->get_geom(i);
+      PT(Geom) new_geom = simplifier.simplify(geom, ratio);
+      if (new_geom->get_nested_vertices() != geom->get_nested_vertices()) {
+        gnode->set_geom(i, new_geom);
+        any_changed = true;
+      }
+    }
+    if (any_changed) {
+      ++num_changed;
+    }
+  }
+
+  PandaNode::Children children = node->get_children();
+  int num_children = children.get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    num_changed += r_simplify(children.get_child(i), simplifier, ratio);
+  }
+
+  return num_changed;
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: SceneGraphReducer::r_premunge
 //       Access: Private
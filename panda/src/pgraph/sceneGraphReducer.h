@@ -21,6 +21,7 @@
 #include "renderState.h"
 #include "accumulatedAttribs.h"
 #include "geomTransformer.h"
+#include "meshSimplifier.h"
 #include "pStatCollector.h"
 #include "pStatTimer.h"
 #include "typedObject.h"
@@ -139,6 +140,9 @@ PUBLISHED:
   
   INLINE int make_compatible_format(PandaNode *root, int collect_bits = ~0);
   void decompose(PandaNode *root);
+  int optimize_vertex_cache(PandaNode *root, int cache_size = 32,
+                            bool sort_for_overdraw = false);
+  int simplify(PandaNode *root, PN_stdfloat ratio);
 
   INLINE int collect_vertex_data(PandaNode *root, int collect_bits = ~0);
   INLINE int make_nonindexed(PandaNode *root, int nonindexed_bits = ~0);
@@ -150,10 +154,20 @@ PUBLISHED:
 
 protected:
   void r_apply_attribs(PandaNode *node, const AccumulatedAttribs &attribs,
-                       int attrib_types, GeomTransformer &transformer);
+                       int attrib_types, GeomTransformer &transformer,
+                       bool parallel = false);
+  void apply_attribs_children(PandaNode *node,
+                              const AccumulatedAttribs &attribs,
+                              int attrib_types, GeomTransformer &transformer);
 
   int r_flatten(PandaNode *grandparent_node, PandaNode *parent_node,
-                int combine_siblings_bits);
+                int combine_siblings_bits, bool parallel = false);
+  int check_combine_radius(PandaNode *parent_node, int combine_siblings_bits);
+  int flatten_children(PandaNode *parent_node, int combine_siblings_bits,
+                       bool parallel);
+  int flatten_parent(PandaNode *grandparent_node, PandaNode *parent_node,
+                     int combine_siblings_bits);
+  static bool is_independent_subgraph(PandaNode *node);
   int flatten_siblings(PandaNode *parent_node,
                        int combine_siblings_bits);
 
@@ -184,10 +198,18 @@ protected:
   void r_unify(PandaNode *node, int max_indices, bool preserve_order);
   void r_register_vertices(PandaNode *node, GeomTransformer &transformer);
   void r_decompose(PandaNode *node);
+  int r_optimize_vertex_cache(PandaNode *node, int cache_size,
+                              bool sort_for_overdraw,
+                              GeomTransformer &transformer);
+  int r_simplify(PandaNode *node, MeshSimplifier &simplifier,
+                 PN_stdfloat ratio);
 
   void r_premunge(PandaNode *node, const RenderState *state);
 
 private:
+  class FlattenChildrenBatch;
+  class ApplyAttribsBatch;
+
   PT(GraphicsStateGuardianBase) _gsg;
   PN_stdfloat _combine_radius;
   GeomTransformer _transformer;
@@ -200,6 +222,8 @@ private:
   static PStatCollector _make_nonindexed_collector;
   static PStatCollector _unify_collector;
   static PStatCollector _remove_unused_collector;
+  static PStatCollector _vertex_cache_collector;
+  static PStatCollector _simplify_collector;
   static PStatCollector _premunge_collector;
 };
 
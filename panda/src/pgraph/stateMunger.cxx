@@ -13,6 +13,7 @@
 ////////////////////////////////////////////////////////////////////
 
 #include "stateMunger.h"
+#include "lightMutexHolder.h"
 
 TypeHandle StateMunger::_type_handle;
 
@@ -32,18 +33,24 @@ StateMunger::
 ////////////////////////////////////////////////////////////////////
 CPT(RenderState) StateMunger::
 munge_state(const RenderState *state) {
-  WCPT(RenderState) pt_state = state;
-
-  StateMap::iterator mi = _state_map.find(pt_state);
-  if (mi != _state_map.end()) {
-    if (!(*mi).first.was_deleted() &&
-        !(*mi).second.was_deleted()) {
-      return (*mi).second.p();
+  {
+    LightMutexHolder holder(_state_map_lock);
+    int mi = _state_map.find(state);
+    if (mi != -1) {
+      const MungedState &munged = _state_map.get_data(mi);
+      if (!munged._state.was_deleted() &&
+          !munged._result.was_deleted()) {
+        return munged._result.p();
+      }
     }
   }
 
+  // Compute the result outside of the lock.  If another thread is
+  // doing the same thing, it will compute the same result.
   CPT(RenderState) result = munge_state_impl(state);
-  _state_map[pt_state] = result;
+
+  LightMutexHolder holder(_state_map_lock);
+  _state_map.store(state, MungedState(state, result));
 
   return result;
 }
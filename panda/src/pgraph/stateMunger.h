@@ -19,6 +19,8 @@
 #include "geomMunger.h"
 #include "renderState.h"
 #include "weakPointerTo.h"
+#include "simpleHashMap.h"
+#include "lightMutex.h"
 
 ////////////////////////////////////////////////////////////////////
 //       Class : StateMunger
@@ -36,9 +38,24 @@ public:
 protected:
   virtual CPT(RenderState) munge_state_impl(const RenderState *state);
 
-  typedef pmap< WCPT(RenderState), WCPT(RenderState) > StateMap;
+  // This is consulted for every object rendered, so it is a hash map
+  // keyed on the source state pointer.  We keep weak pointers to both
+  // the source and the result, so we can tell if either has since
+  // been deleted (and the source pointer possibly reused).
+  class MungedState {
+  public:
+    INLINE MungedState(const RenderState *state, const RenderState *result) :
+      _state(state), _result(result) {}
+    WCPT(RenderState) _state;
+    WCPT(RenderState) _result;
+  };
+  typedef SimpleHashMap<const RenderState *, MungedState, pointer_hash> StateMap;
   StateMap _state_map;
 
+  // Several DisplayRegions of the same GSG may be culled at once, in
+  // different threads, so the map needs a lock of its own.
+  LightMutex _state_map_lock;
+
 public:
   static TypeHandle get_class_type() {
     return _type_handle;
@@ -0,0 +1,134 @@
+// Filename: test_cull_borrow.cxx
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#include "pandaNode.h"
+#include "nodePath.h"
+#include "cullTraverserData.h"
+#include "transformState.h"
+#include "renderState.h"
+#include "colorScaleAttrib.h"
+#include "config_pgraph.h"
+#include "clockObject.h"
+#include "thread.h"
+
+#include <stdlib.h>
+
+// This program measures the cost of reference counting in the cull
+// traversal.  It builds a tree of about 100,000 nodes, most of which
+// have a transform and some of which have a state, and walks it the
+// way CullTraverser does: creating a CullTraverserData for each node
+// from its parent's, and composing the node's transform and state
+// onto it.  The walk is repeated with cull-borrow-pointers off and on.
+//
+// Usage: test_cull_borrow [fanout [depth [iterations]]]
+//
+// The default tree has a fanout of 10 and a depth of 5, or 111,111
+// nodes.  The net transform checksum printed for both modes should be
+// the same.
+
+static PT(PandaNode)
+make_tree(int fanout, int depth, int &num_nodes) {
+  PT(PandaNode) node = new PandaNode("node");
+  ++num_nodes;
+
+  // Every other node has a transform, and every tenth has a state,
+  // which is a bit more than a typical scene.
+  if ((num_nodes % 2) == 0) {
+    node->set_transform(TransformState::make_pos
+                        (LVecBase3((PN_stdfloat)(num_nodes % 7), 
+                                   (PN_stdfloat)(num_nodes % 5), 0.0f)));
+  }
+  if ((num_nodes % 10) == 0) {
+    node->set_state(RenderState::make
+                    (ColorScaleAttrib::make(LVecBase4(0.5f, 0.5f, 0.5f, 1.0f))));
+  }
+
+  if (depth > 0) {
+    for (int i = 0; i < fanout; ++i) {
+      node->add_child(make_tree(fanout, depth - 1, num_nodes));
+    }
+  }
+  return node;
+}
+
+static void
+r_walk(const CullTraverserData &data, int &num_nodes, double &sum) {
+  ++num_nodes;
+  sum += data._net_transform->get_pos()[0];
+
+  PandaNode::Children children = data.node_reader()->get_children();
+  int num_children = children.get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    CullTraverserData next_data(data, children.get_child(i));
+
+    const TransformState *transform = next_data.node_reader()->get_transform();
+    if (!transform->is_identity()) {
+      next_data._net_transform = next_data._net_transform->compose(transform);
+    }
+    const RenderState *state = next_data.node_reader()->get_state();
+    if (!state->is_empty()) {
+      next_data._state = next_data._state->compose(state);
+    }
+
+    r_walk(next_data, num_nodes, sum);
+  }
+}
+
+static double
+time_walk(PandaNode *root, bool borrow, int iterations, 
+          int &num_nodes, double &sum) {
+  cull_borrow_pointers.set_value(borrow);
+
+  ClockObject *clock = ClockObject::get_global_clock();
+  double start = clock->get_real_time();
+  for (int i = 0; i < iterations; ++i) {
+    num_nodes = 0;
+    sum = 0.0;
+    CullTraverserData data(NodePath(root), TransformState::make_identity(),
+                           RenderState::make_empty(), NULL,
+                           Thread::get_current_thread());
+    r_walk(data, num_nodes, sum);
+  }
+  double end = clock->get_real_time();
+  return (end - start) / (double)iterations;
+}
+
+int
+main(int argc, char *argv[]) {
+  int fanout = (argc > 1) ? atoi(argv[1]) : 10;
+  int depth = (argc > 2) ? atoi(argv[2]) : 5;
+  int iterations = (argc > 3) ? atoi(argv[3]) : 20;
+
+  int num_nodes = 0;
+  PT(PandaNode) root = make_tree(fanout, depth, num_nodes);
+  cerr << "built " << num_nodes << " nodes\n";
+
+  // Warm up the state caches, so both modes compose the same way.
+  double sum;
+  time_walk(root, false, 1, num_nodes, sum);
+
+  double owned = time_walk(root, false, iterations, num_nodes, sum);
+  cerr << "owned pointers:    " << owned * 1000.0 << " ms per walk ("
+       << num_nodes << " nodes, checksum " << sum << ")\n";
+
+  double borrowed = time_walk(root, true, iterations, num_nodes, sum);
+  cerr << "borrowed pointers: " << borrowed * 1000.0 << " ms per walk ("
+       << num_nodes << " nodes, checksum " << sum << ")\n";
+
+  cerr << "saving: " << (owned - borrowed) * 1000.0 << " ms per walk, "
+       << (owned - borrowed) / (double)num_nodes * 1.0e9 << " ns per node ("
+       << (1.0 - borrowed / owned) * 100.0 << "%)\n";
+
+  return 0;
+}
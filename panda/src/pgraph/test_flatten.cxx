@@ -0,0 +1,185 @@
+// Filename: test_flatten.cxx
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#include "pandaNode.h"
+#include "geomNode.h"
+#include "nodePath.h"
+#include "geom.h"
+#include "geomTriangles.h"
+#include "geomVertexData.h"
+#include "geomVertexFormat.h"
+#include "geomVertexWriter.h"
+#include "geomVertexReader.h"
+#include "colorAttrib.h"
+#include "config_pgraph.h"
+#include "load_prc_file.h"
+#include "clockObject.h"
+#include "flattenBatch.h"
+
+#include <stdlib.h>
+
+// This program measures the throughput of flatten_strong() on a
+// synthetic "city": a grid of blocks, each containing a number of
+// buildings, each of which is a box with subdivided walls.  Every
+// building has its own transform and color, so flattening must
+// transform and recolor all of the vertices before collecting them.
+//
+// Usage: test_flatten [num_threads [blocks_per_side [buildings_per_block [subdiv]]]]
+//
+// It prints the time taken and a checksum of the flattened result,
+// which should not depend on the number of threads.
+
+static PT(Geom)
+make_building(int subdiv) {
+  PT(GeomVertexData) vdata = new GeomVertexData
+    ("building", GeomVertexFormat::get_v3n3(), Geom::UH_static);
+  GeomVertexWriter vertex(vdata, InternalName::get_vertex());
+  GeomVertexWriter normal(vdata, InternalName::get_normal());
+  PT(GeomTriangles) tris = new GeomTriangles(Geom::UH_static);
+
+  // Four walls, each a grid of subdiv x subdiv quads.
+  static const PN_stdfloat walls[4][4] = {
+    { 1, 0, 0, 1 }, { 0, 1, -1, 0 }, { -1, 0, 0, -1 }, { 0, -1, 1, 0 },
+  };
+  int row = 0;
+  for (int w = 0; w < 4; ++w) {
+    LVector3 n(walls[w][0], walls[w][1], 0.0f);
+    LVector3 across(walls[w][2], walls[w][3], 0.0f);
+    LPoint3 origin = LPoint3(n) * 0.5f - across * 0.5f;
+    for (int j = 0; j <= subdiv; ++j) {
+      for (int i = 0; i <= subdiv; ++i) {
+        PN_stdfloat u = (PN_stdfloat)i / (PN_stdfloat)subdiv;
+        PN_stdfloat v = (PN_stdfloat)j / (PN_stdfloat)subdiv;
+        vertex.add_data3(origin + across * u + LVector3(0.0f, 0.0f, v));
+        normal.add_data3(n);
+      }
+    }
+    for (int j = 0; j < subdiv; ++j) {
+      for (int i = 0; i < subdiv; ++i) {
+        int a = row + j * (subdiv + 1) + i;
+        int b = a + 1;
+        int c = a + (subdiv + 1);
+        int d = c + 1;
+        tris->add_vertices(a, b, d);
+        tris->add_vertices(a, d, c);
+      }
+    }
+    row += (subdiv + 1) * (subdiv + 1);
+  }
+
+  PT(Geom) geom = new Geom(vdata);
+  geom->add_primitive(tris);
+  return geom;
+}
+
+static PT(PandaNode)
+make_city(int blocks_per_side, int buildings_per_block, int subdiv,
+          int &num_triangles) {
+  PT(PandaNode) city = new PandaNode("city");
+  PT(Geom) building = make_building(subdiv);
+  int side = 1;
+  while (side * side < buildings_per_block) {
+    ++side;
+  }
+
+  num_triangles = 0;
+  for (int by = 0; by < blocks_per_side; ++by) {
+    for (int bx = 0; bx < blocks_per_side; ++bx) {
+      PT(PandaNode) block = new PandaNode("block");
+      block->set_transform(TransformState::make_pos
+                           (LVecBase3(bx * side * 3.0f, by * side * 3.0f, 0.0f)));
+      city->add_child(block);
+
+      for (int i = 0; i < buildings_per_block; ++i) {
+        // Each building gets its own copy of the vertices, as though
+        // it had been loaded from a separate model.
+        PT(Geom) geom = building->make_copy();
+        geom->set_vertex_data(new GeomVertexData(*building->get_vertex_data()));
+
+        PT(GeomNode) gnode = new GeomNode("building");
+        gnode->add_geom(geom);
+        PN_stdfloat height = 1.0f + (PN_stdfloat)((i * 7 + bx * 3 + by) % 10);
+        gnode->set_transform(TransformState::make_pos_hpr_scale
+                             (LVecBase3((i % side) * 3.0f, (i / side) * 3.0f, 0.0f),
+                              LVecBase3((PN_stdfloat)(i * 15 % 90), 0.0f, 0.0f),
+                              LVecBase3(2.0f, 2.0f, height)));
+        gnode->set_state(RenderState::make
+                         (ColorAttrib::make_flat(LColor((i % 4) * 0.25f, 0.5f, 0.5f, 1.0f))));
+        block->add_child(gnode);
+        num_triangles += subdiv * subdiv * 8;
+      }
+    }
+  }
+
+  return city;
+}
+
+static void
+r_checksum(PandaNode *node, int &num_nodes, int &num_vertices, double &sum) {
+  ++num_nodes;
+  if (node->is_geom_node()) {
+    GeomNode *gnode = DCAST(GeomNode, node);
+    for (int i = 0; i < gnode->get_num_geoms(); ++i) {
+      CPT(GeomVertexData) vdata = gnode->get_geom(i)->get_vertex_data();
+      num_vertices += vdata->get_num_rows();
+      GeomVertexReader vertex(vdata, InternalName::get_vertex());
+      while (!vertex.is_at_end()) {
+        const LVecBase3 &v = vertex.get_data3();
+        sum += v[0] + v[1] * 3.0 + v[2] * 7.0;
+      }
+    }
+  }
+  PandaNode::Children cr = node->get_children();
+  for (int i = 0; i < cr.get_num_children(); ++i) {
+    r_checksum(cr.get_child(i), num_nodes, num_vertices, sum);
+  }
+}
+
+int
+main(int argc, char *argv[]) {
+  int num_threads = (argc > 1) ? atoi(argv[1]) : 0;
+  int blocks_per_side = (argc > 2) ? atoi(argv[2]) : 16;
+  int buildings_per_block = (argc > 3) ? atoi(argv[3]) : 64;
+  int subdiv = (argc > 4) ? atoi(argv[4]) : 8;
+
+  // The flatten thread chain is created with this many threads the
+  // first time it is needed.
+  flatten_threads.set_value(num_threads);
+  load_prc_file_data("", "max-collect-vertices 1000000\n");
+
+  int num_triangles;
+  PT(PandaNode) city = make_city(blocks_per_side, buildings_per_block,
+                                 subdiv, num_triangles);
+  NodePath np(city);
+
+  ClockObject *clock = ClockObject::get_global_clock();
+  double start = clock->get_real_time();
+  int num_removed = np.flatten_strong();
+  double end = clock->get_real_time();
+
+  int num_nodes = 0;
+  int num_vertices = 0;
+  double sum = 0.0;
+  r_checksum(city, num_nodes, num_vertices, sum);
+
+  double elapsed = end - start;
+  cerr << "flatten-threads " << FlattenBatch::get_num_threads()
+       << ": flattened " << num_triangles << " triangles in "
+       << elapsed << " s (" << num_triangles / elapsed / 1000000.0
+       << " Mtris/s), removed " << num_removed << " nodes\n"
+       << "result: " << num_nodes << " nodes, " << num_vertices
+       << " vertices, checksum " << sum << "\n";
+
+  return 0;
+}
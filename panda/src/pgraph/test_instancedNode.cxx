@@ -0,0 +1,245 @@
+// Filename: test_instancedNode.cxx
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#include "instancedNode.h"
+#include "config_pgraph.h"
+#include "shaderAttrib.h"
+#include "boundingSphere.h"
+#include "geom.h"
+#include "geomTriangles.h"
+#include "geomVertexData.h"
+#include "geomVertexFormat.h"
+#include "geomVertexReader.h"
+#include "geomVertexWriter.h"
+#include "clockObject.h"
+#include "thread.h"
+#include "pnotify.h"
+
+// This program checks how an InstancedNode splits its visible
+// instances into batches, what each batch uploads, and that the
+// batches are reused from frame to frame and from one DisplayRegion
+// to another.  It calls make_batches() directly, which is what
+// add_for_draw() does once it has decided whether the GSG can draw
+// hardware instances.
+
+static int num_failures = 0;
+
+static void
+check(bool ok, const string &what) {
+  if (!ok) {
+    nout << "FAILED: " << what << "\n";
+    ++num_failures;
+  }
+}
+
+// make_batches() only uses the DisplayRegion pointer to tell its
+// caches apart, so any two distinct addresses will do.
+static char region_a_tag, region_b_tag;
+static const DisplayRegion *region_a = (const DisplayRegion *)&region_a_tag;
+static const DisplayRegion *region_b = (const DisplayRegion *)&region_b_tag;
+
+static const int num_instances = 10;
+static const int batch_size = 4;
+
+// A single triangle, with one corner at the origin.
+static PT(Geom)
+make_triangle() {
+  PT(GeomVertexData) vdata =
+    new GeomVertexData("triangle", GeomVertexFormat::get_v3(),
+                       GeomEnums::UH_static);
+  GeomVertexWriter vertex(vdata, InternalName::get_vertex());
+  vertex.add_data3(0.0f, 0.0f, 0.0f);
+  vertex.add_data3(1.0f, 0.0f, 0.0f);
+  vertex.add_data3(0.0f, 1.0f, 0.0f);
+
+  PT(GeomTriangles) tris = new GeomTriangles(GeomEnums::UH_static);
+  tris->add_vertices(0, 1, 2);
+  tris->close_primitive();
+
+  PT(Geom) geom = new Geom(vdata);
+  geom->add_primitive(tris);
+  return geom;
+}
+
+static LMatrix4
+instance_mat(int i) {
+  return LMatrix4::translate_mat(10.0f * i, 0.0f, 0.0f);
+}
+
+// Returns the transforms that a hardware batch uploads.
+static const LMatrix4 *
+get_transforms(const InstancedNode::DrawBatch &batch, int &num_transforms) {
+  const ShaderAttrib *sattr = DCAST(ShaderAttrib, batch._state->get_attrib_def(ShaderAttrib::get_class_slot()));
+  const Shader::ShaderPtrData *ptr =
+    sattr->get_shader_input_ptr(InstancedNode::get_transforms_name());
+  if (ptr == (Shader::ShaderPtrData *)NULL) {
+    num_transforms = 0;
+    return NULL;
+  }
+  num_transforms = ptr->_size / 16;
+  return (const LMatrix4 *)ptr->_ptr;
+}
+
+static int
+get_instance_count(const InstancedNode::DrawBatch &batch) {
+  const ShaderAttrib *sattr = DCAST(ShaderAttrib, batch._state->get_attrib_def(ShaderAttrib::get_class_slot()));
+  return sattr->get_instance_count();
+}
+
+// Checks that a hardware batch draws the original Geom and uploads
+// the transforms of the indicated instances, padded with identity
+// matrices.
+static void
+check_hardware_batch(const InstancedNode::DrawBatch &batch, const Geom *geom,
+                     int first, int count, const string &what) {
+  check(batch._geom == geom, what + ": draws the original Geom");
+  check(get_instance_count(batch) == count, what + ": instance count");
+
+  int num_transforms;
+  const LMatrix4 *transforms = get_transforms(batch, num_transforms);
+  check(num_transforms == batch_size, what + ": transform array size");
+  if (num_transforms != batch_size) {
+    return;
+  }
+  for (int i = 0; i < batch_size; ++i) {
+    const LMatrix4 &expected =
+      (i < count) ? instance_mat(first + i) : LMatrix4::ident_mat();
+    check(transforms[i] == expected, what + ": transform values");
+  }
+}
+
+// Checks that an expanded batch holds one copy of the triangle for
+// each of the indicated instances, moved by its transform.
+static void
+check_expanded_batch(const InstancedNode::DrawBatch &batch,
+                     int first, int count, const string &what) {
+  CPT(GeomVertexData) vdata = batch._geom->get_vertex_data();
+  check(vdata->get_num_rows() == 3 * count, what + ": number of vertices");
+  check(batch._geom->get_primitive(0)->get_num_primitives() == count,
+        what + ": number of triangles");
+
+  GeomVertexReader vertex(vdata, InternalName::get_vertex());
+  for (int i = 0; i < count && !vertex.is_at_end(); ++i) {
+    LPoint3 origin = vertex.get_data3();
+    vertex.get_data3();
+    vertex.get_data3();
+    check(origin == instance_mat(first + i).get_row3(3),
+          what + ": vertex positions");
+  }
+}
+
+int
+main(int argc, char *argv[]) {
+  instanced_node_batch_size.set_value(batch_size);
+  ClockObject *clock = ClockObject::get_global_clock();
+  Thread *current_thread = Thread::get_current_thread();
+
+  PT(Geom) geom = make_triangle();
+  PT(InstancedNode) node = new InstancedNode("node");
+  node->set_geom(geom);
+  for (int i = 0; i < num_instances; ++i) {
+    node->add_instance(instance_mat(i));
+  }
+  CPT(RenderState) state = RenderState::make_empty();
+
+  // A volume that contains all of the instances but the first.
+  PT(BoundingSphere) all_but_first =
+    new BoundingSphere(LPoint3(50.0f, 0.0f, 0.0f), 42.0f);
+
+  // Hardware instancing: ten instances become batches of 4, 4 and 2.
+  InstancedNode::DrawBatches frame1;
+  node->make_batches(frame1, state, NULL, true, region_a, current_thread);
+  check(frame1.size() == 3, "hardware: three batches");
+  if (frame1.size() == 3) {
+    check_hardware_batch(frame1[0], geom, 0, 4, "hardware batch 0");
+    check_hardware_batch(frame1[1], geom, 4, 4, "hardware batch 1");
+    check_hardware_batch(frame1[2], geom, 8, 2, "hardware batch 2");
+  }
+
+  // The next frame uses the other set of states, so that the GSG
+  // sees a change and the previous frame's array is left alone.
+  clock->tick();
+  InstancedNode::DrawBatches frame2;
+  node->make_batches(frame2, state, NULL, true, region_a, current_thread);
+  if (frame1.size() == 3 && frame2.size() == 3) {
+    check(frame2[0]._state != frame1[0]._state, "hardware: alternate states");
+    check_hardware_batch(frame2[0], geom, 0, 4, "alternate batch 0");
+  }
+
+  // The frame after that reuses the first frame's states, rewriting
+  // their transforms in place, as long as the number of instances in
+  // the batch is the same.  Culling the first instance shifts the
+  // rest down by one.
+  clock->tick();
+  InstancedNode::DrawBatches frame3;
+  node->make_batches(frame3, state, all_but_first, true, region_a, current_thread);
+  check(frame3.size() == 3, "culled: three batches");
+  if (frame1.size() == 3 && frame3.size() == 3) {
+    check(frame3[0]._state == frame1[0]._state, "culled: batch 0 state reused");
+    check(frame3[1]._state == frame1[1]._state, "culled: batch 1 state reused");
+    check_hardware_batch(frame3[0], geom, 1, 4, "culled batch 0");
+    check_hardware_batch(frame3[1], geom, 5, 4, "culled batch 1");
+    check_hardware_batch(frame3[2], geom, 9, 1, "culled batch 2");
+  }
+
+  // Changing an instance is seen in the next upload.
+  clock->tick();
+  node->set_instance(2, instance_mat(2) * LMatrix4::scale_mat(2.0f));
+  InstancedNode::DrawBatches frame4;
+  node->make_batches(frame4, state, NULL, true, region_a, current_thread);
+  if (frame4.size() == 3) {
+    int num_transforms;
+    const LMatrix4 *transforms = get_transforms(frame4[0], num_transforms);
+    check(num_transforms == batch_size &&
+          transforms[2] == instance_mat(2) * LMatrix4::scale_mat(2.0f),
+          "changed instance is uploaded");
+  }
+  node->set_instance(2, instance_mat(2));
+
+  // Without hardware instancing, each batch is baked into a Geom.
+  clock->tick();
+  InstancedNode::DrawBatches expanded_a;
+  node->make_batches(expanded_a, state, NULL, false, region_a, current_thread);
+  check(expanded_a.size() == 3, "expanded: three batches");
+  if (expanded_a.size() == 3) {
+    check_expanded_batch(expanded_a[0], 0, 4, "expanded batch 0");
+    check_expanded_batch(expanded_a[1], 4, 4, "expanded batch 1");
+    check_expanded_batch(expanded_a[2], 8, 2, "expanded batch 2");
+  }
+
+  // A second DisplayRegion that sees fewer instances gets its own
+  // batches, and doesn't disturb those of the first.
+  InstancedNode::DrawBatches expanded_b;
+  node->make_batches(expanded_b, state, all_but_first, false, region_b, current_thread);
+  if (expanded_b.size() == 3) {
+    check_expanded_batch(expanded_b[0], 1, 4, "second region batch 0");
+  }
+
+  clock->tick();
+  InstancedNode::DrawBatches expanded_a2;
+  node->make_batches(expanded_a2, state, NULL, false, region_a, current_thread);
+  if (expanded_a.size() == 3 && expanded_a2.size() == 3) {
+    for (int b = 0; b < 3; ++b) {
+      check(expanded_a2[b]._geom == expanded_a[b]._geom,
+            "expanded Geoms are kept across DisplayRegions");
+    }
+  }
+
+  if (num_failures != 0) {
+    nout << num_failures << " checks failed.\n";
+    return 1;
+  }
+  nout << "InstancedNode batches are correct.\n";
+  return 0;
+}
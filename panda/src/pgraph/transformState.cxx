@@ -601,7 +601,7 @@ compose(const TransformState *other) const {
     return other;
   }
 
-  if (!transform_cache) {
+  if (!transform_cache_snapshot) {
     return do_compose(other);
   }
 
@@ -671,7 +671,7 @@ invert_compose(const TransformState *other) const {
     return make_identity();
   }
 
-  if (!transform_cache) {
+  if (!transform_cache_snapshot) {
     return do_invert_compose(other);
   }
 
@@ -717,7 +717,7 @@ invert_compose(const TransformState *other) const {
 ////////////////////////////////////////////////////////////////////
 bool TransformState::
 unref() const {
-  if (!transform_cache || garbage_collect_states) {
+  if (!transform_cache_snapshot || garbage_collect_states_snapshot) {
     // If we're not using the cache at all, or if we're relying on
     // garbage collection, just allow the pointer to unref normally.
     return ReferenceCount::unref();
@@ -733,7 +733,7 @@ unref() const {
   // limiting factor on parallelization.
   LightReMutexHolder holder(*_states_lock);
 
-  if (auto_break_cycles && uniquify_transforms) {
+  if (auto_break_cycles && uniquify_transforms_snapshot) {
     if (get_cache_ref_count() > 0 &&
         get_ref_count() == get_cache_ref_count() + 1) {
       // If we are about to remove the one reference that is not in the
@@ -1151,7 +1151,7 @@ clear_cache() {
 ////////////////////////////////////////////////////////////////////
 int TransformState::
 garbage_collect() {
-  if (_states == (States *)NULL || !garbage_collect_states) {
+  if (_states == (States *)NULL || !garbage_collect_states_snapshot) {
     return 0;
   }
   LightReMutexHolder holder(*_states_lock);
@@ -1174,7 +1174,7 @@ garbage_collect() {
     if (_states->has_element(si)) {
       ++num_elements;
       TransformState *state = (TransformState *)_states->get_key(si);
-      if (auto_break_cycles && uniquify_transforms) {
+      if (auto_break_cycles && uniquify_transforms_snapshot) {
         if (state->get_cache_ref_count() > 0 &&
             state->get_ref_count() == state->get_cache_ref_count()) {
           // If we have removed all the references to this state not in
@@ -1438,7 +1438,7 @@ init_states() {
 CPT(TransformState) TransformState::
 return_new(TransformState *state) {
   nassertr(state != (TransformState *)NULL, state);
-  if (!uniquify_transforms && !state->is_identity()) {
+  if (!uniquify_transforms_snapshot && !state->is_identity()) {
     return state;
   }
 
@@ -1461,7 +1461,7 @@ CPT(TransformState) TransformState::
 return_unique(TransformState *state) {
   nassertr(state != (TransformState *)NULL, state);
 
-  if (!transform_cache) {
+  if (!transform_cache_snapshot) {
     return state;
   }
 
@@ -1492,7 +1492,7 @@ return_unique(TransformState *state) {
   }
 
   // Not already in the set; add it.
-  if (garbage_collect_states) {
+  if (garbage_collect_states_snapshot) {
     // If we'll be garbage collecting states explicitly, we'll
     // increment the reference count when we store it in the cache, so
     // that it won't be deleted while it's in it.
@@ -1519,7 +1519,7 @@ do_compose(const TransformState *other) const {
   nassertr((_flags & F_is_invalid) == 0, this);
   nassertr((other->_flags & F_is_invalid) == 0, other);
 
-  if (compose_componentwise && 
+  if (compose_componentwise_snapshot && 
       has_uniform_scale() && 
       !has_nonzero_shear() && !other->has_nonzero_shear() &&
       ((components_given() && other->has_components()) ||
@@ -1558,7 +1558,7 @@ do_compose(const TransformState *other) const {
     }
       
 #ifndef NDEBUG
-    if (paranoid_compose) {
+    if (paranoid_compose_snapshot) {
       // Now verify against the matrix.
       LMatrix4 new_mat;
       new_mat.multiply(other->get_mat(), get_mat());
@@ -1751,7 +1751,7 @@ do_invert_compose(const TransformState *other) const {
   nassertr((_flags & F_is_invalid) == 0, this);
   nassertr((other->_flags & F_is_invalid) == 0, other);
 
-  if (compose_componentwise && 
+  if (compose_componentwise_snapshot && 
       has_uniform_scale() && 
       !has_nonzero_shear() && !other->has_nonzero_shear() &&
       ((components_given() && other->has_components()) ||
@@ -1818,7 +1818,7 @@ do_invert_compose(const TransformState *other) const {
     }
 
 #ifndef NDEBUG
-    if (paranoid_compose) {
+    if (paranoid_compose_snapshot) {
       // Now verify against the matrix.
       if (is_singular()) {
         pgraph_cat.warning()
@@ -17,6 +17,7 @@
 #include "reMutexHolder.h"
 #include "configVariableInt.h"
 #include "config_pipeline.h"
+#include "trueClock.h"
 
 Pipeline *Pipeline::_render_pipeline = (Pipeline *)NULL;
 
@@ -43,9 +44,17 @@ Pipeline(const string &name, int num_stages) :
   // add_dirty_cycler(), and cyclers get moved from dirty to clean
   // during cycle().
 
+  // add_dirty_cycler() is called from any thread that modifies a
+  // cycler, so it does not touch either list, and does not grab
+  // _lock.  Instead, it pushes the cycler onto _pending_dirty, a
+  // lock-free stack; the cyclers on that stack are moved to the
+  // _dirty list the next time the lock is held for cycle() or
+  // remove_cycler().  Thus cycle() only ever walks the dirty cyclers.
+
   // To visit each cycler once requires traversing both lists.
   _clean.make_head();
   _dirty.make_head();
+  _pending_dirty = NULL;
 
   // We also store the total count of all cyclers, clean and dirty, in
   // _num_cyclers; and the count of only dirty cyclers in
@@ -56,6 +65,10 @@ Pipeline(const string &name, int num_stages) :
   // This flag is true only during the call to cycle().
   _cycling = false;
 
+#ifdef DO_PSTATS
+  _time_cycle = false;
+#endif
+
 #endif  // THREADED_PIPELINE
 
   set_num_stages(num_stages);
@@ -70,7 +83,8 @@ Pipeline::
 ~Pipeline() {
 #ifdef THREADED_PIPELINE
   nassertv(_num_cyclers == 0);
-  nassertv(_num_dirty_cyclers == 0);
+  nassertv(AtomicAdjust::get(_num_dirty_cyclers) == 0);
+  nassertv(AtomicAdjust::get_ptr(_pending_dirty) == NULL);
   _clean.clear_head();
   _dirty.clear_head();
   nassertv(!_cycling);
@@ -91,7 +105,6 @@ cycle() {
   }
 
   pvector< PT(CycleData) > saved_cdatas;
-  saved_cdatas.reserve(_num_dirty_cyclers);
   {
     ReMutexHolder holder(_lock);
     if (_num_stages == 1) {
@@ -102,12 +115,32 @@ cycle() {
     
     nassertv(!_cycling);
     _cycling = true;
+
+    // Pick up all of the cyclers that have been made dirty since the
+    // last cycle, in one batch.
+    merge_pending_dirty();
+    saved_cdatas.reserve(AtomicAdjust::get(_num_dirty_cyclers));
     
-    // Move the dirty list to prev_dirty, for processing.
+    // Move the dirty list to prev_dirty, for processing.  Cyclers
+    // that are still dirty after cycling go back onto _dirty and
+    // remain counted; the ones that become clean are subtracted from
+    // _num_dirty_cyclers at the end.
     PipelineCyclerLinks prev_dirty;
     prev_dirty.make_head();
     prev_dirty.take_list(_dirty);
-    _num_dirty_cyclers = 0;
+    int num_cleaned = 0;
+
+#ifdef DO_PSTATS
+    double last_time = 0.0;
+    if (_time_cycle) {
+      CycleTimes::iterator ti;
+      for (ti = _cycle_times.begin(); ti != _cycle_times.end(); ++ti) {
+        (*ti).second._count = 0;
+        (*ti).second._elapsed = 0.0;
+      }
+      last_time = TrueClock::get_global_ptr()->get_short_time();
+    }
+#endif  // DO_PSTATS
 
     switch (_num_stages) {
     case 2:
@@ -125,14 +158,19 @@ cycle() {
           // The cycler is still dirty after cycling.  Keep it on the
           // dirty list for next time.
           cycler->insert_before(&_dirty);
-          ++_num_dirty_cyclers;
         } else {
           // The cycler is now clean.  Add it back to the clean list.
           cycler->insert_before(&_clean);
+          ++num_cleaned;
 #ifdef DEBUG_THREADS
           inc_cycler_type(_dirty_cycler_types, cycler->get_parent_type(), -1);
 #endif
         }
+#ifdef DO_PSTATS
+        if (_time_cycle) {
+          record_cycle_time(cycler, last_time);
+        }
+#endif
       }
       break;
 
@@ -146,13 +184,18 @@ cycle() {
         
         if (cycler->_dirty) {
           cycler->insert_before(&_dirty);
-          ++_num_dirty_cyclers;
         } else {
           cycler->insert_before(&_clean);
+          ++num_cleaned;
 #ifdef DEBUG_THREADS
           inc_cycler_type(_dirty_cycler_types, cycler->get_parent_type(), -1);
 #endif
         }
+#ifdef DO_PSTATS
+        if (_time_cycle) {
+          record_cycle_time(cycler, last_time);
+        }
+#endif
       }
       break;
 
@@ -166,19 +209,25 @@ cycle() {
         
         if (cycler->_dirty) {
           cycler->insert_before(&_dirty);
-          ++_num_dirty_cyclers;
         } else {
           cycler->insert_before(&_clean);
+          ++num_cleaned;
 #ifdef DEBUG_THREADS
           inc_cycler_type(_dirty_cycler_types, cycler->get_parent_type(), -1);
 #endif
         }
+#ifdef DO_PSTATS
+        if (_time_cycle) {
+          record_cycle_time(cycler, last_time);
+        }
+#endif
       }
       break;
     }
       
     // Now we're ready for the next frame.
     prev_dirty.clear_head();
+    AtomicAdjust::add(_num_dirty_cyclers, -num_cleaned);
     _cycling = false;
   }
 
@@ -293,19 +342,26 @@ add_cycler(PipelineCyclerTrueImpl *cycler) {
 void Pipeline::
 add_dirty_cycler(PipelineCyclerTrueImpl *cycler) {
   nassertv(cycler->_lock.debug_is_locked());
-
-  ReMutexHolder holder(_lock);
   nassertv(_num_stages != 1);
-  nassertv(!_cycling);
   nassertv(!cycler->_dirty);
 
-  // Remove it from the "clean" list and add it to the "dirty" list.
-  cycler->remove_from_list();
-  cycler->insert_before(&_dirty);
+  // We don't grab the pipeline lock here; instead, we push the cycler
+  // onto the pending stack, and leave it on the "clean" list until
+  // the next call to merge_pending_dirty() moves it to the "dirty"
+  // list.  The cycler's own lock, which we hold, guarantees that it
+  // can't be pushed twice or destructed in the meantime.
   cycler->_dirty = true;
-  ++_num_dirty_cyclers;
+
+  void *head;
+  do {
+    head = AtomicAdjust::get_ptr(_pending_dirty);
+    cycler->_next_pending = (PipelineCyclerTrueImpl *)head;
+  } while (AtomicAdjust::compare_and_exchange_ptr(_pending_dirty, head, cycler) != head);
+
+  AtomicAdjust::inc(_num_dirty_cyclers);
 
 #ifdef DEBUG_THREADS
+  ReMutexHolder holder(_lock);
   inc_cycler_type(_dirty_cycler_types, cycler->get_parent_type(), 1);
 #endif
 }
@@ -326,6 +382,10 @@ remove_cycler(PipelineCyclerTrueImpl *cycler) {
   ReMutexHolder holder(_lock);
   nassertv(!_cycling);
 
+  // The cycler might still be on the pending stack; clear the stack
+  // so that it doesn't keep a pointer to a destructed cycler.
+  merge_pending_dirty();
+
   --_num_cyclers;
   cycler->remove_from_list();
 
@@ -335,7 +395,7 @@ remove_cycler(PipelineCyclerTrueImpl *cycler) {
 
   if (cycler->_dirty) {
     cycler->_dirty = false;
-    --_num_dirty_cyclers;
+    AtomicAdjust::dec(_num_dirty_cyclers);
 #ifdef DEBUG_THREADS
     inc_cycler_type(_dirty_cycler_types, cycler->get_parent_type(), -1);
 #endif
@@ -365,6 +425,33 @@ iterate_all_cycler_types(CallbackFunc *func, void *data) const {
 }
 #endif  // THREADED_PIPELINE && DEBUG_THREADS
 
+#if defined(THREADED_PIPELINE) && defined(DO_PSTATS)
+////////////////////////////////////////////////////////////////////
+//     Function: Pipeline::iterate_cycle_times
+//       Access: Public
+//  Description: Walks through the types of the cyclers visited by
+//               the most recent call to cycle(), calling the
+//               indicated callback function with the TypeHandle of
+//               each type, the number of cyclers of that type that
+//               were cycled, and the total elapsed time in seconds
+//               spent cycling them.  The types are reported in no
+//               particular order.
+//
+//               This only returns data when set_time_cycle(true) has
+//               been called.  Mainly used for PStats reporting.
+////////////////////////////////////////////////////////////////////
+void Pipeline::
+iterate_cycle_times(TimeCallbackFunc *func, void *data) const {
+  ReMutexHolder holder(_lock);
+  CycleTimes::const_iterator ti;
+  for (ti = _cycle_times.begin(); ti != _cycle_times.end(); ++ti) {
+    if ((*ti).second._count != 0) {
+      func((*ti).first, (*ti).second._count, (*ti).second._elapsed, data);
+    }
+  }
+}
+#endif  // THREADED_PIPELINE && DO_PSTATS
+
 #if defined(THREADED_PIPELINE) && defined(DEBUG_THREADS) 
 ////////////////////////////////////////////////////////////////////
 //     Function: Pipeline::iterate_dirty_cycler_types
@@ -427,3 +514,52 @@ inc_cycler_type(TypeCount &count, TypeHandle type, int addend) {
   nassertv((*ci).second >= 0);
 }
 #endif  // THREADED_PIPELINE && DEBUG_THREADS
+
+#ifdef THREADED_PIPELINE
+////////////////////////////////////////////////////////////////////
+//     Function: Pipeline::merge_pending_dirty
+//       Access: Private
+//  Description: Moves all of the cyclers that have been pushed onto
+//               the pending stack by add_dirty_cycler() from the
+//               clean list onto the dirty list.
+//
+//               It is assumed the lock is held during this call.
+////////////////////////////////////////////////////////////////////
+void Pipeline::
+merge_pending_dirty() {
+  PipelineCyclerTrueImpl *cycler =
+    (PipelineCyclerTrueImpl *)AtomicAdjust::set_ptr(_pending_dirty, NULL);
+  while (cycler != (PipelineCyclerTrueImpl *)NULL) {
+    PipelineCyclerTrueImpl *next = cycler->_next_pending;
+    cycler->_next_pending = NULL;
+    nassertv(cycler->_dirty);
+    cycler->remove_from_list();
+    cycler->insert_before(&_dirty);
+    cycler = next;
+  }
+}
+#endif  // THREADED_PIPELINE
+
+#if defined(THREADED_PIPELINE) && defined(DO_PSTATS)
+////////////////////////////////////////////////////////////////////
+//     Function: Pipeline::record_cycle_time
+//       Access: Private
+//  Description: Charges the time elapsed since last_time to the
+//               type of the indicated cycler, which has just been
+//               cycled, and updates last_time to now.
+//
+//               It is assumed the lock is held during this call, as
+//               well as the cycler's lock.
+////////////////////////////////////////////////////////////////////
+void Pipeline::
+record_cycle_time(PipelineCyclerTrueImpl *cycler, double &last_time) {
+  double now = TrueClock::get_global_ptr()->get_short_time();
+  CycleTime &ct = _cycle_times[cycler->get_parent_type()];
+  if (ct._count == 0) {
+    ct._elapsed = 0.0;
+  }
+  ++ct._count;
+  ct._elapsed += now - last_time;
+  last_time = now;
+}
+#endif  // THREADED_PIPELINE && DO_PSTATS
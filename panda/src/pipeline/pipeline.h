@@ -21,6 +21,7 @@
 #include "pset.h"
 #include "reMutex.h"
 #include "reMutexHolder.h"
+#include "atomicAdjust.h"
 #include "selectThreadImpl.h"  // for THREADED_PIPELINE definition
 
 struct PipelineCyclerTrueImpl;
@@ -65,6 +66,14 @@ public:
   void iterate_dirty_cycler_types(CallbackFunc *func, void *data) const;
 #endif  // DEBUG_THREADS
 
+#ifdef DO_PSTATS
+  INLINE void set_time_cycle(bool time_cycle);
+  INLINE bool get_time_cycle() const;
+
+  typedef void TimeCallbackFunc(TypeHandle type, int count, double elapsed, void *data);
+  void iterate_cycle_times(TimeCallbackFunc *func, void *data) const;
+#endif  // DO_PSTATS
+
 #endif  // THREADED_PIPELINE
 
 private:
@@ -74,11 +83,19 @@ private:
   static Pipeline *_render_pipeline;
 
 #ifdef THREADED_PIPELINE
+  void merge_pending_dirty();
+
   PipelineCyclerLinks _clean;
   PipelineCyclerLinks _dirty;
 
+  // Cyclers that have been made dirty since the last time _lock was
+  // held.  This is a lock-free stack, linked through each cycler's
+  // _next_pending pointer; the cyclers are still on the _clean list
+  // until merge_pending_dirty() moves them.
+  AtomicAdjust::Pointer _pending_dirty;  // PipelineCyclerTrueImpl *
+
   int _num_cyclers;
-  int _num_dirty_cyclers;
+  AtomicAdjust::Integer _num_dirty_cyclers;
 
 #ifdef DEBUG_THREADS
   typedef pmap<TypeHandle, int> TypeCount;
@@ -87,6 +104,21 @@ private:
   static void inc_cycler_type(TypeCount &count, TypeHandle type, int addend);
 #endif  // DEBUG_THREADS
 
+#ifdef DO_PSTATS
+  // The time spent cycling each type of cycler in the last call to
+  // cycle(), if _time_cycle is true.
+  class CycleTime {
+  public:
+    int _count;
+    double _elapsed;
+  };
+  typedef pmap<TypeHandle, CycleTime> CycleTimes;
+  CycleTimes _cycle_times;
+  bool _time_cycle;
+
+  void record_cycle_time(PipelineCyclerTrueImpl *cycler, double &last_time);
+#endif  // DO_PSTATS
+
   // This is true only during cycle().
   bool _cycling;
 
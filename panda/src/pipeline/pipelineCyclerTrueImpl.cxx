@@ -28,6 +28,7 @@ PipelineCyclerTrueImpl::
 PipelineCyclerTrueImpl(CycleData *initial_data, Pipeline *pipeline) :
   _pipeline(pipeline),
   _dirty(false),
+  _next_pending(NULL),
   _lock(this)
 {
   if (_pipeline == (Pipeline *)NULL) {
@@ -52,6 +53,7 @@ PipelineCyclerTrueImpl::
 PipelineCyclerTrueImpl(const PipelineCyclerTrueImpl &copy) :
   _pipeline(copy._pipeline),
   _dirty(false),
+  _next_pending(NULL),
   _lock(this)
 {
   ReMutexHolder holder(_lock);
@@ -129,6 +129,11 @@ private:
   int _num_stages;
   bool _dirty;
 
+  // The next cycler on the Pipeline's lock-free pending-dirty stack.
+  // This is only meaningful while _dirty is true and the cycler has
+  // not yet been moved onto the Pipeline's dirty list.
+  PipelineCyclerTrueImpl *_next_pending;
+
   CyclerMutex _lock;
 
   friend class Pipeline;
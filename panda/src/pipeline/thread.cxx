@@ -54,6 +54,7 @@ Thread(const string &name, const string &sync_name) :
   _pipeline_stage = 0;
   _joinable = false;
   _current_task = NULL;
+  _frame_arena = NULL;
 
 #ifdef HAVE_PYTHON
   _python_data = Py_None;
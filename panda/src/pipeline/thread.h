@@ -35,6 +35,7 @@ class MutexDebug;
 class ConditionVarDebug;
 class ConditionVarFullDebug;
 class AsyncTaskBase;
+class FrameArena;
 
 ////////////////////////////////////////////////////////////////////
 //       Class : Thread
@@ -120,6 +121,9 @@ public:
   INLINE void set_pstats_callback(PStatsCallback *pstats_callback);
   INLINE PStatsCallback *get_pstats_callback() const;
 
+  INLINE void set_frame_arena(FrameArena *frame_arena);
+  INLINE FrameArena *get_frame_arena() const;
+
 #ifdef HAVE_PYTHON
   // Integration with Python.
   PyObject *call_python_func(PyObject *function, PyObject *args);
@@ -141,6 +145,7 @@ private:
   PStatsCallback *_pstats_callback;
   bool _joinable;
   AsyncTaskBase *_current_task;
+  FrameArena *_frame_arena;
 
 #ifdef HAVE_PYTHON
   PyObject *_python_data;
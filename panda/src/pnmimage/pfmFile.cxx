@@ -1274,6 +1274,19 @@ void PfmFile::
 xform(const LMatrix4f &transform) {
   nassertv(is_valid());
 
+  if (!_has_no_data_value && _num_channels >= 3 && !_table.empty() &&
+      transform(0, 3) == 0.0f && transform(1, 3) == 0.0f &&
+      transform(2, 3) == 0.0f && transform(3, 3) == 1.0f) {
+    // Every point is present, and the matrix is affine, so we can
+    // transform the whole table at once.  The result is the same as
+    // xform_point_general(), since the w component is exactly 1.
+    size_t stride = _num_channels * sizeof(PN_float32);
+    unsigned char *table = (unsigned char *)&_table[0];
+    transform.xform_points(table, stride, table, stride,
+                           (size_t)_x_size * (size_t)_y_size);
+    return;
+  }
+
   for (int yi = 0; yi < _y_size; ++yi) {
     for (int xi = 0; xi < _x_size; ++xi) {
       if (!has_point(xi, yi)) {
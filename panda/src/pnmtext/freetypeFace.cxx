@@ -32,6 +32,11 @@ TypeHandle FreetypeFace::_type_handle;
 FreetypeFace::
 FreetypeFace() : _lock("FreetypeFace::_lock") {
   _face = NULL;
+  _face_index = 0;
+  _data = NULL;
+  _data_length = 0;
+  _data_hash_known = false;
+  _data_hash = 0;
   _char_size = 0;
   _dpi = 0;
   _pixel_width = 0;
@@ -105,6 +110,62 @@ release_face(FT_Face face) {
   _lock.release();
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: FreetypeFace::copy_face
+//       Access: Public
+//  Description: Opens a second freetype face on the same font data,
+//               set to the indicated size.  Unlike the face returned
+//               by acquire_face(), the copy belongs to the caller
+//               alone, so it may be used to render glyphs in one
+//               thread while other threads use the original face or
+//               other copies.  Returns NULL if the face cannot be
+//               copied.
+//
+//               You must call free_face_copy() when you are done
+//               using it.
+////////////////////////////////////////////////////////////////////
+FT_Face FreetypeFace::
+copy_face(int char_size, int dpi, int pixel_width, int pixel_height) {
+  MutexHolder holder(_lock);
+  nassertr(_face != NULL, NULL);
+
+  // All of our faces are opened from memory, so we can open the same
+  // memory again.
+  if (_face->stream == NULL || _face->stream->base == NULL) {
+    return NULL;
+  }
+
+  FT_Face face;
+  int error = FT_New_Memory_Face(_ft_library, _face->stream->base,
+                                 (FT_Long)_face->stream->size,
+                                 _face->face_index, &face);
+  if (error) {
+    return NULL;
+  }
+
+  if (pixel_height != 0) {
+    FT_Set_Pixel_Sizes(face, pixel_width, pixel_height);
+  } else if (char_size != 0) {
+    FT_Set_Char_Size(face, char_size, char_size, dpi, dpi);
+  }
+  return face;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: FreetypeFace::free_face_copy
+//       Access: Public
+//  Description: Closes a face returned by a previous call to
+//               copy_face().
+////////////////////////////////////////////////////////////////////
+void FreetypeFace::
+free_face_copy(FT_Face face) {
+  // The library keeps a list of its faces, so this must not happen
+  // while another copy is being opened.
+  MutexHolder holder(_lock);
+  nassertv(face != _face);
+  FT_Done_Face(face);
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: FreetypeFace::set_face
 //       Access: Public
@@ -42,6 +42,9 @@ public:
   FT_Face acquire_face(int char_size, int dpi, int pixel_width, int pixel_height);
   void release_face(FT_Face face);
 
+  FT_Face copy_face(int char_size, int dpi, int pixel_width, int pixel_height);
+  void free_face_copy(FT_Face face);
+
   void set_face(FT_Face face);
 
 private:
@@ -52,6 +55,16 @@ private:
   // needed.
   string _font_data;
 
+  // These identify the font that was loaded, so that cached glyphs
+  // rendered from it can be recognized.  _data points to the bytes
+  // FreeType is reading, which stay valid as long as the face does.
+  string _filename;
+  int _face_index;
+  const char *_data;
+  size_t _data_length;
+  bool _data_hash_known;
+  PN_uint32 _data_hash;
+
   string _name;
   FT_Face _face;
   int _char_size;
@@ -105,6 +105,11 @@ load_font(const Filename &font_filename, int face_index) {
   vfs->resolve_filename(path, get_model_path());
   exists = vfs->read_file(path, _face->_font_data, true);
   if (exists) {
+    _face->_filename = path.get_fullpath();
+    _face->_face_index = face_index;
+    _face->_data = _face->_font_data.data();
+    _face->_data_length = _face->_font_data.length();
+
     FT_Face face;
     error = FT_New_Memory_Face(_face->_ft_library, 
                                (const FT_Byte *)_face->_font_data.data(),
@@ -156,6 +161,10 @@ load_font(const char *font_data, int data_length, int face_index) {
     return false;
   }
 
+  _face->_face_index = face_index;
+  _face->_data = font_data;
+  _face->_data_length = data_length;
+
   int error;
   FT_Face face;
   error = FT_New_Memory_Face(_face->_ft_library, 
@@ -192,6 +201,42 @@ unload_font() {
   _face = NULL;
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: FreetypeFont::get_font_key
+//       Access: Protected
+//  Description: Returns a string that identifies the font file that
+//               was loaded: its full path (if it was read from a
+//               file), the face index, the length of the font data,
+//               and a hash of its contents.  Two fonts with the same
+//               key render the same glyphs at the same settings.
+//               Returns the empty string if no font is loaded.
+////////////////////////////////////////////////////////////////////
+string FreetypeFont::
+get_font_key() const {
+  if (_face == (FreetypeFace *)NULL) {
+    return string();
+  }
+
+  MutexHolder holder(_face->_lock);
+  if (!_face->_data_hash_known) {
+    // A 32-bit FNV-1a hash of the font data.  This is computed only
+    // the first time it is asked for, since most fonts never need it.
+    PN_uint32 hash = 2166136261U;
+    const unsigned char *p = (const unsigned char *)_face->_data;
+    const unsigned char *end = p + _face->_data_length;
+    for (; p < end; ++p) {
+      hash = (hash ^ *p) * 16777619U;
+    }
+    _face->_data_hash = hash;
+    _face->_data_hash_known = true;
+  }
+
+  ostringstream strm;
+  strm << _face->_filename << ":" << _face->_face_index << ":"
+       << _face->_data_length << ":" << hex << _face->_data_hash;
+  return strm.str();
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: FreetypeFont::load_glyph
 //       Access: Protected
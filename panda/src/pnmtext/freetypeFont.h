@@ -76,6 +76,10 @@ PUBLISHED:
 protected:
   INLINE FT_Face acquire_face() const;
   INLINE void release_face(FT_Face face) const;
+  INLINE FT_Face copy_face() const;
+  INLINE void free_face_copy(FT_Face face) const;
+
+  string get_font_key() const;
 
   bool load_glyph(FT_Face face, int glyph_index, bool prerender = true);
   void copy_bitmap_to_pnmimage(const FT_Bitmap &bitmap, PNMImage &image);
@@ -60,3 +60,15 @@
 
 #end test_bin_target
 
+#begin test_bin_target
+  #define LOCAL_LIBS \
+    p3pstatclient
+  #define OTHER_LIBS \
+    $[OTHER_LIBS] p3pystub
+
+  #define TARGET test_pstats_overhead
+
+  #define SOURCES \
+    test_pstats_overhead.cxx
+
+#end test_bin_target
@@ -68,6 +68,22 @@ ConfigVariableDouble pstats_target_frame_rate
           "This frame rate is marked with a different-colored line; "
           "otherwise, this setting has no effect."));
 
+ConfigVariableFilename pstats_record_file
+("pstats-record-file", "",
+ PRC_DESC("If this is set, PStatClient::connect() does not contact a "
+          "server at all; instead, it records every frame of data to the "
+          "named file, which may later be replayed with text-stats -f.  "
+          "This is the same as calling PStatClient::record()."));
+
+ConfigVariableInt64 pstats_record_max_size
+("pstats-record-max-size", 67108864,
+ PRC_DESC("The size in bytes at which a PStats recording file is rotated.  "
+          "When the file reaches this size it is renamed with a .prev "
+          "suffix, replacing any previous one, and a new file is begun; "
+          "so at most twice this much disk space is used, and the most "
+          "recent part of a long session is always kept.  Set this to 0 "
+          "to let the file grow without limit."));
+
 // The rest are different in that they directly control the server,
 // not the client.
 ConfigVariableBool pstats_scroll_mode
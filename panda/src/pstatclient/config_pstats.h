@@ -23,6 +23,8 @@
 #include "configVariableInt.h"
 #include "configVariableDouble.h"
 #include "configVariableBool.h"
+#include "configVariableFilename.h"
+#include "configVariableInt64.h"
 
 // Configure variables for pstats package.
 
@@ -39,6 +41,9 @@ extern EXPCL_PANDA_PSTATCLIENT ConfigVariableString pstats_host;
 extern EXPCL_PANDA_PSTATCLIENT ConfigVariableInt pstats_port;
 extern EXPCL_PANDA_PSTATCLIENT ConfigVariableDouble pstats_target_frame_rate;
 
+extern EXPCL_PANDA_PSTATCLIENT ConfigVariableFilename pstats_record_file;
+extern EXPCL_PANDA_PSTATCLIENT ConfigVariableInt64 pstats_record_max_size;
+
 extern EXPCL_PANDA_PSTATCLIENT ConfigVariableBool pstats_scroll_mode;
 extern EXPCL_PANDA_PSTATCLIENT ConfigVariableDouble pstats_history;
 extern EXPCL_PANDA_PSTATCLIENT ConfigVariableDouble pstats_average_time;
@@ -436,6 +436,9 @@ client_disconnect() {
     thread->_frame_number = 0;
     thread->_is_active = false;
     thread->_next_packet = 0.0;
+
+    LightMutexHolder thread_holder(thread->_thread_lock);
+    drain_events(thread);
     thread->_frame_data.clear();
   }
 
@@ -724,7 +727,20 @@ start(int collector_index, int thread_index) {
   InternalThread *thread = get_thread_ptr(thread_index);
 
   if (client_is_connected() && collector->is_active() && thread->_is_active) {
+    if (thread->is_current()) {
+      // The usual case: a thread recording its own data.  Nobody else
+      // writes this thread's events, so we don't need the lock.
+      if (collector->_per_thread[thread_index]._nested_count == 0) {
+        if (thread->_thread_active) {
+          push_event(thread, collector_index, get_real_time());
+        }
+      }
+      collector->_per_thread[thread_index]._nested_count++;
+      return;
+    }
+
     LightMutexHolder holder(thread->_thread_lock);
+    drain_events(thread);
     if (collector->_per_thread[thread_index]._nested_count == 0) {
       // This collector wasn't already started in this thread; record
       // a new data point.
@@ -754,7 +770,20 @@ start(int collector_index, int thread_index, double as_of) {
   InternalThread *thread = get_thread_ptr(thread_index);
 
   if (client_is_connected() && collector->is_active() && thread->_is_active) {
+    if (thread->is_current()) {
+      // The usual case: a thread recording its own data.  Nobody else
+      // writes this thread's events, so we don't need the lock.
+      if (collector->_per_thread[thread_index]._nested_count == 0) {
+        if (thread->_thread_active) {
+          push_event(thread, collector_index, as_of);
+        }
+      }
+      collector->_per_thread[thread_index]._nested_count++;
+      return;
+    }
+
     LightMutexHolder holder(thread->_thread_lock);
+    drain_events(thread);
     if (collector->_per_thread[thread_index]._nested_count == 0) {
       // This collector wasn't already started in this thread; record
       // a new data point.
@@ -784,7 +813,29 @@ stop(int collector_index, int thread_index) {
   InternalThread *thread = get_thread_ptr(thread_index);
 
   if (client_is_connected() && collector->is_active() && thread->_is_active) {
+    if (thread->is_current()) {
+      // The usual case: a thread recording its own data.  Nobody else
+      // writes this thread's events, so we don't need the lock.
+      int &nested_count = collector->_per_thread[thread_index]._nested_count;
+      if (nested_count == 0) {
+        if (pstats_cat.is_debug()) {
+          pstats_cat.debug()
+            << "Collector " << get_collector_fullname(collector_index)
+            << " was already stopped in thread " << get_thread_name(thread_index)
+            << "!\n";
+        }
+        return;
+      }
+
+      --nested_count;
+      if (nested_count == 0 && thread->_thread_active) {
+        push_event(thread, collector_index | 0x8000, get_real_time());
+      }
+      return;
+    }
+
     LightMutexHolder holder(thread->_thread_lock);
+    drain_events(thread);
     if (collector->_per_thread[thread_index]._nested_count == 0) {
       if (pstats_cat.is_debug()) {
         pstats_cat.debug()
@@ -825,7 +876,29 @@ stop(int collector_index, int thread_index, double as_of) {
   InternalThread *thread = get_thread_ptr(thread_index);
 
   if (client_is_connected() && collector->is_active() && thread->_is_active) {
+    if (thread->is_current()) {
+      // The usual case: a thread recording its own data.  Nobody else
+      // writes this thread's events, so we don't need the lock.
+      int &nested_count = collector->_per_thread[thread_index]._nested_count;
+      if (nested_count == 0) {
+        if (pstats_cat.is_debug()) {
+          pstats_cat.debug()
+            << "Collector " << get_collector_fullname(collector_index)
+            << " was already stopped in thread " << get_thread_name(thread_index)
+            << "!\n";
+        }
+        return;
+      }
+
+      --nested_count;
+      if (nested_count == 0) {
+        push_event(thread, collector_index | 0x8000, as_of);
+      }
+      return;
+    }
+
     LightMutexHolder holder(thread->_thread_lock);
+    drain_events(thread);
     if (collector->_per_thread[thread_index]._nested_count == 0) {
       if (pstats_cat.is_debug()) {
         pstats_cat.debug()
@@ -846,6 +919,37 @@ stop(int collector_index, int thread_index, double as_of) {
   }
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: PStatClient::drain_events
+//       Access: Private, Static
+//  Description: Moves any events that the thread has recorded
+//               without locking into its _frame_data.  The caller
+//               must hold the thread's _thread_lock (except in the
+//               SIMPLE_THREADS context-switch hooks, where nothing
+//               else can be running).
+////////////////////////////////////////////////////////////////////
+void PStatClient::
+drain_events(InternalThread *thread) {
+  int head = (int)AtomicAdjust::get(thread->_event_head);
+  int tail = (int)thread->_event_tail;
+  if (tail == head) {
+    return;
+  }
+
+  while (tail != head) {
+    const InternalThread::Event &event = thread->_events[tail];
+    if (event._index & 0x8000) {
+      thread->_frame_data.add_stop(event._index & 0x7fff, event._time);
+    } else {
+      thread->_frame_data.add_start(event._index, event._time);
+    }
+    tail = (tail + 1) & thread->_event_mask;
+  }
+
+  // Hand the slots back to the thread.
+  AtomicAdjust::set(thread->_event_tail, tail);
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: PStatClient::clear_level
 //       Access: Private
@@ -1105,7 +1209,11 @@ deactivate_hook(Thread *thread) {
     // Start _thread_block_pcollector, by hand, being careful not to
     // grab any mutexes while we do it.
     double now = _impl->get_real_time();
-    ithread->_frame_data.add_start(_thread_block_pcollector.get_index(), now);
+    int index = _thread_block_pcollector.get_index();
+    if (!try_push_event(ithread, index, now)) {
+      drain_events(ithread);
+      try_push_event(ithread, index, now);
+    }
     ithread->_thread_active = false;
   }
 }
@@ -1132,7 +1240,11 @@ activate_hook(Thread *thread) {
 
   if (!ithread->_thread_active) {
     double now = _impl->get_real_time();
-    ithread->_frame_data.add_stop(_thread_block_pcollector.get_index(), now);
+    int index = _thread_block_pcollector.get_index() | 0x8000;
+    if (!try_push_event(ithread, index, now)) {
+      drain_events(ithread);
+      try_push_event(ithread, index, now);
+    }
     ithread->_thread_active = true;
   }
 }
@@ -1170,8 +1282,31 @@ InternalThread(Thread *thread) :
   _frame_number(0),
   _next_packet(0.0),
   _thread_active(true),
+  _event_head(0),
+  _event_tail(0),
   _thread_lock(string("PStatClient::InternalThread ") + thread->get_name())
 {
+  // Threads may be created during static init, so this variable is
+  // created on demand.
+  static ConfigVariableInt *pstats_event_buffer_size = NULL;
+  if (pstats_event_buffer_size == (ConfigVariableInt *)NULL) {
+    pstats_event_buffer_size = new ConfigVariableInt
+      ("pstats-event-buffer-size", 4096,
+       PRC_DESC("The number of start/stop events each thread can record "
+                "between frames without taking a lock.  Each thread records "
+                "its own events into a ring of this size, which is emptied "
+                "at the next main_tick() or thread_tick(); if it fills up "
+                "before then, the thread briefly takes a lock to empty it.  "
+                "This is rounded up to a power of 2."));
+  }
+
+  // The ring size must be a power of 2.
+  int size = 16;
+  while (size < *pstats_event_buffer_size) {
+    size <<= 1;
+  }
+  _events.resize(size);
+  _event_mask = size - 1;
 }
 
 #endif // DO_PSTATS
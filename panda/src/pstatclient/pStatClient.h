@@ -31,6 +31,7 @@
 #include "atomicAdjust.h"
 #include "numeric_types.h"
 #include "bitArray.h"
+#include "filename.h"
 
 class PStatCollector;
 class PStatCollectorDef;
@@ -87,6 +88,7 @@ PUBLISHED:
   INLINE static bool connect(const string &hostname = string(), int port = -1);
   INLINE static void disconnect();
   INLINE static bool is_connected();
+  INLINE static bool record(const Filename &filename);
 
   INLINE static void resume_after_pause();
 
@@ -98,6 +100,7 @@ PUBLISHED:
   INLINE bool client_connect(string hostname, int port);
   void client_disconnect();
   INLINE bool client_is_connected() const;
+  INLINE bool client_record(const Filename &filename);
 
   INLINE void client_resume_after_pause();
 
@@ -139,6 +142,10 @@ private:
   INLINE Collector *get_collector_ptr(int collector_index) const;
   INLINE InternalThread *get_thread_ptr(int thread_index) const;
 
+  INLINE static void push_event(InternalThread *thread, int index, double time);
+  INLINE static bool try_push_event(InternalThread *thread, int index, double time);
+  static void drain_events(InternalThread *thread);
+
   virtual void deactivate_hook(Thread *thread);
   virtual void activate_hook(Thread *thread);
 
@@ -201,6 +208,7 @@ private:
   class InternalThread {
   public:
     InternalThread(Thread *thread);
+    INLINE bool is_current() const;
 
     WPT(Thread) _thread;
     string _name;
@@ -213,9 +221,27 @@ private:
     bool _thread_active;
     BitArray _active_collectors;  // no longer used.
 
+    // Start and stop events that the thread records for itself are
+    // appended to this ring without taking _thread_lock.  The thread
+    // is the only writer of _event_head; _event_tail is only written
+    // by drain_events(), with _thread_lock held, which moves the
+    // events into _frame_data.  The stop flag 0x8000 is kept in the
+    // index, as in PStatFrameData.
+    class Event {
+    public:
+      int _index;
+      double _time;
+    };
+    typedef pvector<Event> Events;
+    Events _events;
+    int _event_mask;
+    AtomicAdjust::Integer _event_head;
+    AtomicAdjust::Integer _event_tail;
+
     // This mutex is used to protect writes to _frame_data for this
     // particular thread, as well as writes to the _per_thread data
-    // for this particular thread in the Collector class, above.
+    // for this particular thread in the Collector class, above, when
+    // they are made from some other thread.
     LightMutex _thread_lock;
   };
   typedef InternalThread *ThreadPointer;
@@ -263,6 +289,7 @@ PUBLISHED:
   INLINE static bool connect(const string & = string(), int = -1) { return false; }
   INLINE static void disconnect() { }
   INLINE static bool is_connected() { return false; }
+  INLINE static bool record(const Filename &) { return false; }
   INLINE static void resume_after_pause() { }
 
   INLINE static void main_tick() { }
@@ -55,6 +55,10 @@ PStatClientImpl(PStatClient *client) :
   _collectors_reported = 0;
   _threads_reported = 0;
 
+  _is_recording = false;
+  _record_bytes = 0;
+  _record_max_bytes = (PN_uint64)max(pstats_record_max_size.get_value(), (PN_int64)0);
+
   _client_name = pstats_name;
   _max_rate = pstats_max_rate;
 
@@ -95,6 +99,10 @@ bool PStatClientImpl::
 client_connect(string hostname, int port) {
   nassertr(!_is_connected, true);
 
+  if (hostname.empty() && !pstats_record_file.empty()) {
+    return client_record(pstats_record_file);
+  }
+
   if (hostname.empty()) {
     hostname = pstats_host;
   }
@@ -134,6 +142,39 @@ client_connect(string hostname, int port) {
   return _is_connected;
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: PStatClientImpl::client_record
+//       Access: Public
+//  Description: Called only by PStatClient::client_record().
+////////////////////////////////////////////////////////////////////
+bool PStatClientImpl::
+client_record(const Filename &filename) {
+  nassertr(!_is_connected, true);
+
+  _record_filename = Filename::binary_filename(filename);
+  if (!open_record_file()) {
+    return false;
+  }
+
+  pstats_cat.info()
+    << "Recording PStats data to " << _record_filename << "\n";
+
+  _is_connected = true;
+  _is_recording = true;
+
+  // There's no server to tell us its UDP port, so we can start
+  // tracking data right away.
+  _got_udp_port = true;
+
+  send_hello();
+
+#ifdef DEBUG_THREADS
+  MutexDebug::increment_pstats();
+#endif // DEBUG_THREADS
+
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: PStatClientImpl::client_disconnect
 //       Access: Public
@@ -145,15 +186,20 @@ client_disconnect() {
 #ifdef DEBUG_THREADS
     MutexDebug::decrement_pstats();
 #endif // DEBUG_THREADS
-    _reader.remove_connection(_tcp_connection);
-    close_connection(_tcp_connection);
-    close_connection(_udp_connection);
+    if (_is_recording) {
+      _record_file.close();
+    } else {
+      _reader.remove_connection(_tcp_connection);
+      close_connection(_tcp_connection);
+      close_connection(_udp_connection);
+    }
   }
 
   _tcp_connection.clear();
   _udp_connection.clear();
 
   _is_connected = false;
+  _is_recording = false;
   _got_udp_port = false;
 
   _collectors_reported = 0;
@@ -194,10 +240,19 @@ new_frame(int thread_index) {
   int frame_number = -1;
   PStatFrameData frame_data;
 
-  if (!pthread->_frame_data.is_empty()) {
+  // Pick up the events the thread has recorded since the last tick.
+  pthread->_thread_lock.acquire();
+  PStatClient::drain_events(pthread);
+  bool has_data = !pthread->_frame_data.is_empty();
+  pthread->_thread_lock.release();
+
+  if (has_data) {
     // Collector 0 is the whole frame.
     _client->stop(0, thread_index, frame_start);
 
+    LightMutexHolder holder(pthread->_thread_lock);
+    PStatClient::drain_events(pthread);
+
     // Fill up the level data for all the collectors who have level
     // data for this pthread.
     int num_collectors = _client->_num_collectors;
@@ -239,7 +294,12 @@ transmit_frame_data(int thread_index, int frame_number,
                     const PStatFrameData &frame_data) {
   nassertv(thread_index >= 0 && thread_index < _client->_num_threads);
   PStatClient::InternalThread *thread = _client->get_thread_ptr(thread_index);
-  if (_is_connected && thread->_is_active) {
+  if (_is_recording) {
+    if (thread->_is_active) {
+      record_frame_data(thread_index, frame_number, frame_data);
+    }
+
+  } else if (_is_connected && thread->_is_active) {
 
     // We don't want to send too many packets in a hurry and flood the
     // server.  Check that enough time has elapsed for us to send a
@@ -314,6 +374,28 @@ transmit_frame_data(int thread_index, int frame_number,
   }
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: PStatClientImpl::record_frame_data
+//       Access: Private
+//  Description: The recording counterpart of transmit_frame_data().
+//               Every frame is written to the file; there is no
+//               server to flood, so no packets are dropped for rate
+//               limiting.
+////////////////////////////////////////////////////////////////////
+void PStatClientImpl::
+record_frame_data(int thread_index, int frame_number, 
+                  const PStatFrameData &frame_data) {
+  // This is exactly the datagram we would have sent to the server.
+  Datagram datagram;
+  datagram.add_uint8(0);
+  datagram.add_uint16(thread_index);
+  datagram.add_uint32(frame_number);
+
+  if (frame_data.write_datagram(datagram, _client)) {
+    write_record(datagram);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: PStatClientImpl::transmit_control_data
 //       Access: Private
@@ -322,6 +404,11 @@ transmit_frame_data(int thread_index, int frame_number,
 ////////////////////////////////////////////////////////////////////
 void PStatClientImpl::
 transmit_control_data() {
+  if (_is_recording && _record_max_bytes != 0 &&
+      _record_bytes >= _record_max_bytes) {
+    rotate_record_file();
+  }
+
   // Check for new messages from the server.
   while (_is_connected && _reader.data_available()) {
     NetDatagram datagram;
@@ -381,7 +468,22 @@ send_hello() {
 
   Datagram datagram;
   message.encode(datagram);
-  _writer.send(datagram, _tcp_connection, true);
+  send_control_datagram(datagram);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: PStatClientImpl::send_control_datagram
+//       Access: Private
+//  Description: Sends a control message to the server over TCP, or
+//               writes it to the recording file.
+////////////////////////////////////////////////////////////////////
+void PStatClientImpl::
+send_control_datagram(const Datagram &datagram) {
+  if (_is_recording) {
+    write_record(datagram);
+  } else {
+    _writer.send(datagram, _tcp_connection, true);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -411,7 +513,7 @@ report_new_collectors() {
     
     Datagram datagram;
     message.encode(datagram);
-    _writer.send(datagram, _tcp_connection, true);
+    send_control_datagram(datagram);
   }
 }
 
@@ -436,7 +538,7 @@ report_new_threads() {
 
     Datagram datagram;
     message.encode(datagram);
-    _writer.send(datagram, _tcp_connection, true);
+    send_control_datagram(datagram);
   }
 }
 
@@ -485,4 +587,87 @@ connection_reset(const PT(Connection) &connection, bool) {
   }
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: PStatClientImpl::open_record_file
+//       Access: Private
+//  Description: Opens _record_filename for writing and writes the
+//               file header.  Returns true on success, false on
+//               failure.
+////////////////////////////////////////////////////////////////////
+bool PStatClientImpl::
+open_record_file() {
+  _record_filename.make_dir();
+  if (!_record_file.open(_record_filename)) {
+    pstats_cat.error()
+      << "Couldn't open " << _record_filename << " for recording.\n";
+    return false;
+  }
+
+  if (!_record_file.write_header(string(pstats_record_header,
+                                        pstats_record_header_size))) {
+    pstats_cat.error()
+      << "Couldn't write to " << _record_filename << "\n";
+    _record_file.close();
+    return false;
+  }
+
+  _record_bytes = pstats_record_header_size;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: PStatClientImpl::rotate_record_file
+//       Access: Private
+//  Description: Called when the recording file has grown past
+//               pstats-record-max-size.  The current file is moved
+//               aside to a .prev file, replacing the one moved aside
+//               last time, and a new file is begun.
+////////////////////////////////////////////////////////////////////
+void PStatClientImpl::
+rotate_record_file() {
+  _record_file.close();
+
+  Filename prev_filename = _record_filename.get_fullpath() + ".prev";
+  prev_filename.set_binary();
+  prev_filename.unlink();
+  if (!_record_filename.rename_to(prev_filename)) {
+    pstats_cat.warning()
+      << "Couldn't rename " << _record_filename << " to "
+      << prev_filename << "\n";
+  }
+
+  if (!open_record_file()) {
+    client_disconnect();
+    return;
+  }
+
+  // Each file must be readable on its own, so it needs its own copy
+  // of the hello and of all the collector and thread definitions.
+  // The collectors and threads will be reported again by
+  // transmit_control_data().
+  _collectors_reported = 0;
+  _threads_reported = 0;
+  send_hello();
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: PStatClientImpl::write_record
+//       Access: Private
+//  Description: Appends the datagram to the recording file.  If the
+//               write fails, recording is stopped.
+////////////////////////////////////////////////////////////////////
+void PStatClientImpl::
+write_record(const Datagram &datagram) {
+  if (!_record_file.put_datagram(datagram)) {
+    pstats_cat.error()
+      << "Error writing to " << _record_filename 
+      << "; recording stopped.\n";
+    client_disconnect();
+    return;
+  }
+
+  // Each datagram is preceded by a 32-bit length.
+  _record_bytes += datagram.get_length() + 4;
+}
+
 #endif // DO_PSTATS
@@ -25,6 +25,8 @@
 #include "queuedConnectionReader.h"
 #include "connectionWriter.h"
 #include "netAddress.h"
+#include "datagramOutputFile.h"
+#include "filename.h"
 
 #include "trueClock.h"
 #include "pmap.h"
@@ -66,6 +68,7 @@ public:
 
   INLINE void client_main_tick();
   bool client_connect(string hostname, int port);
+  bool client_record(const Filename &filename);
   void client_disconnect();
   INLINE bool client_is_connected() const;
 
@@ -77,6 +80,9 @@ private:
   void transmit_frame_data(int thread_index, int frame_number,
                            const PStatFrameData &frame_data);
 
+  void record_frame_data(int thread_index, int frame_number,
+                         const PStatFrameData &frame_data);
+
   void transmit_control_data();
 
   TrueClock *_clock;
@@ -86,6 +92,7 @@ private:
   // Networking stuff
   string get_hostname();
   void send_hello();
+  void send_control_datagram(const Datagram &datagram);
   void report_new_collectors();
   void report_new_threads();
   void handle_server_control_message(const PStatServerControlMessage &message);
@@ -116,6 +123,17 @@ private:
   double _udp_count_factor;
   unsigned int _tcp_count;
   unsigned int _udp_count;
+
+  // Recording stuff
+  bool open_record_file();
+  void rotate_record_file();
+  void write_record(const Datagram &datagram);
+
+  bool _is_recording;
+  Filename _record_filename;
+  DatagramOutputFile _record_file;
+  PN_uint64 _record_bytes;
+  PN_uint64 _record_max_bytes;
 };
 
 #include "pStatClientImpl.I"
@@ -24,6 +24,12 @@ class PStatCollectorDef;
 EXPCL_PANDA_PSTATCLIENT int get_current_pstat_major_version();
 EXPCL_PANDA_PSTATCLIENT int get_current_pstat_minor_version();
 
+// A PStats recording file begins with these bytes, and is followed
+// by the same datagrams that the client would have sent to a server
+// over TCP.
+static const char pstats_record_header[] = "pstats\0\n";
+static const int pstats_record_header_size = 8;
+
 #ifdef DO_PSTATS
 void initialize_collector_def(const PStatClient *client, PStatCollectorDef *def);
 #endif  // DO_PSTATS
@@ -0,0 +1,131 @@
+// Filename: test_pstats_overhead.cxx
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+
+#include "config_pstats.h"
+#include "pStatClient.h"
+#include "pStatCollector.h"
+#include "pStatThread.h"
+#include "trueClock.h"
+#include "filename.h"
+
+// The number of start/stop pairs between frame ticks.
+static const int pairs_per_frame = 1000;
+
+// Keeps the compiler from optimizing away the clock readings.
+static volatile double clock_sink;
+
+////////////////////////////////////////////////////////////////////
+//     Function: time_pairs
+//  Description: Runs num_frames frames of start/stop pairs on the
+//               collector, and returns the average time of one pair
+//               in nanoseconds.  The time spent in main_tick() is not
+//               counted.
+////////////////////////////////////////////////////////////////////
+static double
+time_pairs(PStatCollector &collector, const PStatThread &thread,
+           int num_frames, bool use_as_of) {
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double total = 0.0;
+  double as_of = 0.0;
+
+  for (int f = 0; f < num_frames; ++f) {
+    double start = clock->get_short_time();
+    if (use_as_of) {
+      for (int i = 0; i < pairs_per_frame; ++i) {
+        collector.start(thread, as_of);
+        collector.stop(thread, as_of);
+      }
+    } else {
+      for (int i = 0; i < pairs_per_frame; ++i) {
+        collector.start(thread);
+        collector.stop(thread);
+      }
+    }
+    total += clock->get_short_time() - start;
+    as_of += 0.001;
+
+    PStatClient::main_tick();
+  }
+
+  return total * 1.0e9 / ((double)num_frames * pairs_per_frame);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: time_clock
+//  Description: Returns the average time, in nanoseconds, of one
+//               reading of the clock used by PStats.
+////////////////////////////////////////////////////////////////////
+static double
+time_clock(int count) {
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  double sum = 0.0;
+  for (int i = 0; i < count; ++i) {
+    sum += clock->get_short_time();
+  }
+  double elapsed = clock->get_short_time() - start;
+  clock_sink = sum;
+  return elapsed * 1.0e9 / (double)count;
+}
+
+int
+main(int argc, char *argv[]) {
+  int num_frames = 2000;
+  if (argc > 1) {
+    num_frames = atoi(argv[1]);
+  }
+  if (num_frames <= 0) {
+    nout << "test_pstats_overhead [num_frames]\n";
+    exit(1);
+  }
+
+  PStatCollector collector("Overhead test");
+  PStatThread thread = PStatClient::get_global_pstats()->get_current_thread();
+
+  // With no client connected, PStatCollector::start() and stop() are
+  // supposed to cost next to nothing.
+  double idle_ns = time_pairs(collector, thread, num_frames, false);
+
+  // Record to a scratch file, so we don't need a server.
+  Filename filename = Filename::temporary("", "pstats_");
+  if (!PStatClient::record(filename)) {
+    nout << "Couldn't record to " << filename << "\n";
+    exit(1);
+  }
+
+  // The thread becomes active on its first tick.
+  PStatClient::main_tick();
+
+  double full_ns = time_pairs(collector, thread, num_frames, false);
+  double as_of_ns = time_pairs(collector, thread, num_frames, true);
+  double clock_ns = time_clock(num_frames * pairs_per_frame);
+
+  PStatClient::disconnect();
+  filename.unlink();
+
+  nout << "Start/stop pairs per frame: " << pairs_per_frame
+       << ", frames: " << num_frames << "\n"
+       << "  not connected:            " << idle_ns << " ns per pair\n"
+       << "  connected:                " << full_ns << " ns per pair\n"
+       << "  connected, explicit time: " << as_of_ns << " ns per pair\n"
+       << "  one clock reading:        " << clock_ns << " ns\n";
+
+  // The bookkeeping itself, not counting the clock, is what we aim to
+  // keep under 30 ns per pair.
+  if (as_of_ns > 30.0) {
+    nout << "Bookkeeping overhead exceeds 30 ns per pair.\n";
+    return 1;
+  }
+  return 0;
+}
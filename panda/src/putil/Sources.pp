@@ -246,3 +246,25 @@
   #define OTHER_LIBS $[OTHER_LIBS] p3pystub
 
 #end test_bin_target
+
+#begin test_bin_target
+  #define TARGET test_bitArray
+
+  #define SOURCES \
+    test_bitArray.cxx
+
+  #define LOCAL_LIBS $[LOCAL_LIBS] p3putil
+  #define OTHER_LIBS $[OTHER_LIBS] p3pystub
+
+#end test_bin_target
+
+#begin test_bin_target
+  #define TARGET test_simpleHashMap
+
+  #define SOURCES \
+    test_simpleHashMap.cxx
+
+  #define LOCAL_LIBS $[LOCAL_LIBS] p3putil
+  #define OTHER_LIBS $[OTHER_LIBS] p3pystub
+
+#end test_bin_target
@@ -17,6 +17,135 @@
 
 TypeHandle BitArray::_type_handle;
 
+// The bulk operations below work directly on the array of words
+// underlying the PTA(MaskType), rather than through the BitMask
+// interface and the PTA's operator [], so that the inner loops are
+// simple enough for the compiler to unroll and vectorize.  A BitMask
+// is nothing more than its one word, so the cast is safe.
+typedef BitArray::WordType WordType;
+
+////////////////////////////////////////////////////////////////////
+//     Function: words_are_zero
+//  Description: Returns true if all of the n words are zero.  The
+//               words are tested four at a time, so that the loop
+//               has only one branch per four words.
+////////////////////////////////////////////////////////////////////
+static bool
+words_are_zero(const WordType *words, size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    if ((words[i] | words[i + 1] | words[i + 2] | words[i + 3]) != 0) {
+      return false;
+    }
+  }
+  WordType accum = 0;
+  for (; i < n; ++i) {
+    accum |= words[i];
+  }
+  return (accum == 0);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: words_are_all_on
+//  Description: Returns true if all of the n words are all ones.
+////////////////////////////////////////////////////////////////////
+static bool
+words_are_all_on(const WordType *words, size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    if ((words[i] & words[i + 1] & words[i + 2] & words[i + 3]) != ~(WordType)0) {
+      return false;
+    }
+  }
+  WordType accum = ~(WordType)0;
+  for (; i < n; ++i) {
+    accum &= words[i];
+  }
+  return (accum == ~(WordType)0);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: words_intersect
+//  Description: Returns true if any of the n words of a has a bit in
+//               common with the corresponding word of b.
+////////////////////////////////////////////////////////////////////
+static bool
+words_intersect(const WordType *a, const WordType *b, size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    if (((a[i] & b[i]) | (a[i + 1] & b[i + 1]) |
+         (a[i + 2] & b[i + 2]) | (a[i + 3] & b[i + 3])) != 0) {
+      return true;
+    }
+  }
+  WordType accum = 0;
+  for (; i < n; ++i) {
+    accum |= (a[i] & b[i]);
+  }
+  return (accum != 0);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: count_bits_in_words
+//  Description: Returns the total number of 1 bits in the n words.
+//               Four independent sums are kept, so that consecutive
+//               popcount instructions do not wait on each other.
+////////////////////////////////////////////////////////////////////
+static int
+count_bits_in_words(const WordType *words, size_t n) {
+  int c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    c0 += count_bits_in_word(words[i]);
+    c1 += count_bits_in_word(words[i + 1]);
+    c2 += count_bits_in_word(words[i + 2]);
+    c3 += count_bits_in_word(words[i + 3]);
+  }
+  for (; i < n; ++i) {
+    c0 += count_bits_in_word(words[i]);
+  }
+  return c0 + c1 + c2 + c3;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: find_word_not_equal
+//  Description: Returns the index of the first of the n words that is
+//               not equal to skip, or n if they all are.
+////////////////////////////////////////////////////////////////////
+static size_t
+find_word_not_equal(const WordType *words, size_t n, WordType skip) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    if (((words[i] ^ skip) | (words[i + 1] ^ skip) |
+         (words[i + 2] ^ skip) | (words[i + 3] ^ skip)) != 0) {
+      break;
+    }
+  }
+  while (i < n && words[i] == skip) {
+    ++i;
+  }
+  return i;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: rfind_word_not_equal
+//  Description: Returns the index of the last of the n words that is
+//               not equal to skip, or -1 if they all are.
+////////////////////////////////////////////////////////////////////
+static int
+rfind_word_not_equal(const WordType *words, size_t n, WordType skip) {
+  size_t i = n;
+  while (i >= 4 &&
+         ((words[i - 1] ^ skip) | (words[i - 2] ^ skip) |
+          (words[i - 3] ^ skip) | (words[i - 4] ^ skip)) == 0) {
+    i -= 4;
+  }
+  while (i > 0 && words[i - 1] == skip) {
+    --i;
+  }
+  return (int)i - 1;
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: BitArray::Constructor (from SparseArray)
 //       Access: Published
@@ -52,14 +181,7 @@ is_zero() const {
     return false;
   }
 
-  // Start from the high end, since that's more likely to be nonzero.
-  Array::reverse_iterator ai;
-  for (ai = _array.rbegin(); ai != _array.rend(); ++ai) {
-    if (!(*ai).is_zero()) {
-      return false;
-    }
-  }
-  return true;
+  return words_are_zero((const WordType *)_array.p(), _array.size());
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -76,13 +198,7 @@ is_all_on() const {
     return false;
   }
 
-  Array::reverse_iterator ai;
-  for (ai = _array.rbegin(); ai != _array.rend(); ++ai) {
-    if (!(*ai).is_all_on()) {
-      return false;
-    }
-  }
-  return true;
+  return words_are_all_on((const WordType *)_array.p(), _array.size());
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -314,12 +430,7 @@ get_num_on_bits() const {
     return -1;
   }
 
-  int result = 0;
-  Array::const_iterator ai;
-  for (ai = _array.begin(); ai != _array.end(); ++ai) {
-    result += (*ai).get_num_on_bits();
-  }
-  return result;
+  return count_bits_in_words((const WordType *)_array.p(), _array.size());
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -335,12 +446,9 @@ get_num_off_bits() const {
     return -1;
   }
 
-  int result = 0;
-  Array::const_iterator ai;
-  for (ai = _array.begin(); ai != _array.end(); ++ai) {
-    result += (*ai).get_num_off_bits();
-  }
-  return result;
+  size_t num_words = _array.size();
+  return (int)(num_words * num_bits_per_word) -
+    count_bits_in_words((const WordType *)_array.p(), num_words);
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -351,15 +459,14 @@ get_num_off_bits() const {
 ////////////////////////////////////////////////////////////////////
 int BitArray::
 get_lowest_on_bit() const {
-  int num_words = get_num_words();
-  for (int w = 0; w < num_words; ++w) {
-    int b = _array[w].get_lowest_on_bit();
-    if (b != -1) {
-      return w * num_bits_per_word + b;
-    }
+  const WordType *words = (const WordType *)_array.p();
+  size_t num_words = _array.size();
+  size_t w = find_word_not_equal(words, num_words, 0);
+  if (w < num_words) {
+    return (int)w * num_bits_per_word + ::get_lowest_on_bit(words[w]);
   }
   if (_highest_bits) {
-    return num_words * num_bits_per_word;
+    return (int)num_words * num_bits_per_word;
   } else {
     return -1;
   }
@@ -373,15 +480,14 @@ get_lowest_on_bit() const {
 ////////////////////////////////////////////////////////////////////
 int BitArray::
 get_lowest_off_bit() const {
-  int num_words = get_num_words();
-  for (int w = 0; w < num_words; ++w) {
-    int b = _array[w].get_lowest_off_bit();
-    if (b != -1) {
-      return w * num_bits_per_word + b;
-    }
+  const WordType *words = (const WordType *)_array.p();
+  size_t num_words = _array.size();
+  size_t w = find_word_not_equal(words, num_words, ~(WordType)0);
+  if (w < num_words) {
+    return (int)w * num_bits_per_word + ::get_lowest_on_bit((WordType)~words[w]);
   }
   if (!_highest_bits) {
-    return num_words * num_bits_per_word;
+    return (int)num_words * num_bits_per_word;
   } else {
     return -1;
   }
@@ -399,12 +505,10 @@ get_highest_on_bit() const {
   if (_highest_bits) {
     return -1;
   }
-  int num_words = get_num_words();
-  for (int w = num_words - 1; w >= 0; --w) {
-    int b = _array[w].get_highest_on_bit();
-    if (b != -1) {
-      return w * num_bits_per_word + b;
-    }
+  const WordType *words = (const WordType *)_array.p();
+  int w = rfind_word_not_equal(words, _array.size(), 0);
+  if (w >= 0) {
+    return w * num_bits_per_word + ::get_highest_on_bit(words[w]);
   }
   return -1;
 }
@@ -421,12 +525,10 @@ get_highest_off_bit() const {
   if (!_highest_bits) {
     return -1;
   }
-  int num_words = get_num_words();
-  for (int w = num_words - 1; w >= 0; --w) {
-    int b = _array[w].get_highest_off_bit();
-    if (b != -1) {
-      return w * num_bits_per_word + b;
-    }
+  const WordType *words = (const WordType *)_array.p();
+  int w = rfind_word_not_equal(words, _array.size(), ~(WordType)0);
+  if (w >= 0) {
+    return w * num_bits_per_word + ::get_highest_on_bit((WordType)~words[w]);
   }
   return -1;
 }
@@ -456,12 +558,9 @@ get_next_higher_different_bit(int low_bit) const {
     return w * num_bits_per_word + b2;
   }
   // Look for the next word with anything interesting.
-  MaskType skip_next = (_array[w].get_bit(b)) ? MaskType::all_on() : MaskType::all_off();
-  int w2 = w;
-  ++w2;
-  while (w2 < num_words && _array[w2] == skip_next) {
-    ++w2;
-  }
+  WordType skip_next = (_array[w].get_bit(b)) ? ~(WordType)0 : (WordType)0;
+  const WordType *words = (const WordType *)_array.p();
+  int w2 = w + 1 + (int)find_word_not_equal(words + w + 1, num_words - w - 1, skip_next);
   if (w2 >= num_words) {
     // All bits higher are the same value.
     int is_on = _array[w].get_bit(b);
@@ -486,9 +585,10 @@ void BitArray::
 invert_in_place() {
   _highest_bits = !_highest_bits;
   copy_on_write();
-  Array::iterator ai;
-  for (ai = _array.begin(); ai != _array.end(); ++ai) {
-    (*ai) = ~(*ai);
+  WordType *words = (WordType *)_array.p();
+  size_t num_words = _array.size();
+  for (size_t i = 0; i < num_words; ++i) {
+    words[i] = ~words[i];
   }
 }
 
@@ -515,38 +615,25 @@ has_bits_in_common(const BitArray &other) const {
     // The other array has fewer actual words, and the top n words of
     // the other array are all ones.  We have bits in common if any of
     // our top n words are nonzero.
-    Array::const_iterator ai;
-    for (ai = _array.begin() + other._array.size();
-         ai != _array.end();
-         ++ai) {
-      if (!(*ai).is_zero()) {
-        return true;
-      }
+    if (!words_are_zero((const WordType *)_array.p() + other._array.size(),
+                        _array.size() - other._array.size())) {
+      return true;
     }
-    
+
   } else if (_array.size() < other._array.size() && _highest_bits) {
     // This array has fewer actual words, and the top n words of this
     // array are all ones.  We have bits in common if any of the the
     // other's top n words are nonzero.
-    Array::const_iterator ai;
-    for (ai = other._array.begin() + _array.size();
-         ai != other._array.end();
-         ++ai) {
-      if (!(*ai).is_zero()) {
-        return true;
-      }
-    }
-  }
-
-  // Consider the words that both arrays have in common.
-  for (size_t i = 0; i < num_common_words; ++i) {
-    if (!(_array[i] & other._array[i]).is_zero()) {
+    if (!words_are_zero((const WordType *)other._array.p() + _array.size(),
+                        other._array.size() - _array.size())) {
       return true;
     }
   }
 
-  // Nope, nothing.
-  return false;
+  // Consider the words that both arrays have in common.
+  return words_intersect((const WordType *)_array.p(),
+                         (const WordType *)other._array.p(),
+                         num_common_words);
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -670,17 +757,16 @@ operator &= (const BitArray &other) {
     // This array has fewer actual words, and the top n words of this
     // array are all ones.  "mask on" the top n words of the other
     // array.
-    Array::const_iterator ai;
-    for (ai = other._array.begin() + _array.size();
-         ai != other._array.end();
-         ++ai) {
-      _array.push_back(*ai);
-    }
+    _array.v().insert(_array.v().end(),
+                      other._array.v().begin() + _array.size(),
+                      other._array.v().end());
   }
 
   // Consider the words that both arrays have in common.
+  WordType *words = (WordType *)_array.p();
+  const WordType *other_words = (const WordType *)other._array.p();
   for (size_t i = 0; i < num_common_words; ++i) {
-    _array[i] &= other._array[i];
+    words[i] &= other_words[i];
   }
 
   _highest_bits &= other._highest_bits;
@@ -709,17 +795,16 @@ operator |= (const BitArray &other) {
     // This array has fewer actual words, and the top n words of this
     // array are all zeros.  Copy in the top n words of the other
     // array.
-    Array::const_iterator ai;
-    for (ai = other._array.begin() + _array.size();
-         ai != other._array.end();
-         ++ai) {
-      _array.push_back(*ai);
-    }
+    _array.v().insert(_array.v().end(),
+                      other._array.v().begin() + _array.size(),
+                      other._array.v().end());
   }
 
   // Consider the words that both arrays have in common.
+  WordType *words = (WordType *)_array.p();
+  const WordType *other_words = (const WordType *)other._array.p();
   for (size_t i = 0; i < num_common_words; ++i) {
-    _array[i] |= other._array[i];
+    words[i] |= other_words[i];
   }
 
   _highest_bits |= other._highest_bits;
@@ -754,12 +839,9 @@ operator ^= (const BitArray &other) {
       // This array has fewer actual words, and the top n words of this
       // array are all zeros.  Copy in the top n words of the other
       // array.
-      Array::const_iterator ai;
-      for (ai = other._array.begin() + _array.size();
-           ai != other._array.end();
-           ++ai) {
-        _array.push_back(*ai);
-      }
+      _array.v().insert(_array.v().end(),
+                        other._array.v().begin() + _array.size(),
+                        other._array.v().end());
     } else {
       // This array has fewer actual words, and the top n words of this
       // array are all ones.  Copy in the top n words of the other
@@ -774,8 +856,10 @@ operator ^= (const BitArray &other) {
   }
 
   // Consider the words that both arrays have in common.
+  WordType *words = (WordType *)_array.p();
+  const WordType *other_words = (const WordType *)other._array.p();
   for (size_t i = 0; i < num_common_words; ++i) {
-    _array[i] ^= other._array[i];
+    words[i] ^= other_words[i];
   }
 
   _highest_bits ^= other._highest_bits;
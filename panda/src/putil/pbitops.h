@@ -18,9 +18,16 @@
 #include "pandabase.h"
 #include "numeric_types.h"
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 ////////////////////////////////////////////////////////////////////
 // This file defines a few low-level bit-operation routines, optimized
-// all to heck.
+// all to heck.  Where the compiler offers an intrinsic for the
+// operation, we use it, so that it compiles to a single instruction
+// (popcnt, bsf/tzcnt, bsr/lzcnt) when the target supports one;
+// otherwise we fall back to the num_bits_on table.
 ////////////////////////////////////////////////////////////////////
 
 INLINE int count_bits_in_word(PN_uint16 x);
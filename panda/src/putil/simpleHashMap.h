@@ -28,20 +28,36 @@
 //               it wants an additional method on the Compare object,
 //               Compare::is_equal(a, b), and (c) it doesn't depend on
 //               the system STL providing hash_map.
+//
+//               The table uses open addressing with Robin Hood
+//               linear probing: the entries within each run of
+//               occupied slots are kept sorted by their ideal slot,
+//               so that a lookup can stop as soon as it passes the
+//               place its key would have been.  The entries and a
+//               parallel array of probe lengths live in a single
+//               allocation from a DeletedBufferChain, so that a
+//               lookup touches contiguous memory and storing a new
+//               element rarely allocates.
+//
+//               Slot indices are not stable: storing or removing any
+//               element may move other elements to different slots.
 ////////////////////////////////////////////////////////////////////
 template<class Key, class Value, class Compare = method_hash<Key, less<Key> > >
 class SimpleHashMap {
 public:
 #ifndef CPPPARSER
   INLINE SimpleHashMap(const Compare &comp = Compare());
+  SimpleHashMap(const SimpleHashMap &copy);
   INLINE ~SimpleHashMap();
 
+  INLINE void operator = (const SimpleHashMap &copy);
   INLINE void swap(SimpleHashMap &other);
 
   int find(const Key &key) const;
   int store(const Key &key, const Value &data);
   INLINE bool remove(const Key &key);
   void clear();
+  void reserve(size_t num_entries);
 
   INLINE Value &operator [] (const Key &key);
 
@@ -66,14 +82,21 @@ private:
   INLINE size_t get_hash(const Key &key) const;
 
   INLINE bool is_element(int n, const Key &key) const;
-  INLINE void store_new_element(int n, const Key &key, const Value &data);
+  INLINE void store_new_element(int n, const Key &key, const Value &data,
+                                unsigned char probe);
+  INLINE void move_element(int to, int from, unsigned char probe);
   INLINE void clear_element(int n);
-  INLINE unsigned char *get_exists_array() const;
+  INLINE unsigned char *get_probe_array() const;
 
-  void new_table();
+  int insert_new_element(const Key &key, const Value &data);
+  void new_table(size_t table_size);
   INLINE bool consider_expand_table();
   void expand_table();
 
+  // The probe array records, for each slot, 0 if the slot is empty,
+  // or else 1 + the distance of the element from its ideal slot.
+  enum { max_probe = 255 };
+
   class TableEntry {
   public:
     INLINE TableEntry(const Key &key, const Value &data) :
@@ -87,6 +110,7 @@ private:
   DeletedBufferChain *_deleted_chain;
   size_t _table_size;
   size_t _num_entries;
+  int _hash_shift;
 
   Compare _comp;
 #endif  // CPPPARSER
@@ -27,27 +27,23 @@ SparseArray(const BitArray &from) {
   bool empty_bit = from.get_highest_bits();
   _inverse = empty_bit;
 
+  // Walk through the runs of identical bits, a word at a time where
+  // possible, rather than testing each bit.  Beyond get_num_bits(),
+  // all of the bits have the empty_bit state.
+  int num_bits = from.get_num_bits();
   int begin = 0;
-  bool current_state = from.get_bit(0);
-  int i = 0;
-
-  // By including get_num_bits()--one more than the last bit--in this
-  // traversal, we guarantee that we will end on the empty_bit state
-  // (because the last bit we visit will be one of the highest_bits).
-  while (i <= from.get_num_bits()) {
-    if (from.get_bit(i) != current_state) {
-      // End of a run.
-      if (current_state != empty_bit) {
-        Subrange range(begin, i);
-        _subranges.push_back(range);
-      }
-      begin = i;
-      current_state = !current_state;
+  while (begin < num_bits) {
+    bool current_state = from.get_bit(begin);
+    int end = from.get_next_higher_different_bit(begin);
+    if (end <= begin || end > num_bits) {
+      // The run extends to the end of the stored words.
+      end = num_bits;
+    }
+    if (current_state != empty_bit) {
+      _subranges.push_back(Subrange(begin, end));
     }
-    ++i;
+    begin = end;
   }
-
-  nassertv(current_state == empty_bit);
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -226,14 +222,43 @@ has_bits_in_common(const SparseArray &other) const {
     return true;
   }
 
-  if (_inverse != other._inverse) {
-    // We'll handle this tricky case the lazy way.
-    return !(*this & other).is_zero();
+  if (!_inverse && !other._inverse) {
+    // We have bits in common if any of our subranges overlaps any of
+    // the other's subranges.
+    size_t i = 0;
+    size_t j = 0;
+    while (i < _subranges.size() && j < other._subranges.size()) {
+      const Subrange &a = _subranges[i];
+      const Subrange &b = other._subranges[j];
+      if (a._begin < b._end && b._begin < a._end) {
+        return true;
+      }
+      if (a._end < b._end) {
+        ++i;
+      } else {
+        ++j;
+      }
+    }
+    return false;
   }
 
-  // Actually, we'll handle this easy case the lazy way too.  Maybe
-  // later we'll do this smarter.
-  return !(*this & other).is_zero();
+  // Exactly one of the arrays is inverted: its subranges list the
+  // bits that are *not* on.  We have bits in common unless the other
+  // array's subranges are entirely contained within those.
+  const Subranges &on = _inverse ? other._subranges : _subranges;
+  const Subranges &off = _inverse ? _subranges : other._subranges;
+  size_t j = 0;
+  for (size_t i = 0; i < on.size(); ++i) {
+    const Subrange &a = on[i];
+    while (j < off.size() && off[j]._end <= a._begin) {
+      ++j;
+    }
+    if (j >= off.size() || off[j]._begin > a._begin || off[j]._end < a._end) {
+      // Some part of this subrange is not excluded.
+      return true;
+    }
+  }
+  return false;
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -316,11 +341,6 @@ compare_to(const SparseArray &other) const {
 ////////////////////////////////////////////////////////////////////
 void SparseArray::
 operator &= (const SparseArray &other) {
-  // We do this the slow and stupid way.  This could be done much
-  // better with a little effort, but I'm not at all sure it's worth
-  // the effort.  If you need fast boolean operations, you should
-  // probably be using a BitArray.
-
   if (_inverse && other._inverse) {
     do_union(other);
 
@@ -347,11 +367,6 @@ operator &= (const SparseArray &other) {
 ////////////////////////////////////////////////////////////////////
 void SparseArray::
 operator |= (const SparseArray &other) {
-  // We do this the slow and stupid way.  This could be done much
-  // better with a little effort, but I'm not at all sure it's worth
-  // the effort.  If you need fast boolean operations, you should
-  // probably be using a BitArray.
-
   if (_inverse && other._inverse) {
     do_intersection(other);
 
@@ -609,25 +624,25 @@ do_has_all(int begin, int end) const {
 ////////////////////////////////////////////////////////////////////
 void SparseArray::
 do_intersection(const SparseArray &other) {
-  if (_subranges.empty()) {
-    return;
-  }
-  if (other._subranges.empty()) {
-    _subranges.clear();
-    return;
-  }
-
-  int my_begin = (*_subranges.begin())._begin;
-  int other_begin = (*other._subranges.begin())._begin;
-  do_remove_range(my_begin, other_begin);
-
-  for (size_t i = 0; i < other._subranges.size() - 1; ++i) {
-    do_remove_range(other._subranges[i]._end, other._subranges[i + 1]._begin);
+  // Walk through both lists of subranges together, in linear time.
+  Subranges result;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < _subranges.size() && j < other._subranges.size()) {
+    const Subrange &a = _subranges[i];
+    const Subrange &b = other._subranges[j];
+    int begin = max(a._begin, b._begin);
+    int end = min(a._end, b._end);
+    if (begin < end) {
+      result.push_back(Subrange(begin, end));
+    }
+    if (a._end < b._end) {
+      ++i;
+    } else {
+      ++j;
+    }
   }
-
-  int my_end = (*(_subranges.begin() + _subranges.size() - 1))._end;
-  int other_end = (*(other._subranges.begin() + other._subranges.size() - 1))._end;
-  do_remove_range(other_end, my_end);
+  _subranges.swap(result);
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -638,10 +653,32 @@ do_intersection(const SparseArray &other) {
 ////////////////////////////////////////////////////////////////////
 void SparseArray::
 do_union(const SparseArray &other) {
-  Subranges::const_iterator si;
-  for (si = other._subranges.begin(); si != other._subranges.end(); ++si) {
-    do_add_range((*si)._begin, (*si)._end);
+  // Merge both sorted lists of subranges together, in linear time,
+  // joining any that overlap or touch.
+  Subranges result;
+  result.reserve(_subranges.size() + other._subranges.size());
+  size_t i = 0;
+  size_t j = 0;
+  while (i < _subranges.size() || j < other._subranges.size()) {
+    Subrange next(0, 0);
+    if (j >= other._subranges.size() ||
+        (i < _subranges.size() &&
+         _subranges[i]._begin < other._subranges[j]._begin)) {
+      next = _subranges[i];
+      ++i;
+    } else {
+      next = other._subranges[j];
+      ++j;
+    }
+
+    if (!result.empty() && result[result.size() - 1]._end >= next._begin) {
+      Subrange &last = result[result.size() - 1];
+      last._end = max(last._end, next._end);
+    } else {
+      result.push_back(next);
+    }
   }
+  _subranges.swap(result);
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -652,10 +689,31 @@ do_union(const SparseArray &other) {
 ////////////////////////////////////////////////////////////////////
 void SparseArray::
 do_intersection_neg(const SparseArray &other) {
-  Subranges::const_iterator si;
-  for (si = other._subranges.begin(); si != other._subranges.end(); ++si) {
-    do_remove_range((*si)._begin, (*si)._end);
+  // Subtract the other list of subranges from ours, in linear time.
+  Subranges result;
+  size_t j = 0;
+  for (size_t i = 0; i < _subranges.size(); ++i) {
+    int begin = _subranges[i]._begin;
+    int end = _subranges[i]._end;
+    while (j < other._subranges.size() && other._subranges[j]._end <= begin) {
+      ++j;
+    }
+
+    size_t k = j;
+    while (begin < end) {
+      if (k >= other._subranges.size() || other._subranges[k]._begin >= end) {
+        result.push_back(Subrange(begin, end));
+        break;
+      }
+      const Subrange &b = other._subranges[k];
+      if (b._begin > begin) {
+        result.push_back(Subrange(begin, b._begin));
+      }
+      begin = max(begin, b._end);
+      ++k;
+    }
   }
+  _subranges.swap(result);
 }
 
 ////////////////////////////////////////////////////////////////////
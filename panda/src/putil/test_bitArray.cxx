@@ -0,0 +1,376 @@
+// Filename: test_bitArray.cxx
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+#include "bitArray.h"
+#include "sparseArray.h"
+#include "pbitops.h"
+#include "trueClock.h"
+#include "pnotify.h"
+
+#include <stdlib.h>
+
+// This program checks the bulk operations on BitArray and
+// SparseArray against a naive bit-by-bit computation, and then times
+// each operation on large arrays alongside the word-at-a-time code it
+// replaced.
+
+static const int num_bits = 65536;
+
+static BitArray
+make_random(int density) {
+  BitArray result;
+  int i = 0;
+  while (i < num_bits) {
+    int run = rand() % density + 1;
+    if ((rand() & 1) != 0) {
+      result.set_range(i, run);
+    }
+    i += run;
+  }
+  return result;
+}
+
+static bool
+check(const char *name, bool result, bool expected) {
+  if (result != expected) {
+    nout << name << ": got " << result << ", expected " << expected << "\n";
+    return false;
+  }
+  return true;
+}
+
+static bool
+check_bits(const char *name, const BitArray &a, const BitArray &b, int op,
+           const BitArray &result) {
+  for (int i = 0; i < num_bits + 64; ++i) {
+    bool x = a.get_bit(i);
+    bool y = b.get_bit(i);
+    bool expected = (op == 0) ? (x && y) : (op == 1) ? (x || y) : (x != y);
+    if (result.get_bit(i) != expected) {
+      nout << name << ": mismatch at bit " << i << "\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool
+check_sparse(const char *name, const SparseArray &s, const BitArray &b) {
+  for (int i = 0; i < num_bits + 64; ++i) {
+    if (s.get_bit(i) != b.get_bit(i)) {
+      nout << name << ": mismatch at bit " << i << "\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+static int
+naive_num_on_bits(const BitArray &a) {
+  int count = 0;
+  for (int i = 0; i < a.get_num_bits(); ++i) {
+    if (a.get_bit(i)) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+static int
+naive_lowest_on_bit(const BitArray &a) {
+  for (int i = 0; i < a.get_num_bits(); ++i) {
+    if (a.get_bit(i)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// The implementations that the bulk operations replaced, rebuilt on
+// the public interface so that both can be timed on the same arrays.
+// These go through the words one BitMask at a time, count bits with
+// the num_bits_on table, and build SparseArrays one range (or one
+// bit) at a time.
+typedef BitArray::WordType WordType;
+
+static int
+old_count_bits_in_word(WordType x) {
+  int count = 0;
+  for (size_t i = 0; i < sizeof(WordType) * 8; i += 16) {
+    count += num_bits_on[(x >> i) & 0xffff];
+  }
+  return count;
+}
+
+static void
+old_and_in_place(BitArray &a, const BitArray &b) {
+  // The arrays in this test never have their highest bits set, so
+  // the words of b beyond a's length don't matter.
+  int num_words = a.get_num_words();
+  for (int w = 0; w < num_words; ++w) {
+    a.set_word(w, a.get_word(w) & b.get_word(w));
+  }
+}
+
+static int
+old_get_num_on_bits(const BitArray &a) {
+  int count = 0;
+  int num_words = a.get_num_words();
+  for (int w = 0; w < num_words; ++w) {
+    count += old_count_bits_in_word(a.get_word(w).get_word());
+  }
+  return count;
+}
+
+static bool
+old_has_bits_in_common(const BitArray &a, const BitArray &b) {
+  int num_words = min(a.get_num_words(), b.get_num_words());
+  for (int w = 0; w < num_words; ++w) {
+    if (!(a.get_word(w) & b.get_word(w)).is_zero()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static int
+old_get_lowest_on_bit(const BitArray &a) {
+  int num_words = a.get_num_words();
+  for (int w = 0; w < num_words; ++w) {
+    WordType x = a.get_word(w).get_word();
+    if (x != 0) {
+      return w * BitArray::num_bits_per_word +
+        old_count_bits_in_word((x & (~x + 1)) - 1);
+    }
+  }
+  return -1;
+}
+
+static int
+old_get_highest_on_bit(const BitArray &a) {
+  for (int w = a.get_num_words() - 1; w >= 0; --w) {
+    WordType x = a.get_word(w).get_word();
+    if (x != 0) {
+      return w * BitArray::num_bits_per_word +
+        old_count_bits_in_word(flood_bits_down(x)) - 1;
+    }
+  }
+  return -1;
+}
+
+static SparseArray
+old_union(const SparseArray &a, const SparseArray &b) {
+  SparseArray result = a;
+  for (int i = 0; i < b.get_num_subranges(); ++i) {
+    int begin = b.get_subrange_begin(i);
+    result.set_range(begin, b.get_subrange_end(i) - begin);
+  }
+  return result;
+}
+
+static bool
+old_sparse_has_bits_in_common(const SparseArray &a, const SparseArray &b) {
+  // The old code intersected the arrays, by clearing the gaps of b
+  // out of a copy of a, and then tested the result.
+  int num_a = a.get_num_subranges();
+  int num_b = b.get_num_subranges();
+  if (num_a == 0 || num_b == 0) {
+    return false;
+  }
+  SparseArray result = a;
+  int my_begin = a.get_subrange_begin(0);
+  int other_begin = b.get_subrange_begin(0);
+  if (my_begin < other_begin) {
+    result.clear_range(my_begin, other_begin - my_begin);
+  }
+  for (int i = 0; i + 1 < num_b; ++i) {
+    int gap = b.get_subrange_end(i);
+    result.clear_range(gap, b.get_subrange_begin(i + 1) - gap);
+  }
+  int my_end = a.get_subrange_end(num_a - 1);
+  int other_end = b.get_subrange_end(num_b - 1);
+  if (other_end < my_end) {
+    result.clear_range(other_end, my_end - other_end);
+  }
+  return !result.is_zero();
+}
+
+static SparseArray
+old_sparse_from_bits(const BitArray &a) {
+  SparseArray result;
+  bool state = a.get_bit(0);
+  int begin = 0;
+  for (int i = 1; i <= a.get_num_bits(); ++i) {
+    if (a.get_bit(i) != state) {
+      if (state) {
+        result.set_range(begin, i - begin);
+      }
+      begin = i;
+      state = !state;
+    }
+  }
+  return result;
+}
+
+static void
+report(const char *name, double new_time, double old_time) {
+  nout << "  " << name << new_time * 1000.0 << " ms, was "
+       << old_time * 1000.0 << " ms\n";
+}
+
+int
+main(int argc, char *argv[]) {
+  int iterations = 1000;
+  if (argc > 1) {
+    iterations = atoi(argv[1]);
+  }
+
+  bool ok = true;
+  int densities[] = { 1, 7, 100, 5000 };
+  for (int d = 0; d < 4; ++d) {
+    BitArray a = make_random(densities[d]);
+    BitArray b = make_random(densities[d]);
+    if ((d & 1) != 0) {
+      b.invert_in_place();
+    }
+
+    ok = check_bits("&", a, b, 0, a & b) && ok;
+    ok = check_bits("|", a, b, 1, a | b) && ok;
+    ok = check_bits("^", a, b, 2, a ^ b) && ok;
+    ok = check("has_bits_in_common", a.has_bits_in_common(b),
+               !(a & b).is_zero()) && ok;
+    ok = check("get_num_on_bits",
+               a.get_num_on_bits() == naive_num_on_bits(a), true) && ok;
+    ok = check("get_lowest_on_bit",
+               a.get_lowest_on_bit() == naive_lowest_on_bit(a), true) && ok;
+
+    SparseArray sa(a);
+    SparseArray sb(b);
+    ok = check_sparse("SparseArray(BitArray)", sa, a) && ok;
+    ok = check_sparse("SparseArray &", sa & sb, a & b) && ok;
+    ok = check_sparse("SparseArray |", sa | sb, a | b) && ok;
+    ok = check_sparse("SparseArray ^", sa ^ sb, a ^ b) && ok;
+    ok = check_sparse("SparseArray & ~", sa & ~sb, a & ~b) && ok;
+    ok = check("SparseArray::has_bits_in_common", sa.has_bits_in_common(sb),
+               a.has_bits_in_common(b)) && ok;
+  }
+
+  if (!ok) {
+    return 1;
+  }
+  nout << "All results correct.\n";
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  BitArray a = make_random(100);
+  BitArray b = make_random(100);
+  SparseArray sa(a);
+  SparseArray sb(b);
+  int sink = 0;
+
+  // The old code must agree with the new, or the comparison means
+  // nothing.
+  {
+    BitArray c = a;
+    old_and_in_place(c, b);
+    if (c != (a & b) || old_get_num_on_bits(a) != a.get_num_on_bits() ||
+        old_has_bits_in_common(a, b) != a.has_bits_in_common(b) ||
+        old_get_lowest_on_bit(a) != a.get_lowest_on_bit() ||
+        old_get_highest_on_bit(b) != b.get_highest_on_bit() ||
+        old_union(sa, sb) != (sa | sb) ||
+        old_sparse_has_bits_in_common(sa, sb) != sa.has_bits_in_common(sb) ||
+        old_sparse_from_bits(a) != sa) {
+      nout << "The old implementations disagree with the new.\n";
+      return 1;
+    }
+  }
+
+  double start = clock->get_short_time();
+  for (int i = 0; i < iterations; ++i) {
+    BitArray c = a;
+    c &= b;
+    sink += c.get_num_on_bits();
+  }
+  double bit_and = clock->get_short_time() - start;
+
+  start = clock->get_short_time();
+  for (int i = 0; i < iterations; ++i) {
+    BitArray c = a;
+    old_and_in_place(c, b);
+    sink += old_get_num_on_bits(c);
+  }
+  double old_bit_and = clock->get_short_time() - start;
+
+  start = clock->get_short_time();
+  for (int i = 0; i < iterations; ++i) {
+    sink += a.has_bits_in_common(b);
+    sink += a.get_lowest_on_bit() + b.get_highest_on_bit();
+  }
+  double bit_scan = clock->get_short_time() - start;
+
+  start = clock->get_short_time();
+  for (int i = 0; i < iterations; ++i) {
+    sink += old_has_bits_in_common(a, b);
+    sink += old_get_lowest_on_bit(a) + old_get_highest_on_bit(b);
+  }
+  double old_bit_scan = clock->get_short_time() - start;
+
+  start = clock->get_short_time();
+  for (int i = 0; i < iterations; ++i) {
+    SparseArray c = sa | sb;
+    sink += c.get_num_subranges();
+  }
+  double sparse_or = clock->get_short_time() - start;
+
+  start = clock->get_short_time();
+  for (int i = 0; i < iterations; ++i) {
+    SparseArray c = old_union(sa, sb);
+    sink += c.get_num_subranges();
+  }
+  double old_sparse_or = clock->get_short_time() - start;
+
+  start = clock->get_short_time();
+  for (int i = 0; i < iterations; ++i) {
+    sink += sa.has_bits_in_common(sb);
+  }
+  double sparse_common = clock->get_short_time() - start;
+
+  start = clock->get_short_time();
+  for (int i = 0; i < iterations; ++i) {
+    sink += old_sparse_has_bits_in_common(sa, sb);
+  }
+  double old_sparse_common = clock->get_short_time() - start;
+
+  start = clock->get_short_time();
+  for (int i = 0; i < iterations; ++i) {
+    SparseArray c(a);
+    sink += c.get_num_subranges();
+  }
+  double sparse_convert = clock->get_short_time() - start;
+
+  start = clock->get_short_time();
+  for (int i = 0; i < iterations; ++i) {
+    SparseArray c = old_sparse_from_bits(a);
+    sink += c.get_num_subranges();
+  }
+  double old_sparse_convert = clock->get_short_time() - start;
+
+  nout << iterations << " iterations on " << num_bits << " bits ("
+       << sink << "):\n";
+  report("BitArray &= + count:        ", bit_and, old_bit_and);
+  report("BitArray common + scan:     ", bit_scan, old_bit_scan);
+  report("SparseArray |:              ", sparse_or, old_sparse_or);
+  report("SparseArray common:         ", sparse_common, old_sparse_common);
+  report("SparseArray from BitArray:  ", sparse_convert, old_sparse_convert);
+
+  return 0;
+}
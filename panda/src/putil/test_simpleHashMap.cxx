@@ -0,0 +1,282 @@
+// Filename: test_simpleHashMap.cxx
+// Created by:  agent (18Oct26)
+//
+////////////////////////////////////////////////////////////////////
+//
+// PANDA 3D SOFTWARE
+// Copyright (c) Carnegie Mellon University.  All rights reserved.
+//
+// All use of this software is subject to the terms of the revised BSD
+// license.  You should have received a copy of this license along
+// with this source code in a file named "LICENSE."
+//
+////////////////////////////////////////////////////////////////////
+#include "simpleHashMap.h"
+#include "pmap.h"
+#include "pset.h"
+#include "trueClock.h"
+#include "pnotify.h"
+
+// This program exercises the parts of SimpleHashMap that the Robin
+// Hood scheme makes delicate: keys that differ only in their high
+// bits, removal (which shifts the following elements back), growth
+// and reserve(), copying, and walking the table by slot index.  Every
+// step is followed by validate(), which checks the recorded probe
+// distances and the Robin Hood ordering of each run of slots.
+//
+// It finishes by timing lookups with the kind of keys the state and
+// munger caches use, which are pointers to objects of the same size.
+
+typedef SimpleHashMap<const void *, int, pointer_hash> HashMap;
+
+// The keys are pointers this far apart, like the addresses of
+// consecutively allocated objects.
+static const int key_stride = 64;
+
+static int num_failures = 0;
+
+static void
+expect(bool ok, const char *test, const char *what) {
+  if (!ok) {
+    nout << test << ": " << what << "\n";
+    ++num_failures;
+  }
+}
+
+class Keys {
+public:
+  Keys(int num_keys) : _buffer(new char[num_keys * key_stride]) {}
+  ~Keys() { delete[] _buffer; }
+  const void *operator [] (int i) const { return _buffer + i * key_stride; }
+
+private:
+  char *_buffer;
+};
+
+// Returns the length of the longest run of occupied slots.  With a
+// good hash this stays small even when the table is three-quarters
+// full.
+static int
+longest_run(const HashMap &map) {
+  int longest = 0;
+  int run = 0;
+  for (int i = 0; i < map.get_size(); ++i) {
+    run = map.has_element(i) ? run + 1 : 0;
+    longest = max(longest, run);
+  }
+  return longest;
+}
+
+static void
+test_aligned_keys() {
+  static const char *test = "aligned keys";
+  static const int num_keys = 3000;
+  Keys keys(num_keys);
+  HashMap map;
+
+  for (int i = 0; i < num_keys; ++i) {
+    map.store(keys[i], i);
+  }
+  expect(map.validate(), test, "table is invalid");
+  expect(map.get_num_entries() == num_keys, test, "wrong number of entries");
+
+  bool all_found = true;
+  for (int i = 0; i < num_keys; ++i) {
+    int n = map.find(keys[i]);
+    all_found = all_found && n != -1 && map.get_data(n) == i;
+  }
+  expect(all_found, test, "a stored key was not found");
+
+  nout << test << ": " << num_keys << " keys in " << map.get_size()
+       << " slots, longest run " << longest_run(map) << "\n";
+}
+
+static void
+test_remove() {
+  static const char *test = "remove";
+  static const int num_keys = 1000;
+  Keys keys(num_keys);
+  HashMap map;
+  for (int i = 0; i < num_keys; ++i) {
+    map.store(keys[i], i);
+  }
+
+  // Remove every third key, alternately by key and by slot, so that
+  // each removal shifts back whatever run follows it.
+  bool valid = true;
+  for (int i = 0; i < num_keys; i += 3) {
+    if ((i & 1) == 0) {
+      expect(map.remove(keys[i]), test, "remove() missed a stored key");
+    } else {
+      int n = map.find(keys[i]);
+      expect(n != -1, test, "find() missed a stored key");
+      if (n != -1) {
+        map.remove_element(n);
+      }
+    }
+    valid = valid && map.validate();
+  }
+  expect(valid, test, "table is invalid after a removal");
+  expect(!map.remove(keys[0]), test, "remove() found a removed key");
+
+  bool correct = true;
+  for (int i = 0; i < num_keys; ++i) {
+    int n = map.find(keys[i]);
+    if ((i % 3) == 0) {
+      correct = correct && n == -1;
+    } else {
+      correct = correct && n != -1 && map.get_data(n) == i;
+    }
+  }
+  expect(correct, test, "the wrong keys remain");
+
+  map.clear();
+  expect(map.is_empty() && map.find(keys[1]) == -1, test,
+         "clear() left entries behind");
+}
+
+static void
+test_growth() {
+  static const char *test = "growth";
+  static const int num_keys = 5000;
+  Keys keys(num_keys);
+
+  // The table doubles as it fills, and is never more than
+  // three-quarters full.
+  HashMap map;
+  bool bounded = true;
+  for (int i = 0; i < num_keys; ++i) {
+    map.store(keys[i], i);
+    int size = map.get_size();
+    bounded = bounded && (size & (size - 1)) == 0 &&
+      map.get_num_entries() * 4 <= size * 3;
+  }
+  expect(bounded, test, "load factor exceeded three-quarters");
+  expect(map.validate(), test, "table is invalid");
+
+  // After reserve(), storing that many keys doesn't grow the table.
+  HashMap reserved;
+  reserved.reserve(num_keys);
+  int size = reserved.get_size();
+  for (int i = 0; i < num_keys; ++i) {
+    reserved.store(keys[i], i);
+  }
+  expect(reserved.get_size() == size, test, "table grew after reserve()");
+  expect(reserved.validate(), test, "reserved table is invalid");
+
+  // Reserving less than the table already holds changes nothing.
+  reserved.reserve(10);
+  expect(reserved.get_size() == size && reserved.get_num_entries() == num_keys,
+         test, "reserve() shrank the table");
+}
+
+static void
+test_copy() {
+  static const char *test = "copy";
+  static const int num_keys = 100;
+  Keys keys(num_keys);
+  HashMap map;
+  for (int i = 0; i < num_keys; ++i) {
+    map.store(keys[i], i);
+  }
+
+  HashMap copy(map);
+  HashMap assigned;
+  assigned.store(keys[0], -1);
+  assigned = map;
+  expect(copy.validate() && assigned.validate(), test, "copy is invalid");
+
+  copy.remove(keys[5]);
+  assigned[keys[6]] = -6;
+  expect(map.get_num_entries() == num_keys &&
+         map.get_data(map.find(keys[5])) == 5 &&
+         map.get_data(map.find(keys[6])) == 6, test,
+         "changing a copy changed the original");
+  expect(assigned.get_data(assigned.find(keys[0])) == 0, test,
+         "assignment kept an old value");
+
+  HashMap other;
+  other.store(keys[0], 42);
+  other.swap(copy);
+  expect(other.get_num_entries() == num_keys - 1 &&
+         copy.get_num_entries() == 1, test, "swap() lost entries");
+}
+
+static void
+test_walk() {
+  static const char *test = "walk";
+  static const int num_keys = 700;
+  Keys keys(num_keys);
+  HashMap map;
+  for (int i = 0; i < num_keys; ++i) {
+    map.store(keys[i], i);
+  }
+
+  // Every entry is visited exactly once, with its own data.
+  pset<const void *> seen;
+  bool consistent = true;
+  for (int n = 0; n < map.get_size(); ++n) {
+    if (map.has_element(n)) {
+      const void *key = map.get_key(n);
+      consistent = consistent && seen.insert(key).second &&
+        map.get_data(n) == (int)(((const char *)key - (const char *)keys[0]) / key_stride);
+    }
+  }
+  expect(consistent, test, "an entry was visited twice or had the wrong data");
+  expect((int)seen.size() == num_keys, test, "an entry was not visited");
+}
+
+static void
+time_lookups(int num_keys, int iterations) {
+  TrueClock *clock = TrueClock::get_global_ptr();
+
+  // Every other key is stored, so half the lookups miss.
+  Keys keys(num_keys * 2);
+  HashMap map;
+  pmap<const void *, int> tree;
+  for (int i = 0; i < num_keys; ++i) {
+    map.store(keys[i * 2], i);
+    tree[keys[i * 2]] = i;
+  }
+
+  int hits = 0;
+  double start = clock->get_short_time();
+  for (int n = 0; n < iterations; ++n) {
+    for (int i = 0; i < num_keys * 2; ++i) {
+      hits += (map.find(keys[i]) != -1);
+    }
+  }
+  double map_time = clock->get_short_time() - start;
+
+  start = clock->get_short_time();
+  for (int n = 0; n < iterations; ++n) {
+    for (int i = 0; i < num_keys * 2; ++i) {
+      hits += (tree.find(keys[i]) != tree.end());
+    }
+  }
+  double tree_time = clock->get_short_time() - start;
+
+  double per_lookup = 1.0e9 / ((double)iterations * num_keys * 2);
+  nout << num_keys << " keys: " << map_time * per_lookup
+       << " ns per find(), pmap " << tree_time * per_lookup
+       << " ns (" << hits << " hits)\n";
+}
+
+int
+main(int argc, char *argv[]) {
+  test_aligned_keys();
+  test_remove();
+  test_growth();
+  test_copy();
+  test_walk();
+
+  if (num_failures != 0) {
+    nout << num_failures << " failures.\n";
+    return 1;
+  }
+
+  time_lookups(16, 100000);
+  time_lookups(1000, 1000);
+  time_lookups(100000, 10);
+  return 0;
+}
@@ -197,6 +197,13 @@ ConfigVariableEnum<TextFont::RenderMode> text_render_mode
 ("text-render-mode", TextFont::RM_texture,
  PRC_DESC("The default render mode for dynamic text fonts"));
 
+ConfigVariableInt text_rasterize_threads
+("text-rasterize-threads", 2,
+ PRC_DESC("The number of additional threads that DynamicTextFont::prewarm() "
+          "starts to rasterize glyphs in parallel.  Glyphs that are "
+          "rasterized on demand, while text is being assembled, are always "
+          "rasterized by the calling thread."));
+
 
 
 ////////////////////////////////////////////////////////////////////
@@ -49,6 +49,7 @@ extern ConfigVariableDouble text_hyphen_ratio;
 extern wstring get_text_never_break_before();
 extern ConfigVariableInt text_max_never_break;
 extern ConfigVariableDouble text_default_underscore_height;
+extern ConfigVariableInt text_rasterize_threads;
 
 extern ConfigVariableEnum<Texture::FilterType> text_minfilter;
 extern ConfigVariableEnum<Texture::FilterType> text_magfilter;
@@ -42,11 +42,21 @@
 #include "triangulator.h"
 #include "nurbsCurveEvaluator.h"
 #include "nurbsCurveResult.h"
+#include "genericThread.h"
+#include "datagram.h"
+#include "datagramIterator.h"
+#include "mutexHolder.h"
+#include "pset.h"
 //#include "renderModeAttrib.h"
 //#include "antialiasAttrib.h"
 
 TypeHandle DynamicTextFont::_type_handle;
 
+// The header and version number at the beginning of a glyph cache
+// file written by write_glyph_cache().
+static const string glyph_cache_header = "pgc\n";
+static const int glyph_cache_version = 2;
+
 
 ////////////////////////////////////////////////////////////////////
 //     Function: DynamicTextFont::Constructor
@@ -235,6 +245,315 @@ clear() {
   _empty_glyphs.clear();
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: DynamicTextFont::prewarm
+//       Access: Published
+//  Description: Renders all of the glyphs needed for the indicated
+//               text into the font's pages ahead of time, so that
+//               they need not be rendered one at a time when the text
+//               is first displayed.  The glyphs are rendered by
+//               FreeType in text-rasterize-threads threads at once,
+//               and then copied into the pages by the calling thread.
+//               Returns the number of glyphs that were added.
+//
+//               This is most useful for fonts with large character
+//               sets, such as CJK fonts, where a single new string
+//               can require many glyphs that have not been seen
+//               before.
+////////////////////////////////////////////////////////////////////
+int DynamicTextFont::
+prewarm(const wstring &text) {
+  pvector<int> characters;
+  characters.reserve(text.length());
+  wstring::const_iterator ti;
+  for (ti = text.begin(); ti != text.end(); ++ti) {
+    characters.push_back((int)(*ti));
+  }
+  return prewarm_characters(characters);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: DynamicTextFont::prewarm_range
+//       Access: Published
+//  Description: Renders the glyphs for all of the characters from
+//               first_character to last_character, inclusive, into
+//               the font's pages ahead of time.  Characters that the
+//               font does not define are skipped.  Returns the number
+//               of glyphs that were added.  See prewarm().
+////////////////////////////////////////////////////////////////////
+int DynamicTextFont::
+prewarm_range(int first_character, int last_character) {
+  pvector<int> characters;
+  if (last_character >= first_character) {
+    characters.reserve(last_character - first_character + 1);
+  }
+  for (int ch = first_character; ch <= last_character; ++ch) {
+    characters.push_back(ch);
+  }
+  return prewarm_characters(characters);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: DynamicTextFont::write_glyph_cache
+//       Access: Published
+//  Description: Writes the font's pages, and the placement of each
+//               glyph on them, to the indicated file.  A later call to
+//               read_glyph_cache() on a font with the same settings
+//               can restore them without rendering any glyphs with
+//               FreeType.  Returns true on success.
+//
+//               This is only supported for fonts rendered in
+//               RM_texture mode.
+////////////////////////////////////////////////////////////////////
+bool DynamicTextFont::
+write_glyph_cache(const Filename &filename) const {
+  if (_render_mode != RM_texture) {
+    text_cat.error()
+      << "Cannot write glyph cache for " << get_name()
+      << ": only texture fonts are supported.\n";
+    return false;
+  }
+
+  Datagram dg;
+  dg.append_data(glyph_cache_header);
+  dg.add_uint16(glyph_cache_version);
+
+  Datagram key;
+  write_cache_key(key);
+  dg.add_string32(key.get_message());
+
+  pmap<const DynamicTextPage *, int> page_index;
+  dg.add_uint32(_pages.size());
+  for (size_t pi = 0; pi < _pages.size(); ++pi) {
+    DynamicTextPage *page = _pages[pi];
+    page_index[page] = (int)pi;
+    CPTA_uchar image = page->get_ram_image();
+    dg.add_uint32(image.size());
+    dg.append_data(image.p(), image.size());
+  }
+
+  // Glyphs on a page that has been dropped by clear() are not written.
+  Cache::const_iterator ci;
+  int num_glyphs = 0;
+  for (ci = _cache.begin(); ci != _cache.end(); ++ci) {
+    DynamicTextGlyph *glyph = (*ci).second;
+    if (glyph == (DynamicTextGlyph *)NULL || glyph->_page == (DynamicTextPage *)NULL ||
+        page_index.find(glyph->_page) != page_index.end()) {
+      ++num_glyphs;
+    }
+  }
+
+  dg.add_uint32(num_glyphs);
+  for (ci = _cache.begin(); ci != _cache.end(); ++ci) {
+    DynamicTextGlyph *glyph = (*ci).second;
+    if (glyph == (DynamicTextGlyph *)NULL) {
+      // The font has no glyph for this index.
+      dg.add_int32((*ci).first);
+      dg.add_int32(-2);
+
+    } else if (glyph->_page == (DynamicTextPage *)NULL) {
+      // An empty glyph, which has only an advance.
+      dg.add_int32((*ci).first);
+      dg.add_int32(-1);
+      dg.add_int32(glyph->get_character());
+      dg.add_float32(glyph->get_advance());
+
+    } else {
+      pmap<const DynamicTextPage *, int>::const_iterator pi;
+      pi = page_index.find(glyph->_page);
+      if (pi == page_index.end()) {
+        continue;
+      }
+      dg.add_int32((*ci).first);
+      dg.add_int32((*pi).second);
+      dg.add_int32(glyph->get_character());
+      dg.add_float32(glyph->get_advance());
+      dg.add_int32(glyph->_x);
+      dg.add_int32(glyph->_y);
+      dg.add_int32(glyph->_x_size);
+      dg.add_int32(glyph->_y_size);
+      dg.add_int32(glyph->_margin);
+      dg.add_int32(glyph->_bitmap_top);
+      dg.add_int32(glyph->_bitmap_left);
+      dg.add_float32(glyph->_tex_x_size);
+      dg.add_float32(glyph->_tex_y_size);
+    }
+  }
+
+  Filename fn = Filename::binary_filename(filename);
+  pofstream out;
+  if (!fn.open_write(out)) {
+    text_cat.error()
+      << "Unable to write glyph cache " << fn << "\n";
+    return false;
+  }
+  out.write((const char *)dg.get_data(), dg.get_length());
+  return !out.fail();
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: DynamicTextFont::read_glyph_cache
+//       Access: Published
+//  Description: Replaces the font's pages and glyphs with the ones
+//               stored in the indicated file by write_glyph_cache().
+//               Returns true on success.  If the file does not exist,
+//               or was written for a different font or with
+//               different settings, the font is left unchanged and
+//               false is returned, and the glyphs will be rendered
+//               as usual when they are needed.
+////////////////////////////////////////////////////////////////////
+bool DynamicTextFont::
+read_glyph_cache(const Filename &filename) {
+  if (!_is_valid || _render_mode != RM_texture) {
+    return false;
+  }
+
+  Filename fn = Filename::binary_filename(filename);
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  string data;
+  if (!vfs->read_file(fn, data, true)) {
+    if (text_cat.is_debug()) {
+      text_cat.debug()
+        << "No glyph cache " << fn << "\n";
+    }
+    return false;
+  }
+
+  Datagram dg(data);
+  DatagramIterator scan(dg);
+  size_t header_size = glyph_cache_header.size();
+  if (data.size() < header_size + 2 ||
+      scan.get_fixed_string(header_size) != glyph_cache_header ||
+      scan.get_uint16() != glyph_cache_version) {
+    text_cat.warning()
+      << fn << " is not a glyph cache file of the current version.\n";
+    return false;
+  }
+
+  Datagram key;
+  write_cache_key(key);
+  if (scan.get_remaining_size() < 4) {
+    text_cat.error()
+      << "Glyph cache " << fn << " is invalid.\n";
+    return false;
+  }
+  size_t key_size = scan.get_uint32();
+  if ((size_t)scan.get_remaining_size() < key_size ||
+      scan.get_fixed_string(key_size) != key.get_message()) {
+    text_cat.info()
+      << "Ignoring glyph cache " << fn << ", which was written for "
+      << "a different font or different font settings.\n";
+    return false;
+  }
+
+  clear();
+
+  // The file may have been truncated, so check that each field is
+  // really there before reading it.
+  if (scan.get_remaining_size() < 4) {
+    return glyph_cache_invalid(fn);
+  }
+  size_t num_pages = scan.get_uint32();
+  for (size_t pi = 0; pi < num_pages; ++pi) {
+    if (scan.get_remaining_size() < 4) {
+      return glyph_cache_invalid(fn);
+    }
+    PT(DynamicTextPage) page = new DynamicTextPage(this, (int)pi);
+    size_t size = scan.get_uint32();
+    PTA_uchar image = page->modify_ram_image();
+    if (size != image.size() || (size_t)scan.get_remaining_size() < size) {
+      return glyph_cache_invalid(fn);
+    }
+    string bytes = scan.get_fixed_string(size);
+    memcpy(image.p(), bytes.data(), size);
+    _pages.push_back(page);
+  }
+
+  if (scan.get_remaining_size() < 4) {
+    return glyph_cache_invalid(fn);
+  }
+  size_t num_glyphs = scan.get_uint32();
+  for (size_t gi = 0; gi < num_glyphs; ++gi) {
+    // The glyph index and page.
+    if (scan.get_remaining_size() < 8) {
+      return glyph_cache_invalid(fn);
+    }
+    int glyph_index = scan.get_int32();
+    int pi = scan.get_int32();
+    if (pi == -2) {
+      _cache.insert(Cache::value_type(glyph_index, (DynamicTextGlyph *)NULL));
+      continue;
+    }
+
+    // The character and advance.
+    if (scan.get_remaining_size() < 8) {
+      return glyph_cache_invalid(fn);
+    }
+    int character = scan.get_int32();
+    PN_stdfloat advance = scan.get_float32();
+    if (pi == -1) {
+      PT(DynamicTextGlyph) glyph = new DynamicTextGlyph(character, advance);
+      _empty_glyphs.push_back(glyph);
+      _cache.insert(Cache::value_type(glyph_index, glyph));
+      continue;
+    }
+
+    // The placement on the page: seven int32's and two float32's.
+    if (scan.get_remaining_size() < 36) {
+      return glyph_cache_invalid(fn);
+    }
+    int x = scan.get_int32();
+    int y = scan.get_int32();
+    int x_size = scan.get_int32();
+    int y_size = scan.get_int32();
+    int margin = scan.get_int32();
+    int bitmap_top = scan.get_int32();
+    int bitmap_left = scan.get_int32();
+    PN_stdfloat tex_x_size = scan.get_float32();
+    PN_stdfloat tex_y_size = scan.get_float32();
+    if (pi < 0 || pi >= (int)_pages.size() ||
+        x < 0 || y < 0 || x + x_size > _page_x_size || y + y_size > _page_y_size) {
+      return glyph_cache_invalid(fn);
+    }
+
+    DynamicTextPage *page = _pages[pi];
+    PT(DynamicTextGlyph) glyph =
+      new DynamicTextGlyph(character, page, x, y, x_size, y_size, margin);
+    page->_glyphs.push_back(glyph);
+    glyph->make_geom(bitmap_top, bitmap_left, advance * _font_pixels_per_unit,
+                     _poly_margin, tex_x_size, tex_y_size,
+                     _font_pixels_per_unit, _tex_pixels_per_unit);
+
+    // Restore the advance exactly as it was, rather than recomputing
+    // it from pixels.
+    glyph->_advance = advance;
+    _cache.insert(Cache::value_type(glyph_index, glyph));
+  }
+
+  if (text_cat.is_debug()) {
+    text_cat.debug()
+      << "Read " << _cache.size() << " glyphs on " << _pages.size()
+      << " pages from glyph cache " << fn << "\n";
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: DynamicTextFont::glyph_cache_invalid
+//       Access: Private
+//  Description: Called by read_glyph_cache() when the file turns out
+//               to be truncated or corrupt partway through.  Reports
+//               the error, discards whatever was read, and returns
+//               false.
+////////////////////////////////////////////////////////////////////
+bool DynamicTextFont::
+glyph_cache_invalid(const Filename &fn) {
+  text_cat.error()
+    << "Glyph cache " << fn << " is invalid.\n";
+  clear();
+  return false;
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: DynamicTextFont::write
 //       Access: Published, Virtual
@@ -549,6 +868,23 @@ make_glyph(int character, FT_Face face, int glyph_index) {
     FT_Render_Glyph(slot, ft_render_mode_normal);
   }
 
+  return make_texture_glyph(character, bitmap, slot->bitmap_top,
+                            slot->bitmap_left, advance);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: DynamicTextFont::make_texture_glyph
+//       Access: Private
+//  Description: Slots a space in the texture map for the glyph whose
+//               bitmap has been rendered by FreeType, and copies the
+//               bitmap into it.  This is the part of make_glyph()
+//               that modifies the font; it is also used by
+//               prewarm() to store the glyphs that were rendered in
+//               other threads.
+////////////////////////////////////////////////////////////////////
+DynamicTextGlyph *DynamicTextFont::
+make_texture_glyph(int character, const FT_Bitmap &bitmap,
+                   int bitmap_top, int bitmap_left, PN_stdfloat advance) {
   if (bitmap.width == 0 || bitmap.rows == 0) {
     // If we got an empty bitmap, it's a special case.
 
@@ -611,8 +947,8 @@ make_glyph(int character, FT_Face face, int glyph_index) {
       }
     }
       
-    glyph->make_geom((int)floor(slot->bitmap_top + outline * _scale_factor + 0.5f),
-                     (int)floor(slot->bitmap_left - outline * _scale_factor + 0.5f),
+    glyph->make_geom((int)floor(bitmap_top + outline * _scale_factor + 0.5f),
+                     (int)floor(bitmap_left - outline * _scale_factor + 0.5f),
                      advance, _poly_margin,
                      tex_x_size, tex_y_size,
                      _font_pixels_per_unit, _tex_pixels_per_unit);
@@ -620,6 +956,217 @@ make_glyph(int character, FT_Face face, int glyph_index) {
   }
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: DynamicTextFont::prewarm_characters
+//       Access: Private
+//  Description: The implementation of prewarm() and prewarm_range().
+//               Renders the glyphs for the indicated characters that
+//               are not already in the cache, using as many threads
+//               as text-rasterize-threads allows, and then slots them
+//               into the pages in order, so the resulting pages do
+//               not depend on which thread rendered which glyph.
+////////////////////////////////////////////////////////////////////
+int DynamicTextFont::
+prewarm_characters(const pvector<int> &characters) {
+  if (!_is_valid) {
+    return 0;
+  }
+
+  // First, determine which glyphs we don't have yet.
+  RasterGlyphs rasters;
+  {
+    pset<int> glyph_indices;
+    FT_Face face = acquire_face();
+    pvector<int>::const_iterator ci;
+    for (ci = characters.begin(); ci != characters.end(); ++ci) {
+      int glyph_index = FT_Get_Char_Index(face, (*ci));
+      if (glyph_index != 0 &&
+          _cache.find(glyph_index) == _cache.end() &&
+          glyph_indices.insert(glyph_index).second) {
+        rasters.push_back(RasterGlyph((*ci), glyph_index));
+      }
+    }
+    release_face(face);
+  }
+
+  if (rasters.empty()) {
+    return 0;
+  }
+
+  if (_render_mode != RM_texture) {
+    // Polygon glyphs are built from the outline directly, which is
+    // not worth doing in parallel; just load them the normal way.
+    RasterGlyphs::const_iterator ri;
+    for (ri = rasters.begin(); ri != rasters.end(); ++ri) {
+      const TextGlyph *glyph;
+      get_glyph((*ri)._character, glyph);
+    }
+    return (int)rasters.size();
+  }
+
+  int num_threads = 0;
+  if (Thread::is_threading_supported()) {
+    num_threads = min((int)text_rasterize_threads, (int)rasters.size() - 1);
+  }
+
+  RasterBatch batch(this, rasters);
+  pvector< PT(GenericThread) > threads;
+  for (int i = 0; i < num_threads; ++i) {
+    PT(GenericThread) thread =
+      new GenericThread("text-rasterize", "text-rasterize",
+                        st_rasterize_glyphs, &batch);
+    if (thread->start(TP_normal, true)) {
+      threads.push_back(thread);
+    }
+  }
+
+  // The calling thread takes a share of the glyphs too.
+  rasterize_glyphs(&batch);
+
+  pvector< PT(GenericThread) >::iterator thi;
+  for (thi = threads.begin(); thi != threads.end(); ++thi) {
+    (*thi)->join();
+  }
+
+  // Now copy them into the pages, in order.
+  int count = 0;
+  RasterGlyphs::iterator ri;
+  for (ri = rasters.begin(); ri != rasters.end(); ++ri) {
+    RasterGlyph &raster = (*ri);
+    DynamicTextGlyph *glyph = (DynamicTextGlyph *)NULL;
+    if (raster._valid) {
+      glyph = make_texture_glyph(raster._character, raster._bitmap,
+                                 raster._bitmap_top, raster._bitmap_left,
+                                 raster._advance);
+      ++count;
+    }
+    _cache.insert(Cache::value_type(raster._glyph_index, glyph));
+  }
+
+  if (text_cat.is_debug()) {
+    text_cat.debug()
+      << "Prewarmed " << count << " glyphs of " << get_name() << " using "
+      << threads.size() + 1 << " threads.\n";
+  }
+  return count;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: DynamicTextFont::rasterize_glyphs
+//       Access: Private
+//  Description: Renders glyphs from the batch until there are none
+//               left.  This is called by each of the prewarm threads
+//               as well as the thread that called prewarm().  Each
+//               uses its own copy of the FreeType face, so that they
+//               need not wait for each other.
+////////////////////////////////////////////////////////////////////
+void DynamicTextFont::
+rasterize_glyphs(RasterBatch *batch) {
+  FT_Face face = copy_face();
+  bool is_copy = (face != (FT_Face)NULL);
+  if (!is_copy) {
+    // We couldn't open our own copy of the face, so we'll have to
+    // share the font's face.
+    face = acquire_face();
+  }
+
+  while (true) {
+    size_t n;
+    {
+      MutexHolder holder(batch->_lock);
+      if (batch->_next >= batch->_glyphs.size()) {
+        break;
+      }
+      n = batch->_next;
+      ++batch->_next;
+    }
+    rasterize_glyph(face, batch->_glyphs[n]);
+  }
+
+  if (is_copy) {
+    free_face_copy(face);
+  } else {
+    release_face(face);
+  }
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: DynamicTextFont::rasterize_glyph
+//       Access: Private
+//  Description: Has FreeType render the indicated glyph to a bitmap,
+//               and saves a copy of the bitmap and its metrics in the
+//               RasterGlyph.  This does not modify the font, and may
+//               be called from any thread.
+////////////////////////////////////////////////////////////////////
+void DynamicTextFont::
+rasterize_glyph(FT_Face face, RasterGlyph &raster) {
+  if (!load_glyph(face, raster._glyph_index, false)) {
+    return;
+  }
+
+  FT_GlyphSlot slot = face->glyph;
+  if (slot->format != ft_glyph_format_bitmap) {
+    FT_Render_Glyph(slot, ft_render_mode_normal);
+  }
+
+  const FT_Bitmap &bitmap = slot->bitmap;
+  raster._advance = slot->advance.x / 64.0;
+  raster._bitmap_top = slot->bitmap_top;
+  raster._bitmap_left = slot->bitmap_left;
+
+  // Copy the bitmap, since the slot will be reused for the next glyph.
+  raster._bitmap = bitmap;
+  int pitch = (bitmap.pitch < 0) ? -bitmap.pitch : bitmap.pitch;
+  raster._buffer.resize(pitch * bitmap.rows);
+  for (int yi = 0; yi < (int)bitmap.rows; ++yi) {
+    memcpy(&raster._buffer[yi * pitch], bitmap.buffer + yi * bitmap.pitch, pitch);
+  }
+  raster._bitmap.pitch = pitch;
+  raster._bitmap.buffer = raster._buffer.empty() ? NULL : &raster._buffer[0];
+  raster._valid = true;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: DynamicTextFont::st_rasterize_glyphs
+//       Access: Private, Static
+//  Description: The thread function for the prewarm threads.
+////////////////////////////////////////////////////////////////////
+void DynamicTextFont::
+st_rasterize_glyphs(void *data) {
+  RasterBatch *batch = (RasterBatch *)data;
+  batch->_font->rasterize_glyphs(batch);
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: DynamicTextFont::write_cache_key
+//       Access: Private
+//  Description: Writes all of the font settings that affect the
+//               contents of the pages to the datagram.  A glyph
+//               cache file is only used if it was written with the
+//               same settings.
+////////////////////////////////////////////////////////////////////
+void DynamicTextFont::
+write_cache_key(Datagram &dg) const {
+  dg.add_string(get_name());
+  dg.add_string(get_font_key());
+  dg.add_float32(_point_size);
+  dg.add_float32(_tex_pixels_per_unit);
+  dg.add_float32(_scale_factor);
+  dg.add_bool(_native_antialias);
+  dg.add_int32(_texture_margin);
+  dg.add_float32(_poly_margin);
+  dg.add_int32(_page_x_size);
+  dg.add_int32(_page_y_size);
+  dg.add_uint8(_tex_format);
+  for (int i = 0; i < 4; ++i) {
+    dg.add_float32(_fg[i]);
+    dg.add_float32(_bg[i]);
+    dg.add_float32(_outline_color[i]);
+  }
+  dg.add_float32(_outline_width);
+  dg.add_float32(_outline_feather);
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: DynamicTextFont::copy_bitmap_to_texture
 //       Access: Private
@@ -26,11 +26,13 @@
 #include "filename.h"
 #include "pvector.h"
 #include "pmap.h"
+#include "pmutex.h"
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
 class NurbsCurveResult;
+class Datagram;
 
 ////////////////////////////////////////////////////////////////////
 //       Class : DynamicTextFont
@@ -107,6 +109,12 @@ PUBLISHED:
   int garbage_collect();
   void clear();
 
+  int prewarm(const wstring &text);
+  int prewarm_range(int first_character, int last_character);
+
+  bool write_glyph_cache(const Filename &filename) const;
+  bool read_glyph_cache(const Filename &filename);
+
   virtual void write(ostream &out, int indent_level) const;
 
 public:
@@ -117,6 +125,9 @@ private:
   void update_filters();
   void determine_tex_format();
   DynamicTextGlyph *make_glyph(int character, FT_Face face, int glyph_index);
+  DynamicTextGlyph *make_texture_glyph(int character, const FT_Bitmap &bitmap,
+                                       int bitmap_top, int bitmap_left,
+                                       PN_stdfloat advance);
   void copy_bitmap_to_texture(const FT_Bitmap &bitmap, DynamicTextGlyph *glyph);
   void copy_pnmimage_to_texture(const PNMImage &image, DynamicTextGlyph *glyph);
   void blend_pnmimage_to_texture(const PNMImage &image, DynamicTextGlyph *glyph,
@@ -135,6 +146,39 @@ private:
                               const FT_Vector *to, void *user);
   int outline_nurbs(NurbsCurveResult *ncr);
 
+  // A glyph rendered by FreeType in one of the prewarm threads, which
+  // has not yet been copied into a page.
+  class RasterGlyph {
+  public:
+    INLINE RasterGlyph(int character, int glyph_index);
+
+    int _character;
+    int _glyph_index;
+    bool _valid;
+    PN_stdfloat _advance;
+    int _bitmap_top, _bitmap_left;
+    FT_Bitmap _bitmap;
+    pvector<unsigned char> _buffer;
+  };
+  typedef pvector<RasterGlyph> RasterGlyphs;
+
+  class RasterBatch {
+  public:
+    INLINE RasterBatch(DynamicTextFont *font, RasterGlyphs &glyphs);
+
+    DynamicTextFont *_font;
+    RasterGlyphs &_glyphs;
+    size_t _next;
+    Mutex _lock;
+  };
+
+  int prewarm_characters(const pvector<int> &characters);
+  void rasterize_glyphs(RasterBatch *batch);
+  void rasterize_glyph(FT_Face face, RasterGlyph &raster);
+  static void st_rasterize_glyphs(void *data);
+  void write_cache_key(Datagram &dg) const;
+  bool glyph_cache_invalid(const Filename &fn);
+
   int _texture_margin;
   PN_stdfloat _poly_margin;
   int _page_x_size, _page_y_size;
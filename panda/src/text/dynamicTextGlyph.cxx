@@ -103,6 +103,11 @@ make_geom(int bitmap_top, int bitmap_left, PN_stdfloat advance, PN_stdfloat poly
   // This function should not be called twice.
   nassertv(_geom_count == 0);
 
+  _bitmap_top = bitmap_top;
+  _bitmap_left = bitmap_left;
+  _tex_x_size = tex_x_size;
+  _tex_y_size = tex_y_size;
+
   tex_x_size += _margin * 2;
   tex_y_size += _margin * 2;
 
@@ -60,6 +60,11 @@ public:
   int _x, _y;
   int _x_size, _y_size;
   int _margin;
+
+  // These are the parameters that were passed to make_geom(), so that
+  // the glyph can be recreated from a glyph cache file.
+  int _bitmap_top, _bitmap_left;
+  PN_stdfloat _tex_x_size, _tex_y_size;
 };
 
 #include "dynamicTextGlyph.I"
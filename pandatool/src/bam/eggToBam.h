@@ -45,6 +45,9 @@ private:
   void collect_textures(PandaNode *node);
   void collect_textures(const RenderState *state);
   void convert_txo(Texture *tex);
+  PN_stdfloat get_acmr(PandaNode *node, int cache_size);
+  void r_get_acmr(PandaNode *node, int cache_size, PN_stdfloat &num_misses,
+                  int &num_faces);
 
   bool make_buffer();
 
@@ -68,6 +71,12 @@ private:
   bool _tex_mipmap;
   string _ctex_quality;
   string _load_display;
+  bool _has_vcache;
+  int _vcache_size;
+  bool _vcache_overdraw;
+  bool _has_lod;
+  int _lod_levels;
+  double _lod_pixel_error;
 
   // The rest of this is required to support -ctex.
   PT(GraphicsPipe) _pipe;
@@ -54,7 +54,9 @@ PStatReader(PStatServer *manager, PStatMonitor *monitor) :
 ////////////////////////////////////////////////////////////////////
 PStatReader::
 ~PStatReader() {
-  _manager->release_udp_port(_udp_port);
+  if (_udp_port != 0) {
+    _manager->release_udp_port(_udp_port);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -128,6 +130,28 @@ idle() {
   _monitor->idle();
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: PStatReader::handle_client_datagram
+//       Access: Public
+//  Description: Handles a datagram as it arrives on the client's TCP
+//               connection: either a control message or a frame of
+//               data.  This is also used by PStatServer to feed a
+//               reader the contents of a recording file.
+////////////////////////////////////////////////////////////////////
+void PStatReader::
+handle_client_datagram(const Datagram &datagram) {
+  PStatClientControlMessage message;
+  if (message.decode(datagram, _client_data)) {
+    handle_client_control_message(message);
+
+  } else if (message._type == PStatClientControlMessage::T_datagram) {
+    handle_client_udp_data(datagram);
+
+  } else {
+    nout << "Got unexpected message from client.\n";
+  }
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: PStatReader::get_monitor
 //       Access: Public
@@ -183,16 +207,7 @@ receive_datagram(const NetDatagram &datagram) {
   Connection *connection = datagram.get_connection();
 
   if (connection == _tcp_connection) {
-    PStatClientControlMessage message;
-    if (message.decode(datagram, _client_data)) {
-      handle_client_control_message(message);
-
-    } else if (message._type == PStatClientControlMessage::T_datagram) {
-      handle_client_udp_data(datagram);
-
-    } else {
-      nout << "Got unexpected message from client.\n";
-    }
+    handle_client_datagram(datagram);
 
   } else if (connection == _udp_connection) {
     handle_client_udp_data(datagram);
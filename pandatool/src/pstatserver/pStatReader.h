@@ -52,6 +52,8 @@ public:
   void lost_connection();
   void idle();
 
+  void handle_client_datagram(const Datagram &datagram);
+
   PStatMonitor *get_monitor();
 
 private:
@@ -16,6 +16,12 @@
 #include "pStatReader.h"
 #include "thread.h"
 #include "config_pstats.h"
+#include "pStatProperties.h"
+
+// The number of frames of recorded data that are fed to each replay
+// reader per call to poll().  This must be comfortably less than
+// queued_frame_records, or the reader will drop frames.
+static const int replay_frames_per_poll = 100;
 
 ////////////////////////////////////////////////////////////////////
 //     Function: PStatServer::Constructor
@@ -36,6 +42,12 @@ PStatServer() {
 PStatServer::
 ~PStatServer() {
   delete _listener;
+
+  Replays::iterator pi;
+  for (pi = _replays.begin(); pi != _replays.end(); ++pi) {
+    delete (*pi)->_reader;
+    delete (*pi);
+  }
 }
 
 
@@ -79,6 +91,64 @@ listen(int port) {
 }
 
 
+////////////////////////////////////////////////////////////////////
+//     Function: PStatServer::replay
+//       Access: Public
+//  Description: Opens a file written by PStatClient::record() and
+//               begins playing it back to a new PStatMonitor, as if
+//               the recorded client had just connected.  The data is
+//               fed to the monitor a bit at a time by subsequent
+//               calls to poll().
+//
+//               This function returns true if the file was
+//               successfully opened, or false if it could not be
+//               opened or is not a PStats recording.
+////////////////////////////////////////////////////////////////////
+bool PStatServer::
+replay(const Filename &filename) {
+  Filename fn = Filename::binary_filename(filename);
+
+  Replay *replay = new Replay;
+  if (!replay->_file.open(fn)) {
+    nout << "Unable to open " << fn << "\n";
+    delete replay;
+    return false;
+  }
+
+  string header;
+  if (!replay->_file.read_header(header, pstats_record_header_size) ||
+      header != string(pstats_record_header, pstats_record_header_size)) {
+    nout << fn << " is not a PStats recording.\n";
+    delete replay;
+    return false;
+  }
+
+  PStatMonitor *monitor = make_monitor();
+  if (monitor == (PStatMonitor *)NULL) {
+    nout << "Couldn't create monitor!\n";
+    delete replay;
+    return false;
+  }
+
+  nout << "Replaying " << fn << "\n";
+
+  replay->_reader = new PStatReader(this, monitor);
+  replay->_closed = false;
+  _replays.push_back(replay);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+//     Function: PStatServer::is_replaying
+//       Access: Public
+//  Description: Returns true if any files opened with replay() have
+//               not yet been played back completely.
+////////////////////////////////////////////////////////////////////
+bool PStatServer::
+is_replaying() const {
+  return !_replays.empty();
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: PStatServer::poll
 //       Access: Public
@@ -123,6 +193,8 @@ poll() {
     
     ri = rnext;
   }
+
+  poll_replays();
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -166,12 +238,23 @@ void PStatServer::
 remove_reader(Connection *connection, PStatReader *reader) {
   Readers::iterator ri;
   ri = _readers.find(connection);
-  if (ri == _readers.end() || (*ri).second != reader) {
-    nout << "Attempt to remove undefined reader.\n";
-  } else {
+  if (ri != _readers.end() && (*ri).second == reader) {
     _readers.erase(ri);
     _removed_readers.push_back(reader);
+    return;
   }
+
+  // Maybe it's playing back a file.  It will be cleaned up by the
+  // next call to poll_replays().
+  Replays::iterator pi;
+  for (pi = _replays.begin(); pi != _replays.end(); ++pi) {
+    if ((*pi)->_reader == reader) {
+      (*pi)->_closed = true;
+      return;
+    }
+  }
+
+  nout << "Attempt to remove undefined reader.\n";
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -321,6 +404,59 @@ is_thread_safe() {
   return false;
 }
 
+////////////////////////////////////////////////////////////////////
+//     Function: PStatServer::poll_replays
+//       Access: Private
+//  Description: Feeds the next few frames of each file being played
+//               back to its reader, and cleans up the replays that
+//               have finished.
+////////////////////////////////////////////////////////////////////
+void PStatServer::
+poll_replays() {
+  Replays::iterator pi = _replays.begin();
+  while (pi != _replays.end()) {
+    Replay *replay = (*pi);
+
+    bool finished = false;
+    int num_frames = 0;
+    while (!replay->_closed && num_frames < replay_frames_per_poll) {
+      Datagram datagram;
+      if (!replay->_file.get_datagram(datagram)) {
+        if (!replay->_file.is_eof()) {
+          nout << "Error reading " << replay->_file.get_filename() << "\n";
+        }
+        finished = true;
+        break;
+      }
+
+      // Frame data begins with a zero byte; everything else is a
+      // control message.
+      if (datagram.get_length() != 0 &&
+          ((const unsigned char *)datagram.get_data())[0] == 0) {
+        ++num_frames;
+      }
+      replay->_reader->handle_client_datagram(datagram);
+    }
+
+    if (!replay->_closed) {
+      replay->_reader->idle();
+    }
+
+    if (replay->_closed || finished) {
+      // If the monitor closed itself, it has already been told about
+      // the lost connection.
+      if (!replay->_closed) {
+        replay->_reader->lost_connection();
+      }
+      delete replay->_reader;
+      delete replay;
+      pi = _replays.erase(pi);
+    } else {
+      ++pi;
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////////////////
 //     Function: PStatServer::connection_reset
 //       Access: Protected, Virtual
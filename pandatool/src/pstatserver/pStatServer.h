@@ -18,6 +18,8 @@
 #include "pandatoolbase.h"
 #include "pStatListener.h"
 #include "connectionManager.h"
+#include "datagramInputFile.h"
+#include "filename.h"
 #include "vector_stdfloat.h"
 #include "pmap.h"
 #include "pdeque.h"
@@ -37,6 +39,11 @@ class PStatReader;
 //               on.  It will automatically create PStatMonitors as
 //               connections are established and mark the connections
 //               closed as they are lost.
+//
+//               A file written by PStatClient::record() may also be
+//               played back with replay(); it is fed to a new
+//               PStatMonitor exactly as if it were coming from a
+//               live client.
 ////////////////////////////////////////////////////////////////////
 class PStatServer : public ConnectionManager {
 public:
@@ -44,6 +51,8 @@ public:
   ~PStatServer();
 
   bool listen(int port = -1);
+  bool replay(const Filename &filename);
+  bool is_replaying() const;
 
   void poll();
   void main_loop(bool *interrupt_flag = NULL);
@@ -70,6 +79,7 @@ protected:
 
 private:
   void user_guide_bars_changed();
+  void poll_replays();
 
   PStatListener *_listener;
 
@@ -79,6 +89,16 @@ private:
   LostReaders _lost_readers;
   LostReaders _removed_readers;
 
+  // A recording file that is being played back into its own reader.
+  class Replay {
+  public:
+    PStatReader *_reader;
+    DatagramInputFile _file;
+    bool _closed;
+  };
+  typedef pvector<Replay *> Replays;
+  Replays _replays;
+
   typedef pdeque<int> Ports;
   Ports _available_udp_ports;
   int _next_udp_port;
@@ -39,7 +39,8 @@ TextStats() {
   set_program_description
     ("This is a simple PStats server that listens on a TCP port for a "
      "connection from a PStatClient in a Panda player.  It will then report "
-     "frame rate and timing information sent by the player.");
+     "frame rate and timing information sent by the player.  It can also "
+     "replay a file recorded by a player with pstats-record-file set.");
 
   add_option
     ("p", "port", 0,
@@ -47,6 +48,13 @@ TextStats() {
      "is taken from the pstats-host Config variable.",
      &TextStats::dispatch_int, NULL, &_port);
 
+  add_option
+    ("f", "filename", 0,
+     "Instead of listening for a connection, replay the PStats data "
+     "recorded in the indicated file, and exit when it has all been "
+     "reported.",
+     &TextStats::dispatch_filename, &_got_replay_filename, &_replay_filename);
+
   add_option
     ("r", "", 0,
      "Show the raw frame data, in addition to boiling it down to a total "
@@ -86,20 +94,32 @@ run() {
   // we can clean up nicely if the user stops us.
   signal(SIGINT, &signal_handler);
 
-  if (!listen(_port)) {
-    nout << "Unable to open port.\n";
-    exit(1);
-  }
-
-  nout << "Listening for connections.\n";
-
   if (_got_outputFileName) {
     _outFile = new ofstream(_outputFileName.c_str(), ios::out);
   } else {
     _outFile = &(nout);
   }
+
+  if (_got_replay_filename) {
+    if (!replay(_replay_filename)) {
+      exit(1);
+    }
+
+    // There's no need to wait between polls; the data is all there.
+    while (!user_interrupted && is_replaying()) {
+      poll();
+    }
+
+  } else {
+    if (!listen(_port)) {
+      nout << "Unable to open port.\n";
+      exit(1);
+    }
+
+    nout << "Listening for connections.\n";
   
-  main_loop(&user_interrupted);
+    main_loop(&user_interrupted);
+  }
   nout << "Exiting.\n";
 }
 
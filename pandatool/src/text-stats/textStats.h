@@ -39,6 +39,8 @@ public:
 private:  
   int _port;
   bool _show_raw_data;
+  bool _got_replay_filename;
+  Filename _replay_filename;
   
   //[PECI]
   bool _got_outputFileName;